@@ -9,6 +9,7 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include "ketopt.h"
 #include "app_lcl.h"
 #include "amvp/amvp.h"
@@ -150,6 +151,10 @@ static void print_usage(int code) {
     printf("To get the expected results of a sample test session:\n");
     printf("      --get_expected_results <session_file>\n");
     printf("\n");
+    printf("To compare a vector set response file with saved expected results, without\n");
+    printf("contacting the server:\n");
+    printf("      --verify_expected <expected_results_file> --response <file>\n");
+    printf("\n");
     printf("Some other options may support outputting to log OR saving to a file. To save to a file:\n");
     printf("      --save_to <file>\n");
     printf("      -s <file>\n");
@@ -160,6 +165,42 @@ static void print_usage(int code) {
     printf("To post all resources a predefined resource json file:\n");
     printf("      --post_resources <resource_file>\n");
     printf("\n");
+    printf("To process or upload up to <n> vector sets at the same time, online or with\n");
+    printf("--request/--response or --upload:\n");
+    printf("      --vs_workers <n>\n");
+    printf("\n");
+    printf("To set the compression level used when writing .gz or .zst files (1-%d):\n", AMVP_FILE_COMPRESSION_LEVEL_MAX);
+    printf("      --compress_level <n>\n");
+    printf("\n");
+    printf("To hand log messages to the output from a background thread, queueing up to <n>\n");
+    printf("messages (1-%d):\n", AMVP_LOG_ASYNC_SLOTS_MAX);
+    printf("      --log_async <n>\n");
+    printf("\n");
+    printf("To print where the time and memory of the session went, per algorithm and\n");
+    printf("subsystem, when done:\n");
+    printf("      --perf_stats\n");
+    printf("\n");
+    printf("To log the <n> slowest test cases of every vector set, and list the slowest of\n");
+    printf("each algorithm with --perf_stats (1-%d):\n", AMVP_SLOW_TC_MAX);
+    printf("      --slow_tcs <n>\n");
+    printf("\n");
+    printf("To estimate the vector sets, test cases, CPU time, transfer volume and memory of\n");
+    printf("a session from the enabled algorithms, without contacting the server, timing the\n");
+    printf("crypto module on the vector sets of <file> when it is given:\n");
+    printf("      --cost\n");
+    printf("      --cost --calibrate <file>\n");
+    printf("\n");
+    printf("To write a timeline of the session to <file>, for chrome://tracing or Perfetto:\n");
+    printf("      --trace <file>\n");
+    printf("\n");
+    printf("To record every HTTP exchange with the server to <file>:\n");
+    printf("      --record <file>\n");
+    printf("\n");
+    printf("To answer the HTTP requests from a file written by --record instead of the server,\n");
+    printf("at the pace of the recorded session with --replay_realtime:\n");
+    printf("      --replay <file>\n");
+    printf("      --replay_realtime\n");
+    printf("\n");
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
     printf("To disable FIPS mode for this run (Note, a warning will be issued):\n");
     printf("      -disable_fips\n");
@@ -262,6 +303,17 @@ static ko_longopt_t longopts[] = {
     { "get_registration", ko_no_argument, 418 },
     { "module_cert_req", ko_required_argument, 419 },
     { "post_resources", ko_required_argument, 420 },
+    { "vs_workers", ko_required_argument, 421 },
+    { "compress_level", ko_required_argument, 422 },
+    { "verify_expected", ko_required_argument, 423 },
+    { "log_async", ko_required_argument, 424 },
+    { "perf_stats", ko_no_argument, 425 },
+    { "trace", ko_required_argument, 426 },
+    { "record", ko_required_argument, 427 },
+    { "replay", ko_required_argument, 428 },
+    { "replay_realtime", ko_no_argument, 429 },
+    { "slow_tcs", ko_required_argument, 430 },
+    { "calibrate", ko_required_argument, 431 },
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
     { "disable_fips", ko_no_argument, 500 },
 #endif
@@ -608,6 +660,94 @@ int ingest_cli(APP_CONFIG *cfg, int argc, char **argv) {
             strcpy_s(cfg->post_resources_filename, JSON_FILENAME_LENGTH + 1, opt.arg);
             break;
 
+        case 421:
+            cfg->vs_workers = (int)strtol(opt.arg, NULL, 10);
+            if (cfg->vs_workers < 1 || cfg->vs_workers > AMVP_VS_WORKERS_MAX) {
+                printf(ANSI_COLOR_RED "Command error... "ANSI_COLOR_RESET
+                       "\nThe number of vector set workers must be between 1 and %d"
+                       "\n%s\n", AMVP_VS_WORKERS_MAX, AMVP_APP_HELP_MSG);
+                return 1;
+            }
+            break;
+
+        case 422:
+            cfg->compress_level = (int)strtol(opt.arg, NULL, 10);
+            if (cfg->compress_level < 1 || cfg->compress_level > AMVP_FILE_COMPRESSION_LEVEL_MAX) {
+                printf(ANSI_COLOR_RED "Command error... "ANSI_COLOR_RESET
+                       "\nThe compression level must be between 1 and %d"
+                       "\n%s\n", AMVP_FILE_COMPRESSION_LEVEL_MAX, AMVP_APP_HELP_MSG);
+                return 1;
+            }
+            break;
+
+        case 423:
+            cfg->verify_expected = 1;
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->expected_file, JSON_FILENAME_LENGTH + 1, opt.arg);
+            break;
+
+        case 424:
+            cfg->log_async = (int)strtol(opt.arg, NULL, 10);
+            if (cfg->log_async < 1 || cfg->log_async > AMVP_LOG_ASYNC_SLOTS_MAX) {
+                printf(ANSI_COLOR_RED "Command error... "ANSI_COLOR_RESET
+                       "\nThe number of asynchronous log slots must be between 1 and %d"
+                       "\n%s\n", AMVP_LOG_ASYNC_SLOTS_MAX, AMVP_APP_HELP_MSG);
+                return 1;
+            }
+            break;
+
+        case 425:
+            cfg->perf_stats = 1;
+            break;
+
+        case 426:
+            cfg->trace = 1;
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->trace_file, JSON_FILENAME_LENGTH + 1, opt.arg);
+            break;
+
+        case 427:
+            cfg->record = 1;
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->record_file, JSON_FILENAME_LENGTH + 1, opt.arg);
+            break;
+
+        case 428:
+            cfg->replay = 1;
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->replay_file, JSON_FILENAME_LENGTH + 1, opt.arg);
+            break;
+
+        case 429:
+            cfg->replay_realtime = 1;
+            break;
+
+        case 430:
+            cfg->slow_tcs = (int)strtol(opt.arg, NULL, 10);
+            if (cfg->slow_tcs < 1 || cfg->slow_tcs > AMVP_SLOW_TC_MAX) {
+                printf(ANSI_COLOR_RED "Command error... "ANSI_COLOR_RESET
+                       "\nThe number of slow test cases must be between 1 and %d"
+                       "\n%s\n", AMVP_SLOW_TC_MAX, AMVP_APP_HELP_MSG);
+                return 1;
+            }
+            break;
+
+        case 431:
+            cfg->calibrate = 1;
+            if (!check_option_length(opt.arg, c, JSON_FILENAME_LENGTH)) {
+                return 1;
+            }
+            strcpy_s(cfg->calibrate_file, JSON_FILENAME_LENGTH + 1, opt.arg);
+            break;
+
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
         case 500:
             cfg->disable_fips = 1;
@@ -640,7 +780,7 @@ int ingest_cli(APP_CONFIG *cfg, int argc, char **argv) {
 
     //Many args do not need an alg specified. Todo: make cleaner
     if (cfg->empty_alg && !cfg->post && !cfg->get && !cfg->put && !cfg->get_results && !cfg->post_resources
-            && !cfg->get_expected && !cfg->manual_reg && !cfg->vector_upload && !cfg->mod_cert_req
+            && !cfg->get_expected && !cfg->verify_expected && !cfg->manual_reg && !cfg->vector_upload && !cfg->mod_cert_req
             && !cfg->delete && !cfg->cancel_session && !(cfg->resume_session && 
             cfg->vector_req)) {
         /* The user needs to select at least 1 algorithm */
@@ -50,9 +50,20 @@ typedef struct app_config {
     int empty_alg;
     int fips_validation;
     int get_expected;
+    int verify_expected;
     int save_to;
     int get_cost;
     int get_reg;
+    int vs_workers;
+    int compress_level;
+    int log_async;
+    int perf_stats;
+    int trace;
+    int record;
+    int replay;
+    int replay_realtime;
+    int slow_tcs;
+    int calibrate;
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
     int disable_fips;
 #endif
@@ -68,6 +79,11 @@ typedef struct app_config {
     char kat_file[JSON_FILENAME_LENGTH + 1];
     char validation_metadata_file[JSON_FILENAME_LENGTH + 1];
     char save_file[JSON_FILENAME_LENGTH + 1];
+    char expected_file[JSON_FILENAME_LENGTH + 1];
+    char trace_file[JSON_FILENAME_LENGTH + 1];
+    char record_file[JSON_FILENAME_LENGTH + 1];
+    char replay_file[JSON_FILENAME_LENGTH + 1];
+    char calibrate_file[JSON_FILENAME_LENGTH + 1];
     char mod_cert_req_file[JSON_FILENAME_LENGTH + 1];
     char post_resources_filename[JSON_FILENAME_LENGTH + 1];
 
@@ -113,6 +113,162 @@ static AMVP_RESULT progress(char *msg, AMVP_LOG_LVL level) {
     return AMVP_SUCCESS;
 }
 
+static void print_perf_row(const char *name, const char *mode, const AMVP_PERF_COUNTERS *c) {
+    char alg[64];
+
+    if (mode) {
+        snprintf(alg, sizeof(alg), "%s %s", name, mode);
+    } else {
+        snprintf(alg, sizeof(alg), "%s", name);
+    }
+    printf("%-28.28s %5llu %8llu %9.1f %9.1f %9.1f %9.1f %9.1f %9llu %9llu\n", alg,
+           c->vs_count, c->tc_count, c->parse_ns / 1e6, c->decode_ns / 1e6, c->crypto_ns / 1e6,
+           c->serialize_ns / 1e6, c->network_ns / 1e6, c->bytes_in / 1024, c->bytes_out / 1024);
+}
+
+static void print_latency_row(const char *name, const char *mode, const AMVP_LATENCY_STATS *l) {
+    char alg[64];
+    int i;
+
+    if (mode) {
+        snprintf(alg, sizeof(alg), "%s %s", name, mode);
+    } else {
+        snprintf(alg, sizeof(alg), "%s", name);
+    }
+    printf("%-28.28s %8llu %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n", alg, l->count,
+           l->mean_ns / 1e6, l->p50_ns / 1e6, l->p90_ns / 1e6, l->p99_ns / 1e6,
+           l->p999_ns / 1e6, l->max_ns / 1e6);
+    for (i = 0; i < l->slow_count; i++) {
+        printf("%-28s vsId %d tgId %d tcId %d: %.3f ms\n", "", l->slow[i].vs_id,
+               l->slow[i].tg_id, l->slow[i].tc_id, l->slow[i].ns / 1e6);
+    }
+}
+
+/*
+ * Prints how long the crypto handlers took per test case, per algorithm
+ */
+static void print_latency_stats(AMVP_CTX *ctx, const AMVP_PERF_STATS *perf) {
+    AMVP_LATENCY_STATS stats;
+    int i;
+
+    printf("\n%-28s %8s %9s %9s %9s %9s %9s %9s\n", "Crypto handler latency", "Tests",
+           "Mean ms", "p50 ms", "p90 ms", "p99 ms", "p99.9 ms", "Max ms");
+    for (i = AMVP_CIPHER_START + 1; i < AMVP_CIPHER_END; i++) {
+        if (perf->alg[i].name && perf->alg[i].tc_count &&
+            amvp_get_latency_stats(ctx, i, &stats) == AMVP_SUCCESS) {
+            print_latency_row(perf->alg[i].name, perf->alg[i].mode, &stats);
+        }
+    }
+}
+
+/*
+ * Prints where the time of the session went, per algorithm
+ */
+static void print_perf_stats(AMVP_CTX *ctx) {
+    AMVP_PERF_STATS *stats = NULL;
+    int i;
+
+    stats = calloc(1, sizeof(AMVP_PERF_STATS));
+    if (!stats) {
+        return;
+    }
+    if (amvp_get_perf_stats(ctx, stats) != AMVP_SUCCESS) {
+        printf("Unable to get performance counters\n");
+        free(stats);
+        return;
+    }
+    printf("\n%-28s %5s %8s %9s %9s %9s %9s %9s %9s %9s\n", "Algorithm", "VS", "Tests",
+           "Parse ms", "Decode ms", "Crypto ms", "Encode ms", "Net ms", "KB in", "KB out");
+    for (i = AMVP_CIPHER_START + 1; i < AMVP_CIPHER_END; i++) {
+        if (stats->alg[i].name) {
+            print_perf_row(stats->alg[i].name, stats->alg[i].mode, &stats->alg[i]);
+        }
+    }
+    print_perf_row("(session)", NULL, &stats->alg[AMVP_CIPHER_START]);
+    print_perf_row("Total", NULL, &stats->total);
+    print_latency_stats(ctx, stats);
+    free(stats);
+}
+
+/*
+ * Prints the heap use of the library, per subsystem
+ */
+static void print_mem_stats(AMVP_CTX *ctx) {
+    static const char *names[AMVP_MEM_TAG_MAX] = { "JSON", "Test cases", "Transport", "Capabilities" };
+    AMVP_MEM_STATS stats;
+    int i;
+
+    if (amvp_get_mem_stats(ctx, &stats) != AMVP_SUCCESS) {
+        printf("Unable to get memory counters\n");
+        return;
+    }
+    printf("\n%-28s %10s %10s %10s %12s\n", "Memory", "KB now", "KB peak", "Allocs", "KB peak VS");
+    for (i = 0; i < AMVP_MEM_TAG_MAX; i++) {
+        printf("%-28s %10llu %10llu %10llu %12llu\n", names[i], stats.tag[i].current / 1024,
+               stats.tag[i].peak / 1024, stats.tag[i].allocs, stats.peak_vs[i] / 1024);
+    }
+    printf("%-28s %10llu %10llu %10llu %12llu\n", "Total", stats.total.current / 1024,
+           stats.total.peak / 1024, stats.total.allocs, stats.peak_vs_total / 1024);
+    if (stats.vs_count) {
+        printf("Vector set %d needed the most memory of the %d processed\n",
+               stats.peak_vs_id, stats.vs_count);
+    }
+}
+
+static void print_estimate_row(const char *name, const char *mode, const AMVP_ALG_ESTIMATE *e) {
+    char alg[64];
+
+    if (mode) {
+        snprintf(alg, sizeof(alg), "%s %s%s", name, mode, e->calibrated ? "" : " *");
+    } else {
+        snprintf(alg, sizeof(alg), "%s%s", name, e->calibrated ? "" : " *");
+    }
+    printf("%-28.28s %5d %6llu %8llu %12llu %10.1f %9llu %9llu %9llu\n", alg, e->vs_count,
+           e->tg_count, e->tc_count, e->crypto_calls, e->cpu_ns / 1e6, e->bytes_in / 1024,
+           e->bytes_out / 1024, e->mem_peak / 1024);
+}
+
+/*
+ * Prints what the session is predicted to cost, per algorithm
+ */
+static void print_estimate(AMVP_CTX *ctx, const char *calibration_file, int workers) {
+    AMVP_SESSION_ESTIMATE *est = NULL;
+    unsigned long long wall_ns = 0;
+    int i;
+
+    est = calloc(1, sizeof(AMVP_SESSION_ESTIMATE));
+    if (!est) {
+        return;
+    }
+    if (amvp_estimate_session(ctx, calibration_file, est) != AMVP_SUCCESS) {
+        printf("Unable to estimate the cost of the test session\n");
+        free(est);
+        return;
+    }
+    printf("\n%-28s %5s %6s %8s %12s %10s %9s %9s %9s\n", "Estimate", "VS", "Groups", "Tests",
+           "Crypto ops", "CPU ms", "KB in", "KB out", "KB peak");
+    for (i = AMVP_CIPHER_START + 1; i < AMVP_CIPHER_END; i++) {
+        if (est->alg[i].vs_count) {
+            print_estimate_row(est->alg[i].name, est->alg[i].mode, &est->alg[i]);
+        }
+    }
+    print_estimate_row("Total", NULL, &est->total);
+    if (!est->total.calibrated) {
+        printf("* times and sizes of a typical software module, not calibrated\n");
+    }
+
+    /* No vector set is split between workers */
+    workers = workers > 0 ? workers : 1;
+    wall_ns = est->total.cpu_ns / workers;
+    if (wall_ns < est->total.vs_max_ns) {
+        wall_ns = est->total.vs_max_ns;
+    }
+    printf("Processing takes about %.1f s with %d vector set worker%s, and up to %llu KB of heap\n\n",
+           wall_ns / 1e9, workers, workers > 1 ? "s" : "",
+           est->total.mem_peak * workers / 1024);
+    free(est);
+}
+
 static void app_cleanup(AMVP_CTX *ctx) {
     // Routines for libamvp
     amvp_cleanup(ctx);
@@ -230,6 +386,62 @@ int main(int argc, char **argv) {
         amvp_mark_as_sample(ctx);
     }
 
+    if (cfg.vs_workers) {
+        rv = amvp_set_vs_workers(ctx, cfg.vs_workers);
+        if (rv != AMVP_SUCCESS) {
+            printf("Failed to set number of vector set workers\n");
+            goto end;
+        }
+    }
+
+    if (cfg.log_async) {
+        rv = amvp_set_log_async(ctx, cfg.log_async);
+        if (rv != AMVP_SUCCESS) {
+            printf("Failed to enable asynchronous logging\n");
+            goto end;
+        }
+    }
+
+    if (cfg.trace) {
+        rv = amvp_set_trace_file(ctx, cfg.trace_file);
+        if (rv != AMVP_SUCCESS) {
+            printf("Failed to open trace file\n");
+            goto end;
+        }
+    }
+
+    if (cfg.slow_tcs) {
+        rv = amvp_set_slow_tc_capture(ctx, cfg.slow_tcs);
+        if (rv != AMVP_SUCCESS) {
+            printf("Failed to set number of slow test cases to keep\n");
+            goto end;
+        }
+    }
+
+    if (cfg.record) {
+        rv = amvp_set_transport_record(ctx, cfg.record_file);
+        if (rv != AMVP_SUCCESS) {
+            printf("Failed to open transport recording\n");
+            goto end;
+        }
+    }
+
+    if (cfg.replay) {
+        rv = amvp_set_transport_replay(ctx, cfg.replay_file, cfg.replay_realtime);
+        if (rv != AMVP_SUCCESS) {
+            printf("Failed to load transport recording\n");
+            goto end;
+        }
+    }
+
+    if (cfg.compress_level) {
+        rv = amvp_set_file_compression_level(ctx, cfg.compress_level);
+        if (rv != AMVP_SUCCESS) {
+            printf("Failed to set file compression level\n");
+            goto end;
+        }
+    }
+
     if (cfg.get) {
         rv = amvp_mark_as_get_only(ctx, cfg.get_string);
         if (rv != AMVP_SUCCESS) {
@@ -255,11 +467,24 @@ int main(int argc, char **argv) {
         amvp_mark_as_request_only(ctx, cfg.vector_req_file);
     }
 
-    if (!cfg.vector_req && cfg.vector_rsp) {
+    if (!cfg.vector_req && cfg.vector_rsp && !cfg.verify_expected) {
         printf("Offline vector processing requires both options, --vector_req and --vector_rsp\n");
         goto end;
     }
 
+    if (cfg.verify_expected) {
+        if (!cfg.vector_rsp) {
+            printf("Verifying expected results requires a response file, --response\n");
+            goto end;
+        }
+        rv = amvp_verify_expected_results(ctx, cfg.vector_rsp_file, cfg.expected_file, &diff);
+        if (rv == AMVP_SUCCESS && diff) {
+            printf("Responses do not match the expected results (%d mismatches)\n", diff);
+            rv = AMVP_TC_INVALID_DATA;
+        }
+        goto end;
+    }
+
     if (cfg.manual_reg) {
         /*
          * Using a JSON to register allows us to skip the
@@ -280,7 +505,8 @@ int main(int argc, char **argv) {
         if (diff < 0) {
             printf("Unable to get expected vector set count with given test session context.\n\n");
         } else {
-            printf("The given test session context is expected to generate %d vector sets.\n\n", diff);
+            printf("The given test session context is expected to generate %d vector sets.\n", diff);
+            print_estimate(ctx, cfg.calibrate ? cfg.calibrate_file : NULL, cfg.vs_workers);
         }
         goto end;
     }
@@ -401,6 +627,10 @@ int main(int argc, char **argv) {
     amvp_run(ctx, cfg.fips_validation);
 
 end:
+    if (cfg.perf_stats && ctx) {
+        print_perf_stats(ctx);
+        print_mem_stats(ctx);
+    }
     /*
      * Free all memory associated with
      * both the application and libamvp.
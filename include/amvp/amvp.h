@@ -31,6 +31,39 @@ extern "C"
 #define AMVP_DES_MCT_INNER      10000
 #define AMVP_DES_MCT_OUTER      400
 
+/*
+ * Maximum number of test cases handed to a batch crypto handler in a
+ * single call. See amvp_cap_set_batch_handler().
+ */
+#define AMVP_BATCH_TC_MAX       16
+
+/*
+ * Maximum number of vector sets processed concurrently. See amvp_set_vs_workers().
+ */
+#define AMVP_VS_WORKERS_MAX 32
+
+/*
+ * Limits for the siggen key pre-generation pool. See amvp_set_key_pregen().
+ */
+#define AMVP_KEY_PREGEN_THREADS_MAX 16
+#define AMVP_KEY_PREGEN_DEPTH_MAX   32
+
+/*
+ * Highest compression level for .gz and .zst files. See amvp_set_file_compression_level().
+ */
+#define AMVP_FILE_COMPRESSION_LEVEL_MAX 19
+
+/*
+ * Maximum number of messages queued by the asynchronous log sink. See amvp_set_log_async().
+ */
+#define AMVP_LOG_ASYNC_SLOTS_MAX 4096
+
+/*
+ * Maximum number of slowest test cases kept per vector set and per algorithm. See
+ * amvp_set_slow_tc_capture().
+ */
+#define AMVP_SLOW_TC_MAX 16
+
 /**
  * @enum AMVP_LOG_LVL
  * @brief This enum defines the different log levels for
@@ -1105,7 +1138,8 @@ typedef struct amvp_sym_cipher_tc_t {
     unsigned int ct_len;
     unsigned int tag_len;
     unsigned int salt_len;
-    unsigned int mct_index;  /**< used to identify init vs. update */
+    unsigned int mct_index;  /**< used to identify init vs. update. When a native MCT handler is
+                                  registered, this is the outer iteration being processed */
     unsigned int incr_ctr;
     unsigned int ovrflw_ctr;
     unsigned int keyingOption; /**< For some TDES, indicates keyingOption. 
@@ -1145,6 +1179,10 @@ typedef struct amvp_hash_tc_t {
                             SUPPLIED BY USER */
     unsigned int md_len; /**< The length (in bytes) of \ref AMVP_HASH_TC.md
                               SUPPLIED BY USER */
+    unsigned int xof_min_bit_len; /**< Minimum XOF length (in bits) of the SHAKE MCT output
+                                       Only provided to a native MCT handler for SHAKE */
+    unsigned int xof_max_bit_len; /**< Maximum XOF length (in bits) of the SHAKE MCT output
+                                       Only provided to a native MCT handler for SHAKE */
 } AMVP_HASH_TC;
 
 /**
@@ -1774,6 +1812,7 @@ typedef enum amvp_kas_ecc_test_type {
  */
 typedef struct amvp_kas_ecc_tc_t {
     AMVP_CIPHER cipher;
+    unsigned int tc_id;    /**< Test case id */
     AMVP_KAS_ECC_FUNC func;
     AMVP_KAS_ECC_TEST_TYPE test_type;
     AMVP_KAS_ECC_MODE mode;
@@ -1876,6 +1915,7 @@ typedef enum amvp_kas_ffc_test_type {
 
 typedef struct amvp_kas_ffc_tc_t {
     AMVP_CIPHER cipher;
+    unsigned int tc_id;    /**< Test case id */
     AMVP_KAS_FFC_TEST_TYPE test_type;
     AMVP_HASH_ALG md;
     AMVP_KAS_FFC_MODE mode;
@@ -1984,6 +2024,7 @@ typedef enum amvp_kas_ifc_test_type {
  */
 typedef struct amvp_kas_ifc_tc_t {
     AMVP_CIPHER cipher;
+    unsigned int tc_id;    /**< Test case id */
     AMVP_KAS_IFC_TEST_TYPE test_type;
     AMVP_KAS_IFC_KEYGEN key_gen;
     AMVP_HASH_ALG md;
@@ -2281,6 +2322,7 @@ typedef enum amvp_kts_ifc_test_type {
  */
 typedef struct amvp_kts_ifc_tc_t {
     AMVP_CIPHER cipher;
+    unsigned int tc_id;    /**< Test case id */
     AMVP_KTS_IFC_TEST_TYPE test_type;
     AMVP_KTS_IFC_KEYGEN key_gen;
     AMVP_HASH_ALG md;
@@ -2343,6 +2385,46 @@ typedef struct amvp_drbg_tc_t {
     unsigned int drb_len;              /**< Expected drb length (in bytes) */
 } AMVP_DRBG_TC;
 
+/**
+ * @struct AMVP_TEST_GROUP
+ * @brief This struct holds the parameters shared by all test cases of a test group. It is passed
+ *        to the optional group_begin and group_end callbacks of a capability, see
+ *        amvp_cap_set_group_handlers(), and is referenced by every test case of the group. Fields
+ *        that do not apply to the algorithm being tested are left as 0.
+ */
+typedef struct amvp_test_group_t {
+    AMVP_CIPHER cipher;
+    unsigned int tg_id;           /**< Test group id */
+    const char *test_type;        /**< Test type as sent by the server, e.g. "AFT" or "MCT" */
+    AMVP_SYM_CIPH_DIR direction;  /**< Symmetric cipher direction */
+    unsigned int key_len;         /**< Key length (in bits) for symmetric ciphers, HMAC and CMAC */
+    unsigned int iv_len;          /**< IV length (in bits) for symmetric ciphers */
+    unsigned int tag_len;         /**< Tag length (in bits) for AEAD ciphers */
+    unsigned int aad_len;         /**< AAD length (in bits) for AEAD ciphers */
+    unsigned int payload_len;     /**< Payload length (in bits) for symmetric ciphers */
+    unsigned int msg_len;         /**< Message length (in bits) for HMAC and CMAC */
+    unsigned int mac_len;         /**< MAC length (in bits) for HMAC and CMAC */
+    unsigned int modulo;          /**< RSA modulus size (in bits) */
+    AMVP_HASH_ALG hash_alg;       /**< Hash algorithm for RSA, ECDSA and DSA */
+    AMVP_EC_CURVE curve;          /**< ECDSA curve */
+    unsigned int l;               /**< DSA L (in bits) */
+    unsigned int n;               /**< DSA N (in bits) */
+    AMVP_DRBG_MODE drbg_mode;     /**< DRBG mode */
+    int pred_resist;              /**< DRBG prediction resistance enabled */
+    int reseed;                   /**< DRBG reseed enabled */
+    int der_func;                 /**< DRBG derivation function enabled */
+    unsigned int entropy_len;     /**< DRBG entropy input length (in bits) */
+    unsigned int nonce_len;       /**< DRBG nonce length (in bits) */
+    unsigned int perso_string_len;      /**< DRBG personalization string length (in bits) */
+    unsigned int additional_input_len;  /**< DRBG additional input length (in bits) */
+    unsigned int drb_len;         /**< DRBG returned bits length (in bits) */
+    void *user_data; /**< Opaque pointer for the application. May be set by group_begin, it is
+                          available to every test case of the group and to group_end */
+    void *key;       /**< Key pair for RSA, ECDSA and DSA SigGen groups when a key_gen handler is
+                          registered, see amvp_cap_set_key_pregen_handler(). libamvp releases it
+                          with key_free after group_end unless the application sets it to NULL */
+} AMVP_TEST_GROUP;
+
 /**
  * @struct AMVP_TEST_CASE
  * @brief This is the abstracted test case representation used for passing test case data to/from
@@ -2383,8 +2465,141 @@ typedef struct amvp_test_case_t {
         AMVP_KTS_IFC_TC *kts_ifc;
         AMVP_SAFE_PRIMES_TC *safe_primes;
     } tc; /**< the union abstracting the test case for passing to the user application */
+    AMVP_TEST_GROUP *group; /**< the test group this test case belongs to. Only provided for
+                                 capabilities that support group callbacks, NULL otherwise */
 } AMVP_TEST_CASE;
 
+/**
+ * @struct AMVP_PERF_COUNTERS
+ * @brief Where the time of a test session went, for one algorithm or in total. Times are in
+ *        nanoseconds of a monotonic clock. See amvp_get_perf_stats().
+ */
+typedef struct amvp_perf_counters_t {
+    const char *name;                 /**< algorithm name, NULL if nothing was recorded */
+    const char *mode;                 /**< algorithm mode, NULL if the algorithm has none */
+    unsigned long long vs_count;      /**< vector sets processed */
+    unsigned long long tc_count;      /**< test cases handed to the crypto module */
+    unsigned long long parse_ns;      /**< parsing vector set JSON */
+    unsigned long long decode_ns;     /**< reading test cases, hex decoding and building responses */
+    unsigned long long crypto_ns;     /**< in the crypto module's handlers */
+    unsigned long long serialize_ns;  /**< serializing responses */
+    unsigned long long network_ns;    /**< waiting on HTTP requests */
+    unsigned long long bytes_in;      /**< bytes received from the server */
+    unsigned long long bytes_out;     /**< bytes sent to the server */
+} AMVP_PERF_COUNTERS;
+
+/**
+ * @struct AMVP_PERF_STATS
+ * @brief Profiling counters of a test session, per AMVP_CIPHER and in total. alg[AMVP_CIPHER_START]
+ *        holds the work that does not belong to a single vector set, such as login, registration,
+ *        result polling and, with vector set workers, offline file reading and writing.
+ */
+typedef struct amvp_perf_stats_t {
+    AMVP_PERF_COUNTERS alg[AMVP_CIPHER_END];
+    AMVP_PERF_COUNTERS total;
+} AMVP_PERF_STATS;
+
+/**
+ * @enum AMVP_MEM_TAG
+ * @brief The subsystems whose heap use is accounted, see amvp_get_mem_stats()
+ */
+typedef enum amvp_mem_tag {
+    AMVP_MEM_JSON = 0,      /**< JSON values and serialized JSON strings */
+    AMVP_MEM_TC,            /**< test case buffers of the algorithm handlers */
+    AMVP_MEM_TRANSPORT,     /**< HTTP receive buffers */
+    AMVP_MEM_CAPS,          /**< capability structures */
+    AMVP_MEM_TAG_MAX
+} AMVP_MEM_TAG;
+
+/**
+ * @struct AMVP_MEM_COUNTERS
+ * @brief Heap use of one subsystem, in bytes as reported by the C library allocator
+ */
+typedef struct amvp_mem_counters_t {
+    unsigned long long current;       /**< allocated now */
+    unsigned long long peak;          /**< high-water mark of current */
+    unsigned long long allocs;        /**< number of allocations */
+} AMVP_MEM_COUNTERS;
+
+/**
+ * @struct AMVP_MEM_STATS
+ * @brief Heap accounting per AMVP_MEM_TAG. tag[] and total are kept for the whole process,
+ *        the peak_vs fields hold the high-water marks of the vector set of this test session
+ *        that needed the most memory while it was processed.
+ */
+typedef struct amvp_mem_stats_t {
+    AMVP_MEM_COUNTERS tag[AMVP_MEM_TAG_MAX];
+    AMVP_MEM_COUNTERS total;
+    int vs_count;                                   /**< vector sets processed */
+    int peak_vs_id;                                 /**< vsId of the vector set that needed the most */
+    unsigned long long peak_vs[AMVP_MEM_TAG_MAX];   /**< high-water marks of that vector set */
+    unsigned long long peak_vs_total;
+} AMVP_MEM_STATS;
+
+/**
+ * @struct AMVP_SLOW_TC
+ * @brief A test case that kept the crypto module's handler busy for long, see
+ *        amvp_set_slow_tc_capture()
+ */
+typedef struct amvp_slow_tc_t {
+    int vs_id;
+    int tg_id;
+    int tc_id;                        /**< 0 for test cases that have no tcId */
+    unsigned long long ns;            /**< time in the crypto module's handler */
+} AMVP_SLOW_TC;
+
+/**
+ * @struct AMVP_LATENCY_STATS
+ * @brief Distribution of the time the crypto module's handler took per test case, see
+ *        amvp_get_latency_stats(). Percentiles are taken from a log-linear histogram and are
+ *        within 1/16 of the exact value. Test cases handed to a batch_handler are counted with
+ *        the average time of their batch.
+ */
+typedef struct amvp_latency_stats_t {
+    unsigned long long count;         /**< test cases handed to the crypto module */
+    unsigned long long min_ns;
+    unsigned long long mean_ns;
+    unsigned long long p50_ns;
+    unsigned long long p90_ns;
+    unsigned long long p99_ns;
+    unsigned long long p999_ns;
+    unsigned long long max_ns;
+    int slow_count;                   /**< entries of slow[] in use */
+    AMVP_SLOW_TC slow[AMVP_SLOW_TC_MAX]; /**< slowest test cases of the session, slowest first */
+} AMVP_LATENCY_STATS;
+
+/**
+ * @struct AMVP_ALG_ESTIMATE
+ * @brief What the vector sets of one algorithm, or of the whole session, are predicted to cost,
+ *        see amvp_estimate_session(). Times are CPU time of a single thread.
+ */
+typedef struct amvp_alg_estimate_t {
+    const char *name;                 /**< algorithm name, NULL if the algorithm is not registered */
+    const char *mode;                 /**< algorithm mode, NULL if the algorithm has none */
+    int calibrated;                   /**< 1 if the times were measured by a calibration run */
+    int vs_count;                     /**< vector sets */
+    unsigned long long tg_count;      /**< test groups */
+    unsigned long long tc_count;      /**< test cases */
+    unsigned long long crypto_calls;  /**< crypto operations, every iteration of an MCT counts */
+    unsigned long long crypto_ns;     /**< in the crypto module's handlers */
+    unsigned long long cpu_ns;        /**< crypto_ns plus parsing, decoding and serializing */
+    unsigned long long vs_max_ns;     /**< cpu_ns of the most expensive vector set */
+    unsigned long long bytes_in;      /**< vector sets downloaded from the server */
+    unsigned long long bytes_out;     /**< responses uploaded to the server */
+    unsigned long long mem_peak;      /**< heap high-water mark of the largest vector set */
+} AMVP_ALG_ESTIMATE;
+
+/**
+ * @struct AMVP_SESSION_ESTIMATE
+ * @brief Predicted cost of a test session, per AMVP_CIPHER and in total. In total, vs_max_ns
+ *        and mem_peak are the highest of any algorithm: with vector set workers the session
+ *        takes at least vs_max_ns, and every worker can need mem_peak at once.
+ */
+typedef struct amvp_session_estimate_t {
+    AMVP_ALG_ESTIMATE alg[AMVP_CIPHER_END];
+    AMVP_ALG_ESTIMATE total;
+} AMVP_SESSION_ESTIMATE;
+
 
 
 /** @defgroup APIs Public APIs for libamvp
@@ -3453,6 +3668,115 @@ AMVP_RESULT amvp_cap_kmac_set_domain(AMVP_CTX *ctx,
                                      int max,
                                      int increment);
 
+/**
+ * @brief amvp_cap_set_batch_handler() allows an application to register an optional batch
+ *        callback for a capability that was previously enabled. This is intended for crypto
+ *        modules with multi-buffer implementations that are faster when given several
+ *        independent inputs at once.
+ *
+ *        When a batch handler is registered, libamvp collects up to AMVP_BATCH_TC_MAX test
+ *        cases of the same test group and passes them to the batch handler in a single call.
+ *        Monte Carlo tests are always processed one test case at a time using the crypto_handler
+ *        given when the capability was enabled. Batch handlers are supported for the symmetric
+ *        cipher, hash, HMAC, CMAC and KMAC capabilities.
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param cipher AMVP_CIPHER enum value identifying the crypto capability.
+ * @param batch_handler Address of function implemented by application that is invoked by libamvp
+ *        with an array of \p count test cases. The handler sets \p results[i] to the value the
+ *        crypto_handler would have returned for test_cases[i]. The batch_handler function is
+ *        expected to return 0 if it was able to process the batch and 1 for failure.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_cap_set_batch_handler(AMVP_CTX *ctx,
+                                       AMVP_CIPHER cipher,
+                                       int (*batch_handler)(AMVP_TEST_CASE *test_cases,
+                                                            int *results,
+                                                            int count));
+
+/**
+ * @brief amvp_cap_set_mct_handler() allows an application to register an optional native Monte
+ *        Carlo Test (MCT) callback for a capability that was previously enabled. By default
+ *        libamvp runs the MCT inner loop itself and calls the crypto_handler once per inner
+ *        iteration. A native MCT handler is instead called once per outer iteration and runs
+ *        the inner loop inside the crypto module.
+ *
+ *        For hash algorithms (SHA-1, SHA-2, SHA-3 and SHAKE) the handler receives the seed for
+ *        the outer iteration in msg and must return the final digest of the inner loop in md.
+ *        For SHAKE it must also leave the output length of the next outer iteration in xof_len,
+ *        computed from xof_min_bit_len and xof_max_bit_len. libamvp feeds the digest back as the
+ *        next seed.
+ *
+ *        For AES and TDES the handler receives the key, iv and input text of the outer iteration
+ *        (mct_index is the outer iteration). It must return the final result of the inner loop in
+ *        ct (encrypt) or pt (decrypt) and leave the key, iv and input text for the next outer
+ *        iteration in the test case, as defined by the MCT specification of the mode.
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param cipher AMVP_CIPHER enum value identifying the crypto capability.
+ * @param mct_handler Address of function implemented by application that is invoked by libamvp
+ *        for each outer MCT iteration. This mct_handler function is expected to return 0 on
+ *        success and 1 for failure.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_cap_set_mct_handler(AMVP_CTX *ctx,
+                                     AMVP_CIPHER cipher,
+                                     int (*mct_handler)(AMVP_TEST_CASE *test_case));
+
+/**
+ * @brief amvp_cap_set_group_handlers() allows an application to register optional callbacks that
+ *        are invoked when libamvp starts and finishes processing a test group of a capability that
+ *        was previously enabled. This lets the crypto module set up per-group state once, such as
+ *        cipher or digest contexts, signing keys or DRBG parameters, instead of for every test case.
+ *
+ *        group_begin receives the parsed group parameters before the first test case of the group
+ *        and may store a pointer in AMVP_TEST_GROUP.user_data. Each test case of the group refers to
+ *        the group through AMVP_TEST_CASE.group. group_end is invoked after the last test case, and
+ *        also when processing of the group is aborted, so that the application can release its
+ *        state. Group callbacks are supported for the symmetric cipher, hash, HMAC, CMAC, KMAC, DRBG,
+ *        RSA signature, ECDSA and DSA SigGen capabilities.
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param cipher AMVP_CIPHER enum value identifying the crypto capability.
+ * @param group_begin Address of function invoked at the start of each test group, or NULL.
+ * @param group_end Address of function invoked at the end of each test group, or NULL.
+ *        Both functions are expected to return 0 on success and 1 for failure.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_cap_set_group_handlers(AMVP_CTX *ctx,
+                                        AMVP_CIPHER cipher,
+                                        int (*group_begin)(AMVP_TEST_GROUP *group),
+                                        int (*group_end)(AMVP_TEST_GROUP *group));
+
+/**
+ * @brief amvp_cap_set_key_pregen_handler() allows an application to hand key pair generation for
+ *        the RSA, ECDSA and DSA SigGen capabilities over to libamvp. Every SigGen test group needs
+ *        a fresh key pair; with a key_gen handler registered libamvp obtains that key before the
+ *        group starts and passes it to the crypto module in AMVP_TEST_GROUP.key, where the
+ *        crypto_handler of each test case can find it through AMVP_TEST_CASE.group.
+ *
+ *        key_gen receives an AMVP_TEST_GROUP with cipher and the key parameters (modulo, curve, or
+ *        l and n) filled in, and must store the generated key pair in key. When background key
+ *        generation is enabled with amvp_set_key_pregen() key_gen is called from worker threads,
+ *        before the test groups are known, and must therefore be thread safe. key_free is used to
+ *        release keys that were generated but not consumed by a test group.
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param cipher AMVP_RSA_SIGGEN, AMVP_ECDSA_SIGGEN or AMVP_DSA_SIGGEN.
+ * @param key_gen Address of function that generates a key pair. It is expected to return 0 on
+ *        success and 1 for failure.
+ * @param key_free Address of function that releases a key pair created by key_gen.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_cap_set_key_pregen_handler(AMVP_CTX *ctx,
+                                            AMVP_CIPHER cipher,
+                                            int (*key_gen)(AMVP_TEST_GROUP *group),
+                                            void (*key_free)(void *key));
+
 
 /**
  * @brief amvp_cap_kdf135_*_enable() allows an application to specify a kdf cipher capability to be
@@ -4169,6 +4493,30 @@ AMVP_RESULT amvp_mark_as_put_after_test(AMVP_CTX *ctx, char *filename);
  */
 int amvp_get_vector_set_count(AMVP_CTX *ctx);
 
+/**
+ * @brief amvp_estimate_session() predicts the test cases, CPU time, download and upload volume
+ *        and memory peak of a test session from the capabilities registered so far, before
+ *        amvp_register() is called. The number of test groups and test cases follows a model of
+ *        the vector sets the server generates for each algorithm, with MCT iteration counts and
+ *        RSA modulus sizes taken into account; like amvp_get_vector_set_count() it is an
+ *        estimate, servers can differ.
+ *
+ *        Without a calibration file, the time of a crypto operation and the size of a test case
+ *        are typical values for a software module. With one, its vector sets are run through
+ *        the registered handlers first, and the time per crypto operation, the time the library
+ *        spends per test case, the JSON sizes and the memory use measured for each algorithm
+ *        replace the typical values. The calibration run does not count in the profiling
+ *        counters or latency histograms of the session.
+ *
+ * @param ctx Pointer to AMVP_CTX with registered algorithms
+ * @param calibration_file Vector sets in the format saved with amvp_mark_as_request_only() or of
+ *        a KAT file, such as written by test/gen_vectors; NULL for no calibration run
+ * @param est Filled with the estimate, per algorithm and in total
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_estimate_session(AMVP_CTX *ctx, const char *calibration_file, AMVP_SESSION_ESTIMATE *est);
+
 /**
  * @brief Performs the AMVP testing procedures.
  *        This function will do the following actions:
@@ -4264,6 +4612,12 @@ AMVP_RESULT amvp_upload_vectors_from_file(AMVP_CTX *ctx, const char *rsp_filenam
  * @brief Runs a set of tests from vector sets that were saved to a file and saves the results in a
  *        different file.
  *
+ *        Results are written to rsp_filename.tmp and journaled in rsp_filename.journal as each
+ *        vector set completes, and the file is moved to rsp_filename once all of them are done.
+ *        If the process dies before the run completes, calling this again with the same
+ *        (unmodified) request file and response file name skips the vector sets that were already
+ *        completed. A run that returns an error removes both files, so the next one starts over.
+ *
  * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
  * @param req_filename Name of the file that contains the unprocessed vector sets
  * @param rsp_filename Name of the file to save vector set test results to
@@ -4304,10 +4658,31 @@ AMVP_RESULT amvp_get_results_from_server(AMVP_CTX *ctx, const char *request_file
  */
 AMVP_RESULT amvp_get_expected_results(AMVP_CTX *ctx, const char *request_filename, const char *save_filename);
 
+/**
+ * @brief Compares a vector set response file with the expected results saved by
+ *        amvp_get_expected_results(), without contacting the server.
+ *
+ *        Test cases are matched on (vsId, tgId, tcId) and every field of an expected test case is
+ *        compared with the response. Each mismatched field, test case without a response and
+ *        response without an expected result is logged.
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param rsp_filename File containing the vector set responses, as written by
+ *        amvp_run_vectors_from_file()
+ * @param expected_filename File containing the expected results
+ * @param mismatch_cnt Set to the number of mismatches found
+ *
+ * @return AMVP_RESULT; AMVP_SUCCESS means the files were compared, not that they match
+ */
+AMVP_RESULT amvp_verify_expected_results(AMVP_CTX *ctx, const char *rsp_filename,
+                                         const char *expected_filename, int *mismatch_cnt);
+
 /**
  * @brief Queries the server for any vector sets that have not received a response (e.x. in case of
  *        lose of connectivity during testing), downloads those vector sets, and continues to
- *        process them
+ *        process them. Only the vector sets without a response are processed, on the number of
+ *        workers set with amvp_set_vs_workers(). Vector sets that were already submitted but are
+ *        not graded yet are watched in the background while the others are processed.
  *
  * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
  * @param request_filename File containing the session info created by libamvp
@@ -4341,6 +4716,177 @@ AMVP_RESULT amvp_cancel_test_session(AMVP_CTX *ctx, const char *request_filename
  */
 AMVP_RESULT amvp_set_2fa_callback(AMVP_CTX *ctx, AMVP_RESULT (*totp_cb)(char **token, int token_max));
 
+/**
+ * @brief amvp_set_key_pregen() enables background generation of SigGen key pairs. Right after
+ *        registration libamvp starts the given number of worker threads, which call the key_gen
+ *        handler of each capability set with amvp_cap_set_key_pregen_handler() for every registered
+ *        modulus, curve or L/N pair, while the vector sets are still being downloaded. Test groups
+ *        then draw their key from this pool; when none is ready the key is generated on demand.
+ *        Background generation is not available on Windows, where keys are always generated on
+ *        demand.
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param threads Number of worker threads, 0 to generate keys on demand only.
+ *        Max is AMVP_KEY_PREGEN_THREADS_MAX.
+ * @param depth Number of keys kept ready per key parameter set, 1 to AMVP_KEY_PREGEN_DEPTH_MAX.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_set_key_pregen(AMVP_CTX *ctx, int threads, int depth);
+
+/**
+ * @brief amvp_set_log_async() hands log messages to the progress callback from a background
+ *        thread, so that processing test cases never waits on the application's output. Messages
+ *        are queued in a ring of the given number of slots. When the ring is full, info and
+ *        verbose messages are dropped and a count of them is logged; other messages wait for a
+ *        free slot. Queued messages are delivered before amvp_free_test_session() returns.
+ *        This should be called before amvp_run(). Not available on Windows, where messages are
+ *        always logged synchronously.
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param slots Number of messages that can be queued, 0 to log synchronously.
+ *        Max is AMVP_LOG_ASYNC_SLOTS_MAX.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_set_log_async(AMVP_CTX *ctx, int slots);
+
+/**
+ * @brief amvp_get_perf_stats() copies the profiling counters gathered so far in this test
+ *        session. The counters are always collected; every test case costs two reads of a
+ *        monotonic clock.
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param stats Filled with the counters, per algorithm and in total
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_get_perf_stats(AMVP_CTX *ctx, AMVP_PERF_STATS *stats);
+
+/**
+ * @brief amvp_get_mem_stats() copies the heap accounting of the JSON parser, the test case
+ *        buffers, the transport buffers and the capability structures: what each holds now and
+ *        its high-water mark, and the high-water marks of the vector set that needed the most
+ *        memory. The high-water marks of every vector set are also logged when it is done. The
+ *        accounting is always on; sizes come from the C library allocator, where it can not
+ *        tell the size of a block the counters stay at zero.
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param stats Filled with the counters, per subsystem and in total
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_get_mem_stats(AMVP_CTX *ctx, AMVP_MEM_STATS *stats);
+
+/**
+ * @brief amvp_get_latency_stats() copies the distribution of the time the crypto module's handler
+ *        took per test case of one algorithm, or of all of them. The histograms are always kept;
+ *        the slowest test cases only with amvp_set_slow_tc_capture().
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param cipher Algorithm to report, AMVP_CIPHER_START for all algorithms together
+ * @param stats Filled with the percentiles and the slowest test cases
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_get_latency_stats(AMVP_CTX *ctx, AMVP_CIPHER cipher, AMVP_LATENCY_STATS *stats);
+
+/**
+ * @brief amvp_set_slow_tc_capture() keeps the tgId and tcId of the slowest test cases. When a
+ *        vector set is done its slowest test cases are logged, and the slowest of the session
+ *        are kept per algorithm for amvp_get_latency_stats(). This should be called before
+ *        amvp_run().
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param count Number of test cases to keep, 0 to keep none. Max is AMVP_SLOW_TC_MAX.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_set_slow_tc_capture(AMVP_CTX *ctx, int count);
+
+/**
+ * @brief amvp_set_trace_file() writes a timeline of the test session to a file in the Chrome
+ *        trace event format, which can be loaded in chrome://tracing or https://ui.perfetto.dev.
+ *        It has a span for login, registration, the download, retry waits, processing and upload
+ *        of each vector set, each test group and each poll for results. Every worker thread of
+ *        amvp_set_vs_workers() gets a track of its own. The file is completed by
+ *        amvp_free_test_session(). This should be called before amvp_run().
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param path Name of the trace file, which is overwritten. NULL stops tracing.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_set_trace_file(AMVP_CTX *ctx, const char *path);
+
+/**
+ * @brief amvp_set_transport_record() records every HTTP exchange of the test session with the
+ *        server to a file, one JSON object per line holding the method, URL, request headers
+ *        and body, HTTP status, response headers and body, and when the request was sent and
+ *        how long the server took to answer. The Authorization header and the access tokens
+ *        and passwords in the bodies are redacted. A filename ending in .gz or .zst is
+ *        compressed. The file is completed by amvp_free_test_session(). This should be called
+ *        before amvp_run().
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param path Name of the recording, which is overwritten. NULL stops recording.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_set_transport_record(AMVP_CTX *ctx, const char *path);
+
+/**
+ * @brief amvp_set_transport_replay() answers the HTTP requests of the test session from a file
+ *        written by amvp_set_transport_record() instead of sending them to the server, so that
+ *        a session can be repeated without a network. A request is answered by the first
+ *        unused exchange recorded for the same method and URL path; once those are used up the
+ *        last one is repeated, and a request that was never recorded fails like a lost
+ *        connection. This should be called before amvp_run().
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param path Name of the recording. NULL stops replaying.
+ * @param realtime 1 to delay every answer by the time the server took in the recorded session
+ *        and wait out the retry periods the server asked for; the client's own time between
+ *        requests is not reproduced. 0 to answer as fast as possible without waiting.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_set_transport_replay(AMVP_CTX *ctx, const char *path, int realtime);
+
+/**
+ * @brief amvp_set_vs_workers() sets the number of vector sets that amvp_process_tests() downloads,
+ *        processes and submits concurrently. Each worker thread processes one vector set at a
+ *        time with its own transport buffer and JSON response tree, and log messages of a worker
+ *        are prefixed with the vsId being processed. The crypto_handler callbacks of the
+ *        application are then invoked from several threads at once and must be thread safe.
+ *        amvp_run_vectors_from_file() uses the same number of workers to process the vector
+ *        sets of a request file, and writes the responses in the order of the request file.
+ *        amvp_upload_vectors_from_file() keeps up to this many vector set uploads in flight.
+ *        Concurrent processing is not used when vector sets are saved to a file, and is not
+ *        available on Windows.
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param workers Number of worker threads, 1 (the default) processes vector sets one at a time.
+ *        Max is AMVP_VS_WORKERS_MAX.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_set_vs_workers(AMVP_CTX *ctx, int workers);
+
+/**
+ * @brief amvp_set_file_compression_level() sets the compression level used when the library
+ *        writes a file whose name ends in .gz (gzip) or .zst (zstd), such as the vector set request
+ *        file or the offline response file. Compressed files are read transparently whatever
+ *        their name. gzip and zstd support depends on the library being built with zlib and zstd.
+ *
+ * @param ctx Pointer to AMVP_CTX that was previously created by calling amvp_create_test_session.
+ * @param level 0 (the default) for the default level of the compressor, otherwise 1 to
+ *        AMVP_FILE_COMPRESSION_LEVEL_MAX. gzip uses at most level 9.
+ *
+ * @return AMVP_RESULT
+ */
+AMVP_RESULT amvp_set_file_compression_level(AMVP_CTX *ctx, int level);
+
 /**
  * @brief amvp_bin_to_hexstr() Converts a binary string to hex
  *
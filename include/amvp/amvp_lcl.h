@@ -17,39 +17,56 @@
 #define AMVP_LIBRARY_VERSION    "libamvp_oss-0.1.0"
 
 
+/*
+ * The log macros test the level before any of their arguments are evaluated.
+ * Levels more verbose than AMVP_LOG_LVL_COMPILED (configure --with-log-level)
+ * are compiled out entirely.
+ */
+#ifndef AMVP_LOG_LVL_COMPILED
+#define AMVP_LOG_LVL_COMPILED AMVP_LOG_LVL_DEBUG
+#endif
+
+#define AMVP_LOG_ON(lvl) ((lvl) <= AMVP_LOG_LVL_COMPILED && ctx && ctx->log_lvl >= (lvl))
+
 #ifndef AMVP_LOG_ERR
 #define AMVP_LOG_ERR(msg, ...) do { \
-        amvp_log_msg(ctx, AMVP_LOG_LVL_ERR, __func__, __LINE__, msg, ##__VA_ARGS__); \
+        if (AMVP_LOG_ON(AMVP_LOG_LVL_ERR)) \
+            amvp_log_msg(ctx, AMVP_LOG_LVL_ERR, __func__, __LINE__, msg, ##__VA_ARGS__); \
 } while (0)
 #endif
 
 #ifndef AMVP_LOG_WARN
 #define AMVP_LOG_WARN(msg, ...) do { \
-        amvp_log_msg(ctx, AMVP_LOG_LVL_WARN, __func__, __LINE__, msg, ##__VA_ARGS__); \
+        if (AMVP_LOG_ON(AMVP_LOG_LVL_WARN)) \
+            amvp_log_msg(ctx, AMVP_LOG_LVL_WARN, __func__, __LINE__, msg, ##__VA_ARGS__); \
 } while (0)
 #endif
 
 #ifndef AMVP_LOG_STATUS
 #define AMVP_LOG_STATUS(msg, ...)  do { \
-        amvp_log_msg(ctx, AMVP_LOG_LVL_STATUS, __func__, __LINE__, msg, ##__VA_ARGS__); \
+        if (AMVP_LOG_ON(AMVP_LOG_LVL_STATUS)) \
+            amvp_log_msg(ctx, AMVP_LOG_LVL_STATUS, __func__, __LINE__, msg, ##__VA_ARGS__); \
 } while (0)
 #endif
 
 #ifndef AMVP_LOG_INFO
 #define AMVP_LOG_INFO(msg, ...) do { \
-        amvp_log_msg(ctx, AMVP_LOG_LVL_INFO, __func__, __LINE__, msg, ##__VA_ARGS__); \
+        if (AMVP_LOG_ON(AMVP_LOG_LVL_INFO)) \
+            amvp_log_msg(ctx, AMVP_LOG_LVL_INFO, __func__, __LINE__, msg, ##__VA_ARGS__); \
 } while (0)
 #endif
 
 #ifndef AMVP_LOG_VERBOSE
 #define AMVP_LOG_VERBOSE(msg, ...) do { \
-        amvp_log_msg(ctx, AMVP_LOG_LVL_VERBOSE, __func__, __LINE__, msg, ##__VA_ARGS__); \
+        if (AMVP_LOG_ON(AMVP_LOG_LVL_VERBOSE)) \
+            amvp_log_msg(ctx, AMVP_LOG_LVL_VERBOSE, __func__, __LINE__, msg, ##__VA_ARGS__); \
 } while (0)
 #endif
 
 #ifndef AMVP_LOG_NEWLINE
 #define AMVP_LOG_NEWLINE do { \
-        amvp_log_newline(ctx); \
+        if (AMVP_LOG_ON(AMVP_LOG_LVL_STATUS)) \
+            amvp_log_newline(ctx); \
 } while (0)
 #endif
 
@@ -58,8 +75,55 @@
 #define AMVP_LOG_TRUNCATED_STR_LEN 14
 #define AMVP_LOG_MAX_MSG_LEN 2048
 
+/*
+ * Linux USDT probes of the provider "libamvp", for bpftrace, perf or
+ * SystemTap. They are compiled in with configure --enable-usdt, otherwise
+ * they expand to nothing and their arguments are not evaluated.
+ *
+ *   login_start(refresh)               login_done(refresh, rv, bytes_out, bytes_in)
+ *   registration_start()               registration_done(rv, bytes_out, bytes_in)
+ *   download_start(vs_id)              download_done(vs_id, rv, bytes_in)
+ *   retry_wait(situation, seconds)     1 waiting for vector sets, 2 for results
+ *   dispatch_start(vs_id, cipher)      dispatch_done(vs_id, cipher, rv)
+ *   group_start(vs_id, tg_id)          group_done(vs_id, tg_id)
+ *   tc_start(vs_id, tg_id, tc_id)      tc_done(vs_id, tg_id, tc_id, rc)
+ *   batch_start(vs_id, tg_id, count)   batch_done(vs_id, tg_id, count, rc)
+ *   serialize(vs_id, bytes)            responses serialized for upload
+ *   upload_start(vs_id)                upload_done(vs_id, rv, bytes_out)
+ *
+ * tc_start and tc_done surround every crypto_handler and mct_handler call,
+ * batch_start and batch_done every batch_handler call. rv is an AMVP_RESULT,
+ * rc what the crypto module's handler returned. The vs_id of the download
+ * probes is taken from the vector set URL; upload_done counts all bytes sent
+ * for the vector set.
+ */
+#ifdef AMVP_USDT
+#include <sys/sdt.h>
+#define AMVP_PROBE(name) STAP_PROBE(libamvp, name)
+#define AMVP_PROBE1(name, a) STAP_PROBE1(libamvp, name, a)
+#define AMVP_PROBE2(name, a, b) STAP_PROBE2(libamvp, name, a, b)
+#define AMVP_PROBE3(name, a, b, c) STAP_PROBE3(libamvp, name, a, b, c)
+#define AMVP_PROBE4(name, a, b, c, d) STAP_PROBE4(libamvp, name, a, b, c, d)
+#else
+#define AMVP_PROBE(name)
+#define AMVP_PROBE1(name, a)
+#define AMVP_PROBE2(name, a, b)
+#define AMVP_PROBE3(name, a, b, c)
+#define AMVP_PROBE4(name, a, b, c, d)
+#endif
+
 #define AMVP_BIT2BYTE(x) ((x + 7) >> 3) /**< Convert bit length (x, of type integer) into byte length */
 
+/*
+ * Scratch buffers that live at file scope must be per thread, vector sets
+ * can be processed concurrently (see amvp_set_vs_workers())
+ */
+#ifdef _WIN32
+#define AMVP_THREAD_LOCAL __declspec(thread)
+#else
+#define AMVP_THREAD_LOCAL __thread
+#endif
+
 #define AMVP_ALG_MAX AMVP_CIPHER_END - 1  /* Used by alg_tbl[] */
 
 #define AMVP_CAP_MAX AMVP_ALG_MAX * 2 /* Arbitrary limit to the number of capability objects that
@@ -863,6 +927,14 @@
 #define AMVP_MAX_WAIT_TIME      7200
 #define AMVP_RETRY_TIME         30
 #define AMVP_RETRY_MODIFIER_MAX 10
+#define AMVP_UPLOAD_RETRY_MAX   3  /* extra attempts for a vector set response that failed to post */
+#define AMVP_UPLOAD_RETRY_TIME  5  /* seconds, multiplied by the attempt number */
+#define AMVP_RESULTS_POLL_MIN   10 /* seconds between results polls when few vector sets are incomplete */
+#define AMVP_RESULTS_POLL_PER_VS 2 /* seconds added to the results poll interval per incomplete vector set */
+#define AMVP_RESULTS_POLL_MAX   120 /* seconds, cap of the interval backoff while the results are unchanged */
+#define AMVP_ETAG_MAX           128
+#define AMVP_VERIFY_BUCKETS     4096 /* hash buckets of the expected results index, power of 2 */
+#define AMVP_VERIFY_VALUE_MAX   64 /* characters of a mismatched value shown in the log */
 #define AMVP_JWT_TOKEN_MAX      2048
 #define AMVP_ATTR_URL_MAX       2083 /* MS IE's limit - arbitrary */
 
@@ -1048,6 +1120,28 @@ typedef struct amvp_string_list_t {
     struct amvp_string_list_t *next;
 } AMVP_STRING_LIST;
 
+/*
+ * Algorithm and mode of a vector set of the session, recorded when the
+ * vector set is processed so that a failure can be reported without
+ * downloading the vector set again
+ */
+typedef struct amvp_vs_meta_t {
+    int vs_id;
+    char alg[AMVP_ALG_NAME_MAX + 1];
+    char mode[AMVP_ALG_MODE_MAX + 1]; /* empty if the vector set has no mode */
+    struct amvp_vs_meta_t *next;
+} AMVP_VS_META;
+
+/*
+ * Final status of a vector set that was graded while the rest of a resumed
+ * session was being processed, see amvp_results_monitor_poll()
+ */
+typedef struct amvp_vs_graded_t {
+    int vs_id;
+    int failed;             /* the server's status was "fail" */
+    struct amvp_vs_graded_t *next;
+} AMVP_VS_GRADED;
+
 /**
  * @struct AMVP_KV_LIST
  * @brief This struct is a list of key/value pairs.
@@ -1566,10 +1660,30 @@ typedef struct amvp_caps_list_t {
     } cap;
 
     int (*crypto_handler)(AMVP_TEST_CASE *test_case);
+    int (*batch_handler)(AMVP_TEST_CASE *test_cases, int *results, int count);
+    int (*mct_handler)(AMVP_TEST_CASE *test_case);
+    int (*group_begin)(AMVP_TEST_GROUP *group);
+    int (*group_end)(AMVP_TEST_GROUP *group);
+    int (*key_gen)(AMVP_TEST_GROUP *group);
+    void (*key_free)(void *key);
 
     struct amvp_caps_list_t *next;
 } AMVP_CAPS_LIST;
 
+/*
+ * Test cases queued for a capability's batch_handler. The handler modules own
+ * the test case storage; the batch only tracks the abstracted test cases,
+ * their pending response objects and how to output/release them.
+ */
+typedef struct amvp_tc_batch_t {
+    AMVP_TEST_CASE tc[AMVP_BATCH_TC_MAX];
+    int tc_rv[AMVP_BATCH_TC_MAX];
+    JSON_Value *r_tval[AMVP_BATCH_TC_MAX];
+    int count;
+    AMVP_RESULT (*output_tc)(AMVP_CTX *ctx, AMVP_TEST_CASE *tc, JSON_Object *r_tobj, int tc_rv);
+    void (*release_tc)(AMVP_TEST_CASE *tc);
+} AMVP_TC_BATCH;
+
 typedef struct amvp_vendor_address_t {
     char *street_1;
     char *street_2;
@@ -1706,6 +1820,47 @@ typedef struct amvp_fips_t {
  * struct are transitory and used during the JSON parsing and
  * vector processing logic.
  */
+/*
+ * Log-linear histogram of crypto_handler latencies in nanoseconds, see
+ * amvp_latency.c. Every power of two is split in 1 << AMVP_LATENCY_SUB_BITS
+ * buckets, up to 1 << AMVP_LATENCY_MAG_MAX ns (about 18 minutes).
+ */
+#define AMVP_LATENCY_SUB_BITS 4
+#define AMVP_LATENCY_MAG_MAX 40
+#define AMVP_LATENCY_BUCKETS ((AMVP_LATENCY_MAG_MAX - AMVP_LATENCY_SUB_BITS + 1) << AMVP_LATENCY_SUB_BITS)
+
+typedef struct amvp_latency_t {
+    unsigned long long count;
+    unsigned long long sum_ns;
+    unsigned long long min_ns;
+    unsigned long long max_ns;
+    unsigned long long bucket[AMVP_LATENCY_BUCKETS];
+    int slow_count;
+    AMVP_SLOW_TC slow[AMVP_SLOW_TC_MAX]; /* slowest first */
+} AMVP_LATENCY;
+
+/*
+ * Per vector set work state. Every vector set being processed needs its own
+ * copy; when vector sets are processed concurrently each worker thread runs on
+ * a clone of the session AMVP_CTX with a private AMVP_VS_WORK.
+ */
+typedef struct amvp_vs_work_t {
+    int vs_id;            /* vs_id currently being processed */
+    JSON_Value *kat_resp; /* holds the current set of vector responses */
+    char *curl_buf;       /**< Data buffer for inbound Curl messages */
+    int curl_read_ctr;    /**< Total number of bytes written to the curl_buf */
+    int use_etag;         /* make the next GET conditional on etag and record the new ETag */
+    int not_modified;     /* the last conditional GET was answered with 304 Not Modified */
+    int http_code;        /* HTTP status of the last request, 0 if the server didn't answer */
+    char etag[AMVP_ETAG_MAX + 1]; /* ETag of the last results document, empty if none */
+    AMVP_CIPHER cipher;   /* algorithm of the vector set being processed */
+    AMVP_PERF_COUNTERS perf; /* counters not yet added to the session's, see amvp_perf_flush() */
+    int trace_tg_id;      /* test group whose trace span is open, see amvp_trace_group() */
+    unsigned long long trace_tg_start;
+    int tg_id;            /* test group being processed, see amvp_trace_group() */
+    AMVP_LATENCY latency; /* crypto_handler latencies not yet added to the session's */
+} AMVP_VS_WORK;
+
 struct amvp_ctx_t {
     /* Global config values for the session */
     AMVP_LOG_LVL log_lvl;
@@ -1724,6 +1879,8 @@ struct amvp_ctx_t {
     
     AMVP_OPERATING_ENV op_env; /**< The Operating Environment resources available */
     AMVP_STRING_LIST *vsid_url_list;
+    AMVP_VS_META *vs_meta;  /* vector sets processed so far, see amvp_vs_meta_add() */
+    AMVP_VS_GRADED *vs_graded; /* vector sets the results monitor saw graded */
     char *session_url;
     int session_passed;
 
@@ -1767,13 +1924,41 @@ struct amvp_ctx_t {
     /* Two-factor authentication callback */
     AMVP_RESULT (*totp_cb) (char **token, int token_max);
 
+    /* SigGen key pre-generation, see amvp_key_pool.c */
+    int key_pregen_threads;
+    int key_pregen_depth;
+    struct amvp_key_pool_t *key_pool;
+
+    /* Asynchronous log sink, see amvp_set_log_async() */
+    struct amvp_log_ring_t *log_ring;
+
+    /* Profiling counters of the session, see amvp_get_perf_stats() */
+    AMVP_PERF_STATS *perf;
+
+    /* Timeline of the session, see amvp_trace.c */
+    struct amvp_trace_t *trace;
+    int trace_tid;        /* track of the thread running on this ctx */
+
+    /* Heap high-water marks of the vector set that needed the most, see amvp_mem.c */
+    int mem_vs_count;
+    int mem_peak_vs_id;
+    long long mem_peak_vs[AMVP_MEM_TAG_MAX + 1]; /* the last one is the total */
+
+    /* crypto_handler latencies per algorithm, see amvp_get_latency_stats() */
+    AMVP_LATENCY *latency[AMVP_CIPHER_END];
+    int slow_tc_max;      /* slowest test cases kept, see amvp_set_slow_tc_capture() */
+
+    /* Recording and replay of the HTTP exchanges, see amvp_record.c */
+    struct amvp_record_t *record;
+    struct amvp_replay_t *replay;
+
     /* Transitory values */
-    int vs_id;      /* vs_id currently being processed */
+    AMVP_VS_WORK work;    /* state of the vector set being processed by this ctx */
 
-    JSON_Value *kat_resp; /* holds the current set of vector responses */
+    int vs_workers;       /* number of vector sets processed concurrently, see amvp_set_vs_workers() */
+    int file_compress_level; /* level for .gz/.zst files written, 0 for the default, see amvp_file.c */
+    AMVP_CTX *parent;     /* session ctx this worker ctx was cloned from, NULL for the session ctx */
 
-    char *curl_buf;       /**< Data buffer for inbound Curl messages */
-    int curl_read_ctr;    /**< Total number of bytes written to the curl_buf */
     int post_size_constraint;  /**< The number of bytes that the body of an HTTP POST may contain
                                     without requiring the use of the /large endpoint. If the POST body
                                     is larger than this value, then use of the /large endpoint is necessary */
@@ -1808,6 +1993,8 @@ AMVP_RESULT amvp_submit_vector_responses(AMVP_CTX *ctx, char *vsid_url);
 
 void amvp_log_msg(AMVP_CTX *ctx, AMVP_LOG_LVL level, const char *func, int line, const char *format, ...);
 void amvp_log_newline(AMVP_CTX *ctx);
+AMVP_RESULT amvp_log_ring_start(AMVP_CTX *ctx, int slots);
+void amvp_log_ring_free(AMVP_CTX *ctx);
 
 /*
  * These are the handler routines for each KAT operation
@@ -1969,6 +2156,163 @@ AMVP_RESULT amvp_setup_json_rsp_group(AMVP_CTX **ctx,
                                       const char *alg_str,
                                       JSON_Array **groups_arr);
 
+AMVP_RESULT amvp_group_begin(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_GROUP *group);
+
+AMVP_RESULT amvp_group_end(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_GROUP *group);
+
+typedef enum amvp_file_type {
+    AMVP_FILE_PLAIN = 0,
+    AMVP_FILE_GZIP,
+    AMVP_FILE_ZSTD
+} AMVP_FILE_TYPE;
+
+typedef struct amvp_file_t AMVP_FILE;
+
+AMVP_FILE_TYPE amvp_file_type(const char *filename);
+
+AMVP_RESULT amvp_file_open(AMVP_FILE **file,
+                           const char *filename,
+                           const char *mode,
+                           AMVP_FILE_TYPE type,
+                           int level);
+
+AMVP_FILE_TYPE amvp_file_get_type(AMVP_FILE *file);
+
+size_t amvp_file_read(AMVP_FILE *file, void *buf, size_t len);
+
+int amvp_file_write(AMVP_FILE *file, const void *buf, size_t len);
+
+int amvp_file_puts(AMVP_FILE *file, const char *str);
+
+int amvp_file_sync(AMVP_FILE *file);
+
+AMVP_RESULT amvp_file_truncate(AMVP_FILE *file, unsigned long long offset);
+
+int amvp_file_close(AMVP_FILE *file);
+
+JSON_Value *amvp_json_parse_file(const char *filename);
+
+typedef struct amvp_json_stream_t AMVP_JSON_STREAM;
+
+AMVP_RESULT amvp_json_stream_open(AMVP_JSON_STREAM **stream, const char *filename);
+
+AMVP_RESULT amvp_json_stream_next(AMVP_JSON_STREAM *stream, JSON_Value **val);
+
+AMVP_RESULT amvp_json_stream_skip(AMVP_JSON_STREAM *stream, int count);
+
+void amvp_json_stream_close(AMVP_JSON_STREAM *stream);
+
+typedef struct amvp_json_writer_t AMVP_JSON_WRITER;
+
+AMVP_RESULT amvp_json_writer_open(AMVP_JSON_WRITER **writer,
+                                  const char *filename,
+                                  const char *req_filename,
+                                  int level,
+                                  int *committed);
+
+AMVP_RESULT amvp_json_writer_append(AMVP_JSON_WRITER *writer, const JSON_Value *value);
+
+AMVP_RESULT amvp_json_writer_finish(AMVP_JSON_WRITER *writer);
+
+void amvp_json_writer_abort(AMVP_JSON_WRITER *writer);
+
+AMVP_RESULT amvp_key_pool_start(AMVP_CTX *ctx);
+
+AMVP_RESULT amvp_key_pool_take(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_GROUP *group);
+
+void amvp_key_pool_free(AMVP_CTX *ctx);
+
+unsigned long long amvp_perf_now(void);
+
+int amvp_tc_id(AMVP_CAPS_LIST *cap, AMVP_TEST_CASE *tc);
+
+int amvp_crypto_handler(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_CASE *tc);
+
+int amvp_mct_handler(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_CASE *tc);
+
+void amvp_perf_flush(AMVP_CTX *ctx, AMVP_CIPHER cipher);
+
+AMVP_RESULT amvp_perf_copy(AMVP_CTX *ctx, AMVP_PERF_STATS *stats);
+
+void amvp_perf_free(AMVP_CTX *ctx);
+
+AMVP_RESULT amvp_trace_open(AMVP_CTX *ctx, const char *path);
+
+void amvp_trace_close(AMVP_CTX *ctx);
+
+void amvp_trace_thread(AMVP_CTX *ctx, const char *name);
+
+unsigned long long amvp_trace_begin(AMVP_CTX *ctx);
+
+void amvp_trace_span(AMVP_CTX *ctx, const char *cat, const char *name,
+                     unsigned long long start, int vs_id, const char *url);
+
+void amvp_trace_group(AMVP_CTX *ctx, int tg_id);
+
+void amvp_latency_record(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_CASE *tc,
+                         unsigned long long ns);
+
+void amvp_latency_flush(AMVP_CTX *ctx, AMVP_CIPHER cipher);
+
+AMVP_RESULT amvp_latency_copy(AMVP_CTX *ctx, AMVP_CIPHER cipher, AMVP_LATENCY_STATS *stats);
+
+void amvp_latency_free(AMVP_CTX *ctx);
+
+void *amvp_mem_malloc(AMVP_MEM_TAG tag, size_t size);
+
+void *amvp_mem_calloc(AMVP_MEM_TAG tag, size_t count, size_t size);
+
+void amvp_mem_free(AMVP_MEM_TAG tag, void *ptr);
+
+void amvp_mem_init(void);
+
+void amvp_mem_vs_begin(void);
+
+void amvp_mem_vs_end(AMVP_CTX *ctx);
+
+unsigned long long amvp_mem_vs_peak(void);
+
+void amvp_mem_copy(AMVP_CTX *ctx, AMVP_MEM_STATS *stats);
+
+AMVP_RESULT amvp_dispatch_vector_set(AMVP_CTX *ctx, JSON_Object *obj);
+
+AMVP_RESULT amvp_estimate(AMVP_CTX *ctx, const char *calibration_file, AMVP_SESSION_ESTIMATE *est);
+
+typedef enum amvp_http_method {
+    AMVP_HTTP_GET = 0,
+    AMVP_HTTP_POST,
+    AMVP_HTTP_PUT,
+    AMVP_HTTP_DELETE
+} AMVP_HTTP_METHOD;
+
+AMVP_RESULT amvp_record_open(AMVP_CTX *ctx, const char *path);
+
+void amvp_record_close(AMVP_CTX *ctx);
+
+void amvp_record_http(AMVP_CTX *ctx, AMVP_HTTP_METHOD method, const char *url,
+                      int auth, const char *etag, const char *data, int data_len,
+                      long http_code, unsigned long long start);
+
+AMVP_RESULT amvp_replay_open(AMVP_CTX *ctx, const char *path, int realtime);
+
+void amvp_replay_close(AMVP_CTX *ctx);
+
+long amvp_replay_http(AMVP_CTX *ctx, AMVP_HTTP_METHOD method, const char *url);
+
+int amvp_replay_fast(AMVP_CTX *ctx);
+
+void amvp_tc_batch_init(AMVP_TC_BATCH *batch,
+                        AMVP_RESULT (*output_tc)(AMVP_CTX *ctx, AMVP_TEST_CASE *tc,
+                                                 JSON_Object *r_tobj, int tc_rv),
+                        void (*release_tc)(AMVP_TEST_CASE *tc));
+
+AMVP_RESULT amvp_tc_batch_flush(AMVP_CTX *ctx,
+                                AMVP_CAPS_LIST *cap,
+                                AMVP_TC_BATCH *batch,
+                                JSON_Array *r_tarr);
+
+void amvp_tc_batch_discard(AMVP_TC_BATCH *batch);
+
 void amvp_release_json(JSON_Value *r_vs_val,
                        JSON_Value *r_gval);
 
@@ -1989,6 +2333,14 @@ AMVP_RESULT amvp_append_name_list(AMVP_NAME_LIST **list, const char *string);
 int amvp_is_in_name_list(AMVP_NAME_LIST *list, const char *string);
 AMVP_RESULT amvp_append_str_list(AMVP_STRING_LIST **list, const char *string);
 int amvp_lookup_str_list(AMVP_STRING_LIST **list, const char *string);
+AMVP_RESULT amvp_vs_meta_add(AMVP_CTX *ctx, int vs_id, const char *alg, const char *mode);
+const AMVP_VS_META *amvp_vs_meta_lookup(AMVP_CTX *ctx, const char *vsid_url);
+JSON_Value *amvp_vs_meta_to_json(AMVP_CTX *ctx);
+AMVP_RESULT amvp_vs_meta_from_json(AMVP_CTX *ctx, JSON_Array *arr);
+void amvp_vs_meta_free(AMVP_VS_META **list);
+AMVP_RESULT amvp_vs_graded_add(AMVP_CTX *ctx, int vs_id, int failed);
+const AMVP_VS_GRADED *amvp_vs_graded_lookup(AMVP_CTX *ctx, int vs_id);
+void amvp_vs_graded_free(AMVP_VS_GRADED **list);
 int amvp_lookup_param_list(AMVP_PARAM_LIST *list, int value);
 const char* amvp_lookup_aux_function_alg_str(AMVP_CIPHER alg);
 AMVP_CIPHER amvp_lookup_aux_function_alg_tbl(const char *str);
@@ -1999,8 +2351,8 @@ AMVP_KDF108_MAC_MODE_VAL read_mac_mode(const char *str);
 AMVP_KDF108_FIXED_DATA_ORDER_VAL read_ctr_location(const char *str);
 AMVP_KDF108_MODE read_mode(const char *str);
 
-AMVP_RESULT amvp_json_serialize_to_file_pretty_a(const JSON_Value *value, const char *filename);
-AMVP_RESULT amvp_json_serialize_to_file_pretty_w(const JSON_Value *value, const char *filename);
+AMVP_RESULT amvp_json_serialize_to_file_pretty_a(AMVP_CTX *ctx, const JSON_Value *value, const char *filename);
+AMVP_RESULT amvp_json_serialize_to_file_pretty_w(AMVP_CTX *ctx, const JSON_Value *value, const char *filename);
 
 
 #endif
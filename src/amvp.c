@@ -16,6 +16,8 @@
 #include <Windows.h>
 #else
 #include <unistd.h>
+#include <pthread.h>
+#include <time.h>
 #endif
 #include <math.h>
 #include "amvp.h"
@@ -48,7 +50,30 @@ static AMVP_RESULT amvp_process_vector_set(AMVP_CTX *ctx, JSON_Object *obj);
 
 static AMVP_RESULT amvp_process_ie_set(AMVP_CTX *ctx, JSON_Object *obj);
 
-static AMVP_RESULT amvp_dispatch_vector_set(AMVP_CTX *ctx, JSON_Object *obj);
+/*
+ * Outcome of uploading the response of one vector set in
+ * amvp_upload_vectors_from_file()
+ */
+typedef struct amvp_upload_status_t {
+    int vs_id;
+    AMVP_RESULT rv;
+} AMVP_UPLOAD_STATUS;
+
+static AMVP_RESULT amvp_upload_vs_rsp(AMVP_CTX *ctx, char *vsid_url, JSON_Value *vs_val, AMVP_UPLOAD_STATUS *status);
+
+#ifndef _WIN32
+static AMVP_RESULT amvp_run_vectors_concurrent(AMVP_CTX *ctx, AMVP_JSON_STREAM *stream, JSON_Value *first,
+                                               int vs_cnt, AMVP_JSON_WRITER *writer);
+
+static AMVP_RESULT amvp_upload_concurrent(AMVP_CTX *ctx, AMVP_JSON_STREAM *stream, JSON_Value *first,
+                                          AMVP_UPLOAD_STATUS *status, int vs_cnt);
+
+typedef struct amvp_results_monitor_t AMVP_RESULTS_MONITOR;
+
+static AMVP_RESULTS_MONITOR *amvp_results_monitor_start(AMVP_CTX *ctx, AMVP_STRING_LIST *pending);
+
+static void amvp_results_monitor_stop(AMVP_RESULTS_MONITOR *monitor);
+#endif
 
 static void amvp_cap_free_sl(AMVP_SL_LIST *list);
 
@@ -199,6 +224,7 @@ AMVP_RESULT amvp_create_test_session(AMVP_CTX **ctx,
     if (!*ctx) {
         return AMVP_MALLOC_FAIL;
     }
+    amvp_mem_init();
 
     if (progress_cb) {
         (*ctx)->test_progress_cb = progress_cb;
@@ -223,12 +249,205 @@ AMVP_RESULT amvp_set_2fa_callback(AMVP_CTX *ctx, AMVP_RESULT (*totp_cb)(char **t
     return AMVP_SUCCESS;
 }
 
+AMVP_RESULT amvp_set_key_pregen(AMVP_CTX *ctx, int threads, int depth) {
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (threads < 0 || threads > AMVP_KEY_PREGEN_THREADS_MAX) {
+        AMVP_LOG_ERR("Invalid number of key pre-generation threads %d, max %d",
+                     threads, AMVP_KEY_PREGEN_THREADS_MAX);
+        return AMVP_INVALID_ARG;
+    }
+    if (depth < 1 || depth > AMVP_KEY_PREGEN_DEPTH_MAX) {
+        AMVP_LOG_ERR("Invalid key pre-generation depth %d, max %d",
+                     depth, AMVP_KEY_PREGEN_DEPTH_MAX);
+        return AMVP_INVALID_ARG;
+    }
+    if (ctx->key_pool) {
+        AMVP_LOG_ERR("Key pre-generation has already started");
+        return AMVP_UNSUPPORTED_OP;
+    }
+#ifdef _WIN32
+    if (threads) {
+        AMVP_LOG_WARN("Background key generation is not supported on Windows, keys will be generated on demand");
+    }
+#endif
+    ctx->key_pregen_threads = threads;
+    ctx->key_pregen_depth = depth;
+    return AMVP_SUCCESS;
+}
+
+AMVP_RESULT amvp_set_vs_workers(AMVP_CTX *ctx, int workers) {
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (workers < 1 || workers > AMVP_VS_WORKERS_MAX) {
+        AMVP_LOG_ERR("Invalid number of vector set workers %d, max %d", workers, AMVP_VS_WORKERS_MAX);
+        return AMVP_INVALID_ARG;
+    }
+#ifdef _WIN32
+    if (workers > 1) {
+        AMVP_LOG_WARN("Concurrent vector set processing is not supported on Windows");
+    }
+#endif
+    ctx->vs_workers = workers;
+    return AMVP_SUCCESS;
+}
+
+AMVP_RESULT amvp_set_log_async(AMVP_CTX *ctx, int slots) {
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (slots < 0 || slots > AMVP_LOG_ASYNC_SLOTS_MAX) {
+        AMVP_LOG_ERR("Invalid number of asynchronous log slots %d, max %d", slots, AMVP_LOG_ASYNC_SLOTS_MAX);
+        return AMVP_INVALID_ARG;
+    }
+    amvp_log_ring_free(ctx);
+    if (!slots) {
+        return AMVP_SUCCESS;
+    }
+#ifdef _WIN32
+    AMVP_LOG_WARN("Asynchronous logging is not supported on Windows, messages will be logged synchronously");
+#else
+    rv = amvp_log_ring_start(ctx, slots);
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("Failed to start asynchronous logging");
+    }
+#endif
+    return rv;
+}
+
+AMVP_RESULT amvp_get_perf_stats(AMVP_CTX *ctx, AMVP_PERF_STATS *stats) {
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!stats) {
+        return AMVP_MISSING_ARG;
+    }
+    return amvp_perf_copy(ctx, stats);
+}
+
+AMVP_RESULT amvp_get_mem_stats(AMVP_CTX *ctx, AMVP_MEM_STATS *stats) {
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!stats) {
+        return AMVP_MISSING_ARG;
+    }
+    amvp_mem_copy(ctx, stats);
+    return AMVP_SUCCESS;
+}
+
+AMVP_RESULT amvp_get_latency_stats(AMVP_CTX *ctx, AMVP_CIPHER cipher, AMVP_LATENCY_STATS *stats) {
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!stats) {
+        return AMVP_MISSING_ARG;
+    }
+    if (cipher < AMVP_CIPHER_START || cipher >= AMVP_CIPHER_END) {
+        AMVP_LOG_ERR("Invalid cipher %d", cipher);
+        return AMVP_INVALID_ARG;
+    }
+    return amvp_latency_copy(ctx, cipher, stats);
+}
+
+AMVP_RESULT amvp_estimate_session(AMVP_CTX *ctx, const char *calibration_file, AMVP_SESSION_ESTIMATE *est) {
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!est) {
+        return AMVP_MISSING_ARG;
+    }
+    if (!ctx->caps_list) {
+        AMVP_LOG_ERR("No capabilities registered, nothing to estimate");
+        return AMVP_NO_CAP;
+    }
+    if (calibration_file &&
+        strnlen_s(calibration_file, AMVP_JSON_FILENAME_MAX + 1) > AMVP_JSON_FILENAME_MAX) {
+        AMVP_LOG_ERR("Provided calibration_file length > max(%d)", AMVP_JSON_FILENAME_MAX);
+        return AMVP_INVALID_ARG;
+    }
+    return amvp_estimate(ctx, calibration_file, est);
+}
+
+AMVP_RESULT amvp_set_slow_tc_capture(AMVP_CTX *ctx, int count) {
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (count < 0 || count > AMVP_SLOW_TC_MAX) {
+        AMVP_LOG_ERR("Invalid number of slow test cases %d, max %d", count, AMVP_SLOW_TC_MAX);
+        return AMVP_INVALID_ARG;
+    }
+    ctx->slow_tc_max = count;
+    return AMVP_SUCCESS;
+}
+
+AMVP_RESULT amvp_set_trace_file(AMVP_CTX *ctx, const char *path) {
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    amvp_trace_close(ctx);
+    if (!path) {
+        return AMVP_SUCCESS;
+    }
+    if (strnlen_s(path, AMVP_SESSION_PARAMS_STR_LEN_MAX + 1) > AMVP_SESSION_PARAMS_STR_LEN_MAX) {
+        AMVP_LOG_ERR("Trace filename is suspiciously long...");
+        return AMVP_INVALID_ARG;
+    }
+    return amvp_trace_open(ctx, path);
+}
+
+AMVP_RESULT amvp_set_transport_record(AMVP_CTX *ctx, const char *path) {
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    amvp_record_close(ctx);
+    if (!path) {
+        return AMVP_SUCCESS;
+    }
+    if (strnlen_s(path, AMVP_SESSION_PARAMS_STR_LEN_MAX + 1) > AMVP_SESSION_PARAMS_STR_LEN_MAX) {
+        AMVP_LOG_ERR("Recording filename is suspiciously long...");
+        return AMVP_INVALID_ARG;
+    }
+    return amvp_record_open(ctx, path);
+}
+
+AMVP_RESULT amvp_set_transport_replay(AMVP_CTX *ctx, const char *path, int realtime) {
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    amvp_replay_close(ctx);
+    if (!path) {
+        return AMVP_SUCCESS;
+    }
+    if (strnlen_s(path, AMVP_SESSION_PARAMS_STR_LEN_MAX + 1) > AMVP_SESSION_PARAMS_STR_LEN_MAX) {
+        AMVP_LOG_ERR("Recording filename is suspiciously long...");
+        return AMVP_INVALID_ARG;
+    }
+    return amvp_replay_open(ctx, path, realtime);
+}
+
+AMVP_RESULT amvp_set_file_compression_level(AMVP_CTX *ctx, int level) {
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (level < 0 || level > AMVP_FILE_COMPRESSION_LEVEL_MAX) {
+        AMVP_LOG_ERR("Invalid file compression level %d, max %d", level, AMVP_FILE_COMPRESSION_LEVEL_MAX);
+        return AMVP_INVALID_ARG;
+    }
+    ctx->file_compress_level = level;
+    return AMVP_SUCCESS;
+}
+
 static void amvp_free_prereqs(AMVP_CAPS_LIST *cap_list) {
     while (cap_list->prereq_vals) {
         AMVP_PREREQ_LIST *temp_ptr;
         temp_ptr = cap_list->prereq_vals;
         cap_list->prereq_vals = cap_list->prereq_vals->next;
-        free(temp_ptr);
+        amvp_mem_free(AMVP_MEM_CAPS, temp_ptr);
     }
 }
 
@@ -246,7 +465,7 @@ static void amvp_cap_free_ec_alg_list(AMVP_CURVE_ALG_COMPAT_LIST *list) {
     while (tmp) {
         tmp2 = tmp;
         tmp = tmp->next;
-        free(tmp2);
+        amvp_mem_free(AMVP_MEM_CAPS, tmp2);
     }
 }
 
@@ -266,12 +485,12 @@ static void amvp_cap_free_dsa_attrs(AMVP_CAPS_LIST *cap_entry) {
             while (next) {
                 attrs = next;
                 next = attrs->next;
-                free(attrs);
+                amvp_mem_free(AMVP_MEM_CAPS, attrs);
             }
         }
     }
     dsa_cap_mode = cap_entry->cap.dsa_cap->dsa_cap_mode;
-    free(dsa_cap_mode);
+    amvp_mem_free(AMVP_MEM_CAPS, dsa_cap_mode);
 }
 
 /*
@@ -286,7 +505,7 @@ static void amvp_cap_free_rsa_keygen_list(AMVP_CAPS_LIST *cap_list) {
 
     while (keygen_cap) {
         if (keygen_cap->fixed_pub_exp) {
-            free(keygen_cap->fixed_pub_exp);
+            amvp_mem_free(AMVP_MEM_CAPS, keygen_cap->fixed_pub_exp);
         }
 
         AMVP_RSA_MODE_CAPS_LIST *mode_list = keygen_cap->mode_capabilities;
@@ -298,13 +517,13 @@ static void amvp_cap_free_rsa_keygen_list(AMVP_CAPS_LIST *cap_list) {
 
             temp_mode_list = mode_list;
             mode_list = mode_list->next;
-            free(temp_mode_list);
+            amvp_mem_free(AMVP_MEM_CAPS, temp_mode_list);
             temp_mode_list = NULL;
         }
 
         temp_keygen_cap = keygen_cap;
         keygen_cap = keygen_cap->next;
-        free(temp_keygen_cap);
+        amvp_mem_free(AMVP_MEM_CAPS, temp_keygen_cap);
         temp_keygen_cap = NULL;
     }
 }
@@ -331,20 +550,20 @@ static void amvp_cap_free_rsa_sig_list(AMVP_CAPS_LIST *cap_list) {
         AMVP_RSA_MODE_CAPS_LIST *temp_mode_list;
 
         if (sig_cap->fixed_pub_exp) {
-            free(sig_cap->fixed_pub_exp);
+            amvp_mem_free(AMVP_MEM_CAPS, sig_cap->fixed_pub_exp);
         }
         while (mode_list) {
             amvp_cap_free_hash_pairs(mode_list->hash_pair);
 
             temp_mode_list = mode_list;
             mode_list = mode_list->next;
-            free(temp_mode_list);
+            amvp_mem_free(AMVP_MEM_CAPS, temp_mode_list);
             temp_mode_list = NULL;
         }
 
         temp_sig_cap = sig_cap;
         sig_cap = sig_cap->next;
-        free(temp_sig_cap);
+        amvp_mem_free(AMVP_MEM_CAPS, temp_sig_cap);
         temp_sig_cap = NULL;
     }
 }
@@ -375,7 +594,7 @@ static void amvp_cap_free_kas_ecc_mode(AMVP_CAPS_LIST *cap_list) {
                 if (current_pre_req_vals) {
                     do {
                         next_pre_req_vals = current_pre_req_vals->next;
-                        free(current_pre_req_vals);
+                        amvp_mem_free(AMVP_MEM_CAPS, current_pre_req_vals);
                         current_pre_req_vals = next_pre_req_vals;
                     } while (current_pre_req_vals);
                 }
@@ -401,20 +620,20 @@ static void amvp_cap_free_kas_ecc_mode(AMVP_CAPS_LIST *cap_list) {
                             do {
                                 amvp_cap_free_pl(current_pset->sha);
                                 next_pset = current_pset->next;
-                                free(current_pset);
+                                amvp_mem_free(AMVP_MEM_CAPS, current_pset);
                                 current_pset = next_pset;
                             } while (current_pset);
                         }
                         next_scheme = current_scheme->next;
-                        free(current_scheme);
+                        amvp_mem_free(AMVP_MEM_CAPS, current_scheme);
                         current_scheme = next_scheme;
                     } while (current_scheme);
                 }
             }
         }
     }
-    free(cap_list->cap.kas_ecc_cap->kas_ecc_mode);
-    free(cap_list->cap.kas_ecc_cap);
+    amvp_mem_free(AMVP_MEM_CAPS, cap_list->cap.kas_ecc_cap->kas_ecc_mode);
+    amvp_mem_free(AMVP_MEM_CAPS, cap_list->cap.kas_ecc_cap);
 }
 
 /*
@@ -443,7 +662,7 @@ static void amvp_cap_free_kas_ffc_mode(AMVP_CAPS_LIST *cap_list) {
                 if (current_pre_req_vals) {
                     do {
                         next_pre_req_vals = current_pre_req_vals->next;
-                        free(current_pre_req_vals);
+                        amvp_mem_free(AMVP_MEM_CAPS, current_pre_req_vals);
                         current_pre_req_vals = next_pre_req_vals;
                     } while (current_pre_req_vals);
                 }
@@ -469,20 +688,20 @@ static void amvp_cap_free_kas_ffc_mode(AMVP_CAPS_LIST *cap_list) {
                             do {
                                 amvp_cap_free_pl(current_pset->sha);
                                 next_pset = current_pset->next;
-                                free(current_pset);
+                                amvp_mem_free(AMVP_MEM_CAPS, current_pset);
                                 current_pset = next_pset;
                             } while (current_pset);
                         }
                         next_scheme = current_scheme->next;
-                        free(current_scheme);
+                        amvp_mem_free(AMVP_MEM_CAPS, current_scheme);
                         current_scheme = next_scheme;
                     } while (current_scheme);
                 }
             }
         }
     }
-    free(cap_list->cap.kas_ffc_cap->kas_ffc_mode);
-    free(cap_list->cap.kas_ffc_cap);
+    amvp_mem_free(AMVP_MEM_CAPS, cap_list->cap.kas_ffc_cap->kas_ffc_mode);
+    amvp_mem_free(AMVP_MEM_CAPS, cap_list->cap.kas_ffc_cap);
 }
 
 /*
@@ -502,7 +721,7 @@ static void amvp_free_drbg_struct(AMVP_CAPS_LIST *cap_list) {
         current_pre_req_vals = drbg_cap->prereq_vals;
         while (current_pre_req_vals) {
             next_pre_req_vals = current_pre_req_vals->next;
-            free(current_pre_req_vals);
+            amvp_mem_free(AMVP_MEM_CAPS, current_pre_req_vals);
             current_pre_req_vals = next_pre_req_vals;
         }
 
@@ -511,16 +730,16 @@ static void amvp_free_drbg_struct(AMVP_CAPS_LIST *cap_list) {
             while (group_list) {
                 next_group_list = group_list->next;
                 if (group_list->group) {
-                    free(group_list->group);
+                    amvp_mem_free(AMVP_MEM_CAPS, group_list->group);
                 }
-                free(group_list);
+                amvp_mem_free(AMVP_MEM_CAPS, group_list);
                 group_list = next_group_list;
             }
             next_mode_list = mode_list->next;
-            free(mode_list);
+            amvp_mem_free(AMVP_MEM_CAPS, mode_list);
             mode_list = next_mode_list;
         }
-        free(drbg_cap);
+        amvp_mem_free(AMVP_MEM_CAPS, drbg_cap);
         drbg_cap = NULL;
         cap_list->cap.drbg_cap = NULL;
     }
@@ -587,11 +806,11 @@ static void amvp_cap_free_kts_ifc_schemes(AMVP_CAPS_LIST *cap_entry) {
     while (current_scheme) {
         amvp_cap_free_pl(current_scheme->roles);
         amvp_cap_free_pl(current_scheme->hash);
-        free(current_scheme->assoc_data_pattern);
-        free(current_scheme->encodings);
+        amvp_mem_free(AMVP_MEM_CAPS, current_scheme->assoc_data_pattern);
+        amvp_mem_free(AMVP_MEM_CAPS, current_scheme->encodings);
         current_scheme = current_scheme->next;
     }
-    free(cap_entry->cap.kts_ifc_cap->schemes);
+    amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kts_ifc_cap->schemes);
 }
 /*
  * The application will invoke this to free the AMVP context
@@ -606,8 +825,18 @@ AMVP_RESULT amvp_free_test_session(AMVP_CTX *ctx) {
         return AMVP_SUCCESS;
     }
 
-    if (ctx->kat_resp) { json_value_free(ctx->kat_resp); }
-    if (ctx->curl_buf) { free(ctx->curl_buf); }
+    /* Stop key pre-generation before the capabilities it uses are freed */
+    amvp_key_pool_free(ctx);
+    /* Deliver any queued log messages */
+    amvp_log_ring_free(ctx);
+    amvp_perf_free(ctx);
+    amvp_latency_free(ctx);
+    amvp_trace_close(ctx);
+    amvp_record_close(ctx);
+    amvp_replay_close(ctx);
+
+    if (ctx->work.kat_resp) { json_value_free(ctx->work.kat_resp); }
+    if (ctx->work.curl_buf) { amvp_mem_free(AMVP_MEM_TRANSPORT, ctx->work.curl_buf); }
     if (ctx->server_name) { free(ctx->server_name); }
     if (ctx->path_segment) { free(ctx->path_segment); }
     if (ctx->api_context) { free(ctx->api_context); }
@@ -639,6 +868,12 @@ AMVP_RESULT amvp_free_test_session(AMVP_CTX *ctx) {
     if (ctx->vsid_url_list) {
         amvp_free_str_list(&ctx->vsid_url_list);
     }
+    if (ctx->vs_meta) {
+        amvp_vs_meta_free(&ctx->vs_meta);
+    }
+    if (ctx->vs_graded) {
+        amvp_vs_graded_free(&ctx->vs_graded);
+    }
     if (ctx->registration) {
             json_value_free(ctx->registration);
     }
@@ -657,10 +892,10 @@ AMVP_RESULT amvp_free_test_session(AMVP_CTX *ctx) {
                 amvp_cap_free_sl(cap_entry->cap.sym_cap->aadlen);
                 amvp_cap_free_sl(cap_entry->cap.sym_cap->taglen);
                 amvp_cap_free_sl(cap_entry->cap.sym_cap->tweak);
-                free(cap_entry->cap.sym_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.sym_cap);
                 break;
             case AMVP_HASH_TYPE:
-                free(cap_entry->cap.hash_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.hash_cap);
                 break;
             case AMVP_DRBG_TYPE:
                 amvp_free_drbg_struct(cap_entry);
@@ -668,24 +903,24 @@ AMVP_RESULT amvp_free_test_session(AMVP_CTX *ctx) {
             case AMVP_HMAC_TYPE:
                 amvp_cap_free_domain(&cap_entry->cap.hmac_cap->key_len);
                 amvp_cap_free_domain(&cap_entry->cap.hmac_cap->mac_len);
-                free(cap_entry->cap.hmac_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.hmac_cap);
                 break;
             case AMVP_CMAC_TYPE:
                 amvp_cap_free_sl(cap_entry->cap.cmac_cap->key_len);
                 amvp_cap_free_sl(cap_entry->cap.cmac_cap->keying_option);
                 amvp_cap_free_domain(&cap_entry->cap.cmac_cap->msg_len);
                 amvp_cap_free_domain(&cap_entry->cap.cmac_cap->mac_len);
-                free(cap_entry->cap.cmac_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.cmac_cap);
                 break;
             case AMVP_KMAC_TYPE:
                 amvp_cap_free_domain(&cap_entry->cap.kmac_cap->key_len);
                 amvp_cap_free_domain(&cap_entry->cap.kmac_cap->msg_len);
                 amvp_cap_free_domain(&cap_entry->cap.kmac_cap->mac_len);
-                free(cap_entry->cap.kmac_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kmac_cap);
                 break;
             case AMVP_DSA_TYPE:
                 amvp_cap_free_dsa_attrs(cap_entry);
-                free(cap_entry->cap.dsa_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.dsa_cap);
                 break;
             case AMVP_KAS_ECC_CDH_TYPE:
             case AMVP_KAS_ECC_COMP_TYPE:
@@ -703,49 +938,49 @@ AMVP_RESULT amvp_free_test_session(AMVP_CTX *ctx) {
                 amvp_cap_free_pl(cap_entry->cap.kas_ifc_cap->kas2_roles);
                 amvp_cap_free_pl(cap_entry->cap.kas_ifc_cap->keygen_method);
                 amvp_cap_free_sl(cap_entry->cap.kas_ifc_cap->modulo);
-                free(cap_entry->cap.kas_ifc_cap->fixed_pub_exp);
-                free(cap_entry->cap.kas_ifc_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kas_ifc_cap->fixed_pub_exp);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kas_ifc_cap);
                 break;
             case AMVP_KDA_ONESTEP_TYPE:
                 if (cap_entry->cap.kda_onestep_cap->literal_pattern_candidate) {
-                    free(cap_entry->cap.kda_onestep_cap->literal_pattern_candidate);
+                    amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kda_onestep_cap->literal_pattern_candidate);
                 }
                 amvp_cap_free_pl(cap_entry->cap.kda_onestep_cap->patterns);
                 amvp_cap_free_pl(cap_entry->cap.kda_onestep_cap->encodings);
                 amvp_cap_free_nl(cap_entry->cap.kda_onestep_cap->aux_functions);
                 amvp_cap_free_nl(cap_entry->cap.kda_onestep_cap->mac_salt_methods);
-                free(cap_entry->cap.kda_onestep_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kda_onestep_cap);
                 break;
             case AMVP_KDA_TWOSTEP_TYPE:
                 if (cap_entry->cap.kda_twostep_cap->literal_pattern_candidate) {
-                    free(cap_entry->cap.kda_twostep_cap->literal_pattern_candidate);
+                    amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kda_twostep_cap->literal_pattern_candidate);
                 }
                 amvp_cap_free_nl(cap_entry->cap.kda_twostep_cap->mac_salt_methods);
                 amvp_cap_free_pl(cap_entry->cap.kda_twostep_cap->patterns);
                 amvp_cap_free_pl(cap_entry->cap.kda_twostep_cap->encodings);
                 amvp_cap_free_domain(&cap_entry->cap.kda_twostep_cap->aux_secret_len);
                 amvp_cap_free_kdf108(&cap_entry->cap.kda_twostep_cap->kdf_params);
-                free(cap_entry->cap.kda_twostep_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kda_twostep_cap);
                 break;
             case AMVP_KDA_HKDF_TYPE:
                 if (cap_entry->cap.kda_hkdf_cap->literal_pattern_candidate) {
-                    free(cap_entry->cap.kda_hkdf_cap->literal_pattern_candidate);
+                    amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kda_hkdf_cap->literal_pattern_candidate);
                 }
                 amvp_cap_free_pl(cap_entry->cap.kda_hkdf_cap->patterns);
                 amvp_cap_free_pl(cap_entry->cap.kda_hkdf_cap->encodings);
                 amvp_cap_free_nl(cap_entry->cap.kda_hkdf_cap->hmac_algs);
                 amvp_cap_free_nl(cap_entry->cap.kda_hkdf_cap->mac_salt_methods);
                 amvp_cap_free_domain(&cap_entry->cap.kda_hkdf_cap->aux_secret_len);
-                free(cap_entry->cap.kda_hkdf_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kda_hkdf_cap);
                 break;
             case AMVP_KTS_IFC_TYPE:
                 amvp_cap_free_pl(cap_entry->cap.kts_ifc_cap->keygen_method);
                 amvp_cap_free_pl(cap_entry->cap.kts_ifc_cap->functions);
                 amvp_cap_free_sl(cap_entry->cap.kts_ifc_cap->modulo);
-                free(cap_entry->cap.kts_ifc_cap->fixed_pub_exp);
-                free(cap_entry->cap.kts_ifc_cap->iut_id);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kts_ifc_cap->fixed_pub_exp);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kts_ifc_cap->iut_id);
                 amvp_cap_free_kts_ifc_schemes(cap_entry);
-                free(cap_entry->cap.kts_ifc_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kts_ifc_cap);
                 break;
             case AMVP_RSA_KEYGEN_TYPE:
                 amvp_cap_free_rsa_keygen_list(cap_entry);
@@ -758,43 +993,43 @@ AMVP_RESULT amvp_free_test_session(AMVP_CTX *ctx) {
                 break;
             case AMVP_RSA_PRIM_TYPE:
                 if (cap_entry->cap.rsa_prim_cap->fixed_pub_exp) {
-                    free(cap_entry->cap.rsa_prim_cap->fixed_pub_exp);
+                    amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.rsa_prim_cap->fixed_pub_exp);
                 }
-                free(cap_entry->cap.rsa_prim_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.rsa_prim_cap);
                 break;
             case AMVP_ECDSA_KEYGEN_TYPE:
                 amvp_cap_free_ec_alg_list(cap_entry->cap.ecdsa_keygen_cap->curves);
                 amvp_cap_free_nl(cap_entry->cap.ecdsa_keygen_cap->secret_gen_modes);
-                free(cap_entry->cap.ecdsa_keygen_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.ecdsa_keygen_cap);
                 break;
             case AMVP_ECDSA_KEYVER_TYPE:
                 amvp_cap_free_ec_alg_list(cap_entry->cap.ecdsa_keyver_cap->curves);
                 amvp_cap_free_nl(cap_entry->cap.ecdsa_keyver_cap->secret_gen_modes);
-                free(cap_entry->cap.ecdsa_keyver_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.ecdsa_keyver_cap);
                 break;
             case AMVP_ECDSA_SIGGEN_TYPE:
                 amvp_cap_free_ec_alg_list(cap_entry->cap.ecdsa_siggen_cap->curves);
-                free(cap_entry->cap.ecdsa_siggen_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.ecdsa_siggen_cap);
                 break;
             case AMVP_ECDSA_SIGVER_TYPE:
                 amvp_cap_free_ec_alg_list(cap_entry->cap.ecdsa_sigver_cap->curves);
-                free(cap_entry->cap.ecdsa_sigver_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.ecdsa_sigver_cap);
                 break;
             case AMVP_KDF135_SRTP_TYPE:
                 amvp_cap_free_sl(cap_entry->cap.kdf135_srtp_cap->aes_keylens);
-                free(cap_entry->cap.kdf135_srtp_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kdf135_srtp_cap);
                 break;
             case AMVP_KDF108_TYPE:
                 amvp_cap_free_kdf108(cap_entry->cap.kdf108_cap);
-                free(cap_entry->cap.kdf108_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kdf108_cap);
                 break;
             case AMVP_KDF135_SNMP_TYPE:
                 amvp_cap_free_sl(cap_entry->cap.kdf135_snmp_cap->pass_lens);
                 amvp_cap_free_nl(cap_entry->cap.kdf135_snmp_cap->eng_ids);
-                free(cap_entry->cap.kdf135_snmp_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kdf135_snmp_cap);
                 break;
             case AMVP_KDF135_SSH_TYPE:
-                free(cap_entry->cap.kdf135_ssh_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kdf135_ssh_cap);
                 break;
             case AMVP_KDF135_IKEV2_TYPE:
                 amvp_cap_free_nl(cap_entry->cap.kdf135_ikev2_cap->hash_algs);
@@ -802,56 +1037,56 @@ AMVP_RESULT amvp_free_test_session(AMVP_CTX *ctx) {
                 amvp_cap_free_domain(&cap_entry->cap.kdf135_ikev2_cap->respond_nonce_len_domain);
                 amvp_cap_free_domain(&cap_entry->cap.kdf135_ikev2_cap->dh_secret_len);
                 amvp_cap_free_domain(&cap_entry->cap.kdf135_ikev2_cap->key_material_len);
-                free(cap_entry->cap.kdf135_ikev2_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kdf135_ikev2_cap);
                 break;
             case AMVP_KDF135_IKEV1_TYPE:
                 amvp_cap_free_nl(cap_entry->cap.kdf135_ikev1_cap->hash_algs);
-                free(cap_entry->cap.kdf135_ikev1_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kdf135_ikev1_cap);
                 break;
             case AMVP_KDF135_X942_TYPE:
                 amvp_cap_free_nl(cap_entry->cap.kdf135_x942_cap->hash_algs);
                 amvp_cap_free_nl(cap_entry->cap.kdf135_x942_cap->oids);
-                free(cap_entry->cap.kdf135_x942_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kdf135_x942_cap);
                 break;
             case AMVP_KDF135_X963_TYPE:
                 amvp_cap_free_nl(cap_entry->cap.kdf135_x963_cap->hash_algs);
                 amvp_cap_free_sl(cap_entry->cap.kdf135_x963_cap->shared_info_lengths);
                 amvp_cap_free_sl(cap_entry->cap.kdf135_x963_cap->field_sizes);
                 amvp_cap_free_sl(cap_entry->cap.kdf135_x963_cap->key_data_lengths);
-                free(cap_entry->cap.kdf135_x963_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kdf135_x963_cap);
                 break;
             case AMVP_PBKDF_TYPE:
                 amvp_cap_free_nl(cap_entry->cap.pbkdf_cap->hmac_algs);
-                free(cap_entry->cap.pbkdf_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.pbkdf_cap);
                 break;
             case AMVP_KDF_TLS13_TYPE:
                 amvp_cap_free_nl(cap_entry->cap.kdf_tls13_cap->hmac_algs);
                 amvp_cap_free_pl(cap_entry->cap.kdf_tls13_cap->running_mode);
-                free(cap_entry->cap.kdf_tls13_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kdf_tls13_cap);
                 break;
             case AMVP_KDF_TLS12_TYPE:
                 amvp_cap_free_nl(cap_entry->cap.kdf_tls12_cap->hash_algs);
-                free(cap_entry->cap.kdf_tls12_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.kdf_tls12_cap);
                 break;
             case AMVP_SAFE_PRIMES_KEYGEN_TYPE:
                 if (cap_entry->cap.safe_primes_keygen_cap->mode->genmeth) {
                     amvp_cap_free_pl(cap_entry->cap.safe_primes_keygen_cap->mode->genmeth);
                 }
-                free(cap_entry->cap.safe_primes_keygen_cap->mode);
-                free(cap_entry->cap.safe_primes_keygen_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.safe_primes_keygen_cap->mode);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.safe_primes_keygen_cap);
                 break;
             case AMVP_SAFE_PRIMES_KEYVER_TYPE:
                 if (cap_entry->cap.safe_primes_keyver_cap->mode->genmeth) {
                     amvp_cap_free_pl(cap_entry->cap.safe_primes_keyver_cap->mode->genmeth);
                 }
-                free(cap_entry->cap.safe_primes_keyver_cap->mode);
-                free(cap_entry->cap.safe_primes_keyver_cap);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.safe_primes_keyver_cap->mode);
+                amvp_mem_free(AMVP_MEM_CAPS, cap_entry->cap.safe_primes_keyver_cap);
                 break;
             case AMVP_KDF135_TPM_TYPE:
             default:
                 return AMVP_INVALID_ARG;
             }
-            free(cap_entry);
+            amvp_mem_free(AMVP_MEM_CAPS, cap_entry);
             cap_entry = cap_e2;
         }
     }
@@ -878,7 +1113,7 @@ static void amvp_cap_free_sl(AMVP_SL_LIST *list) {
     while (top) {
         tmp = top;
         top = top->next;
-        free(tmp);
+        amvp_mem_free(AMVP_MEM_CAPS, tmp);
     }
 }
 
@@ -893,7 +1128,7 @@ static void amvp_cap_free_pl(AMVP_PARAM_LIST *list) {
     while (top) {
         tmp = top;
         top = top->next;
-        free(tmp);
+        amvp_mem_free(AMVP_MEM_CAPS, tmp);
     }
 }
 
@@ -908,7 +1143,7 @@ static void amvp_cap_free_nl(AMVP_NAME_LIST *list) {
     while (top) {
         tmp = top;
         top = top->next;
-        free(tmp);
+        amvp_mem_free(AMVP_MEM_CAPS, tmp);
     }
 }
 
@@ -928,7 +1163,7 @@ static void amvp_cap_free_hash_pairs(AMVP_RSA_HASH_PAIR_LIST *list) {
         tmp = top;
 
         top = top->next;
-        free(tmp);
+        amvp_mem_free(AMVP_MEM_CAPS, tmp);
     }
 }
 
@@ -976,7 +1211,8 @@ AMVP_RESULT amvp_load_kat_filename(AMVP_CTX *ctx, const char *kat_filename) {
         return AMVP_INVALID_ARG;
     }
 
-    val = json_parse_file(kat_filename);
+    amvp_mem_vs_begin();
+    val = amvp_json_parse_file(kat_filename);
 
     reg_array = json_value_get_array(val);
     obj = json_array_get_object(reg_array, 1);
@@ -989,6 +1225,36 @@ AMVP_RESULT amvp_load_kat_filename(AMVP_CTX *ctx, const char *kat_filename) {
     /* Process the kat vector(s) */
     rv  = amvp_dispatch_vector_set(ctx, obj);
     json_value_free(val);
+    amvp_mem_vs_end(ctx);
+    return rv;
+}
+
+/*
+ * Append the response of one vector set, as left in kat_resp by its handler,
+ * to the offline response file
+ */
+static AMVP_RESULT amvp_offline_write_rsp(AMVP_CTX *ctx, AMVP_JSON_WRITER *writer, JSON_Value *rsp) {
+    JSON_Array *kat_arr = NULL;
+    JSON_Value *kat_val = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    unsigned long long start = 0;
+
+    /* The response for this vector set is the last element of kat_resp */
+    kat_arr = json_value_get_array(rsp);
+    kat_val = json_array_get_value(kat_arr, json_array_get_count(kat_arr) - 1);
+    if (!kat_val) {
+        AMVP_LOG_ERR("JSON val parse error");
+        return AMVP_JSON_ERR;
+    }
+    AMVP_LOG_STATUS("Writing vector set responses for vector set %d...",
+                    (int)json_object_get_number(json_value_get_object(kat_val), "vsId"));
+
+    start = amvp_perf_now();
+    rv = amvp_json_writer_append(writer, kat_val);
+    ctx->work.perf.serialize_ns += amvp_perf_now() - start;
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("File write error");
+    }
     return rv;
 }
 
@@ -1000,19 +1266,17 @@ AMVP_RESULT amvp_load_kat_filename(AMVP_CTX *ctx, const char *kat_filename) {
 AMVP_RESULT amvp_run_vectors_from_file(AMVP_CTX *ctx, const char *req_filename, const char *rsp_filename) {
     JSON_Object *obj = NULL;
     JSON_Value *val = NULL;
-    JSON_Array *reg_array;
-    JSON_Value *file_val = NULL;
-    JSON_Value *kat_val = NULL;
-    JSON_Array *kat_array;
-    JSON_Value *rsp_val = NULL;
+    JSON_Value *hdr_val = NULL;
+    AMVP_JSON_STREAM *stream = NULL;
+    AMVP_JSON_WRITER *writer = NULL;
     AMVP_RESULT rv = AMVP_SUCCESS;
-    int n, i;
+    unsigned long long start = 0;
+    int i, committed = 0, done = 0;
     AMVP_STRING_LIST *vs_entry;
     JSON_Array *vect_sets = NULL;
     const char *test_session_url = NULL;
     int vs_cnt = 0, isSample = 0;
     const char *jwt = NULL;
-    char *json_result = NULL;
 
     AMVP_LOG_STATUS("Beginning offline processing of vector sets...");
 
@@ -1029,12 +1293,19 @@ AMVP_RESULT amvp_run_vectors_from_file(AMVP_CTX *ctx, const char *req_filename,
         return AMVP_INVALID_ARG;
     }
 
-    val = json_parse_file(req_filename);
+    /*
+     * The request file is read one vector set at a time, only the
+     * header and the vector set being processed are held in memory
+     */
+    rv = amvp_json_stream_open(&stream, req_filename);
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("Unable to open request file %s", req_filename);
+        return rv;
+    }
 
-    n = 0;
-    reg_array = json_value_get_array(val);
-    obj = json_array_get_object(reg_array, n);
-    if (!obj) {
+    rv = amvp_json_stream_next(stream, &hdr_val);
+    obj = json_value_get_object(hdr_val);
+    if (rv != AMVP_SUCCESS || !obj) {
         AMVP_LOG_ERR("JSON obj parse error");
         goto end;
     }
@@ -1083,20 +1354,72 @@ AMVP_RESULT amvp_run_vectors_from_file(AMVP_CTX *ctx, const char *req_filename,
         AMVP_LOG_INFO("Received vsid_url=%s", vsid_url);
     }
 
-    n++;        /* bump past the version or url, jwt, url sets */
-    obj = json_array_get_object(reg_array, n);
-    if (!obj) {
-        AMVP_LOG_ERR("JSON obj parse error");
+    vs_entry = ctx->vsid_url_list;
+    if (!vs_entry) {
         goto end;
     }
 
-    vs_entry = ctx->vsid_url_list;
-    if (!vs_entry) {
+    /*
+     * Pick up where an interrupted run against this request file left off.
+     * The identifiers are the first element of the response file, so all
+     * but one of the committed elements are completed vector sets.
+     */
+    rv = amvp_json_writer_open(&writer, rsp_filename, req_filename,
+                               ctx->file_compress_level, &committed);
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("File write error");
+        goto end;
+    }
+    if (committed) {
+        done = committed - 1;
+        AMVP_LOG_STATUS("Resuming offline run, %d of %d vector sets already completed", done, vs_cnt);
+        rv = amvp_json_stream_skip(stream, done);
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("Unable to skip completed vector sets");
+            goto end;
+        }
+        for (i = 0; i < done && vs_entry; i++) {
+            vs_entry = vs_entry->next;
+        }
+    } else {
+        /* start the file with the '[' and identifiers array */
+        rv = amvp_json_writer_append(writer, hdr_val);
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("File write error");
+            goto end;
+        }
+    }
+
+    /* bump past the version or url, jwt, url sets */
+    amvp_mem_vs_begin();
+    start = amvp_perf_now();
+    rv = amvp_json_stream_next(stream, &val);
+    ctx->work.perf.parse_ns += amvp_perf_now() - start;
+    obj = json_value_get_object(val);
+    if (rv != AMVP_SUCCESS || (!obj && !done)) {
+        AMVP_LOG_ERR("JSON obj parse error");
         goto end;
     }
 
+    if (amvp_key_pool_start(ctx) != AMVP_SUCCESS) {
+        AMVP_LOG_WARN("Unable to start key pre-generation, keys will be generated on demand");
+    }
+
+#ifndef _WIN32
+    if (ctx->vs_workers > 1 && obj && vs_entry && vs_entry->next) {
+        rv = amvp_run_vectors_concurrent(ctx, stream, val, vs_cnt - done, writer);
+        val = NULL;
+        if (rv != AMVP_SUCCESS) {
+            goto end;
+        }
+        obj = NULL;
+    }
+#endif
+
     while (obj) {
         if (!vs_entry) {
+            AMVP_LOG_ERR("Request file has more vector sets than vectorSetUrls");
+            rv = AMVP_JSON_ERR;
             goto end;
         }
         /* Process the kat vector(s) */
@@ -1105,53 +1428,118 @@ AMVP_RESULT amvp_run_vectors_from_file(AMVP_CTX *ctx, const char *req_filename,
             AMVP_LOG_ERR("KAT dispatch error");
             goto end;
         }
-        AMVP_LOG_STATUS("Writing vector set responses for vector set %d...", ctx->vs_id);
-
-        /* 
-         * Convert the JSON from a fully qualified to a value that can be 
-         * added to the file. Kind of klumsy, but it works.
-         */
-        kat_array = json_value_get_array(ctx->kat_resp);
-        kat_val = json_array_get_value(kat_array, 1);
-        if (!kat_val) {
-            AMVP_LOG_ERR("JSON val parse error");
+        rv = amvp_offline_write_rsp(ctx, writer, ctx->work.kat_resp);
+        if (rv != AMVP_SUCCESS) {
             goto end;
         }
-        json_result = json_serialize_to_string_pretty(kat_val, NULL);
-        file_val = json_parse_string(json_result);
-        json_free_serialized_string(json_result);
+        amvp_perf_flush(ctx, ctx->work.cipher);
+        ctx->work.cipher = AMVP_CIPHER_START;
 
-        /* track first vector set with file count */
-        if (n == 1) {
+        /* Done with this vector set, release it before reading the next one */
+        json_value_free(ctx->work.kat_resp);
+        ctx->work.kat_resp = NULL;
+        json_value_free(val);
+        val = NULL;
+        amvp_mem_vs_end(ctx);
 
-            rsp_val = json_array_get_value(reg_array, 0);
-            /* start the file with the '[' and identifiers array */
-            rv = amvp_json_serialize_to_file_pretty_w(rsp_val, rsp_filename);
-            if (rv != AMVP_SUCCESS) {
-                AMVP_LOG_ERR("File write error");
-                json_value_free(file_val);
-                goto end;
-            }
-        } 
-        /* append vector sets */
-        rv = amvp_json_serialize_to_file_pretty_a(file_val, rsp_filename);
+        /* Parsing is counted towards the vector set that was read */
+        start = amvp_perf_now();
+        rv = amvp_json_stream_next(stream, &val);
+        ctx->work.perf.parse_ns += amvp_perf_now() - start;
         if (rv != AMVP_SUCCESS) {
-            AMVP_LOG_ERR("File write error");
-            json_value_free(file_val);
+            AMVP_LOG_ERR("JSON obj parse error");
             goto end;
         }
-
-        json_value_free(file_val);
-        file_val = NULL;
-        n++;
-        obj = json_array_get_object(reg_array, n);
+        obj = json_value_get_object(val);
         vs_entry = vs_entry->next;
     }
-    /* append the final ']' to make the JSON work */ 
-    rv = amvp_json_serialize_to_file_pretty_a(NULL, rsp_filename);
+    /* append the final ']', sync and move the file into place */
+    rv = amvp_json_writer_finish(writer);
+    writer = NULL;
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("File write error");
+        goto end;
+    }
     AMVP_LOG_STATUS("Completed processing of vector sets. Responses saved in specified file.");
 end:
-    json_value_free(val);
+    amvp_json_writer_abort(writer);
+    if (val) json_value_free(val);
+    if (hdr_val) json_value_free(hdr_val);
+    amvp_json_stream_close(stream);
+    return rv;
+}
+
+/*
+ * Whether a failed upload may succeed if it is sent again: only when the
+ * server could not be reached or answered with a 5xx. Any other answer is
+ * final, and an offline build has no server at all.
+ */
+static int amvp_upload_retryable(AMVP_CTX *ctx) {
+#ifdef AMVP_OFFLINE
+    return 0;
+#else
+    return !ctx->work.http_code || (ctx->work.http_code >= 500 && ctx->work.http_code < 600);
+#endif
+}
+
+/*
+ * Post the response of one vector set read from a response file and record
+ * the outcome in status. A failure that amvp_upload_retryable() allows is
+ * retried up to AMVP_UPLOAD_RETRY_MAX times; an expired JWT is refreshed by
+ * the transport layer itself. Takes ownership of vs_val.
+ */
+static AMVP_RESULT amvp_upload_vs_rsp(AMVP_CTX *ctx, char *vsid_url, JSON_Value *vs_val, AMVP_UPLOAD_STATUS *status) {
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    JSON_Value *vec_array_val = NULL;
+    char *json_result = NULL;
+    int attempt = 0;
+
+    /* check vsId compared to vs URL */
+    ctx->work.vs_id = json_object_get_number(json_value_get_object(vs_val), "vsId");
+    status->vs_id = ctx->work.vs_id;
+
+    /* The response array takes ownership of the vector set */
+    vec_array_val = json_value_init_array();
+    if (!vec_array_val) {
+        json_value_free(vs_val);
+        status->rv = AMVP_MALLOC_FAIL;
+        return status->rv;
+    }
+    json_array_append_value(json_array(vec_array_val), vs_val);
+    ctx->work.kat_resp = vec_array_val;
+
+    if (ctx->log_lvl == AMVP_LOG_LVL_VERBOSE) {
+        json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
+        printf("\n\n%s\n\n", json_result);
+        json_free_serialized_string(json_result);
+    } else if (ctx->log_lvl >= AMVP_LOG_LVL_INFO) {
+        json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
+        AMVP_LOG_INFO("\n\n%s\n\n", json_result);
+        json_free_serialized_string(json_result);
+    }
+
+    AMVP_LOG_STATUS("Sending responses for vector set %d", ctx->work.vs_id);
+    while (1) {
+        ctx->work.http_code = 0;
+        rv = amvp_submit_vector_responses(ctx, vsid_url);
+        if (rv != AMVP_TRANSPORT_FAIL || !amvp_upload_retryable(ctx) || attempt++ >= AMVP_UPLOAD_RETRY_MAX) {
+            break;
+        }
+        AMVP_LOG_WARN("Upload of vector set %d failed (HTTP status %d), retrying in %d seconds...",
+                      ctx->work.vs_id, ctx->work.http_code, AMVP_UPLOAD_RETRY_TIME * attempt);
+        if (amvp_replay_fast(ctx)) {
+            continue;
+        }
+#ifdef _WIN32
+        Sleep(AMVP_UPLOAD_RETRY_TIME * attempt * 1000);
+#else
+        sleep(AMVP_UPLOAD_RETRY_TIME * attempt);
+#endif
+    }
+
+    json_value_free(vec_array_val);
+    ctx->work.kat_resp = NULL;
+    status->rv = rv;
     return rv;
 }
 
@@ -1161,21 +1549,17 @@ end:
  */
 AMVP_RESULT amvp_upload_vectors_from_file(AMVP_CTX *ctx, const char *rsp_filename, int fips_validation) {
     JSON_Object *obj = NULL;
-    JSON_Object *rsp_obj = NULL;
     JSON_Value *vs_val = NULL;
-    JSON_Value *new_val = NULL;
     JSON_Value *val = NULL;
+    AMVP_JSON_STREAM *stream = NULL;
     AMVP_RESULT rv = AMVP_SUCCESS;
-    JSON_Array *reg_array;
-    int n, i;
+    int i;
     AMVP_STRING_LIST *vs_entry;
     JSON_Array *vect_sets = NULL;
     const char *test_session_url = NULL;
     int vs_cnt = 0, isSample = 0;
     const char *jwt = NULL;
-    char *json_result = NULL;
-    JSON_Array *vec_array = NULL;
-    JSON_Value *vec_array_val = NULL;
+    AMVP_UPLOAD_STATUS *status = NULL;
 
     AMVP_LOG_STATUS("Uploading vectors from response file...");
 
@@ -1192,13 +1576,19 @@ AMVP_RESULT amvp_upload_vectors_from_file(AMVP_CTX *ctx, const char *rsp_filenam
         return AMVP_INVALID_ARG;
     }
 
-    val = json_parse_file(rsp_filename);
-    if (!val) {
+    /* Responses are read and submitted one vector set at a time */
+    rv = amvp_json_stream_open(&stream, rsp_filename);
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("Unable to open response file %s", rsp_filename);
+        return rv;
+    }
+    rv = amvp_json_stream_next(stream, &val);
+    if (rv != AMVP_SUCCESS) {
         AMVP_LOG_ERR("JSON val parse error");
-        return AMVP_MALFORMED_JSON;
+        rv = AMVP_MALFORMED_JSON;
+        goto end;
     }
-    reg_array = json_value_get_array(val);
-    obj = json_array_get_object(reg_array, 0);
+    obj = json_value_get_object(val);
     if (!obj) {
         AMVP_LOG_ERR("JSON obj parse error");
         rv = AMVP_MALFORMED_JSON;
@@ -1276,47 +1666,59 @@ AMVP_RESULT amvp_upload_vectors_from_file(AMVP_CTX *ctx, const char *rsp_filenam
         ctx->fips.do_validation = 0; /* Disable */
     }
 
-    n = 1;    /* start with second array index */
-    reg_array = json_value_get_array(val);
-    vs_val = json_array_get_value(reg_array, n);
-
-    while (vs_entry) {
-
-        /* check vsId compared to vs URL */
-        rsp_obj = json_array_get_object(reg_array, n);
-        ctx->vs_id = json_object_get_number(rsp_obj, "vsId");
-
-        vec_array_val = json_value_init_array();
-        vec_array = json_array((const JSON_Value *)vec_array_val);
-
-        json_result = json_serialize_to_string_pretty(vs_val, NULL);
-        new_val = json_parse_string(json_result);
-        json_free_serialized_string(json_result);
-
-        json_array_append_value(vec_array, new_val);
+    status = calloc(vs_cnt, sizeof(AMVP_UPLOAD_STATUS));
+    if (!status) {
+        rv = AMVP_MALLOC_FAIL;
+        goto end;
+    }
 
-        ctx->kat_resp = vec_array_val;
+    /* start with second array index */
+    rv = amvp_json_stream_next(stream, &vs_val);
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("JSON val parse error");
+        goto end;
+    }
 
-        json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
-        if (ctx->log_lvl == AMVP_LOG_LVL_VERBOSE) {
-            printf("\n\n%s\n\n", json_result);
-        } else {
-            AMVP_LOG_INFO("\n\n%s\n\n", json_result);
+#ifndef _WIN32
+    if (ctx->vs_workers > 1 && vs_entry->next) {
+        rv = amvp_upload_concurrent(ctx, stream, vs_val, status, vs_cnt);
+        vs_val = NULL;
+        if (rv != AMVP_SUCCESS) {
+            goto end;
         }
-        json_free_serialized_string(json_result);
-        AMVP_LOG_STATUS("Sending responses for vector set %d", ctx->vs_id);
-        rv = amvp_submit_vector_responses(ctx, vs_entry->string);
+        vs_entry = NULL;
+    }
+#endif
+    for (i = 0; vs_entry; i++) {
+        if (!json_value_get_object(vs_val)) {
+            AMVP_LOG_ERR("Response file has fewer vector sets than the session");
+            rv = AMVP_MALFORMED_JSON;
+            goto end;
+        }
+        rv = amvp_upload_vs_rsp(ctx, vs_entry->string, vs_val, &status[i]);
+        vs_val = NULL;
         if (rv != AMVP_SUCCESS) {
             AMVP_LOG_ERR("Failed to submit test results for vector set - skipping...");
         }
 
-        json_value_free(vec_array_val);
-        ctx->kat_resp = NULL;
-        n++;
-        vs_val = json_array_get_value(reg_array, n);
+        rv = amvp_json_stream_next(stream, &vs_val);
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("JSON val parse error");
+            goto end;
+        }
         vs_entry = vs_entry->next;
     }
 
+    AMVP_LOG_STATUS("Upload summary:");
+    for (i = 0; i < vs_cnt; i++) {
+        if (status[i].rv == AMVP_SUCCESS) {
+            AMVP_LOG_STATUS("    vsId %d: uploaded", status[i].vs_id);
+        } else {
+            AMVP_LOG_STATUS("    vsId %d: failed (%s)", status[i].vs_id,
+                            amvp_lookup_error_string(status[i].rv));
+        }
+    }
+
     /*
      * Check the test results.
      */
@@ -1343,7 +1745,10 @@ AMVP_RESULT amvp_upload_vectors_from_file(AMVP_CTX *ctx, const char *rsp_filenam
         }
     }
 end:
+    if (status) free(status);
+    if (vs_val) json_value_free(vs_val);
     json_value_free(val);
+    amvp_json_stream_close(stream);
     return rv;
 }
 
@@ -1418,7 +1823,7 @@ AMVP_RESULT amvp_get_expected_results(AMVP_CTX *ctx, const char *request_filenam
         goto end;
     }
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->work.curl_buf);
     if (!val) {
         AMVP_LOG_ERR("Error while parsing json from server!");
         rv = AMVP_JSON_ERR;
@@ -1461,7 +1866,7 @@ AMVP_RESULT amvp_get_expected_results(AMVP_CTX *ctx, const char *request_filenam
         }
         json_object_set_string(fw_obj, "jwt", ctx->jwt_token);
         json_object_set_string(fw_obj, "url", ctx->session_url);
-        rv = amvp_json_serialize_to_file_pretty_w(fw_val, save_filename);
+        rv = amvp_json_serialize_to_file_pretty_w(ctx, fw_val, save_filename);
         if (rv != AMVP_SUCCESS) {
             AMVP_LOG_ERR("Error writing to provided file.");
             json_value_free(fw_val);
@@ -1501,14 +1906,14 @@ AMVP_RESULT amvp_get_expected_results(AMVP_CTX *ctx, const char *request_filenam
 
         //If save_filename != null, we are saving to file, otherwise log it all
         if (save_filename) {
-            fw_val = json_parse_string(ctx->curl_buf);
+            fw_val = json_parse_string(ctx->work.curl_buf);
             if (!fw_val) {
                 AMVP_LOG_ERR("Error parsing JSON from server response");
                 rv = AMVP_TRANSPORT_FAIL;
                 goto end;
             }
             /* append data */
-            rv = amvp_json_serialize_to_file_pretty_a(fw_val, save_filename);
+            rv = amvp_json_serialize_to_file_pretty_a(ctx, fw_val, save_filename);
             if (rv != AMVP_SUCCESS) {
                 AMVP_LOG_ERR("Error writing to file");
                 goto end;
@@ -1516,12 +1921,12 @@ AMVP_RESULT amvp_get_expected_results(AMVP_CTX *ctx, const char *request_filenam
             json_value_free(fw_val);
             fw_val = NULL;
         } else {
-            printf("%s,\n", ctx->curl_buf);
+            printf("%s,\n", ctx->work.curl_buf);
         }
         vsid_url = NULL;
     }
     //append the final ']'
-    rv = amvp_json_serialize_to_file_pretty_a(NULL, save_filename);
+    rv = amvp_json_serialize_to_file_pretty_a(ctx, NULL, save_filename);
     AMVP_LOG_STATUS("Completed output of expected results.");
 end:
    if (fw_val) json_value_free(fw_val);
@@ -1529,6 +1934,299 @@ end:
    return rv;
 }
 
+/*
+ * One expected test case, indexed on (vsId, tgId, tcId)
+ */
+typedef struct amvp_expected_tc_t {
+    int vs_id;
+    int tg_id;
+    int tc_id;
+    int seen;
+    JSON_Object *tc;
+    struct amvp_expected_tc_t *next;
+} AMVP_EXPECTED_TC;
+
+typedef struct amvp_expected_index_t {
+    AMVP_EXPECTED_TC *buckets[AMVP_VERIFY_BUCKETS];
+    JSON_Value **vals;      /* parsed vector sets owning the indexed test cases */
+    int val_cnt;
+    int val_max;
+} AMVP_EXPECTED_INDEX;
+
+static unsigned int amvp_expected_hash(int vs_id, int tg_id, int tc_id) {
+    unsigned int h = 2166136261u;
+
+    h = (h ^ (unsigned int)vs_id) * 16777619u;
+    h = (h ^ (unsigned int)tg_id) * 16777619u;
+    h = (h ^ (unsigned int)tc_id) * 16777619u;
+    return h & (AMVP_VERIFY_BUCKETS - 1);
+}
+
+static AMVP_EXPECTED_TC *amvp_expected_lookup(AMVP_EXPECTED_INDEX *index, int vs_id, int tg_id, int tc_id) {
+    AMVP_EXPECTED_TC *entry = index->buckets[amvp_expected_hash(vs_id, tg_id, tc_id)];
+
+    while (entry) {
+        if (entry->vs_id == vs_id && entry->tg_id == tg_id && entry->tc_id == tc_id) {
+            return entry;
+        }
+        entry = entry->next;
+    }
+    return NULL;
+}
+
+static void amvp_expected_index_free(AMVP_EXPECTED_INDEX *index) {
+    AMVP_EXPECTED_TC *entry = NULL, *next = NULL;
+    int i;
+
+    if (!index) {
+        return;
+    }
+    for (i = 0; i < AMVP_VERIFY_BUCKETS; i++) {
+        entry = index->buckets[i];
+        while (entry) {
+            next = entry->next;
+            free(entry);
+            entry = next;
+        }
+    }
+    for (i = 0; i < index->val_cnt; i++) {
+        json_value_free(index->vals[i]);
+    }
+    if (index->vals) free(index->vals);
+    free(index);
+}
+
+/*
+ * Expected results and responses are either a bare vector set object or
+ * the server's [{version}, {vector set}] array. Returns NULL for anything
+ * else, such as the session header at the start of both files.
+ */
+static JSON_Object *amvp_verify_get_vs(JSON_Value *val) {
+    JSON_Array *arr = NULL;
+    JSON_Object *obj = NULL;
+    int i, count;
+
+    obj = json_value_get_object(val);
+    if (obj) {
+        return json_object_has_value(obj, "testGroups") ? obj : NULL;
+    }
+    arr = json_value_get_array(val);
+    count = (int)json_array_get_count(arr);
+    for (i = 0; i < count; i++) {
+        obj = json_array_get_object(arr, i);
+        if (obj && json_object_has_value(obj, "testGroups")) {
+            return obj;
+        }
+    }
+    return NULL;
+}
+
+static AMVP_RESULT amvp_expected_index_add(AMVP_EXPECTED_INDEX *index, JSON_Value *val) {
+    AMVP_EXPECTED_TC *entry = NULL;
+    JSON_Object *vs_obj = NULL, *group = NULL, *tc = NULL;
+    JSON_Array *groups = NULL, *tests = NULL;
+    JSON_Value **vals = NULL;
+    unsigned int h;
+    int vs_id, tg_id, g_cnt, t_cnt, i, j;
+
+    vs_obj = amvp_verify_get_vs(val);
+    if (!vs_obj) {
+        json_value_free(val);
+        return AMVP_SUCCESS;
+    }
+    if (index->val_cnt == index->val_max) {
+        vals = realloc(index->vals, (index->val_max + 16) * sizeof(JSON_Value *));
+        if (!vals) {
+            json_value_free(val);
+            return AMVP_MALLOC_FAIL;
+        }
+        index->vals = vals;
+        index->val_max += 16;
+    }
+    index->vals[index->val_cnt++] = val;
+
+    vs_id = (int)json_object_get_number(vs_obj, "vsId");
+    groups = json_object_get_array(vs_obj, "testGroups");
+    g_cnt = (int)json_array_get_count(groups);
+    for (i = 0; i < g_cnt; i++) {
+        group = json_array_get_object(groups, i);
+        tg_id = (int)json_object_get_number(group, "tgId");
+        tests = json_object_get_array(group, "tests");
+        t_cnt = (int)json_array_get_count(tests);
+        for (j = 0; j < t_cnt; j++) {
+            tc = json_array_get_object(tests, j);
+            if (!tc) {
+                continue;
+            }
+            entry = calloc(1, sizeof(AMVP_EXPECTED_TC));
+            if (!entry) {
+                return AMVP_MALLOC_FAIL;
+            }
+            entry->vs_id = vs_id;
+            entry->tg_id = tg_id;
+            entry->tc_id = (int)json_object_get_number(tc, "tcId");
+            entry->tc = tc;
+            h = amvp_expected_hash(vs_id, tg_id, entry->tc_id);
+            entry->next = index->buckets[h];
+            index->buckets[h] = entry;
+        }
+    }
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Logs one mismatched field, with both values cut to AMVP_VERIFY_VALUE_MAX
+ */
+static void amvp_verify_log_field(AMVP_CTX *ctx, AMVP_EXPECTED_TC *entry, const char *field,
+                                  const JSON_Value *expected, const JSON_Value *actual) {
+    char *exp_str = NULL, *act_str = NULL;
+
+    exp_str = json_serialize_to_string(expected, NULL);
+    if (actual) {
+        act_str = json_serialize_to_string(actual, NULL);
+    }
+    AMVP_LOG_ERR("vsId %d tgId %d tcId %d: %s expected %.*s, got %.*s", entry->vs_id, entry->tg_id,
+                 entry->tc_id, field, AMVP_VERIFY_VALUE_MAX, exp_str ? exp_str : "?",
+                 AMVP_VERIFY_VALUE_MAX, act_str ? act_str : "nothing");
+    json_free_serialized_string(exp_str);
+    json_free_serialized_string(act_str);
+}
+
+/*
+ * Compares every field of the expected test case with the response and
+ * returns the number of fields that differ.
+ */
+static int amvp_verify_tc(AMVP_CTX *ctx, AMVP_EXPECTED_TC *entry, JSON_Object *rsp_tc) {
+    const char *field = NULL;
+    JSON_Value *expected = NULL, *actual = NULL;
+    int i, count, mismatches = 0;
+
+    count = (int)json_object_get_count(entry->tc);
+    for (i = 0; i < count; i++) {
+        field = json_object_get_name(entry->tc, i);
+        if (!strcmp(field, "tcId")) {
+            continue;
+        }
+        expected = json_object_get_value_at(entry->tc, i);
+        actual = json_object_get_value(rsp_tc, field);
+        if (!actual || !json_value_equals(expected, actual)) {
+            amvp_verify_log_field(ctx, entry, field, expected, actual);
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+AMVP_RESULT amvp_verify_expected_results(AMVP_CTX *ctx, const char *rsp_filename,
+                                         const char *expected_filename, int *mismatch_cnt) {
+    AMVP_EXPECTED_INDEX *index = NULL;
+    AMVP_EXPECTED_TC *entry = NULL;
+    AMVP_JSON_STREAM *stream = NULL;
+    JSON_Value *val = NULL;
+    JSON_Object *vs_obj = NULL, *group = NULL, *tc = NULL;
+    JSON_Array *groups = NULL, *tests = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int vs_id, tg_id, tc_id, g_cnt, t_cnt, i, j;
+    int tc_cnt = 0, tc_failed = 0, field_cnt = 0;
+
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!rsp_filename || !expected_filename || !mismatch_cnt) {
+        AMVP_LOG_ERR("Must provide response file, expected results file and mismatch count");
+        return AMVP_MISSING_ARG;
+    }
+    *mismatch_cnt = 0;
+
+    index = calloc(1, sizeof(AMVP_EXPECTED_INDEX));
+    if (!index) {
+        return AMVP_MALLOC_FAIL;
+    }
+
+    /* Index the expected results one vector set at a time */
+    rv = amvp_json_stream_open(&stream, expected_filename);
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("Unable to open expected results file %s", expected_filename);
+        goto end;
+    }
+    while ((rv = amvp_json_stream_next(stream, &val)) == AMVP_SUCCESS && val) {
+        rv = amvp_expected_index_add(index, val);
+        val = NULL;
+        if (rv != AMVP_SUCCESS) {
+            goto end;
+        }
+    }
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("Unable to parse expected results file %s", expected_filename);
+        goto end;
+    }
+    amvp_json_stream_close(stream);
+    stream = NULL;
+
+    /* Stream the responses and check each test case against the index */
+    rv = amvp_json_stream_open(&stream, rsp_filename);
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("Unable to open response file %s", rsp_filename);
+        goto end;
+    }
+    while ((rv = amvp_json_stream_next(stream, &val)) == AMVP_SUCCESS && val) {
+        vs_obj = amvp_verify_get_vs(val);
+        vs_id = (int)json_object_get_number(vs_obj, "vsId");
+        groups = json_object_get_array(vs_obj, "testGroups");
+        g_cnt = (int)json_array_get_count(groups);
+        for (i = 0; i < g_cnt; i++) {
+            group = json_array_get_object(groups, i);
+            tg_id = (int)json_object_get_number(group, "tgId");
+            tests = json_object_get_array(group, "tests");
+            t_cnt = (int)json_array_get_count(tests);
+            for (j = 0; j < t_cnt; j++) {
+                tc = json_array_get_object(tests, j);
+                if (!tc) {
+                    continue;
+                }
+                tc_id = (int)json_object_get_number(tc, "tcId");
+                tc_cnt++;
+                entry = amvp_expected_lookup(index, vs_id, tg_id, tc_id);
+                if (!entry) {
+                    AMVP_LOG_ERR("vsId %d tgId %d tcId %d: no expected result", vs_id, tg_id, tc_id);
+                    tc_failed++;
+                    (*mismatch_cnt)++;
+                    continue;
+                }
+                entry->seen = 1;
+                field_cnt = amvp_verify_tc(ctx, entry, tc);
+                if (field_cnt) {
+                    *mismatch_cnt += field_cnt;
+                    tc_failed++;
+                }
+            }
+        }
+        json_value_free(val);
+        val = NULL;
+    }
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("Unable to parse response file %s", rsp_filename);
+        goto end;
+    }
+
+    for (i = 0; i < AMVP_VERIFY_BUCKETS; i++) {
+        for (entry = index->buckets[i]; entry; entry = entry->next) {
+            if (!entry->seen) {
+                AMVP_LOG_ERR("vsId %d tgId %d tcId %d: no response", entry->vs_id, entry->tg_id, entry->tc_id);
+                (*mismatch_cnt)++;
+            }
+        }
+    }
+
+    AMVP_LOG_STATUS("Verified %d test cases against expected results: %d failed, %d mismatches",
+                    tc_cnt, tc_failed, *mismatch_cnt);
+end:
+    if (val) json_value_free(val);
+    amvp_json_stream_close(stream);
+    amvp_expected_index_free(index);
+    return rv;
+}
+
 /**
  * Allows application to continue a previous test session by checking which KAT responses the server is missing
  */
@@ -1536,6 +2234,10 @@ AMVP_RESULT amvp_resume_test_session(AMVP_CTX *ctx, const char *request_filename
     JSON_Value *val = NULL;
     JSON_Object *obj = NULL;
     AMVP_RESULT rv = AMVP_SUCCESS;
+    AMVP_STRING_LIST *pending = NULL;
+#ifndef _WIN32
+    AMVP_RESULTS_MONITOR *monitor = NULL;
+#endif
     
     if (!ctx) {
         return AMVP_NO_CTX;
@@ -1564,7 +2266,7 @@ AMVP_RESULT amvp_resume_test_session(AMVP_CTX *ctx, const char *request_filename
         goto end;
     }
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->work.curl_buf);
     if (!val) {
         AMVP_LOG_ERR("Error while parsing json from server!");
         rv = AMVP_JSON_ERR;
@@ -1605,7 +2307,8 @@ AMVP_RESULT amvp_resume_test_session(AMVP_CTX *ctx, const char *request_filename
     count = (int)json_array_get_count(results);
     JSON_Object *current = NULL;
     const char *vsid_url = NULL, *status = NULL;
-    
+    int unreceived = 0;
+
     for (i = 0; i < count; i++) {
         int diff = 1;
         current = json_array_get_object(results, i);
@@ -1653,6 +2356,21 @@ AMVP_RESULT amvp_resume_test_session(AMVP_CTX *ctx, const char *request_filename
                     AMVP_LOG_ERR("Error resuming session");
                     goto end;
                 }
+                unreceived++;
+                continue;
+            }
+
+            /*
+             * Responses to incomplete vector sets were received but not yet
+             * graded, they are watched while the others are processed
+             */
+            strcmp_s("incomplete", 10, status, &diff);
+            if (!diff) {
+                rv = amvp_append_str_list(&pending, vsid_url);
+                if (rv != AMVP_SUCCESS) {
+                    AMVP_LOG_ERR("Error resuming session");
+                    goto end;
+                }
             }
         }
     }
@@ -1661,7 +2379,20 @@ AMVP_RESULT amvp_resume_test_session(AMVP_CTX *ctx, const char *request_filename
         AMVP_LOG_STATUS("All vector set results already uploaded. Nothing to resume.");
         goto end;
     } else {
+        if (!ctx->vector_req) {
+            AMVP_LOG_STATUS("%d of %d vector sets need responses, the others were already submitted",
+                            unreceived, count);
+        }
+#ifndef _WIN32
+        if (pending) {
+            monitor = amvp_results_monitor_start(ctx, pending);
+        }
+#endif
         rv = amvp_process_tests(ctx);
+#ifndef _WIN32
+        amvp_results_monitor_stop(monitor);
+        monitor = NULL;
+#endif
         if (rv != AMVP_SUCCESS) {
             AMVP_LOG_ERR("Failed to process vectors");
             goto end;
@@ -1697,6 +2428,7 @@ AMVP_RESULT amvp_resume_test_session(AMVP_CTX *ctx, const char *request_filename
         }
     }
 end:
+    if (pending) amvp_free_str_list(&pending);
     if (val) json_value_free(val);
     return rv;
 }
@@ -1743,22 +2475,22 @@ AMVP_RESULT amvp_cancel_test_session(AMVP_CTX *ctx, const char *request_filename
     }
     if (save_filename) {
         AMVP_LOG_STATUS("Saving cancel request response to specified file...");
-        val = json_parse_string(ctx->curl_buf);
+        val = json_parse_string(ctx->work.curl_buf);
         if (!val) {
             AMVP_LOG_ERR("Unable to parse JSON. printing output instead...");
         } else {
-            rv = amvp_json_serialize_to_file_pretty_w(val, save_filename);
+            rv = amvp_json_serialize_to_file_pretty_w(ctx, val, save_filename);
             if (rv != AMVP_SUCCESS) {
                 AMVP_LOG_ERR("Failed to write file, printing instead...");
             } else {
-                rv = amvp_json_serialize_to_file_pretty_a(NULL, save_filename);
+                rv = amvp_json_serialize_to_file_pretty_a(ctx, NULL, save_filename);
                 if (rv != AMVP_SUCCESS)
                     AMVP_LOG_WARN("Unable to append ending ] to write file");
                 goto end;
             }
         }
     }
-    AMVP_LOG_STATUS("DELETE Response:\n\n%s\n", ctx->curl_buf);
+    AMVP_LOG_STATUS("DELETE Response:\n\n%s\n", ctx->work.curl_buf);
 
 end:
     if (val) json_value_free(val);
@@ -2260,9 +2992,12 @@ static AMVP_RESULT amvp_register(AMVP_CTX *ctx) {
 
     JSON_Value *tmp_json = NULL;
     JSON_Array *tmp_arr = NULL;
+    unsigned long long start = 0;
     if (!ctx) {
         return AMVP_NO_CTX;
     }
+    start = amvp_trace_begin(ctx);
+    AMVP_PROBE(registration_start);
 
     /*
      * Send the capabilities to the AMVP server and get the response,
@@ -2270,7 +3005,7 @@ static AMVP_RESULT amvp_register(AMVP_CTX *ctx) {
      */
     if (ctx->use_json) {
         AMVP_LOG_STATUS("Reading capabilities registration file...");
-        tmp_json = json_parse_file(ctx->json_filename);
+        tmp_json = amvp_json_parse_file(ctx->json_filename);
         if (!tmp_json) {
             AMVP_LOG_ERR("Error reading capabilities file");
             rv = AMVP_JSON_ERR;
@@ -2323,6 +3058,8 @@ static AMVP_RESULT amvp_register(AMVP_CTX *ctx) {
     }
 
 end:
+    amvp_trace_span(ctx, "session", "registration", start, 0, NULL);
+    AMVP_PROBE3(registration_done, rv, reg_len, ctx->work.curl_read_ctr);
     if (reg) json_free_serialized_string(reg);
     return rv;
 }
@@ -2343,7 +3080,7 @@ static AMVP_RESULT amvp_parse_mod_cert_req(AMVP_CTX *ctx) {
     /*
      * Parse the JSON
      */
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->work.curl_buf);
     if (!val) {
         AMVP_LOG_ERR("JSON parse error");
         return AMVP_JSON_ERR;
@@ -2402,6 +3139,17 @@ end:
     return rv;
 }
 
+#ifdef AMVP_USDT
+/*
+ * The id at the end of a vector set URL, for the USDT probes
+ */
+static int amvp_url_id(const char *url) {
+    const char *id = url ? strrchr(url, '/') : NULL;
+
+    return id ? atoi(id + 1) : 0;
+}
+#endif
+
 /*
  * This function will process a single KAT vector set.  Each KAT
  * vector set has an identifier associated with it, called
@@ -2428,14 +3176,25 @@ static AMVP_RESULT amvp_process_teid(AMVP_CTX *ctx, char *vsid_url, int count) {
     int retry_period = 0;
     int retry = 1;
     unsigned int time_waited_so_far = 0;
+    unsigned long long start = 0;
+
+    /* Login and registration are not part of this vector set */
+    amvp_perf_flush(ctx, AMVP_CIPHER_START);
+    amvp_mem_vs_begin();
     while (retry) {
         /*
          * Get the KAT vector set
          */
+        AMVP_PROBE1(download_start, amvp_url_id(vsid_url));
+        start = amvp_trace_begin(ctx);
         rv = amvp_retrieve_vector_set(ctx, vsid_url);
+        amvp_trace_span(ctx, "vector set", "download", start, 0, vsid_url);
+        AMVP_PROBE3(download_done, amvp_url_id(vsid_url), rv, ctx->work.curl_read_ctr);
         if (rv != AMVP_SUCCESS) goto end;
 
-        val = json_parse_string(ctx->curl_buf);
+        start = amvp_perf_now();
+        val = json_parse_string(ctx->work.curl_buf);
+        ctx->work.perf.parse_ns += amvp_perf_now() - start;
         if (!val) {
             AMVP_LOG_ERR("JSON parse error");
             rv = AMVP_JSON_ERR;
@@ -2485,7 +3244,7 @@ static AMVP_RESULT amvp_process_teid(AMVP_CTX *ctx, char *vsid_url, int count) {
                         vs_entry = vs_entry->next;
                     }
                     /* Start with identifiers */
-                    rv = amvp_json_serialize_to_file_pretty_w(ts_val, ctx->vector_req_file);
+                    rv = amvp_json_serialize_to_file_pretty_w(ctx, ts_val, ctx->vector_req_file);
                     if (rv != AMVP_SUCCESS) {
                         AMVP_LOG_ERR("File write error");
                         json_value_free(ts_val);
@@ -2493,7 +3252,7 @@ static AMVP_RESULT amvp_process_teid(AMVP_CTX *ctx, char *vsid_url, int count) {
                     }
                 } 
                 /* append the TE groups */
-                rv = amvp_json_serialize_to_file_pretty_a(set_val, ctx->vector_req_file);
+                rv = amvp_json_serialize_to_file_pretty_a(ctx, set_val, ctx->vector_req_file);
                 json_value_free(ts_val);
                 goto end;
             }
@@ -2513,11 +3272,18 @@ static AMVP_RESULT amvp_process_teid(AMVP_CTX *ctx, char *vsid_url, int count) {
     /*
      * Send the responses to the AMVP server
      */
-    AMVP_LOG_STATUS("Posting ie set responses for vsId %d to URL: %s...", ctx->vs_id, vsid_url);
+    AMVP_LOG_STATUS("Posting ie set responses for vsId %d to URL: %s...", ctx->work.vs_id, vsid_url);
+    AMVP_PROBE1(upload_start, ctx->work.vs_id);
+    start = amvp_trace_begin(ctx);
     rv = amvp_submit_vector_responses(ctx, vsid_url);
+    amvp_trace_span(ctx, "vector set", "upload", start, ctx->work.vs_id, vsid_url);
+    AMVP_PROBE3(upload_done, ctx->work.vs_id, rv, ctx->work.perf.bytes_out);
 
 end:
+    amvp_perf_flush(ctx, ctx->work.cipher);
+    ctx->work.cipher = AMVP_CIPHER_START;
     if (val) json_value_free(val);
+    amvp_mem_vs_end(ctx);
     return rv;
 }
 
@@ -2557,7 +3323,7 @@ AMVP_RESULT amvp_process_amvp_tes(AMVP_CTX *ctx) {
     }
     /* Need to add the ending ']' here */
     if (ctx->vector_req) {
-        rv = amvp_json_serialize_to_file_pretty_a(NULL, ctx->vector_req_file);
+        rv = amvp_json_serialize_to_file_pretty_a(ctx, NULL, ctx->vector_req_file);
     }
     return rv;
 }
@@ -2585,7 +3351,7 @@ AMVP_RESULT amvp_mod_cert_req(AMVP_CTX *ctx) {
      * which should be a list of vector set ID urls
      */
     AMVP_LOG_STATUS("Reading module cert request file...");
-    tmp_json = json_parse_file(ctx->mod_cert_req_file);
+    tmp_json = amvp_json_parse_file(ctx->mod_cert_req_file);
     if (!tmp_json) {
         AMVP_LOG_ERR("Error reading capabilities file");
         rv = AMVP_JSON_ERR;
@@ -2682,7 +3448,7 @@ static AMVP_RESULT amvp_append_vsid_url(AMVP_CTX *ctx, const char *vsid_url) {
 static AMVP_RESULT amvp_parse_login(AMVP_CTX *ctx) {
     JSON_Value *val;
     JSON_Object *obj = NULL;
-    char *json_buf = ctx->curl_buf;
+    char *json_buf = ctx->work.curl_buf;
     const char *jwt;
 #ifdef AMVP_DEPRECATED
     int large_required = 0;
@@ -2742,7 +3508,7 @@ static AMVP_RESULT amvp_parse_validation(AMVP_CTX *ctx) {
     /*
      * Parse the JSON
      */
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->work.curl_buf);
     if (!val) {
         AMVP_LOG_ERR("JSON parse error");
         return AMVP_JSON_ERR;
@@ -2771,7 +3537,7 @@ static AMVP_RESULT amvp_parse_validation(AMVP_CTX *ctx) {
     AMVP_LOG_STATUS("Validation requested -- status %s -- url: %s", status, url);
     /* save the request URL to the test session info file, if it is saved in the CTX. */
     if (ctx->session_file_path) {
-        ts_val = json_parse_file(ctx->session_file_path);
+        ts_val = amvp_json_parse_file(ctx->session_file_path);
         if (!ts_val) {
             AMVP_LOG_WARN("Failed to save request URL to test session file. Make sure you save it from output!");
             goto end;
@@ -2797,12 +3563,12 @@ static AMVP_RESULT amvp_parse_validation(AMVP_CTX *ctx) {
             AMVP_LOG_WARN("Failed to save request URL to test session file. Make sure you save it from output!");
             goto end;  
         }
-        rv = amvp_json_serialize_to_file_pretty_w(new_ts, ctx->session_file_path);
+        rv = amvp_json_serialize_to_file_pretty_w(ctx, new_ts, ctx->session_file_path);
         if (rv) {
             AMVP_LOG_WARN("Failed to save request URL to test session file. Make sure you save it from output!");
             goto end;
         } else {
-            amvp_json_serialize_to_file_pretty_a(NULL, ctx->session_file_path);
+            amvp_json_serialize_to_file_pretty_a(ctx, NULL, ctx->session_file_path);
         }
     }
 
@@ -2869,7 +3635,7 @@ AMVP_RESULT amvp_notify_large(AMVP_CTX *ctx,
         goto err;
     }
 
-    server_val = json_parse_string(ctx->curl_buf);
+    server_val = json_parse_string(ctx->work.curl_buf);
     if (!server_val) {
         AMVP_LOG_ERR("JSON parse error");
         rv = AMVP_JSON_ERR;
@@ -2938,142 +3704,833 @@ static AMVP_RESULT amvp_parse_test_session_register(AMVP_CTX *ctx) {
     /*
      * Parse the JSON
      */
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->work.curl_buf);
     if (!val) {
         AMVP_LOG_ERR("JSON parse error");
         return AMVP_JSON_ERR;
     }
-    obj = amvp_get_obj_from_rsp(ctx, val);
+    obj = amvp_get_obj_from_rsp(ctx, val);
+
+    /*
+     * This is the identifiers provided by the server
+     * for this specific test session!
+     */
+    test_session_url = json_object_get_string(obj, "url");
+    if (!test_session_url) {
+        AMVP_LOG_ERR("JSON parse error");
+        return AMVP_JSON_ERR;
+    }
+
+    ctx->session_url = calloc(AMVP_ATTR_URL_MAX + 1, sizeof(char));
+    strcpy_s(ctx->session_url, AMVP_ATTR_URL_MAX + 1, test_session_url);
+
+    /*
+     * The accessToken needed for this specific test session.
+     */
+    access_token = json_object_get_string(obj, "accessToken");
+    if (!access_token) {
+        AMVP_LOG_ERR("JSON parse error");
+        return AMVP_JSON_ERR;
+    }
+    if (strnlen_s(access_token, AMVP_JWT_TOKEN_MAX + 1) > AMVP_JWT_TOKEN_MAX) {
+        AMVP_LOG_ERR("access_token too large");
+        return AMVP_JWT_INVALID;
+    }
+    memzero_s(ctx->jwt_token, AMVP_JWT_TOKEN_MAX + 1);
+    strcpy_s(ctx->jwt_token, AMVP_JWT_TOKEN_MAX + 1, access_token);
+
+    /*
+     * Identify the VS identifiers provided by the server, save them for
+     * processing later.
+     */
+    vect_sets = json_object_get_array(obj, "vectorSetUrls");
+    vs_cnt = json_array_get_count(vect_sets);
+    for (i = 0; i < vs_cnt; i++) {
+        const char *vsid_url = json_array_get_string(vect_sets, i);
+
+        if (!vsid_url) {
+            AMVP_LOG_ERR("No vsid_url");
+            goto end;
+        }
+
+        rv = amvp_append_vsid_url(ctx, vsid_url);
+        if (rv != AMVP_SUCCESS) goto end;
+        AMVP_LOG_INFO("Received vsid_url=%s", vsid_url);
+    }
+
+end:
+    if (val) json_value_free(val);
+    return rv;
+}
+
+
+/**
+ * Loads all of the data we need to process or view test session information
+ * from the given file. used for non-continuous sessions.
+ */
+static AMVP_RESULT amvp_parse_session_info_file(AMVP_CTX *ctx, const char *filename) {
+    JSON_Value *val = NULL;
+    JSON_Array *reg_array;
+    JSON_Object *obj = NULL;
+    const char *test_session_url = NULL;
+    const char *jwt = NULL;
+    int isSample = 0;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!filename) {
+        AMVP_LOG_ERR("Must provide value for JSON filename");
+        return AMVP_MISSING_ARG;
+    }
+    
+    if (strnlen_s(filename, AMVP_JSON_FILENAME_MAX + 1) > AMVP_JSON_FILENAME_MAX) {
+        AMVP_LOG_ERR("Provided filename length > max(%d)", AMVP_JSON_FILENAME_MAX);
+        return AMVP_INVALID_ARG;
+    }
+    
+    val = amvp_json_parse_file(filename);
+    if (!val) {
+        AMVP_LOG_ERR("JSON val parse error");
+        return AMVP_MALFORMED_JSON;
+    }
+    reg_array = json_value_get_array(val);
+    obj = json_array_get_object(reg_array, 0);
+    if (!obj) {
+        AMVP_LOG_ERR("JSON obj parse error");
+        rv = AMVP_MALFORMED_JSON;
+        goto end;
+    }
+
+    test_session_url = json_object_get_string(obj, "url");
+    if (!test_session_url) {
+        AMVP_LOG_ERR("Missing session URL");
+        rv = AMVP_MALFORMED_JSON;
+        goto end;
+    }
+
+    ctx->session_url = calloc(AMVP_ATTR_URL_MAX + 1, sizeof(char));
+    if (!ctx->session_url) {
+        rv = AMVP_MALLOC_FAIL;
+        goto end;
+    }
+    strcpy_s(ctx->session_url, AMVP_ATTR_URL_MAX + 1, test_session_url);
+
+    jwt = json_object_get_string(obj, "jwt");
+    if (!jwt) {
+        rv = AMVP_MALFORMED_JSON;
+        goto end;
+    }
+    ctx->jwt_token = calloc(AMVP_JWT_TOKEN_MAX + 1, sizeof(char));
+    if (!ctx->jwt_token) {
+        rv = AMVP_MALLOC_FAIL;
+        goto end;
+    }
+    strcpy_s(ctx->jwt_token, AMVP_JWT_TOKEN_MAX + 1, jwt);
+
+    isSample = json_object_get_boolean(obj, "isSample");
+    if (json_object_has_value(obj, "isSample")) {
+        ctx->is_sample = isSample;
+    } else {
+        AMVP_LOG_WARN("Missing indication of whether tests are sample in file, continuing");
+    }
+
+    /* Written once the vector sets of the session were processed */
+    rv = amvp_vs_meta_from_json(ctx, json_object_get_array(obj, "vectorSets"));
+
+end:
+    if (val) json_value_free(val);
+    return rv;
+}
+
+#ifndef _WIN32
+/*
+ * Vector sets still to be processed by the workers of
+ * amvp_process_tests_concurrent()
+ */
+typedef struct amvp_vs_queue_t {
+    pthread_mutex_t lock;
+    AMVP_STRING_LIST *next; /* next vector set URL to process */
+    int count;              /* position of next in the vsid_url_list */
+    AMVP_RESULT rv;         /* first failure, stops all workers */
+} AMVP_VS_QUEUE;
+
+typedef struct amvp_vs_worker_t {
+    AMVP_CTX *ctx;          /* worker clone of the session ctx */
+    AMVP_VS_QUEUE *queue;
+    pthread_t thread;
+} AMVP_VS_WORKER;
+
+/*
+ * Clone the session ctx for a vector set worker. The clone shares the
+ * capabilities, session data and callbacks with the session ctx but has its
+ * own AMVP_VS_WORK, and its own JWT so that a refresh on one worker does not
+ * free the token out from under the others.
+ */
+static AMVP_CTX *amvp_vs_worker_ctx_new(AMVP_CTX *ctx) {
+    AMVP_CTX *wctx = NULL;
+
+    wctx = calloc(1, sizeof(AMVP_CTX));
+    if (!wctx) {
+        return NULL;
+    }
+    *wctx = *ctx;
+    memzero_s(&wctx->work, sizeof(AMVP_VS_WORK));
+    wctx->parent = ctx;
+    wctx->tmp_jwt = NULL;
+    wctx->use_tmp_jwt = 0;
+    wctx->jwt_token = NULL;
+    if (ctx->jwt_token) {
+        wctx->jwt_token = calloc(AMVP_JWT_TOKEN_MAX + 1, sizeof(char));
+        if (!wctx->jwt_token) {
+            free(wctx);
+            return NULL;
+        }
+        strcpy_s(wctx->jwt_token, AMVP_JWT_TOKEN_MAX + 1, ctx->jwt_token);
+    }
+    return wctx;
+}
+
+static void amvp_vs_worker_ctx_free(AMVP_CTX *wctx) {
+    AMVP_CTX *ctx = wctx->parent;
+
+    amvp_perf_flush(wctx, AMVP_CIPHER_START);
+    if (wctx->work.kat_resp) json_value_free(wctx->work.kat_resp);
+    if (wctx->work.curl_buf) amvp_mem_free(AMVP_MEM_TRANSPORT, wctx->work.curl_buf);
+    if (wctx->jwt_token) free(wctx->jwt_token);
+    if (wctx->tmp_jwt) free(wctx->tmp_jwt);
+    if (wctx->http_user_agent && wctx->http_user_agent != ctx->http_user_agent) {
+        free(wctx->http_user_agent);
+    }
+    free(wctx);
+}
+
+static void *amvp_vs_worker_run(void *arg) {
+    AMVP_VS_WORKER *worker = arg;
+    AMVP_VS_QUEUE *queue = worker->queue;
+    AMVP_CTX *ctx = worker->ctx;
+    AMVP_STRING_LIST *vs_entry = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int count = 0;
+
+    amvp_trace_thread(ctx, "vector set worker");
+    while (1) {
+        pthread_mutex_lock(&queue->lock);
+        vs_entry = queue->rv == AMVP_SUCCESS ? queue->next : NULL;
+        if (vs_entry) {
+            queue->next = vs_entry->next;
+            count = queue->count++;
+        }
+        pthread_mutex_unlock(&queue->lock);
+        if (!vs_entry) {
+            break;
+        }
+
+        rv = amvp_process_vsid(ctx, vs_entry->string, count);
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("Unable to process vector set! Error: %d", rv);
+            pthread_mutex_lock(&queue->lock);
+            if (queue->rv == AMVP_SUCCESS) {
+                queue->rv = rv;
+            }
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        ctx->work.vs_id = 0;
+    }
+    return NULL;
+}
+
+/*
+ * Process the vector sets of the session on ctx->vs_workers threads. Each
+ * worker takes the next vector set from the shared list, so a slow vector set
+ * does not hold up the others. The first failure stops the workers from
+ * starting new vector sets and is returned once all of them are done.
+ */
+static AMVP_RESULT amvp_process_tests_concurrent(AMVP_CTX *ctx) {
+    AMVP_VS_WORKER worker[AMVP_VS_WORKERS_MAX];
+    AMVP_VS_QUEUE queue;
+    AMVP_STRING_LIST *vs_entry = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int workers = 0, vs_cnt = 0, started = 0, i = 0;
+
+    for (vs_entry = ctx->vsid_url_list; vs_entry; vs_entry = vs_entry->next) {
+        vs_cnt++;
+    }
+    workers = ctx->vs_workers < vs_cnt ? ctx->vs_workers : vs_cnt;
+
+    memzero_s(worker, sizeof(worker));
+    memzero_s(&queue, sizeof(AMVP_VS_QUEUE));
+    pthread_mutex_init(&queue.lock, NULL);
+    queue.next = ctx->vsid_url_list;
+    queue.rv = AMVP_SUCCESS;
+
+    AMVP_LOG_STATUS("Processing %d vector sets on %d workers...", vs_cnt, workers);
+    for (i = 0; i < workers; i++) {
+        worker[i].queue = &queue;
+        worker[i].ctx = amvp_vs_worker_ctx_new(ctx);
+        if (!worker[i].ctx) {
+            AMVP_LOG_ERR("Unable to allocate vector set worker");
+            rv = AMVP_MALLOC_FAIL;
+            break;
+        }
+        if (pthread_create(&worker[i].thread, NULL, amvp_vs_worker_run, &worker[i])) {
+            AMVP_LOG_WARN("Unable to start vector set worker, continuing with %d", i);
+            amvp_vs_worker_ctx_free(worker[i].ctx);
+            worker[i].ctx = NULL;
+            break;
+        }
+        started++;
+    }
+    if (rv != AMVP_SUCCESS || !started) {
+        /* Stop the workers that did start from taking more vector sets */
+        pthread_mutex_lock(&queue.lock);
+        queue.rv = rv != AMVP_SUCCESS ? rv : AMVP_INTERNAL_ERR;
+        pthread_mutex_unlock(&queue.lock);
+    }
+
+    for (i = 0; i < started; i++) {
+        pthread_join(worker[i].thread, NULL);
+        amvp_vs_worker_ctx_free(worker[i].ctx);
+    }
+    pthread_mutex_destroy(&queue.lock);
+
+    return queue.rv;
+}
+
+/*
+ * Vector sets in flight in amvp_run_vectors_concurrent(). The reader fills a
+ * window of slots in file order, the workers process them in any order and
+ * the writer drains them in file order again, so the response file is the
+ * same as the one written by a serial run.
+ */
+typedef struct amvp_offline_slot_t {
+    JSON_Value *req;        /* vector set read from the request file */
+    JSON_Value *rsp;        /* kat_resp of the worker that processed req */
+    int done;
+} AMVP_OFFLINE_SLOT;
+
+typedef struct amvp_offline_queue_t {
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond; /* a vector set was read, or there will be no more */
+    pthread_cond_t done_cond; /* a vector set was processed, or failed */
+    AMVP_OFFLINE_SLOT *slot;
+    int window;             /* number of slots */
+    int read;               /* vector sets read so far */
+    int taken;              /* vector sets handed to a worker so far */
+    int eof;                /* no more vector sets will be read */
+    AMVP_RESULT rv;         /* first failure, stops all workers */
+} AMVP_OFFLINE_QUEUE;
+
+typedef struct amvp_offline_worker_t {
+    AMVP_CTX *ctx;          /* worker clone of the session ctx */
+    AMVP_OFFLINE_QUEUE *queue;
+    pthread_t thread;
+} AMVP_OFFLINE_WORKER;
+
+static void *amvp_offline_worker_run(void *arg) {
+    AMVP_OFFLINE_WORKER *worker = arg;
+    AMVP_OFFLINE_QUEUE *queue = worker->queue;
+    AMVP_CTX *ctx = worker->ctx;
+    AMVP_OFFLINE_SLOT *slot = NULL;
+    JSON_Value *req = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    amvp_trace_thread(ctx, "vector set worker");
+    while (1) {
+        pthread_mutex_lock(&queue->lock);
+        while (queue->rv == AMVP_SUCCESS && queue->taken == queue->read && !queue->eof) {
+            pthread_cond_wait(&queue->work_cond, &queue->lock);
+        }
+        if (queue->rv != AMVP_SUCCESS || queue->taken == queue->read) {
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        /* The slot is not reused until the writer has drained it */
+        slot = &queue->slot[queue->taken++ % queue->window];
+        req = slot->req;
+        slot->req = NULL;
+        pthread_mutex_unlock(&queue->lock);
+
+        /* The vector set was parsed by the reader, that is not counted here */
+        amvp_mem_vs_begin();
+        rv = amvp_dispatch_vector_set(ctx, json_value_get_object(req));
+        json_value_free(req);
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("KAT dispatch error");
+        }
+        amvp_perf_flush(ctx, ctx->work.cipher);
+        amvp_mem_vs_end(ctx);
+        ctx->work.cipher = AMVP_CIPHER_START;
+
+        pthread_mutex_lock(&queue->lock);
+        if (rv != AMVP_SUCCESS) {
+            if (queue->rv == AMVP_SUCCESS) {
+                queue->rv = rv;
+            }
+            pthread_cond_broadcast(&queue->work_cond);
+        } else {
+            slot->rsp = ctx->work.kat_resp;
+            slot->done = 1;
+            ctx->work.kat_resp = NULL;
+        }
+        pthread_cond_signal(&queue->done_cond);
+        pthread_mutex_unlock(&queue->lock);
+        ctx->work.vs_id = 0;
+        if (rv != AMVP_SUCCESS) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Offline counterpart of amvp_process_tests_concurrent(). Reads the vector
+ * sets of the request file starting with first, processes them on
+ * ctx->vs_workers threads and appends the responses to writer in file order.
+ * At most two vector sets per worker are held in memory at a time. Takes
+ * ownership of first.
+ */
+static AMVP_RESULT amvp_run_vectors_concurrent(AMVP_CTX *ctx, AMVP_JSON_STREAM *stream, JSON_Value *first,
+                                               int vs_cnt, AMVP_JSON_WRITER *writer) {
+    AMVP_OFFLINE_WORKER worker[AMVP_VS_WORKERS_MAX];
+    AMVP_OFFLINE_QUEUE queue;
+    AMVP_OFFLINE_SLOT *slot = NULL;
+    JSON_Value *val = first;
+    JSON_Value *rsp = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int workers = 0, started = 0, written = 0, i = 0;
+
+    workers = ctx->vs_workers < vs_cnt ? ctx->vs_workers : vs_cnt;
+
+    memzero_s(worker, sizeof(worker));
+    memzero_s(&queue, sizeof(AMVP_OFFLINE_QUEUE));
+    queue.window = workers * 2;
+    queue.slot = calloc(queue.window, sizeof(AMVP_OFFLINE_SLOT));
+    if (!queue.slot) {
+        json_value_free(first);
+        return AMVP_MALLOC_FAIL;
+    }
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.work_cond, NULL);
+    pthread_cond_init(&queue.done_cond, NULL);
+    queue.rv = AMVP_SUCCESS;
+
+    AMVP_LOG_STATUS("Processing %d vector sets on %d workers...", vs_cnt, workers);
+    for (i = 0; i < workers; i++) {
+        worker[i].queue = &queue;
+        worker[i].ctx = amvp_vs_worker_ctx_new(ctx);
+        if (!worker[i].ctx) {
+            AMVP_LOG_ERR("Unable to allocate vector set worker");
+            rv = AMVP_MALLOC_FAIL;
+            break;
+        }
+        if (pthread_create(&worker[i].thread, NULL, amvp_offline_worker_run, &worker[i])) {
+            AMVP_LOG_WARN("Unable to start vector set worker, continuing with %d", i);
+            amvp_vs_worker_ctx_free(worker[i].ctx);
+            worker[i].ctx = NULL;
+            break;
+        }
+        started++;
+    }
+
+    pthread_mutex_lock(&queue.lock);
+    if (rv != AMVP_SUCCESS || !started) {
+        queue.rv = rv != AMVP_SUCCESS ? rv : AMVP_INTERNAL_ERR;
+    }
+    while (queue.rv == AMVP_SUCCESS) {
+        /* Write out the oldest vector set as soon as it is done */
+        slot = &queue.slot[written % queue.window];
+        if (written < queue.read && slot->done) {
+            rsp = slot->rsp;
+            slot->rsp = NULL;
+            slot->done = 0;
+            pthread_mutex_unlock(&queue.lock);
+
+            rv = amvp_offline_write_rsp(ctx, writer, rsp);
+            json_value_free(rsp);
+
+            pthread_mutex_lock(&queue.lock);
+            if (rv != AMVP_SUCCESS && queue.rv == AMVP_SUCCESS) {
+                queue.rv = rv;
+            }
+            written++;
+            continue;
+        }
+
+        /* Keep the window full while there are vector sets left */
+        if (!queue.eof && queue.read - written < queue.window) {
+            if (!val) {
+                pthread_mutex_unlock(&queue.lock);
+                rv = amvp_json_stream_next(stream, &val);
+                pthread_mutex_lock(&queue.lock);
+                if (rv != AMVP_SUCCESS) {
+                    AMVP_LOG_ERR("JSON obj parse error");
+                    if (queue.rv == AMVP_SUCCESS) {
+                        queue.rv = rv;
+                    }
+                    break;
+                }
+            }
+            if (!json_value_get_object(val)) {
+                queue.eof = 1;
+            } else if (queue.read == vs_cnt) {
+                AMVP_LOG_ERR("Request file has more vector sets than vectorSetUrls");
+                if (queue.rv == AMVP_SUCCESS) {
+                    queue.rv = AMVP_JSON_ERR;
+                }
+                break;
+            } else {
+                queue.slot[queue.read % queue.window].req = val;
+                queue.read++;
+                val = NULL;
+            }
+            pthread_cond_broadcast(&queue.work_cond);
+            continue;
+        }
+
+        if (queue.eof && written == queue.read) {
+            break;
+        }
+        pthread_cond_wait(&queue.done_cond, &queue.lock);
+    }
+    rv = queue.rv;
+    /* Wake the workers so that they see the failure or the end of the file */
+    pthread_cond_broadcast(&queue.work_cond);
+    pthread_mutex_unlock(&queue.lock);
+
+    for (i = 0; i < started; i++) {
+        pthread_join(worker[i].thread, NULL);
+        amvp_vs_worker_ctx_free(worker[i].ctx);
+    }
+    for (i = 0; i < queue.window; i++) {
+        if (queue.slot[i].req) json_value_free(queue.slot[i].req);
+        if (queue.slot[i].rsp) json_value_free(queue.slot[i].rsp);
+    }
+    if (val) json_value_free(val);
+    free(queue.slot);
+    pthread_cond_destroy(&queue.done_cond);
+    pthread_cond_destroy(&queue.work_cond);
+    pthread_mutex_destroy(&queue.lock);
+
+    return rv;
+}
+
+/*
+ * Vector set responses still to be uploaded by the workers of
+ * amvp_upload_concurrent(). The response file is read under the lock, so each
+ * worker holds at most the one vector set it is uploading.
+ */
+typedef struct amvp_upload_queue_t {
+    pthread_mutex_t lock;
+    AMVP_JSON_STREAM *stream;
+    JSON_Value *first;          /* vector set read before the workers started */
+    AMVP_STRING_LIST *next;     /* vector set URL for the next response in the file */
+    AMVP_UPLOAD_STATUS *status; /* one entry per vector set, in file order */
+    int count;                  /* position of next in the vsid_url_list */
+    AMVP_RESULT rv;             /* first failure reading the file, stops all workers */
+} AMVP_UPLOAD_QUEUE;
+
+typedef struct amvp_upload_worker_t {
+    AMVP_CTX *ctx;              /* worker clone of the session ctx */
+    AMVP_UPLOAD_QUEUE *queue;
+    pthread_t thread;
+} AMVP_UPLOAD_WORKER;
+
+static void *amvp_upload_worker_run(void *arg) {
+    AMVP_UPLOAD_WORKER *worker = arg;
+    AMVP_UPLOAD_QUEUE *queue = worker->queue;
+    AMVP_CTX *ctx = worker->ctx;
+    AMVP_STRING_LIST *vs_entry = NULL;
+    JSON_Value *vs_val = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int count = 0;
+
+    amvp_trace_thread(ctx, "upload worker");
+    while (1) {
+        pthread_mutex_lock(&queue->lock);
+        vs_entry = queue->rv == AMVP_SUCCESS ? queue->next : NULL;
+        if (vs_entry) {
+            if (queue->first) {
+                vs_val = queue->first;
+                queue->first = NULL;
+            } else {
+                rv = amvp_json_stream_next(queue->stream, &vs_val);
+                if (rv != AMVP_SUCCESS) {
+                    AMVP_LOG_ERR("JSON val parse error");
+                    queue->rv = rv;
+                    vs_entry = NULL;
+                }
+            }
+        }
+        if (vs_entry && !json_value_get_object(vs_val)) {
+            AMVP_LOG_ERR("Response file has fewer vector sets than the session");
+            queue->rv = AMVP_MALFORMED_JSON;
+            vs_entry = NULL;
+        }
+        if (vs_entry) {
+            queue->next = vs_entry->next;
+            count = queue->count++;
+        }
+        pthread_mutex_unlock(&queue->lock);
+        if (!vs_entry) {
+            break;
+        }
+
+        /* status[count] is only written by this worker */
+        rv = amvp_upload_vs_rsp(ctx, vs_entry->string, vs_val, &queue->status[count]);
+        vs_val = NULL;
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("Failed to submit test results for vector set %d - skipping...",
+                         queue->status[count].vs_id);
+        }
+        ctx->work.vs_id = 0;
+    }
+    if (vs_val) json_value_free(vs_val);
+    return NULL;
+}
+
+/*
+ * Upload counterpart of amvp_process_tests_concurrent(). Posts the vector set
+ * responses of the response file, starting with first, on ctx->vs_workers
+ * threads, so at most that many uploads are in flight. A failed upload is
+ * recorded in status and does not stop the others; only a malformed response
+ * file does. Takes ownership of first.
+ */
+static AMVP_RESULT amvp_upload_concurrent(AMVP_CTX *ctx, AMVP_JSON_STREAM *stream, JSON_Value *first,
+                                          AMVP_UPLOAD_STATUS *status, int vs_cnt) {
+    AMVP_UPLOAD_WORKER worker[AMVP_VS_WORKERS_MAX];
+    AMVP_UPLOAD_QUEUE queue;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int workers = 0, started = 0, i = 0;
+
+    workers = ctx->vs_workers < vs_cnt ? ctx->vs_workers : vs_cnt;
+
+    memzero_s(worker, sizeof(worker));
+    memzero_s(&queue, sizeof(AMVP_UPLOAD_QUEUE));
+    pthread_mutex_init(&queue.lock, NULL);
+    queue.stream = stream;
+    queue.first = first;
+    queue.next = ctx->vsid_url_list;
+    queue.status = status;
+    queue.rv = AMVP_SUCCESS;
+
+    AMVP_LOG_STATUS("Uploading %d vector sets on %d workers...", vs_cnt, workers);
+    for (i = 0; i < workers; i++) {
+        worker[i].queue = &queue;
+        worker[i].ctx = amvp_vs_worker_ctx_new(ctx);
+        if (!worker[i].ctx) {
+            AMVP_LOG_ERR("Unable to allocate upload worker");
+            rv = AMVP_MALLOC_FAIL;
+            break;
+        }
+        if (pthread_create(&worker[i].thread, NULL, amvp_upload_worker_run, &worker[i])) {
+            AMVP_LOG_WARN("Unable to start upload worker, continuing with %d", i);
+            amvp_vs_worker_ctx_free(worker[i].ctx);
+            worker[i].ctx = NULL;
+            break;
+        }
+        started++;
+    }
+    if (rv != AMVP_SUCCESS || !started) {
+        /* Stop the workers that did start from taking more vector sets */
+        pthread_mutex_lock(&queue.lock);
+        queue.rv = rv != AMVP_SUCCESS ? rv : AMVP_INTERNAL_ERR;
+        pthread_mutex_unlock(&queue.lock);
+    }
 
-    /*
-     * This is the identifiers provided by the server
-     * for this specific test session!
-     */
-    test_session_url = json_object_get_string(obj, "url");
-    if (!test_session_url) {
-        AMVP_LOG_ERR("JSON parse error");
-        return AMVP_JSON_ERR;
+    for (i = 0; i < started; i++) {
+        pthread_join(worker[i].thread, NULL);
+        amvp_vs_worker_ctx_free(worker[i].ctx);
     }
+    if (queue.first) json_value_free(queue.first);
+    pthread_mutex_destroy(&queue.lock);
 
-    ctx->session_url = calloc(AMVP_ATTR_URL_MAX + 1, sizeof(char));
-    strcpy_s(ctx->session_url, AMVP_ATTR_URL_MAX + 1, test_session_url);
+    return queue.rv;
+}
 
-    /*
-     * The accessToken needed for this specific test session.
-     */
-    access_token = json_object_get_string(obj, "accessToken");
-    if (!access_token) {
-        AMVP_LOG_ERR("JSON parse error");
-        return AMVP_JSON_ERR;
-    }
-    if (strnlen_s(access_token, AMVP_JWT_TOKEN_MAX + 1) > AMVP_JWT_TOKEN_MAX) {
-        AMVP_LOG_ERR("access_token too large");
-        return AMVP_JWT_INVALID;
-    }
-    memzero_s(ctx->jwt_token, AMVP_JWT_TOKEN_MAX + 1);
-    strcpy_s(ctx->jwt_token, AMVP_JWT_TOKEN_MAX + 1, access_token);
+/*
+ * Watches the results of vector sets that were submitted before a session was
+ * resumed while amvp_resume_test_session() processes the rest, so waiting on
+ * the server overlaps with the new work instead of following it. The final
+ * status of each one is recorded on the session ctx with amvp_vs_graded_add(),
+ * which amvp_check_test_results() then doesn't evaluate again.
+ */
+struct amvp_results_monitor_t {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;    /* signalled to stop the monitor */
+    AMVP_CTX *ctx;          /* worker clone of the session ctx */
+    AMVP_STRING_LIST *pending; /* vector set URLs that were incomplete */
+    int stop;
+    pthread_t thread;
+};
 
-    /*
-     * Identify the VS identifiers provided by the server, save them for
-     * processing later.
-     */
-    vect_sets = json_object_get_array(obj, "vectorSetUrls");
-    vs_cnt = json_array_get_count(vect_sets);
-    for (i = 0; i < vs_cnt; i++) {
-        const char *vsid_url = json_array_get_string(vect_sets, i);
+/*
+ * Record the algorithm and mode of a failed vector set that was not processed
+ * by this session, so the final results check does not download it again. A
+ * vector set that can't be retrieved now is looked up by that check instead.
+ */
+static void amvp_results_monitor_meta(AMVP_CTX *ctx, const char *vsid_url, int vs_id) {
+    JSON_Value *val = NULL;
+    JSON_Object *obj = NULL;
+    char *vs_url = NULL;
 
-        if (!vsid_url) {
-            AMVP_LOG_ERR("No vsid_url");
-            goto end;
+    //retrieve_vector_set expects a non-const string
+    vs_url = calloc(AMVP_REQUEST_STR_LEN_MAX + 1, sizeof(char));
+    if (!vs_url) {
+        return;
+    }
+    strncpy_s(vs_url, AMVP_REQUEST_STR_LEN_MAX + 1, vsid_url, AMVP_REQUEST_STR_LEN_MAX);
+    if (amvp_retrieve_vector_set(ctx, vs_url) == AMVP_SUCCESS) {
+        val = json_parse_string(ctx->work.curl_buf);
+        obj = amvp_get_obj_from_rsp(ctx, val);
+        if (obj) {
+            amvp_vs_meta_add(ctx, vs_id, json_object_get_string(obj, "algorithm"),
+                             json_object_get_string(obj, "mode"));
         }
-
-        rv = amvp_append_vsid_url(ctx, vsid_url);
-        if (rv != AMVP_SUCCESS) goto end;
-        AMVP_LOG_INFO("Received vsid_url=%s", vsid_url);
     }
-
-end:
     if (val) json_value_free(val);
-    return rv;
+    free(vs_url);
 }
 
-
-/**
- * Loads all of the data we need to process or view test session information
- * from the given file. used for non-continuous sessions.
+/*
+ * Poll the session results once and record the final status of every pending
+ * vector set that was graded on the session ctx. Returns the number of pending
+ * vector sets that are still incomplete, or -1 if the results could not be
+ * retrieved.
  */
-static AMVP_RESULT amvp_parse_session_info_file(AMVP_CTX *ctx, const char *filename) {
+static int amvp_results_monitor_poll(AMVP_RESULTS_MONITOR *monitor) {
+    AMVP_CTX *ctx = monitor->ctx;
     JSON_Value *val = NULL;
-    JSON_Array *reg_array;
-    JSON_Object *obj = NULL;
-    const char *test_session_url = NULL;
-    const char *jwt = NULL;
-    int isSample = 0;
+    JSON_Array *results = NULL;
+    JSON_Object *current = NULL;
+    const char *vsid_url = NULL, *status = NULL;
+    const AMVP_VS_GRADED *graded = NULL;
+    int count = 0, incomplete = 0, failed = 0, i = 0, diff = 1, vs_id = 0;
+    unsigned long long start = amvp_trace_begin(ctx);
     AMVP_RESULT rv = AMVP_SUCCESS;
 
-    if (!ctx) {
-        return AMVP_NO_CTX;
-    }
-    if (!filename) {
-        AMVP_LOG_ERR("Must provide value for JSON filename");
-        return AMVP_MISSING_ARG;
+    rv = amvp_retrieve_vector_set_result(ctx, ctx->session_url);
+    amvp_trace_span(ctx, "results", "poll", start, 0, ctx->session_url);
+    if (rv != AMVP_SUCCESS) {
+        return -1;
     }
-    
-    if (strnlen_s(filename, AMVP_JSON_FILENAME_MAX + 1) > AMVP_JSON_FILENAME_MAX) {
-        AMVP_LOG_ERR("Provided filename length > max(%d)", AMVP_JSON_FILENAME_MAX);
-        return AMVP_INVALID_ARG;
+    val = json_parse_string(ctx->work.curl_buf);
+    results = json_object_get_array(amvp_get_obj_from_rsp(ctx, val), "results");
+    if (!results) {
+        json_value_free(val);
+        return -1;
     }
-    
-    val = json_parse_file(filename);
-    if (!val) {
-        AMVP_LOG_ERR("JSON val parse error");
-        return AMVP_MALFORMED_JSON;
+    count = (int)json_array_get_count(results);
+    for (i = 0; i < count; i++) {
+        current = json_array_get_object(results, i);
+        vsid_url = json_object_get_string(current, "vectorSetUrl");
+        status = json_object_get_string(current, "status");
+        if (!vsid_url || !status || !amvp_lookup_str_list(&monitor->pending, vsid_url)) {
+            continue;
+        }
+        strcmp_s("incomplete", 10, status, &diff);
+        if (!diff) {
+            incomplete++;
+            continue;
+        }
+        vs_id = strrchr(vsid_url, '/') ? atoi(strrchr(vsid_url, '/') + 1) : 0;
+        graded = amvp_vs_graded_lookup(ctx->parent, vs_id);
+        if (vs_id && !graded) {
+            strcmp_s("fail", 4, status, &diff);
+            if (!diff && !amvp_vs_meta_lookup(ctx->parent, vsid_url)) {
+                amvp_results_monitor_meta(ctx, vsid_url, vs_id);
+            }
+            AMVP_LOG_STATUS("Vector set %d: %s", vs_id, status);
+            amvp_vs_graded_add(ctx, vs_id, !diff);
+            graded = amvp_vs_graded_lookup(ctx->parent, vs_id);
+        }
+        if (graded && graded->failed) {
+            failed++;
+        }
     }
-    reg_array = json_value_get_array(val);
-    obj = json_array_get_object(reg_array, 0);
-    if (!obj) {
-        AMVP_LOG_ERR("JSON obj parse error");
-        rv = AMVP_MALFORMED_JSON;
-        goto end;
+    if (!incomplete) {
+        AMVP_LOG_STATUS("Results are ready for the vector sets submitted before the resume, %d failed", failed);
     }
+    json_value_free(val);
+    return incomplete;
+}
 
-    test_session_url = json_object_get_string(obj, "url");
-    if (!test_session_url) {
-        AMVP_LOG_ERR("Missing session URL");
-        rv = AMVP_MALFORMED_JSON;
-        goto end;
+static void *amvp_results_monitor_run(void *arg) {
+    AMVP_RESULTS_MONITOR *monitor = arg;
+    struct timespec deadline;
+    int incomplete = 0;
+
+    amvp_trace_thread(monitor->ctx, "results monitor");
+    pthread_mutex_lock(&monitor->lock);
+    while (!monitor->stop) {
+        pthread_mutex_unlock(&monitor->lock);
+        incomplete = amvp_results_monitor_poll(monitor);
+        pthread_mutex_lock(&monitor->lock);
+        if (!incomplete) {
+            break;
+        }
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        if (!amvp_replay_fast(monitor->ctx)) {
+            deadline.tv_sec += AMVP_RETRY_TIME;
+        }
+        while (!monitor->stop) {
+            if (pthread_cond_timedwait(&monitor->cond, &monitor->lock, &deadline)) {
+                break;
+            }
+        }
     }
+    pthread_mutex_unlock(&monitor->lock);
+    return NULL;
+}
 
-    ctx->session_url = calloc(AMVP_ATTR_URL_MAX + 1, sizeof(char));
-    if (!ctx->session_url) {
-        rv = AMVP_MALLOC_FAIL;
-        goto end;
-    }
-    strcpy_s(ctx->session_url, AMVP_ATTR_URL_MAX + 1, test_session_url);
+/*
+ * Start watching the vector set URLs in pending. Returns NULL if the monitor
+ * could not be started, in which case the results are only checked at the end.
+ */
+static AMVP_RESULTS_MONITOR *amvp_results_monitor_start(AMVP_CTX *ctx, AMVP_STRING_LIST *pending) {
+    AMVP_RESULTS_MONITOR *monitor = NULL;
 
-    jwt = json_object_get_string(obj, "jwt");
-    if (!jwt) {
-        rv = AMVP_MALFORMED_JSON;
-        goto end;
+    monitor = calloc(1, sizeof(AMVP_RESULTS_MONITOR));
+    if (!monitor) {
+        return NULL;
     }
-    ctx->jwt_token = calloc(AMVP_JWT_TOKEN_MAX + 1, sizeof(char));
-    if (!ctx->jwt_token) {
-        rv = AMVP_MALLOC_FAIL;
-        goto end;
+    monitor->ctx = amvp_vs_worker_ctx_new(ctx);
+    if (!monitor->ctx) {
+        free(monitor);
+        return NULL;
     }
-    strcpy_s(ctx->jwt_token, AMVP_JWT_TOKEN_MAX + 1, jwt);
+    monitor->pending = pending;
+    pthread_mutex_init(&monitor->lock, NULL);
+    pthread_cond_init(&monitor->cond, NULL);
+    if (pthread_create(&monitor->thread, NULL, amvp_results_monitor_run, monitor)) {
+        AMVP_LOG_WARN("Unable to start results monitor, continuing without it");
+        pthread_cond_destroy(&monitor->cond);
+        pthread_mutex_destroy(&monitor->lock);
+        amvp_vs_worker_ctx_free(monitor->ctx);
+        free(monitor);
+        return NULL;
+    }
+    return monitor;
+}
 
-    isSample = json_object_get_boolean(obj, "isSample");
-    if (json_object_has_value(obj, "isSample")) {
-        ctx->is_sample = isSample;
-    } else {
-        AMVP_LOG_WARN("Missing indication of whether tests are sample in file, continuing");
+static void amvp_results_monitor_stop(AMVP_RESULTS_MONITOR *monitor) {
+    if (!monitor) {
+        return;
     }
+    pthread_mutex_lock(&monitor->lock);
+    monitor->stop = 1;
+    pthread_cond_signal(&monitor->cond);
+    pthread_mutex_unlock(&monitor->lock);
+    pthread_join(monitor->thread, NULL);
 
-end:
-    if (val) json_value_free(val);
-    return rv;
+    pthread_cond_destroy(&monitor->cond);
+    pthread_mutex_destroy(&monitor->lock);
+    amvp_vs_worker_ctx_free(monitor->ctx);
+    free(monitor);
 }
+#endif
 
 /*
  * This function is used by the application after registration
@@ -3099,6 +4556,15 @@ AMVP_RESULT amvp_process_tests(AMVP_CTX *ctx) {
     if (!vs_entry) {
         return AMVP_MISSING_ARG;
     }
+#ifndef _WIN32
+    /*
+     * Vector sets saved to a file must be written in order, so
+     * they are always processed one at a time
+     */
+    if (ctx->vs_workers > 1 && vs_entry->next && !ctx->vector_req) {
+        return amvp_process_tests_concurrent(ctx);
+    }
+#endif
     while (vs_entry) {
         rv = amvp_process_vsid(ctx, vs_entry->string, count);
         if (rv != AMVP_SUCCESS) {
@@ -3110,7 +4576,7 @@ AMVP_RESULT amvp_process_tests(AMVP_CTX *ctx) {
     }
     /* Need to add the ending ']' here */
     if (ctx->vector_req) {
-        rv = amvp_json_serialize_to_file_pretty_a(NULL, ctx->vector_req_file);
+        rv = amvp_json_serialize_to_file_pretty_a(ctx, NULL, ctx->vector_req_file);
     }
     return rv;
 }
@@ -3125,6 +4591,8 @@ AMVP_RESULT amvp_process_tests(AMVP_CTX *ctx) {
  * function will ensure that retry periods will sum to no longer than AMVP_MAX_WAIT_TIME.
  */
 static AMVP_RESULT amvp_retry_handler(AMVP_CTX *ctx, int *retry_period, unsigned int *waited_so_far, int modifier, AMVP_WAITING_STATUS situation) {
+    unsigned long long start = 0;
+
     /* perform check at beginning of function call, so library can check one more time when max
      * time is reached to see if server status has changed */
     if (*waited_so_far >= AMVP_MAX_WAIT_TIME) {
@@ -3146,14 +4614,21 @@ static AMVP_RESULT amvp_retry_handler(AMVP_CTX *ctx, int *retry_period, unsigned
         AMVP_LOG_STATUS("200 OK, waiting %u seconds and trying again...", *retry_period);
     }
 
+    AMVP_PROBE2(retry_wait, situation, *retry_period);
+    start = amvp_trace_begin(ctx);
+    /* A replay as fast as possible does not wait for the recorded server */
+    if (!amvp_replay_fast(ctx)) {
     #ifdef _WIN32
-    /*
-     * Windows uses milliseconds
-     */
-    Sleep(*retry_period * 1000);
+        /*
+         * Windows uses milliseconds
+         */
+        Sleep(*retry_period * 1000);
     #else
-    sleep(*retry_period);
+        sleep(*retry_period);
     #endif
+    }
+    amvp_trace_span(ctx, situation == AMVP_WAITING_FOR_RESULTS ? "results" : "vector set",
+                    "retry wait", start, 0, NULL);
 
     /* ensure that all parameters are valid and that we do not wait longer than AMVP_MAX_WAIT_TIME */
     if (modifier < 1 || modifier > AMVP_RETRY_MODIFIER_MAX) {
@@ -3193,7 +4668,9 @@ static AMVP_RESULT amvp_login(AMVP_CTX *ctx, int refresh) {
     AMVP_PROTOCOL_ERR *err = NULL;
     char *login = NULL;
     int login_len = 0;
+    unsigned long long start = amvp_trace_begin(ctx);
 
+    AMVP_PROBE1(login_start, refresh);
     AMVP_LOG_STATUS("Logging in...");
     rv = amvp_build_login(ctx, &login, &login_len, refresh);
     if (rv != AMVP_SUCCESS) {
@@ -3216,10 +4693,12 @@ static AMVP_RESULT amvp_login(AMVP_CTX *ctx, int refresh) {
         AMVP_LOG_STATUS("Login Response Failed, %d", rv);
     } else {
         AMVP_LOG_STATUS("Login successful");
-        //AMVP_LOG_STATUS("    Login Response: %s", ctx->curl_buf);
+        //AMVP_LOG_STATUS("    Login Response: %s", ctx->work.curl_buf);
     }
 end:
-    if (login) free(login);
+    amvp_trace_span(ctx, "session", refresh ? "login refresh" : "login", start, 0, NULL);
+    AMVP_PROBE4(login_done, refresh, rv, login_len, ctx->work.curl_read_ctr);
+    if (login) json_free_serialized_string(login);
     if (err) amvp_free_protocol_err(err);
     return rv;
 }
@@ -3259,14 +4738,25 @@ static AMVP_RESULT amvp_process_vsid(AMVP_CTX *ctx, char *vsid_url, int count) {
     int retry_period = 0;
     int retry = 1;
     unsigned int time_waited_so_far = 0;
+    unsigned long long start = 0;
+
+    /* Login and registration, or the previous vector set, are not part of this vector set */
+    amvp_perf_flush(ctx, AMVP_CIPHER_START);
+    amvp_mem_vs_begin();
     while (retry) {
         /*
          * Get the KAT vector set
          */
+        AMVP_PROBE1(download_start, amvp_url_id(vsid_url));
+        start = amvp_trace_begin(ctx);
         rv = amvp_retrieve_vector_set(ctx, vsid_url);
+        amvp_trace_span(ctx, "vector set", "download", start, 0, vsid_url);
+        AMVP_PROBE3(download_done, amvp_url_id(vsid_url), rv, ctx->work.curl_read_ctr);
         if (rv != AMVP_SUCCESS) goto end;
 
-        val = json_parse_string(ctx->curl_buf);
+        start = amvp_perf_now();
+        val = json_parse_string(ctx->work.curl_buf);
+        ctx->work.perf.parse_ns += amvp_perf_now() - start;
         if (!val) {
             AMVP_LOG_ERR("JSON parse error");
             rv = AMVP_JSON_ERR;
@@ -3316,7 +4806,7 @@ static AMVP_RESULT amvp_process_vsid(AMVP_CTX *ctx, char *vsid_url, int count) {
                         vs_entry = vs_entry->next;
                     }
                     /* Start with identifiers */
-                    rv = amvp_json_serialize_to_file_pretty_w(ts_val, ctx->vector_req_file);
+                    rv = amvp_json_serialize_to_file_pretty_w(ctx, ts_val, ctx->vector_req_file);
                     if (rv != AMVP_SUCCESS) {
                         AMVP_LOG_ERR("File write error");
                         json_value_free(ts_val);
@@ -3324,7 +4814,7 @@ static AMVP_RESULT amvp_process_vsid(AMVP_CTX *ctx, char *vsid_url, int count) {
                     }
                 } 
                 /* append vector set */
-                rv = amvp_json_serialize_to_file_pretty_a(alg_val, ctx->vector_req_file);
+                rv = amvp_json_serialize_to_file_pretty_a(ctx, alg_val, ctx->vector_req_file);
                 json_value_free(ts_val);
                 goto end;
             }
@@ -3344,11 +4834,18 @@ static AMVP_RESULT amvp_process_vsid(AMVP_CTX *ctx, char *vsid_url, int count) {
     /*
      * Send the responses to the AMVP server
      */
-    AMVP_LOG_STATUS("Posting vector set responses for vsId %d...", ctx->vs_id);
+    AMVP_LOG_STATUS("Posting vector set responses for vsId %d...", ctx->work.vs_id);
+    AMVP_PROBE1(upload_start, ctx->work.vs_id);
+    start = amvp_trace_begin(ctx);
     rv = amvp_submit_vector_responses(ctx, vsid_url);
+    amvp_trace_span(ctx, "vector set", "upload", start, ctx->work.vs_id, vsid_url);
+    AMVP_PROBE3(upload_done, ctx->work.vs_id, rv, ctx->work.perf.bytes_out);
 
 end:
+    amvp_perf_flush(ctx, ctx->work.cipher);
+    ctx->work.cipher = AMVP_CIPHER_START;
     if (val) json_value_free(val);
+    amvp_mem_vs_end(ctx);
     return rv;
 }
 
@@ -3359,14 +4856,15 @@ end:
  * KAT vector set that was previously downloaded.  The handler function
  * is looked up in the alg_tbl[] and invoked here.
  */
-static AMVP_RESULT amvp_dispatch_vector_set(AMVP_CTX *ctx, JSON_Object *obj) {
+AMVP_RESULT amvp_dispatch_vector_set(AMVP_CTX *ctx, JSON_Object *obj) {
     int i;
     const char *alg = json_object_get_string(obj, "algorithm");
     const char *mode = json_object_get_string(obj, "mode");
     int vs_id = json_object_get_number(obj, "vsId");
     int diff = 1;
+    unsigned long long start = 0, crypto_ns = 0;
 
-    ctx->vs_id = vs_id;
+    ctx->work.vs_id = vs_id;
     AMVP_RESULT rv;
 
     if (!alg) {
@@ -3374,6 +4872,10 @@ static AMVP_RESULT amvp_dispatch_vector_set(AMVP_CTX *ctx, JSON_Object *obj) {
         return AMVP_JSON_ERR;
     }
 
+    if (amvp_vs_meta_add(ctx, vs_id, alg, mode) != AMVP_SUCCESS) {
+        AMVP_LOG_WARN("Unable to record vector set metadata, failures will be looked up on the server");
+    }
+
     AMVP_LOG_STATUS("Processing vector set: %d", vs_id);
     AMVP_LOG_STATUS("Algorithm: %s", alg);
     if (mode) {
@@ -3383,21 +4885,27 @@ static AMVP_RESULT amvp_dispatch_vector_set(AMVP_CTX *ctx, JSON_Object *obj) {
         strcmp_s(alg_tbl[i].name,
                  AMVP_ALG_NAME_MAX,
                  alg, &diff);
-        if (!diff) {
-            if (mode == NULL) {
-                rv = (alg_tbl[i].handler)(ctx, obj);
-                return rv;
-            }
-
-            if (alg_tbl[i].mode != NULL) {
-                strcmp_s(alg_tbl[i].mode,
-                        AMVP_ALG_MODE_MAX,
-                        mode, &diff);
-                if (!diff) {
-                    rv = (alg_tbl[i].handler)(ctx, obj);
-                    return rv;
-                }
+        if (!diff && mode != NULL) {
+            if (alg_tbl[i].mode == NULL) {
+                continue;
             }
+            strcmp_s(alg_tbl[i].mode,
+                    AMVP_ALG_MODE_MAX,
+                    mode, &diff);
+        }
+        if (!diff) {
+            /* Time in the handler that is not spent in the crypto module */
+            ctx->work.cipher = alg_tbl[i].cipher;
+            ctx->work.perf.vs_count++;
+            start = amvp_perf_now();
+            crypto_ns = ctx->work.perf.crypto_ns;
+            AMVP_PROBE2(dispatch_start, vs_id, ctx->work.cipher);
+            rv = (alg_tbl[i].handler)(ctx, obj);
+            ctx->work.perf.decode_ns += amvp_perf_now() - start - (ctx->work.perf.crypto_ns - crypto_ns);
+            amvp_trace_group(ctx, 0);
+            AMVP_PROBE3(dispatch_done, vs_id, ctx->work.cipher, rv);
+            amvp_trace_span(ctx, "vector set", alg, start, vs_id, NULL);
+            return rv;
         }
     }
     return AMVP_UNSUPPORTED_OP;
@@ -3466,7 +4974,7 @@ static AMVP_RESULT amvp_dispatch_ie_set(AMVP_CTX *ctx, JSON_Object *obj) {
     const char *ev_str;
     char *json_result;
 
-    ctx->vs_id = ie_id;
+    ctx->work.vs_id = ie_id;
     AMVP_RESULT rv;
 
     AMVP_LOG_STATUS("Processing ie set: %d", ie_id);
@@ -3570,7 +5078,7 @@ static AMVP_RESULT amvp_dispatch_ie_set(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, &ieset_len);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, &ieset_len);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -3635,6 +5143,20 @@ static AMVP_RESULT amvp_process_ie_set(AMVP_CTX *ctx, JSON_Object *obj) {
     return AMVP_SUCCESS;
 }
 
+/*
+ * FNV-1a hash of a results document, to tell whether it changed since
+ * the last poll when the server does not send an ETag
+ */
+static unsigned long long amvp_results_hash(const char *buf) {
+    unsigned long long hash = 14695981039346656037ULL;
+
+    while (buf && *buf) {
+        hash ^= (unsigned char)*buf++;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 /*
  * This function will get the test results for a test session by checking the results of each vector set
  */
@@ -3648,8 +5170,11 @@ static AMVP_RESULT amvp_get_result_test_session(AMVP_CTX *ctx, char *session_url
     JSON_Array *results = NULL;
     JSON_Object *current = NULL;
     const char *status = NULL, *alg = NULL, *mode = NULL;
+    const AMVP_VS_META *meta = NULL;
     unsigned int time_waited_so_far = 0;
     int retry_interval = AMVP_RETRY_TIME;
+    unsigned long long body_hash = 0, last_hash = 0;
+    int incomplete = 0;
     //Maintains a list of names of algorithms that have failed
     AMVP_STRING_LIST *failedAlgList = NULL;
     AMVP_STRING_LIST *failedModeList = NULL;
@@ -3658,20 +5183,51 @@ static AMVP_RESULT amvp_get_result_test_session(AMVP_CTX *ctx, char *session_url
      * so we don't redownload failed vector sets every time a retry is done
      */
      AMVP_STRING_LIST *failedVsList = NULL;
+    /* vsIds whose result was already reported */
+    AMVP_PARAM_LIST *reportedVsList = NULL;
+    unsigned long long start = amvp_trace_begin(ctx), poll_start = 0;
 
+    ctx->work.etag[0] = 0;
     while (1) {
         int testsCompleted = 0;
 
         /*
-         * Get the KAT vector set
+         * Get the KAT vector set. After the first poll the GET is
+         * conditional on the ETag, if the server sent one.
          */
+        ctx->work.use_etag = 1;
+        poll_start = amvp_trace_begin(ctx);
         rv = amvp_retrieve_vector_set_result(ctx, session_url);
+        amvp_trace_span(ctx, "results", ctx->work.not_modified ? "poll (not modified)" : "poll",
+                        poll_start, 0, session_url);
         if (rv != AMVP_SUCCESS) {
             AMVP_LOG_ERR("Error retrieving vector set results!");
             goto end;
         }
 
-        val = json_parse_string(ctx->curl_buf);
+        /*
+         * Nothing was graded since the last poll, wait longer before the next one.
+         * Servers without ETag support are detected by the hash of the body.
+         */
+        if (!ctx->work.not_modified) {
+            body_hash = amvp_results_hash(ctx->work.curl_buf);
+        }
+        if (last_hash && (ctx->work.not_modified || body_hash == last_hash)) {
+            AMVP_LOG_STATUS("TestSession results unchanged, %d vector sets still incomplete...", incomplete);
+            retry_interval *= 2;
+            if (retry_interval > AMVP_RESULTS_POLL_MAX) {
+                retry_interval = AMVP_RESULTS_POLL_MAX;
+            }
+            if (amvp_retry_handler(ctx, &retry_interval, &time_waited_so_far, 1, AMVP_WAITING_FOR_RESULTS) != AMVP_KAT_DOWNLOAD_RETRY) {
+                AMVP_LOG_STATUS("Maximum wait time with server reached! (Max: %d seconds)", AMVP_MAX_WAIT_TIME);
+                rv = AMVP_TRANSPORT_FAIL;
+                goto end;
+            }
+            continue;
+        }
+        last_hash = body_hash;
+
+        val = json_parse_string(ctx->work.curl_buf);
         if (!val) {
             AMVP_LOG_ERR("Error while parsing json from server!");
             rv = AMVP_JSON_ERR;
@@ -3690,10 +5246,30 @@ static AMVP_RESULT amvp_get_result_test_session(AMVP_CTX *ctx, char *session_url
          */
         results = json_object_get_array(obj, "results");
         count = (int)json_array_get_count(results);
+        incomplete = 0;
         for (i = 0; i < count; i++) {
             int diff = 1;
+            const char *done_url = NULL;
+            const AMVP_VS_GRADED *graded = NULL;
+            int done_id = 0;
+
             current = json_array_get_object(results, i);
-            status = json_object_get_string(current, "status");
+            done_url = json_object_get_string(current, "vectorSetUrl");
+            if (done_url && strrchr(done_url, '/')) {
+                done_id = atoi(strrchr(done_url, '/') + 1);
+            }
+
+            /*
+             * Vector sets the results monitor saw graded were already
+             * reported, only failures are named again below
+             */
+            graded = amvp_vs_graded_lookup(ctx, done_id);
+            if (graded && !graded->failed) {
+                testsCompleted++;
+                continue;
+            }
+
+            status = graded ? "fail" : json_object_get_string(current, "status");
             if (!status) {
                 goto end;
             }
@@ -3713,8 +5289,16 @@ static AMVP_RESULT amvp_get_result_test_session(AMVP_CTX *ctx, char *session_url
              */
             strcmp_s("incomplete", 10, status, &diff);
             if (!diff) {
+                incomplete++;
                 continue;
             }
+
+            /* Report each vector set as soon as it is graded */
+            if (done_id && !graded && !amvp_lookup_param_list(reportedVsList, done_id)) {
+                AMVP_LOG_STATUS("Vector set %d: %s", done_id, status);
+                amvp_append_param_list(&reportedVsList, done_id);
+            }
+
             /*
              * If the result is fail, retrieve vector set, get algorithm name, add to list
              */
@@ -3732,39 +5316,49 @@ static AMVP_RESULT amvp_get_result_test_session(AMVP_CTX *ctx, char *session_url
                         AMVP_LOG_ERR("Error appending failed algorithm name to list, skipping...");
                         continue;
                     }
-                    //retrieve_vector_set expects a non-const string
-                    char *vs_url = calloc(AMVP_REQUEST_STR_LEN_MAX + 1, sizeof(char));
-                    if (!vs_url) {
-                        AMVP_LOG_ERR("Unable to calloc when reporting failed algorithms, skipping...");
-                        continue;                    
-                    }
-                    strncpy_s(vs_url, AMVP_REQUEST_STR_LEN_MAX + 1, vsurl, AMVP_REQUEST_STR_LEN_MAX);
-                    rv = amvp_retrieve_vector_set(ctx, vs_url);
-                    free(vs_url);
-                    if (rv != AMVP_SUCCESS) {
-                        AMVP_LOG_ERR("Unable to retrieve vector set while reporting failed algorithms, skipping...");
-                        continue;
-                    }
+                    /* Vector sets processed by this ctx or its session file need no download */
+                    mode = NULL;
+                    meta = amvp_vs_meta_lookup(ctx, vsurl);
+                    if (meta) {
+                        alg = meta->alg;
+                        if (meta->mode[0]) {
+                            mode = meta->mode;
+                        }
+                    } else {
+                        //retrieve_vector_set expects a non-const string
+                        char *vs_url = calloc(AMVP_REQUEST_STR_LEN_MAX + 1, sizeof(char));
+                        if (!vs_url) {
+                            AMVP_LOG_ERR("Unable to calloc when reporting failed algorithms, skipping...");
+                            continue;
+                        }
+                        strncpy_s(vs_url, AMVP_REQUEST_STR_LEN_MAX + 1, vsurl, AMVP_REQUEST_STR_LEN_MAX);
+                        rv = amvp_retrieve_vector_set(ctx, vs_url);
+                        free(vs_url);
+                        if (rv != AMVP_SUCCESS) {
+                            AMVP_LOG_ERR("Unable to retrieve vector set while reporting failed algorithms, skipping...");
+                            continue;
+                        }
 
-                    val2 = json_parse_string(ctx->curl_buf);
-                    if (!val2) {
-                        AMVP_LOG_ERR("JSON parse error while reporting failed algorithms, skipping...");
-                        continue;
-                    }
-                    obj2 = amvp_get_obj_from_rsp(ctx, val2);
-                    if (!obj2) {
-                        json_value_free(val2);
-                        AMVP_LOG_ERR("JSON parse error while reporting failed algorithms, skipping...");
-                        continue;
-                    }
-                    alg = json_object_get_string(obj2, "algorithm");
-                    if (!alg) {
-                        AMVP_LOG_ERR("JSON parse error while reporting failed algorithms, skipping...");
-                        continue;
-                    }
-                    //Some algorithms have the same names, but different modes. Need to differentiate.
-                    if (json_object_get_string(obj2, "mode")) {
-                        mode = json_object_get_string(obj2, "mode");
+                        val2 = json_parse_string(ctx->work.curl_buf);
+                        if (!val2) {
+                            AMVP_LOG_ERR("JSON parse error while reporting failed algorithms, skipping...");
+                            continue;
+                        }
+                        obj2 = amvp_get_obj_from_rsp(ctx, val2);
+                        if (!obj2) {
+                            json_value_free(val2);
+                            AMVP_LOG_ERR("JSON parse error while reporting failed algorithms, skipping...");
+                            continue;
+                        }
+                        alg = json_object_get_string(obj2, "algorithm");
+                        if (!alg) {
+                            AMVP_LOG_ERR("JSON parse error while reporting failed algorithms, skipping...");
+                            continue;
+                        }
+                        //Some algorithms have the same names, but different modes. Need to differentiate.
+                        if (json_object_get_string(obj2, "mode")) {
+                            mode = json_object_get_string(obj2, "mode");
+                        }
                     }
                     if (!amvp_lookup_str_list(&failedAlgList, alg) || !amvp_lookup_str_list(&failedModeList, mode)) {
                         rv = amvp_append_str_list(&failedAlgList, alg);
@@ -3815,7 +5409,22 @@ static AMVP_RESULT amvp_get_result_test_session(AMVP_CTX *ctx, char *session_url
              * If any tests are incomplete, retry, even if some have failed
              */
             amvp_list_failing_algorithms(ctx, &failedAlgList, &failedModeList);
-            AMVP_LOG_STATUS("TestSession results incomplete...");
+            AMVP_LOG_STATUS("TestSession results incomplete, %d of %d vector sets graded...", count - incomplete, count);
+            /*
+             * Poll sooner when only a few vector sets are left, unless the
+             * server asks for a specific interval
+             */
+            retry_interval = (int)json_object_get_number(obj, "retry");
+            if (retry_interval && retry_interval < AMVP_RESULTS_POLL_MIN) {
+                retry_interval = AMVP_RESULTS_POLL_MIN;
+            } else if (!retry_interval) {
+                retry_interval = incomplete * AMVP_RESULTS_POLL_PER_VS;
+                if (retry_interval < AMVP_RESULTS_POLL_MIN) {
+                    retry_interval = AMVP_RESULTS_POLL_MIN;
+                } else if (retry_interval > AMVP_RETRY_TIME) {
+                    retry_interval = AMVP_RETRY_TIME;
+                }
+            }
             if (amvp_retry_handler(ctx, &retry_interval, &time_waited_so_far, 1, AMVP_WAITING_FOR_RESULTS) != AMVP_KAT_DOWNLOAD_RETRY) {
                 AMVP_LOG_STATUS("Maximum wait time with server reached! (Max: %d seconds)", AMVP_MAX_WAIT_TIME);
                 rv = AMVP_TRANSPORT_FAIL;
@@ -3843,7 +5452,7 @@ static AMVP_RESULT amvp_get_result_test_session(AMVP_CTX *ctx, char *session_url
                 if (ctx->log_lvl == AMVP_LOG_LVL_VERBOSE) {
                     AMVP_LOG_STATUS("Getting details for failed Vector Set...");
                     rv = amvp_retrieve_vector_set_result(ctx, vs_url);
-                    printf("\n%s\n", ctx->curl_buf);
+                    printf("\n%s\n", ctx->work.curl_buf);
                     if (rv != AMVP_SUCCESS) goto end;
                 }
             }
@@ -3864,6 +5473,10 @@ end:
     if (failedVsList) {
         amvp_free_str_list(&failedVsList);
     }
+    if (reportedVsList) {
+        amvp_cap_free_pl(reportedVsList);
+    }
+    amvp_trace_span(ctx, "results", "results", start, 0, NULL);
     return rv;
 }
 
@@ -3934,7 +5547,7 @@ AMVP_RESULT amvp_post_data(AMVP_CTX *ctx, char *filename) {
         return AMVP_INVALID_ARG;
     }
 
-    val = json_parse_file(filename);
+    val = amvp_json_parse_file(filename);
     if (!val) {
         AMVP_LOG_ERR("JSON val parse error");
         return AMVP_MALFORMED_JSON;
@@ -3965,7 +5578,7 @@ AMVP_RESULT amvp_post_data(AMVP_CTX *ctx, char *filename) {
     json_value_free(reg_arry_val);
 
     rv = amvp_transport_post(ctx, path, json_result, len);
-    AMVP_LOG_STATUS("POST response:\n\n%s\n", ctx->curl_buf);
+    AMVP_LOG_STATUS("POST response:\n\n%s\n", ctx->work.curl_buf);
     json_free_serialized_string(json_result);
 
 end:
@@ -3996,7 +5609,7 @@ AMVP_RESULT amvp_post_resources(AMVP_CTX *ctx, const char *resource_file) {
         return AMVP_INVALID_ARG;
     }
 
-    val = json_parse_file(resource_file);
+    val = amvp_json_parse_file(resource_file);
     if (!val) {
         AMVP_LOG_ERR("Failed to parse JSON in metadata file");
         return AMVP_JSON_ERR;
@@ -4022,7 +5635,7 @@ AMVP_RESULT amvp_post_resources(AMVP_CTX *ctx, const char *resource_file) {
 
     AMVP_LOG_INFO("\nPOST Data: %s, %s\n\n", "/amv/v1/labs", json_result);
     rv = amvp_transport_post(ctx, "/amv/v1/labs", json_result, len);
-    AMVP_LOG_STATUS("POST response:\n\n%s\n", ctx->curl_buf);
+    AMVP_LOG_STATUS("POST response:\n\n%s\n", ctx->work.curl_buf);
     json_free_serialized_string(json_result);
     json_value_free(post_val);
 
@@ -4040,7 +5653,7 @@ AMVP_RESULT amvp_post_resources(AMVP_CTX *ctx, const char *resource_file) {
 
     AMVP_LOG_INFO("\nPOST Data: %s, %s\n\n", "/amv/v1/vendors", json_result);
     rv = amvp_transport_post(ctx, "/amv/v1/vendors", json_result, len);
-    AMVP_LOG_STATUS("POST response:\n\n%s\n", ctx->curl_buf);
+    AMVP_LOG_STATUS("POST response:\n\n%s\n", ctx->work.curl_buf);
     json_free_serialized_string(json_result);
     json_value_free(post_val);
 
@@ -4059,7 +5672,7 @@ AMVP_RESULT amvp_post_resources(AMVP_CTX *ctx, const char *resource_file) {
 
     AMVP_LOG_INFO("\nPOST Data: %s, %s\n\n", "/amv/v1/modules", json_result);
     rv = amvp_transport_post(ctx, "/amv/v1/modules", json_result, len);
-    AMVP_LOG_STATUS("POST response:\n\n%s\n", ctx->curl_buf);
+    AMVP_LOG_STATUS("POST response:\n\n%s\n", ctx->work.curl_buf);
     json_free_serialized_string(json_result);
     json_value_free(post_val);
 
@@ -4083,6 +5696,7 @@ AMVP_RESULT amvp_post_resources(AMVP_CTX *ctx, const char *resource_file) {
 static AMVP_RESULT amvp_write_session_info(AMVP_CTX *ctx) {
     AMVP_RESULT rv = AMVP_INTERNAL_ERR;
     JSON_Value *ts_val = NULL;
+    JSON_Value *meta_val = NULL;
     JSON_Object *ts_obj = NULL;
     char *filename = NULL, *ptr = NULL, *path = NULL, *prefix = NULL;
     int diff;
@@ -4103,6 +5717,10 @@ static AMVP_RESULT amvp_write_session_info(AMVP_CTX *ctx) {
     json_object_set_string(ts_obj, "jwt", ctx->jwt_token);
     json_object_set_boolean(ts_obj, "isSample", ctx->is_sample);
     json_object_set_value(ts_obj, "registration", ctx->registration);
+    meta_val = amvp_vs_meta_to_json(ctx);
+    if (meta_val) {
+        json_object_set_value(ts_obj, "vectorSets", meta_val);
+    }
 
     /* pull test session ID out of URL */
     ptr = ctx->session_url;
@@ -4159,13 +5777,13 @@ static AMVP_RESULT amvp_write_session_info(AMVP_CTX *ctx) {
         rv = AMVP_UNSUPPORTED_OP;
         goto end;
     }
-    rv = amvp_json_serialize_to_file_pretty_w(ts_val, filename);
+    rv = amvp_json_serialize_to_file_pretty_w(ctx, ts_val, filename);
     if (rv != AMVP_SUCCESS) {
         AMVP_LOG_ERR("File write error. Check that directory exists and allows writes.");
         goto end;
     }
 
-    rv = amvp_json_serialize_to_file_pretty_a(NULL, filename);
+    rv = amvp_json_serialize_to_file_pretty_a(ctx, NULL, filename);
     if (rv != AMVP_SUCCESS) {
         AMVP_LOG_ERR("File write error. Check that directory exists and allows writes.");
         goto end;
@@ -4208,7 +5826,7 @@ static AMVP_RESULT amvp_cert_req(AMVP_CTX *ctx)
         AMVP_LOG_ERR("Unable to retrieve docs");
         goto end;
     }
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->work.curl_buf);
     if (!val) {
         AMVP_LOG_ERR("JSON parse error");
         rv = AMVP_JSON_ERR;
@@ -4274,15 +5892,15 @@ AMVP_RESULT amvp_run(AMVP_CTX *ctx, int fips_validation) {
         rv = amvp_transport_get(ctx, ctx->get_string, NULL);
         if (ctx->save_filename) {
             AMVP_LOG_STATUS("Saving GET result to specified file...");
-            val = json_parse_string(ctx->curl_buf);
+            val = json_parse_string(ctx->work.curl_buf);
             if (!val) {
                 AMVP_LOG_ERR("Unable to parse JSON. printing output instead...");
             } else {
-                rv = amvp_json_serialize_to_file_pretty_w(val, ctx->save_filename);
+                rv = amvp_json_serialize_to_file_pretty_w(ctx, val, ctx->save_filename);
                 if (rv != AMVP_SUCCESS) {
                     AMVP_LOG_ERR("Failed to write file, printing instead...");
                 } else {
-                    rv = amvp_json_serialize_to_file_pretty_a(NULL, ctx->save_filename);
+                    rv = amvp_json_serialize_to_file_pretty_a(ctx, NULL, ctx->save_filename);
                     if (rv != AMVP_SUCCESS)
                         AMVP_LOG_WARN("Unable to append ending ] to write file");
                     goto end;
@@ -4290,9 +5908,9 @@ AMVP_RESULT amvp_run(AMVP_CTX *ctx, int fips_validation) {
             }
         }
         if (ctx->log_lvl == AMVP_LOG_LVL_VERBOSE) {
-            printf("\n\n%s\n\n", ctx->curl_buf);
+            printf("\n\n%s\n\n", ctx->work.curl_buf);
         } else {
-            AMVP_LOG_STATUS("GET Response:\n\n%s\n", ctx->curl_buf);
+            AMVP_LOG_STATUS("GET Response:\n\n%s\n", ctx->work.curl_buf);
         }
         goto end;
     }
@@ -4316,15 +5934,15 @@ AMVP_RESULT amvp_run(AMVP_CTX *ctx, int fips_validation) {
         rv = amvp_transport_delete(ctx, ctx->delete_string);
         if (ctx->save_filename) {
             AMVP_LOG_STATUS("Saving DELETE response to specified file...");
-            val = json_parse_string(ctx->curl_buf);
+            val = json_parse_string(ctx->work.curl_buf);
             if (!val) {
                 AMVP_LOG_ERR("Unable to parse JSON. printing output instead...");
             } else {
-                rv = amvp_json_serialize_to_file_pretty_w(val, ctx->save_filename);
+                rv = amvp_json_serialize_to_file_pretty_w(ctx, val, ctx->save_filename);
                 if (rv != AMVP_SUCCESS) {
                     AMVP_LOG_ERR("Failed to write file, printing instead...");
                 } else {
-                    rv = amvp_json_serialize_to_file_pretty_a(NULL, ctx->save_filename);
+                    rv = amvp_json_serialize_to_file_pretty_a(ctx, NULL, ctx->save_filename);
                     if (rv != AMVP_SUCCESS)
                         AMVP_LOG_WARN("Unable to append ending ] to write file");
                     goto end;
@@ -4332,9 +5950,9 @@ AMVP_RESULT amvp_run(AMVP_CTX *ctx, int fips_validation) {
             }
         }
         if (ctx->log_lvl == AMVP_LOG_LVL_VERBOSE) {
-            printf("\n\n%s\n\n", ctx->curl_buf);
+            printf("\n\n%s\n\n", ctx->work.curl_buf);
         } else {
-            AMVP_LOG_STATUS("DELETE Response:\n\n%s\n", ctx->curl_buf);
+            AMVP_LOG_STATUS("DELETE Response:\n\n%s\n", ctx->work.curl_buf);
         }
         goto end;
     }
@@ -4360,6 +5978,13 @@ AMVP_RESULT amvp_run(AMVP_CTX *ctx, int fips_validation) {
         AMVP_LOG_ERR("Failed to register with AMVP server");
         goto end;
     }
+
+    /*
+     * Start generating SigGen keys while the vector sets are downloaded
+     */
+    if (amvp_key_pool_start(ctx) != AMVP_SUCCESS) {
+        AMVP_LOG_WARN("Unable to start key pre-generation, keys will be generated on demand");
+    }
     
     //write session info so if we time out or lose connection waiting for results, we can recheck later on
     if (!ctx->put) {
@@ -4379,6 +6004,13 @@ AMVP_RESULT amvp_run(AMVP_CTX *ctx, int fips_validation) {
         AMVP_LOG_ERR("Failed to process vectors");
         goto end;
     }
+
+    /* Add the vector set metadata, so failures can be reported without downloading them again */
+    if (ctx->session_file_path && ctx->vs_meta) {
+        if (amvp_write_session_info(ctx) != AMVP_SUCCESS) {
+            AMVP_LOG_WARN("Unable to update the session info file with the vector set metadata");
+        }
+    }
 check:
     if (ctx->vector_req) {
         AMVP_LOG_STATUS("Successfully downloaded evidence and saved to specified file.");
@@ -4455,7 +6087,7 @@ AMVP_RESULT amvp_put_data_from_file(AMVP_CTX *ctx, const char *put_filename) {
         return AMVP_INVALID_ARG;
     }
 
-    val = json_parse_file(put_filename);
+    val = amvp_json_parse_file(put_filename);
     if (!val) {
         AMVP_LOG_ERR("JSON val parse error");
         return AMVP_MALFORMED_JSON;
@@ -4536,7 +6168,7 @@ AMVP_RESULT amvp_put_data_from_file(AMVP_CTX *ctx, const char *put_filename) {
             AMVP_LOG_STATUS("Failed to parse Validation response");
         }
     } else {
-        AMVP_LOG_STATUS("PUT response: \n%s", ctx->curl_buf);
+        AMVP_LOG_STATUS("PUT response: \n%s", ctx->work.curl_buf);
     }
 end:
     if (json_result) {json_free_serialized_string(json_result);}
@@ -4567,7 +6199,7 @@ static AMVP_RESULT amvp_put_data_from_ctx(AMVP_CTX *ctx) {
         return AMVP_INVALID_ARG;
     }
 
-    val = json_parse_file(ctx->put_filename);
+    val = amvp_json_parse_file(ctx->put_filename);
     if (!val) {
         AMVP_LOG_ERR("JSON val parse error");
         return AMVP_MALFORMED_JSON;
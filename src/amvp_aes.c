@@ -63,10 +63,10 @@ static AMVP_RESULT amvp_aes_release_tc(AMVP_SYM_CIPHER_TC *stc);
 #define IV_ROW_LEN 16
 #define TEXT_COL_LEN 1001
 #define TEXT_ROW_LEN 32
-static unsigned char mkey[KEY_COL_LEN][KEY_ROW_LEN];
-static unsigned char miv[IV_COL_LEN][IV_ROW_LEN];
-static unsigned char ptext[TEXT_COL_LEN][TEXT_ROW_LEN];
-static unsigned char ctext[TEXT_COL_LEN][TEXT_ROW_LEN];
+static AMVP_THREAD_LOCAL unsigned char mkey[KEY_COL_LEN][KEY_ROW_LEN];
+static AMVP_THREAD_LOCAL unsigned char miv[IV_COL_LEN][IV_ROW_LEN];
+static AMVP_THREAD_LOCAL unsigned char ptext[TEXT_COL_LEN][TEXT_ROW_LEN];
+static AMVP_THREAD_LOCAL unsigned char ctext[TEXT_COL_LEN][TEXT_ROW_LEN];
 
 #define gb(a, b) (((a)[(b) / 8] >> (7 - (b) % 8)) & 1)
 #define sb(a, b, v) ((a)[(b) / 8] = ((a)[(b) / 8] & ~(1 << (7 - (b) % 8))) | (!!(v) << (7 - (b) % 8)))
@@ -296,7 +296,7 @@ static AMVP_RESULT amvp_aes_mct_tc(AMVP_CTX *ctx,
         for (j = 0; j < AMVP_AES_MCT_INNER; ++j) {
             stc->mct_index = j;    /* indicates init vs. update */
             /* Process the current AES encrypt test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (amvp_crypto_handler(ctx, cap, tc)) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 free(tmp);
                 json_value_free(r_tval);
@@ -450,6 +450,82 @@ static AMVP_RESULT amvp_aes_mct_tc(AMVP_CTX *ctx,
     return AMVP_SUCCESS;
 }
 
+/*
+ * This is the MCT handler used when the crypto module registered a
+ * native MCT callback. The module runs the inner loop and prepares the
+ * key, iv and text of the next outer iteration itself, so libamvp only
+ * records the values of each outer iteration.
+ */
+static AMVP_RESULT amvp_aes_mct_native_tc(AMVP_CTX *ctx,
+                                          AMVP_CAPS_LIST *cap,
+                                          AMVP_TEST_CASE *tc,
+                                          AMVP_SYM_CIPHER_TC *stc,
+                                          JSON_Array *res_array) {
+    unsigned int i;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    JSON_Value *r_tval = NULL;  /* Response testval */
+    JSON_Object *r_tobj = NULL; /* Response testobj */
+    char *tmp = NULL;
+
+    tmp = calloc(AMVP_SYM_CT_MAX + 1, sizeof(char));
+    if (!tmp) {
+        AMVP_LOG_ERR("Unable to malloc in amvp_aes_mct_native_tc");
+        return AMVP_MALLOC_FAIL;
+    }
+
+    for (i = 0; i < AMVP_AES_MCT_OUTER; ++i) {
+        /*
+         * Create a new test case in the response
+         */
+        r_tval = json_value_init_object();
+        r_tobj = json_value_get_object(r_tval);
+
+        /*
+         * Output the test case request values using JSON
+         */
+        rv = amvp_aes_output_mct_tc(ctx, stc, r_tobj);
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("JSON output failure in AES module");
+            goto end;
+        }
+
+        stc->mct_index = i;
+        if (amvp_mct_handler(ctx, cap, tc)) {
+            AMVP_LOG_ERR("crypto module failed the operation");
+            rv = AMVP_CRYPTO_MODULE_FAIL;
+            goto end;
+        }
+
+        memzero_s(tmp, AMVP_SYM_CT_MAX);
+        if (stc->direction == AMVP_SYM_CIPH_DIR_ENCRYPT) {
+            rv = amvp_bin_to_hexstr(stc->ct, stc->cipher == AMVP_AES_CFB1 ? 1 : stc->ct_len,
+                                    tmp, AMVP_SYM_CT_MAX);
+            if (rv != AMVP_SUCCESS) {
+                AMVP_LOG_ERR("hex conversion failure (ct)");
+                goto end;
+            }
+            json_object_set_string(r_tobj, "ct", tmp);
+        } else {
+            rv = amvp_bin_to_hexstr(stc->pt, stc->cipher == AMVP_AES_CFB1 ? 1 : stc->pt_len,
+                                    tmp, AMVP_SYM_CT_MAX);
+            if (rv != AMVP_SUCCESS) {
+                AMVP_LOG_ERR("hex conversion failure (pt)");
+                goto end;
+            }
+            json_object_set_string(r_tobj, "pt", tmp);
+        }
+
+        /* Append the test response value to array */
+        json_array_append_value(res_array, r_tval);
+        r_tval = NULL;
+    }
+
+end:
+    if (r_tval) json_value_free(r_tval);
+    free(tmp);
+    return rv;
+}
+
 static AMVP_SYM_CIPH_TWEAK_MODE read_tw_mode(const char *str) {
     int diff = 0;
 
@@ -614,6 +690,31 @@ static AMVP_SYM_CIPH_DIR read_direction(const char *str) {
     return 0;
 }
 
+/*
+ * Batch adapters so queued AES test cases can be output and released
+ * through the common batch helpers.
+ */
+static AMVP_RESULT amvp_aes_batch_output_tc(AMVP_CTX *ctx,
+                                            AMVP_TEST_CASE *tc,
+                                            JSON_Object *r_tobj,
+                                            int tc_rv) {
+    AMVP_SYM_CIPHER_TC *stc = tc->tc.symmetric;
+
+    if (tc_rv) {
+        if (stc->cipher != AMVP_AES_KW && stc->cipher != AMVP_AES_GCM &&
+                stc->cipher != AMVP_AES_GCM_SIV && stc->cipher != AMVP_AES_CCM
+                && stc->cipher != AMVP_AES_KWP && stc->cipher != AMVP_AES_GMAC) {
+            AMVP_LOG_ERR("ERROR: crypto module failed the operation");
+            return AMVP_CRYPTO_MODULE_FAIL;
+        }
+    }
+    return amvp_aes_output_tc(ctx, stc, r_tobj, tc_rv);
+}
+
+static void amvp_aes_batch_release_tc(AMVP_TEST_CASE *tc) {
+    amvp_aes_release_tc(tc->tc.symmetric);
+}
+
 /*
  * This is the handler for AES KAT values.  This will parse
  * a JSON encoded vector set for AES.  Each test case is
@@ -641,9 +742,12 @@ AMVP_RESULT amvp_aes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *res_tarr = NULL;                /* Response resultsArray */
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
-    AMVP_CAPS_LIST *cap;
+    AMVP_CAPS_LIST *cap = NULL;
     AMVP_SYM_CIPHER_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
+    AMVP_TEST_GROUP group = { 0 };
+    AMVP_SYM_CIPHER_TC *batch_stc = NULL;
+    AMVP_TC_BATCH batch;
     AMVP_RESULT rv;
     char *json_result = NULL;
     const char *alg_str = NULL;
@@ -670,6 +774,7 @@ AMVP_RESULT amvp_aes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     }
 
     tc.tc.symmetric = &stc;
+    tc.group = &group;
 
     /* Get the crypto module handler for AES mode */
     alg_id = amvp_lookup_cipher_index(alg_str);
@@ -700,6 +805,16 @@ AMVP_RESULT amvp_aes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         return rv;
     }
 
+    amvp_tc_batch_init(&batch, &amvp_aes_batch_output_tc, &amvp_aes_batch_release_tc);
+    if (cap->batch_handler) {
+        batch_stc = calloc(AMVP_BATCH_TC_MAX, sizeof(AMVP_SYM_CIPHER_TC));
+        if (!batch_stc) {
+            AMVP_LOG_ERR("Unable to malloc batch test cases");
+            rv = AMVP_MALLOC_FAIL;
+            goto err;
+        }
+    }
+
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
     for (i = 0; i < g_cnt; i++) {
@@ -725,6 +840,7 @@ AMVP_RESULT amvp_aes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON group obj");
             rv = AMVP_TC_MISSING_DATA;
@@ -968,6 +1084,23 @@ AMVP_RESULT amvp_aes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
                 AMVP_LOG_VERBOSE("      kwCipher: %s", kwcipher_str);
         }
 
+        /*
+         * Let the crypto module set up any state shared by the group
+         */
+        group.cipher = alg_id;
+        group.tg_id = tgId;
+        group.test_type = test_type_str;
+        group.direction = dir;
+        group.key_len = keylen;
+        group.iv_len = ivlen;
+        group.tag_len = taglen;
+        group.aad_len = aadlen;
+        group.payload_len = paylen;
+        rv = amvp_group_begin(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
@@ -1199,6 +1332,36 @@ AMVP_RESULT amvp_aes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
             json_object_set_number(r_tobj, "tcId", tc_id);
 
+            if (cap->batch_handler && test_type != AMVP_SYM_TEST_TYPE_MCT) {
+                /*
+                 * Queue the test case for the crypto module's batch handler,
+                 * the results are output once the batch is flushed.
+                 */
+                AMVP_SYM_CIPHER_TC *bstc = &batch_stc[batch.count];
+
+                rv = amvp_aes_init_tc(ctx, bstc, tc_id, test_type, key, pt, ct, iv, tag, 
+                                      aad, salt, kwcipher, keylen, ivlen, datalen, paylen,
+                                      taglen, aadlen, saltLen, dataUnitLen, conformance, alg_id, dir, iv_gen,
+                                      iv_gen_mode, incr_ctr, ovrflw_ctr, tweak_mode, seq_num, salt_src);
+                if (rv != AMVP_SUCCESS) {
+                    AMVP_LOG_ERR("Init for stc (test case) failed");
+                    amvp_aes_release_tc(bstc);
+                    json_value_free(r_tval);
+                    goto err;
+                }
+                batch.tc[batch.count].tc.symmetric = bstc;
+                batch.tc[batch.count].group = &group;
+                batch.r_tval[batch.count++] = r_tval;
+
+                if (batch.count == AMVP_BATCH_TC_MAX) {
+                    rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+                    if (rv != AMVP_SUCCESS) {
+                        goto err;
+                    }
+                }
+                continue;
+            }
+
             /*
              * Setup the test case data that will be passed down to
              * the crypto module.
@@ -1217,7 +1380,11 @@ AMVP_RESULT amvp_aes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             if (stc.test_type == AMVP_SYM_TEST_TYPE_MCT) {
                 json_object_set_value(r_tobj, "resultsArray", json_value_init_array());
                 res_tarr = json_object_get_array(r_tobj, "resultsArray");
-                rv = amvp_aes_mct_tc(ctx, cap, &tc, &stc, res_tarr);
+                if (cap->mct_handler) {
+                    rv = amvp_aes_mct_native_tc(ctx, cap, &tc, &stc, res_tarr);
+                } else {
+                    rv = amvp_aes_mct_tc(ctx, cap, &tc, &stc, res_tarr);
+                }
                 if (rv != AMVP_SUCCESS) {
                     AMVP_LOG_ERR("crypto module failed the MCT operation");
                     json_value_free(r_tval);
@@ -1226,7 +1393,7 @@ AMVP_RESULT amvp_aes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
                 }
             } else {
                 /* Process the current AES KAT test vector... */
-                int t_rv = (cap->crypto_handler)(&tc);
+                int t_rv = amvp_crypto_handler(ctx, cap, &tc);
                 if (t_rv) {
                     if (alg_id != AMVP_AES_KW && alg_id != AMVP_AES_GCM &&
                             alg_id != AMVP_AES_GCM_SIV && alg_id != AMVP_AES_CCM 
@@ -1259,16 +1426,29 @@ AMVP_RESULT amvp_aes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+
+        /* Process any test cases still waiting on the batch handler */
+        rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+        rv = amvp_group_end(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
         json_array_append_value(r_garr, r_gval);
     }
     json_array_append_value(reg_arry, r_vs_val);
     rv = AMVP_SUCCESS;
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
 
 err:
+    amvp_group_end(ctx, cap, &group);
+    amvp_tc_batch_discard(&batch);
+    if (batch_stc) free(batch_stc);
     if (rv != AMVP_SUCCESS) {
         amvp_release_json(r_vs_val, r_gval);
     }
@@ -1428,19 +1608,19 @@ static AMVP_RESULT amvp_aes_init_tc(AMVP_CTX *ctx,
 
     memzero_s(stc, sizeof(AMVP_SYM_CIPHER_TC));
 
-    stc->key = calloc(AMVP_SYM_KEY_MAX_BYTES, 1);
+    stc->key = amvp_mem_calloc(AMVP_MEM_TC, AMVP_SYM_KEY_MAX_BYTES, 1);
     if (!stc->key) { return AMVP_MALLOC_FAIL; }
-    stc->pt = calloc( AMVP_SYM_PT_BYTE_MAX, 1);
+    stc->pt = amvp_mem_calloc(AMVP_MEM_TC,  AMVP_SYM_PT_BYTE_MAX, 1);
     if (!stc->pt) { return AMVP_MALLOC_FAIL; }
-    stc->ct = calloc(AMVP_SYM_CT_BYTE_MAX, 1);
+    stc->ct = amvp_mem_calloc(AMVP_MEM_TC, AMVP_SYM_CT_BYTE_MAX, 1);
     if (!stc->ct) { return AMVP_MALLOC_FAIL; }
-    stc->tag = calloc(AMVP_SYM_TAG_BYTE_MAX, 1);
+    stc->tag = amvp_mem_calloc(AMVP_MEM_TC, AMVP_SYM_TAG_BYTE_MAX, 1);
     if (!stc->tag) { return AMVP_MALLOC_FAIL; }
-    stc->iv = calloc(AMVP_SYM_IV_BYTE_MAX, 1);
+    stc->iv = amvp_mem_calloc(AMVP_MEM_TC, AMVP_SYM_IV_BYTE_MAX, 1);
     if (!stc->iv) { return AMVP_MALLOC_FAIL; }
-    stc->aad = calloc(AMVP_SYM_AAD_BYTE_MAX, 1);
+    stc->aad = amvp_mem_calloc(AMVP_MEM_TC, AMVP_SYM_AAD_BYTE_MAX, 1);
     if (!stc->aad) { return AMVP_MALLOC_FAIL; }
-    stc->salt = calloc(AMVP_AES_XPN_SALTLEN, 1);
+    stc->salt = amvp_mem_calloc(AMVP_MEM_TC, AMVP_AES_XPN_SALTLEN, 1);
     if (!stc->salt) { return AMVP_MALLOC_FAIL; }
 
     /*
@@ -1567,13 +1747,13 @@ static AMVP_RESULT amvp_aes_init_tc(AMVP_CTX *ctx,
  * a test case.
  */
 static AMVP_RESULT amvp_aes_release_tc(AMVP_SYM_CIPHER_TC *stc) {
-    if (stc->key) free(stc->key);
-    if (stc->pt) free(stc->pt);
-    if (stc->ct) free(stc->ct);
-    if (stc->tag) free(stc->tag);
-    if (stc->iv) free(stc->iv);
-    if (stc->aad) free(stc->aad);
-    if (stc->salt) free(stc->salt);
+    if (stc->key) amvp_mem_free(AMVP_MEM_TC, stc->key);
+    if (stc->pt) amvp_mem_free(AMVP_MEM_TC, stc->pt);
+    if (stc->ct) amvp_mem_free(AMVP_MEM_TC, stc->ct);
+    if (stc->tag) amvp_mem_free(AMVP_MEM_TC, stc->tag);
+    if (stc->iv) amvp_mem_free(AMVP_MEM_TC, stc->iv);
+    if (stc->aad) amvp_mem_free(AMVP_MEM_TC, stc->aad);
+    if (stc->salt) amvp_mem_free(AMVP_MEM_TC, stc->salt);
     memzero_s(stc, sizeof(AMVP_SYM_CIPHER_TC));
 
     return AMVP_SUCCESS;
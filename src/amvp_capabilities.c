@@ -34,13 +34,13 @@ static AMVP_DSA_CAP *allocate_dsa_cap(void) {
     int i = 0;
 
     // Allocate the capability object
-    cap = calloc(1, sizeof(AMVP_DSA_CAP));
+    cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_DSA_CAP));
     if (!cap) return NULL;
 
     // Allocate the array of dsa_mode
-    modes = calloc(AMVP_DSA_MAX_MODES, sizeof(AMVP_DSA_CAP_MODE));
+    modes = amvp_mem_calloc(AMVP_MEM_CAPS, AMVP_DSA_MAX_MODES, sizeof(AMVP_DSA_CAP_MODE));
     if (!modes) {
-        free(cap);
+        amvp_mem_free(AMVP_MEM_CAPS, cap);
         return NULL;
     }
     cap->dsa_cap_mode = modes;
@@ -61,14 +61,14 @@ static AMVP_KAS_ECC_CAP *allocate_kas_ecc_cap(void) {
     AMVP_KAS_ECC_CAP_MODE *modes = NULL;
     int i = 0;
 
-    cap = calloc(1, sizeof(AMVP_KAS_ECC_CAP));
+    cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KAS_ECC_CAP));
     if (!cap) {
         return NULL;
     }
 
-    modes = calloc(AMVP_KAS_ECC_MAX_MODES, sizeof(AMVP_KAS_ECC_CAP_MODE));
+    modes = amvp_mem_calloc(AMVP_MEM_CAPS, AMVP_KAS_ECC_MAX_MODES, sizeof(AMVP_KAS_ECC_CAP_MODE));
     if (!modes) {
-        free(cap);
+        amvp_mem_free(AMVP_MEM_CAPS, cap);
         return NULL;
     }
     cap->kas_ecc_mode = (AMVP_KAS_ECC_CAP_MODE *)modes;
@@ -85,14 +85,14 @@ static AMVP_KAS_FFC_CAP *allocate_kas_ffc_cap(void) {
     AMVP_KAS_FFC_MODE *modes = NULL;
     int i = 0;
 
-    cap = calloc(1, sizeof(AMVP_KAS_FFC_CAP));
+    cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KAS_FFC_CAP));
     if (!cap) {
         return NULL;
     }
 
-    modes = calloc(AMVP_KAS_FFC_MAX_MODES, sizeof(AMVP_KAS_FFC_CAP_MODE));
+    modes = amvp_mem_calloc(AMVP_MEM_CAPS, AMVP_KAS_FFC_MAX_MODES, sizeof(AMVP_KAS_FFC_CAP_MODE));
     if (!modes) {
-        free(cap);
+        amvp_mem_free(AMVP_MEM_CAPS, cap);
         return NULL;
     }
 
@@ -107,7 +107,7 @@ static AMVP_KAS_FFC_CAP *allocate_kas_ffc_cap(void) {
 static AMVP_KAS_IFC_CAP *allocate_kas_ifc_cap(void) {
     AMVP_KAS_IFC_CAP *cap = NULL;
 
-    cap = calloc(1, sizeof(AMVP_KAS_IFC_CAP));
+    cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KAS_IFC_CAP));
     if (!cap) {
         return NULL;
     }
@@ -118,7 +118,7 @@ static AMVP_KAS_IFC_CAP *allocate_kas_ifc_cap(void) {
 static AMVP_KTS_IFC_CAP *allocate_kts_ifc_cap(void) {
     AMVP_KTS_IFC_CAP *cap = NULL;
 
-    cap = calloc(1, sizeof(AMVP_KTS_IFC_CAP));
+    cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KTS_IFC_CAP));
     if (!cap) {
         return NULL;
     }
@@ -129,7 +129,7 @@ static AMVP_KTS_IFC_CAP *allocate_kts_ifc_cap(void) {
 static AMVP_SAFE_PRIMES_CAP *allocate_safe_primes_cap(void) {
     AMVP_SAFE_PRIMES_CAP *cap = NULL;
 
-    cap = calloc(1, sizeof(AMVP_SAFE_PRIMES_CAP));
+    cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_SAFE_PRIMES_CAP));
     if (!cap) {
         return NULL;
     }
@@ -165,14 +165,14 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
         return AMVP_DUP_CIPHER;
     }
 
-    cap_entry = calloc(1, sizeof(AMVP_CAPS_LIST));
+    cap_entry = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_CAPS_LIST));
     if (!cap_entry) {
         return AMVP_MALLOC_FAIL;
     }
 
     switch (type) {
     case AMVP_CMAC_TYPE:
-        cap_entry->cap.cmac_cap = calloc(1, sizeof(AMVP_CMAC_CAP));
+        cap_entry->cap.cmac_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_CMAC_CAP));
         if (!cap_entry->cap.cmac_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -180,7 +180,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
         break;
 
     case AMVP_KMAC_TYPE:
-        cap_entry->cap.kmac_cap = calloc(1, sizeof(AMVP_KMAC_CAP));
+        cap_entry->cap.kmac_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KMAC_CAP));
         if (!cap_entry->cap.kmac_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -188,7 +188,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
         break;
 
     case AMVP_DRBG_TYPE:
-        cap_entry->cap.drbg_cap = calloc(1, sizeof(AMVP_DRBG_CAP));
+        cap_entry->cap.drbg_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_DRBG_CAP));
         if (!cap_entry->cap.drbg_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -208,7 +208,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.ecdsa_keygen_cap = calloc(1, sizeof(AMVP_ECDSA_CAP));
+        cap_entry->cap.ecdsa_keygen_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_ECDSA_CAP));
         if (!cap_entry->cap.ecdsa_keygen_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -220,7 +220,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.ecdsa_keyver_cap = calloc(1, sizeof(AMVP_ECDSA_CAP));
+        cap_entry->cap.ecdsa_keyver_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_ECDSA_CAP));
         if (!cap_entry->cap.ecdsa_keyver_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -232,7 +232,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.ecdsa_siggen_cap = calloc(1, sizeof(AMVP_ECDSA_CAP));
+        cap_entry->cap.ecdsa_siggen_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_ECDSA_CAP));
         if (!cap_entry->cap.ecdsa_siggen_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -244,7 +244,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.ecdsa_sigver_cap = calloc(1, sizeof(AMVP_ECDSA_CAP));
+        cap_entry->cap.ecdsa_sigver_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_ECDSA_CAP));
         if (!cap_entry->cap.ecdsa_sigver_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -252,7 +252,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
         break;
 
     case AMVP_HASH_TYPE:
-        cap_entry->cap.hash_cap = calloc(1, sizeof(AMVP_HASH_CAP));
+        cap_entry->cap.hash_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_HASH_CAP));
         if (!cap_entry->cap.hash_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -260,7 +260,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
         break;
 
     case AMVP_HMAC_TYPE:
-        cap_entry->cap.hmac_cap = calloc(1, sizeof(AMVP_HMAC_CAP));
+        cap_entry->cap.hmac_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_HMAC_CAP));
         if (!cap_entry->cap.hmac_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -355,7 +355,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kda_hkdf_cap = calloc(1, sizeof(AMVP_KDA_HKDF_CAP));
+        cap_entry->cap.kda_hkdf_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDA_HKDF_CAP));
         if (!cap_entry->cap.kda_hkdf_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -367,7 +367,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kda_onestep_cap = calloc(1, sizeof(AMVP_KDA_ONESTEP_CAP));
+        cap_entry->cap.kda_onestep_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDA_ONESTEP_CAP));
         if (!cap_entry->cap.kda_onestep_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -379,7 +379,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kda_twostep_cap = calloc(1, sizeof(AMVP_KDA_TWOSTEP_CAP));
+        cap_entry->cap.kda_twostep_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDA_TWOSTEP_CAP));
         if (!cap_entry->cap.kda_twostep_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -415,7 +415,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf108_cap = calloc(1, sizeof(AMVP_KDF108_CAP));
+        cap_entry->cap.kdf108_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDF108_CAP));
         if (!cap_entry->cap.kdf108_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -427,7 +427,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_ikev1_cap = calloc(1, sizeof(AMVP_KDF135_IKEV1_CAP));
+        cap_entry->cap.kdf135_ikev1_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDF135_IKEV1_CAP));
         if (!cap_entry->cap.kdf135_ikev1_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -439,7 +439,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_ikev2_cap = calloc(1, sizeof(AMVP_KDF135_IKEV2_CAP));
+        cap_entry->cap.kdf135_ikev2_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDF135_IKEV2_CAP));
         if (!cap_entry->cap.kdf135_ikev2_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -451,7 +451,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_snmp_cap = calloc(1, sizeof(AMVP_KDF135_SNMP_CAP));
+        cap_entry->cap.kdf135_snmp_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDF135_SNMP_CAP));
         if (!cap_entry->cap.kdf135_snmp_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -463,7 +463,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_srtp_cap = calloc(1, sizeof(AMVP_KDF135_SRTP_CAP));
+        cap_entry->cap.kdf135_srtp_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDF135_SRTP_CAP));
         if (!cap_entry->cap.kdf135_srtp_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -475,7 +475,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_ssh_cap = calloc(1, sizeof(AMVP_KDF135_SSH_CAP));
+        cap_entry->cap.kdf135_ssh_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDF135_SSH_CAP));
         if (!cap_entry->cap.kdf135_ssh_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -487,7 +487,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_x942_cap = calloc(1, sizeof(AMVP_KDF135_X942_CAP));
+        cap_entry->cap.kdf135_x942_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDF135_X942_CAP));
         if (!cap_entry->cap.kdf135_x942_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -499,7 +499,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf135_x963_cap = calloc(1, sizeof(AMVP_KDF135_X963_CAP));
+        cap_entry->cap.kdf135_x963_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDF135_X963_CAP));
         if (!cap_entry->cap.kdf135_x963_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -511,7 +511,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.pbkdf_cap = calloc(1, sizeof(AMVP_PBKDF_CAP));
+        cap_entry->cap.pbkdf_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_PBKDF_CAP));
         if (!cap_entry->cap.pbkdf_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -523,7 +523,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf_tls12_cap = calloc(1, sizeof(AMVP_KDF_TLS12_CAP));
+        cap_entry->cap.kdf_tls12_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDF_TLS12_CAP));
         if (!cap_entry->cap.kdf_tls12_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -535,7 +535,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.kdf_tls13_cap = calloc(1, sizeof(AMVP_KDF_TLS13_CAP));
+        cap_entry->cap.kdf_tls13_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KDF_TLS13_CAP));
         if (!cap_entry->cap.kdf_tls13_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -547,7 +547,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.rsa_keygen_cap = calloc(1, sizeof(AMVP_RSA_KEYGEN_CAP));
+        cap_entry->cap.rsa_keygen_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_KEYGEN_CAP));
         if (!cap_entry->cap.rsa_keygen_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -559,7 +559,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.rsa_siggen_cap = calloc(1, sizeof(AMVP_RSA_SIG_CAP));
+        cap_entry->cap.rsa_siggen_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_SIG_CAP));
         if (!cap_entry->cap.rsa_siggen_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -570,7 +570,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.rsa_sigver_cap = calloc(1, sizeof(AMVP_RSA_SIG_CAP));
+        cap_entry->cap.rsa_sigver_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_SIG_CAP));
         if (!cap_entry->cap.rsa_sigver_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -581,14 +581,14 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
             rv = AMVP_INVALID_ARG;
             goto err;
         }
-        cap_entry->cap.rsa_prim_cap = calloc(1, sizeof(AMVP_RSA_PRIM_CAP));
+        cap_entry->cap.rsa_prim_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_PRIM_CAP));
         if (!cap_entry->cap.rsa_prim_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
         }
         break;
     case AMVP_SYM_TYPE:
-        cap_entry->cap.sym_cap = calloc(1, sizeof(AMVP_SYM_CIPHER_CAP));
+        cap_entry->cap.sym_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_SYM_CIPHER_CAP));
         if (!cap_entry->cap.sym_cap) {
             rv = AMVP_MALLOC_FAIL;
             goto err;
@@ -641,7 +641,7 @@ static AMVP_RESULT amvp_cap_list_append(AMVP_CTX *ctx,
     return AMVP_SUCCESS;
 
 err:
-    if (cap_entry) free(cap_entry);
+    if (cap_entry) amvp_mem_free(AMVP_MEM_CAPS, cap_entry);
 
     return rv;
 }
@@ -767,7 +767,7 @@ static AMVP_RESULT amvp_dsa_set_modulo(AMVP_DSA_CAP_MODE *dsa_cap_mode,
 
     attrs = dsa_cap_mode->dsa_attrs;
     if (!attrs) {
-        attrs = calloc(1, sizeof(AMVP_DSA_ATTRS));
+        attrs = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_DSA_ATTRS));
         if (!attrs) {
             return AMVP_MALLOC_FAIL;
         }
@@ -785,7 +785,7 @@ static AMVP_RESULT amvp_dsa_set_modulo(AMVP_DSA_CAP_MODE *dsa_cap_mode,
         }
         attrs = attrs->next;
     }
-    attrs->next = calloc(1, sizeof(AMVP_DSA_ATTRS));
+    attrs->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_DSA_ATTRS));
     if (!attrs->next) {
         return AMVP_MALLOC_FAIL;
     }
@@ -2083,7 +2083,7 @@ static AMVP_RESULT amvp_add_prereq_val(AMVP_CIPHER cipher,
     AMVP_PREREQ_LIST *prereq_entry, *prereq_entry_2;
     AMVP_RESULT result;
 
-    prereq_entry = calloc(1, sizeof(AMVP_PREREQ_LIST));
+    prereq_entry = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_PREREQ_LIST));
     if (!prereq_entry) {
         return AMVP_MALLOC_FAIL;
     }
@@ -2092,7 +2092,7 @@ static AMVP_RESULT amvp_add_prereq_val(AMVP_CIPHER cipher,
 
     result = amvp_validate_prereq_val(cipher, pre_req);
     if (result != AMVP_SUCCESS) {
-        free(prereq_entry);
+        amvp_mem_free(AMVP_MEM_CAPS, prereq_entry);
         return result;
     }
     /*
@@ -3646,6 +3646,206 @@ AMVP_RESULT amvp_cap_kmac_set_domain(AMVP_CTX *ctx,
 
 }
 
+AMVP_RESULT amvp_cap_set_batch_handler(AMVP_CTX *ctx,
+                                       AMVP_CIPHER cipher,
+                                       int (*batch_handler)(AMVP_TEST_CASE *test_cases,
+                                                            int *results,
+                                                            int count)) {
+    AMVP_CAPS_LIST *cap;
+
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!batch_handler) {
+        AMVP_LOG_ERR("NULL parameter 'batch_handler'");
+        return AMVP_INVALID_ARG;
+    }
+
+    /*
+     * Locate this cipher in the caps array
+     */
+    cap = amvp_locate_cap_entry(ctx, cipher);
+    if (!cap) {
+        AMVP_LOG_ERR("Cap entry not found, enable the capability first.");
+        return AMVP_NO_CAP;
+    }
+
+    switch (cap->cap_type) {
+    case AMVP_SYM_TYPE:
+    case AMVP_HASH_TYPE:
+    case AMVP_HMAC_TYPE:
+    case AMVP_CMAC_TYPE:
+    case AMVP_KMAC_TYPE:
+        break;
+    default:
+        AMVP_LOG_ERR("Batch handlers are not supported for cipher '%s'",
+                     amvp_lookup_cipher_name(cipher));
+        return AMVP_UNSUPPORTED_OP;
+    }
+
+    cap->batch_handler = batch_handler;
+
+    return AMVP_SUCCESS;
+}
+
+AMVP_RESULT amvp_cap_set_mct_handler(AMVP_CTX *ctx,
+                                     AMVP_CIPHER cipher,
+                                     int (*mct_handler)(AMVP_TEST_CASE *test_case)) {
+    AMVP_CAPS_LIST *cap;
+
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!mct_handler) {
+        AMVP_LOG_ERR("NULL parameter 'mct_handler'");
+        return AMVP_INVALID_ARG;
+    }
+
+    /*
+     * Locate this cipher in the caps array
+     */
+    cap = amvp_locate_cap_entry(ctx, cipher);
+    if (!cap) {
+        AMVP_LOG_ERR("Cap entry not found, enable the capability first.");
+        return AMVP_NO_CAP;
+    }
+
+    switch (cipher) {
+    case AMVP_HASH_SHA1:
+    case AMVP_HASH_SHA224:
+    case AMVP_HASH_SHA256:
+    case AMVP_HASH_SHA384:
+    case AMVP_HASH_SHA512:
+    case AMVP_HASH_SHA512_224:
+    case AMVP_HASH_SHA512_256:
+    case AMVP_HASH_SHA3_224:
+    case AMVP_HASH_SHA3_256:
+    case AMVP_HASH_SHA3_384:
+    case AMVP_HASH_SHA3_512:
+    case AMVP_HASH_SHAKE_128:
+    case AMVP_HASH_SHAKE_256:
+    case AMVP_AES_ECB:
+    case AMVP_AES_CBC:
+    case AMVP_AES_OFB:
+    case AMVP_AES_CFB1:
+    case AMVP_AES_CFB8:
+    case AMVP_AES_CFB128:
+    case AMVP_TDES_ECB:
+    case AMVP_TDES_CBC:
+    case AMVP_TDES_OFB:
+    case AMVP_TDES_CFB1:
+    case AMVP_TDES_CFB8:
+    case AMVP_TDES_CFB64:
+        break;
+    default:
+        AMVP_LOG_ERR("Native MCT handlers are not supported for cipher '%s'",
+                     amvp_lookup_cipher_name(cipher));
+        return AMVP_UNSUPPORTED_OP;
+    }
+
+    cap->mct_handler = mct_handler;
+
+    return AMVP_SUCCESS;
+}
+
+AMVP_RESULT amvp_cap_set_group_handlers(AMVP_CTX *ctx,
+                                        AMVP_CIPHER cipher,
+                                        int (*group_begin)(AMVP_TEST_GROUP *group),
+                                        int (*group_end)(AMVP_TEST_GROUP *group)) {
+    AMVP_CAPS_LIST *cap;
+
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!group_begin && !group_end) {
+        AMVP_LOG_ERR("NULL parameters 'group_begin' and 'group_end'");
+        return AMVP_INVALID_ARG;
+    }
+
+    /*
+     * Locate this cipher in the caps array
+     */
+    cap = amvp_locate_cap_entry(ctx, cipher);
+    if (!cap) {
+        AMVP_LOG_ERR("Cap entry not found, enable the capability first.");
+        return AMVP_NO_CAP;
+    }
+
+    switch (cap->cap_type) {
+    case AMVP_SYM_TYPE:
+    case AMVP_HASH_TYPE:
+    case AMVP_HMAC_TYPE:
+    case AMVP_CMAC_TYPE:
+    case AMVP_KMAC_TYPE:
+    case AMVP_DRBG_TYPE:
+    case AMVP_RSA_SIGGEN_TYPE:
+    case AMVP_RSA_SIGVER_TYPE:
+    case AMVP_ECDSA_KEYGEN_TYPE:
+    case AMVP_ECDSA_KEYVER_TYPE:
+    case AMVP_ECDSA_SIGGEN_TYPE:
+    case AMVP_ECDSA_SIGVER_TYPE:
+        break;
+    case AMVP_DSA_TYPE:
+        if (cipher != AMVP_DSA_SIGGEN) {
+            AMVP_LOG_ERR("Group handlers are only supported for DSA SigGen");
+            return AMVP_UNSUPPORTED_OP;
+        }
+        break;
+    default:
+        AMVP_LOG_ERR("Group handlers are not supported for cipher '%s'",
+                     amvp_lookup_cipher_name(cipher));
+        return AMVP_UNSUPPORTED_OP;
+    }
+
+    cap->group_begin = group_begin;
+    cap->group_end = group_end;
+
+    return AMVP_SUCCESS;
+}
+
+AMVP_RESULT amvp_cap_set_key_pregen_handler(AMVP_CTX *ctx,
+                                            AMVP_CIPHER cipher,
+                                            int (*key_gen)(AMVP_TEST_GROUP *group),
+                                            void (*key_free)(void *key)) {
+    AMVP_CAPS_LIST *cap;
+
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!key_gen || !key_free) {
+        AMVP_LOG_ERR("NULL parameter 'key_gen' or 'key_free'");
+        return AMVP_INVALID_ARG;
+    }
+    if (ctx->key_pool) {
+        AMVP_LOG_ERR("Key pre-generation has already started");
+        return AMVP_UNSUPPORTED_OP;
+    }
+
+    switch (cipher) {
+    case AMVP_RSA_SIGGEN:
+    case AMVP_ECDSA_SIGGEN:
+    case AMVP_DSA_SIGGEN:
+        break;
+    default:
+        AMVP_LOG_ERR("Key pre-generation is not supported for cipher '%s'",
+                     amvp_lookup_cipher_name(cipher));
+        return AMVP_UNSUPPORTED_OP;
+    }
+
+    /*
+     * Locate this cipher in the caps array
+     */
+    cap = amvp_locate_cap_entry(ctx, cipher);
+    if (!cap) {
+        AMVP_LOG_ERR("Cap entry not found, enable the capability first.");
+        return AMVP_NO_CAP;
+    }
+
+    cap->key_gen = key_gen;
+    cap->key_free = key_free;
+    return AMVP_SUCCESS;
+}
+
 /*
  * Add DRBG Length Range
  */
@@ -3978,7 +4178,7 @@ AMVP_RESULT amvp_cap_rsa_keygen_set_mode(AMVP_CTX *ctx,
     }
 
     if (!cap_list->cap.rsa_keygen_cap) {
-        cap_list->cap.rsa_keygen_cap = calloc(1, sizeof(AMVP_RSA_KEYGEN_CAP));
+        cap_list->cap.rsa_keygen_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_KEYGEN_CAP));
     }
     keygen_cap = cap_list->cap.rsa_keygen_cap;
 
@@ -3994,7 +4194,7 @@ AMVP_RESULT amvp_cap_rsa_keygen_set_mode(AMVP_CTX *ctx,
             return AMVP_DUP_CIPHER;
         }
         if (!keygen_cap->next) {
-            keygen_cap->next = calloc(1, sizeof(AMVP_RSA_KEYGEN_CAP));
+            keygen_cap->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_KEYGEN_CAP));
             keygen_cap = keygen_cap->next;
             break;
         }
@@ -4146,7 +4346,7 @@ AMVP_RESULT amvp_cap_rsa_sigver_set_type(AMVP_CTX *ctx,
     }
 
     if (!cap_list->cap.rsa_sigver_cap) {
-        cap_list->cap.rsa_sigver_cap = calloc(1, sizeof(AMVP_RSA_SIG_CAP));
+        cap_list->cap.rsa_sigver_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_SIG_CAP));
     }
     sigver_cap = cap_list->cap.rsa_sigver_cap;
 
@@ -4158,7 +4358,7 @@ AMVP_RESULT amvp_cap_rsa_sigver_set_type(AMVP_CTX *ctx,
             return AMVP_DUP_CIPHER;
         }
         if (!sigver_cap->next) {
-            sigver_cap->next = calloc(1, sizeof(AMVP_RSA_SIG_CAP));
+            sigver_cap->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_SIG_CAP));
             sigver_cap = sigver_cap->next;
             break;
         }
@@ -4199,7 +4399,7 @@ AMVP_RESULT amvp_cap_rsa_siggen_set_type(AMVP_CTX *ctx,
     }
 
     if (!cap_list->cap.rsa_siggen_cap) {
-        cap_list->cap.rsa_siggen_cap = calloc(1, sizeof(AMVP_RSA_SIG_CAP));
+        cap_list->cap.rsa_siggen_cap = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_SIG_CAP));
     }
     siggen_cap = cap_list->cap.rsa_siggen_cap;
 
@@ -4211,7 +4411,7 @@ AMVP_RESULT amvp_cap_rsa_siggen_set_type(AMVP_CTX *ctx,
             return AMVP_DUP_CIPHER;
         }
         if (!siggen_cap->next) {
-            siggen_cap->next = calloc(1, sizeof(AMVP_RSA_SIG_CAP));
+            siggen_cap->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_SIG_CAP));
             siggen_cap = siggen_cap->next;
             break;
         }
@@ -4270,7 +4470,7 @@ AMVP_RESULT amvp_cap_rsa_keygen_set_exponent(AMVP_CTX *ctx,
                     return AMVP_INVALID_ARG;
                 }
 
-                cap->fixed_pub_exp = calloc(len + 1, sizeof(char));
+                cap->fixed_pub_exp = amvp_mem_calloc(AMVP_MEM_CAPS, len + 1, sizeof(char));
                 strcpy_s(cap->fixed_pub_exp, len + 1, value);
             } else {
                 AMVP_LOG_ERR("AMVP_FIXED_PUB_EXP_VAL has already been set.");
@@ -4323,7 +4523,7 @@ AMVP_RESULT amvp_cap_rsa_sigver_set_exponent(AMVP_CTX *ctx,
                     return AMVP_INVALID_ARG;
                 }
 
-                cap->fixed_pub_exp = calloc(len + 1, sizeof(char));
+                cap->fixed_pub_exp = amvp_mem_calloc(AMVP_MEM_CAPS, len + 1, sizeof(char));
                 strcpy_s(cap->fixed_pub_exp, len + 1, value);
             } else {
                 AMVP_LOG_ERR("AMVP_FIXED_PUB_EXP_VAL has already been set.");
@@ -4384,7 +4584,7 @@ AMVP_RESULT amvp_cap_rsa_keygen_set_primes(AMVP_CTX *ctx,
     }
 
     if (!keygen_cap->mode_capabilities) {
-        keygen_cap->mode_capabilities = calloc(1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
+        keygen_cap->mode_capabilities = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
         if (!keygen_cap->mode_capabilities) {
             AMVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return AMVP_MALLOC_FAIL;
@@ -4398,7 +4598,7 @@ AMVP_RESULT amvp_cap_rsa_keygen_set_primes(AMVP_CTX *ctx,
         do {
             if (current_prime->modulo != mod) {
                 if (current_prime->next == NULL) {
-                    current_prime->next = calloc(1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
+                    current_prime->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
                     if (!current_prime->next) {
                         AMVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
                         return AMVP_MALLOC_FAIL;
@@ -4483,7 +4683,7 @@ AMVP_RESULT amvp_cap_rsa_sigver_set_mod_parm(AMVP_CTX *ctx,
     }
 
     if (!sigver_cap->mode_capabilities) {
-        sigver_cap->mode_capabilities = calloc(1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
+        sigver_cap->mode_capabilities = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
         if (!sigver_cap->mode_capabilities) {
             AMVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return AMVP_MALLOC_FAIL;
@@ -4497,7 +4697,7 @@ AMVP_RESULT amvp_cap_rsa_sigver_set_mod_parm(AMVP_CTX *ctx,
         do {
             if (current_cap->modulo != mod) {
                 if (current_cap->next == NULL) {
-                    current_cap->next = calloc(1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
+                    current_cap->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
                     if (!current_cap->next) {
                         AMVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
                         return AMVP_MALLOC_FAIL;
@@ -4520,7 +4720,7 @@ AMVP_RESULT amvp_cap_rsa_sigver_set_mod_parm(AMVP_CTX *ctx,
     }
 
     if (!current_cap->hash_pair) {
-        current_cap->hash_pair = calloc(1, sizeof(AMVP_RSA_HASH_PAIR_LIST));
+        current_cap->hash_pair = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_HASH_PAIR_LIST));
         if (!current_cap->hash_pair) {
             AMVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return AMVP_MALLOC_FAIL;
@@ -4534,7 +4734,7 @@ AMVP_RESULT amvp_cap_rsa_sigver_set_mod_parm(AMVP_CTX *ctx,
         while (current_hash->next != NULL) {
             current_hash = current_hash->next;
         }
-        current_hash->next = calloc(1, sizeof(AMVP_RSA_HASH_PAIR_LIST));
+        current_hash->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_HASH_PAIR_LIST));
         if (!current_hash->next) {
             AMVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return AMVP_MALLOC_FAIL;
@@ -4592,7 +4792,7 @@ AMVP_RESULT amvp_cap_rsa_siggen_set_mod_parm(AMVP_CTX *ctx,
     }
 
     if (!siggen_cap->mode_capabilities) {
-        siggen_cap->mode_capabilities = calloc(1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
+        siggen_cap->mode_capabilities = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
         if (!siggen_cap->mode_capabilities) {
             AMVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return AMVP_MALLOC_FAIL;
@@ -4606,7 +4806,7 @@ AMVP_RESULT amvp_cap_rsa_siggen_set_mod_parm(AMVP_CTX *ctx,
         do {
             if (current_cap->modulo != mod) {
                 if (current_cap->next == NULL) {
-                    current_cap->next = calloc(1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
+                    current_cap->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_MODE_CAPS_LIST));
                     if (!current_cap->next) {
                         AMVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
                         return AMVP_MALLOC_FAIL;
@@ -4629,7 +4829,7 @@ AMVP_RESULT amvp_cap_rsa_siggen_set_mod_parm(AMVP_CTX *ctx,
     }
 
     if (!current_cap->hash_pair) {
-        current_cap->hash_pair = calloc(1, sizeof(AMVP_RSA_HASH_PAIR_LIST));
+        current_cap->hash_pair = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_HASH_PAIR_LIST));
         if (!current_cap->hash_pair) {
             AMVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return AMVP_MALLOC_FAIL;
@@ -4643,7 +4843,7 @@ AMVP_RESULT amvp_cap_rsa_siggen_set_mod_parm(AMVP_CTX *ctx,
         while (current_hash->next != NULL) {
             current_hash = current_hash->next;
         }
-        current_hash->next = calloc(1, sizeof(AMVP_RSA_HASH_PAIR_LIST));
+        current_hash->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_RSA_HASH_PAIR_LIST));
         if (!current_hash->next) {
             AMVP_LOG_ERR("Malloc Failed -- enable rsa cap parm");
             return AMVP_MALLOC_FAIL;
@@ -4846,7 +5046,7 @@ AMVP_RESULT amvp_cap_rsa_prim_set_exponent(AMVP_CTX *ctx,
                     return AMVP_INVALID_ARG;
                 }
 
-                cap->fixed_pub_exp = calloc(len + 1, sizeof(char));
+                cap->fixed_pub_exp = amvp_mem_calloc(AMVP_MEM_CAPS, len + 1, sizeof(char));
                 strcpy_s(cap->fixed_pub_exp, len + 1, value);
             } else {
                 AMVP_LOG_ERR("AMVP_FIXED_PUB_EXP_VAL has already been set.");
@@ -4924,10 +5124,10 @@ AMVP_RESULT amvp_cap_ecdsa_set_parm(AMVP_CTX *ctx,
             while (current_curve->next) {
                 current_curve = current_curve->next;
             }
-            current_curve->next = calloc(1, sizeof(AMVP_CURVE_ALG_COMPAT_LIST));
+            current_curve->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_CURVE_ALG_COMPAT_LIST));
             current_curve->next->curve = value;
         } else {
-            cap->curves = calloc(1, sizeof(AMVP_CURVE_ALG_COMPAT_LIST));
+            cap->curves = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_CURVE_ALG_COMPAT_LIST));
             cap->curves->curve = value;
         }
         break;
@@ -6498,7 +6698,7 @@ static AMVP_RESULT amvp_add_kas_ecc_prereq_val(AMVP_CTX *ctx, AMVP_KAS_ECC_CAP_M
     AMVP_PREREQ_LIST *prereq_entry, *prereq_entry_2;
 
     AMVP_LOG_INFO("KAS-ECC mode %d", mode);
-    prereq_entry = calloc(1, sizeof(AMVP_PREREQ_LIST));
+    prereq_entry = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_PREREQ_LIST));
     if (!prereq_entry) {
         return AMVP_MALLOC_FAIL;
     }
@@ -6857,7 +7057,7 @@ AMVP_RESULT amvp_cap_kas_ecc_set_scheme(AMVP_CTX *ctx,
         }
         /* if there are none or didn't find the one we're looking for... */
         if (current_scheme == NULL) {
-            kas_ecc_cap_mode->scheme = calloc(1, sizeof(AMVP_KAS_ECC_SCHEME));
+            kas_ecc_cap_mode->scheme = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KAS_ECC_SCHEME));
             kas_ecc_cap_mode->scheme->scheme = scheme;
             current_scheme = kas_ecc_cap_mode->scheme;
         }
@@ -6889,7 +7089,7 @@ AMVP_RESULT amvp_cap_kas_ecc_set_scheme(AMVP_CTX *ctx,
                 }
             }
             if (!current_pset) {
-                current_pset = calloc(1, sizeof(AMVP_KAS_ECC_PSET));
+                current_pset = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KAS_ECC_PSET));
                 if (current_scheme->pset == NULL) {
                     current_scheme->pset = current_pset;
                 } else {
@@ -6935,7 +7135,7 @@ static AMVP_RESULT amvp_add_kas_ffc_prereq_val(AMVP_CTX *ctx, AMVP_KAS_FFC_CAP_M
     AMVP_PREREQ_LIST *prereq_entry, *prereq_entry_2;
 
     AMVP_LOG_INFO("KAS-FFC mode %d", mode);
-    prereq_entry = calloc(1, sizeof(AMVP_PREREQ_LIST));
+    prereq_entry = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_PREREQ_LIST));
     if (!prereq_entry) {
         return AMVP_MALLOC_FAIL;
     }
@@ -7249,7 +7449,7 @@ AMVP_RESULT amvp_cap_kas_ffc_set_scheme(AMVP_CTX *ctx,
         }
         /* if there are none or didn't find the one we're looking for... */
         if (current_scheme == NULL) {
-            kas_ffc_cap_mode->scheme = calloc(1, sizeof(AMVP_KAS_FFC_SCHEME));
+            kas_ffc_cap_mode->scheme = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KAS_FFC_SCHEME));
             kas_ffc_cap_mode->scheme->scheme = scheme;
             current_scheme = kas_ffc_cap_mode->scheme;
         }
@@ -7289,7 +7489,7 @@ AMVP_RESULT amvp_cap_kas_ffc_set_scheme(AMVP_CTX *ctx,
                 }
             }
             if (!current_pset) {
-                current_pset = calloc(1, sizeof(AMVP_KAS_FFC_PSET));
+                current_pset = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KAS_FFC_PSET));
                 if (current_scheme->pset == NULL) {
                     current_scheme->pset = current_pset;
                 } else {
@@ -7431,7 +7631,7 @@ AMVP_RESULT amvp_cap_kas_ifc_set_exponent(AMVP_CTX *ctx,
     if (param != AMVP_KAS_IFC_FIXEDPUBEXP) {
         return AMVP_INVALID_ARG;
     }        
-    kas_ifc_cap->fixed_pub_exp = calloc(len + 1, sizeof(char));
+    kas_ifc_cap->fixed_pub_exp = amvp_mem_calloc(AMVP_MEM_CAPS, len + 1, sizeof(char));
     strcpy_s(kas_ifc_cap->fixed_pub_exp, len + 1, value);
     return AMVP_SUCCESS;
 }
@@ -7543,7 +7743,7 @@ AMVP_RESULT amvp_cap_kda_set_parm(AMVP_CTX *ctx, AMVP_CIPHER cipher, AMVP_KDA_PA
         case AMVP_KDA_PATTERN:
             if (value == AMVP_KDA_PATTERN_LITERAL && os_cap->literal_pattern_candidate) {
                 AMVP_LOG_WARN("Literal pattern candidate was already previously set. Replacing...");
-                free(os_cap->literal_pattern_candidate);
+                amvp_mem_free(AMVP_MEM_CAPS, os_cap->literal_pattern_candidate);
                 os_cap->literal_pattern_candidate = NULL;
             }
             if (value == AMVP_KDA_PATTERN_LITERAL) {
@@ -7555,7 +7755,7 @@ AMVP_RESULT amvp_cap_kda_set_parm(AMVP_CTX *ctx, AMVP_CIPHER cipher, AMVP_KDA_PA
                     AMVP_LOG_ERR("Provided literal string empty");
                     return AMVP_INVALID_ARG;
                 }
-                os_cap->literal_pattern_candidate = calloc(AMVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
+                os_cap->literal_pattern_candidate = amvp_mem_calloc(AMVP_MEM_CAPS, AMVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
                 if (!os_cap->literal_pattern_candidate) {
                     AMVP_LOG_ERR("Unable to allocate memory for literal pattern candidate");
                     return AMVP_MALLOC_FAIL;
@@ -7640,7 +7840,7 @@ AMVP_RESULT amvp_cap_kda_set_parm(AMVP_CTX *ctx, AMVP_CIPHER cipher, AMVP_KDA_PA
         case AMVP_KDA_PATTERN:
             if (value == AMVP_KDA_PATTERN_LITERAL && hkdf_cap->literal_pattern_candidate) {
                 AMVP_LOG_WARN("Literal pattern candidate was already previously set. Replacing...");
-                free(hkdf_cap->literal_pattern_candidate);
+                amvp_mem_free(AMVP_MEM_CAPS, hkdf_cap->literal_pattern_candidate);
                 hkdf_cap->literal_pattern_candidate = NULL;
             }
             if (value == AMVP_KDA_PATTERN_LITERAL) {
@@ -7652,7 +7852,7 @@ AMVP_RESULT amvp_cap_kda_set_parm(AMVP_CTX *ctx, AMVP_CIPHER cipher, AMVP_KDA_PA
                     AMVP_LOG_ERR("Provided literal string empty");
                     return AMVP_INVALID_ARG;
                 }
-                hkdf_cap->literal_pattern_candidate = calloc(AMVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
+                hkdf_cap->literal_pattern_candidate = amvp_mem_calloc(AMVP_MEM_CAPS, AMVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
                 if (!hkdf_cap->literal_pattern_candidate) {
                     AMVP_LOG_ERR("Unable to allocate memory for literal pattern candidate");
                     return AMVP_MALLOC_FAIL;
@@ -7846,7 +8046,7 @@ AMVP_RESULT amvp_cap_kda_twostep_set_parm(AMVP_CTX *ctx, AMVP_KDA_PARM param,
     case AMVP_KDA_PATTERN:
         if (value == AMVP_KDA_PATTERN_LITERAL && cap->literal_pattern_candidate) {
             AMVP_LOG_WARN("Literal pattern candidate was already previously set. Replacing...");
-            free(cap->literal_pattern_candidate);
+            amvp_mem_free(AMVP_MEM_CAPS, cap->literal_pattern_candidate);
             cap->literal_pattern_candidate = NULL;
         }
         if (value == AMVP_KDA_PATTERN_LITERAL) {
@@ -7858,7 +8058,7 @@ AMVP_RESULT amvp_cap_kda_twostep_set_parm(AMVP_CTX *ctx, AMVP_KDA_PARM param,
                 AMVP_LOG_ERR("Provided literal string empty");
                 return AMVP_INVALID_ARG;
             }
-            cap->literal_pattern_candidate = calloc(AMVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
+            cap->literal_pattern_candidate = amvp_mem_calloc(AMVP_MEM_CAPS, AMVP_KDA_PATTERN_LITERAL_STR_LEN_MAX + 1, sizeof(char));
             if (!cap->literal_pattern_candidate) {
                 AMVP_LOG_ERR("Unable to allocate memory for literal pattern candidate");
                 return AMVP_MALLOC_FAIL;
@@ -8332,10 +8532,10 @@ AMVP_RESULT amvp_cap_kts_ifc_set_parm(AMVP_CTX *ctx,
             while (current_scheme->next) {
                 current_scheme = current_scheme->next;
             }
-            current_scheme->next = calloc(1, sizeof(AMVP_KTS_IFC_SCHEMES));
+            current_scheme->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KTS_IFC_SCHEMES));
             current_scheme->next->scheme = value;
         } else {
-            kts_ifc_cap->schemes = calloc(1, sizeof(AMVP_KTS_IFC_SCHEMES));
+            kts_ifc_cap->schemes = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_KTS_IFC_SCHEMES));
             kts_ifc_cap->schemes->scheme = value;
         }
         break;
@@ -8446,11 +8646,11 @@ AMVP_RESULT amvp_cap_kts_ifc_set_param_string(AMVP_CTX *ctx,
     switch (param)
     {
     case AMVP_KTS_IFC_FIXEDPUBEXP:
-        kts_ifc_cap->fixed_pub_exp = calloc(len + 1, sizeof(char));
+        kts_ifc_cap->fixed_pub_exp = amvp_mem_calloc(AMVP_MEM_CAPS, len + 1, sizeof(char));
         strcpy_s(kts_ifc_cap->fixed_pub_exp, len + 1, value);
         break;
     case AMVP_KTS_IFC_IUT_ID:
-        kts_ifc_cap->iut_id = calloc(len + 1, sizeof(char));
+        kts_ifc_cap->iut_id = amvp_mem_calloc(AMVP_MEM_CAPS, len + 1, sizeof(char));
         strcpy_s(kts_ifc_cap->iut_id, len + 1, value);
         break;
     case AMVP_KTS_IFC_KEYGEN_METHOD:
@@ -8518,11 +8718,11 @@ AMVP_RESULT amvp_cap_kts_ifc_set_scheme_string(AMVP_CTX *ctx,
     switch (param)
     {
     case AMVP_KTS_IFC_AD_PATTERN:
-        current_scheme->assoc_data_pattern = calloc(len + 1, sizeof(char));
+        current_scheme->assoc_data_pattern = amvp_mem_calloc(AMVP_MEM_CAPS, len + 1, sizeof(char));
         strcpy_s(current_scheme->assoc_data_pattern, len + 1, value);
         break;
     case AMVP_KTS_IFC_ENCODING:
-        current_scheme->encodings = calloc(len + 1, sizeof(char));
+        current_scheme->encodings = amvp_mem_calloc(AMVP_MEM_CAPS, len + 1, sizeof(char));
         strcpy_s(current_scheme->encodings, len + 1, value);
         break;
     case AMVP_KTS_IFC_NULL_ASSOC_DATA:
@@ -8602,7 +8802,7 @@ AMVP_RESULT amvp_cap_safe_primes_set_parm(AMVP_CTX *ctx,
         return AMVP_NO_CAP;
     }
     if (!safe_primes_cap->mode) {
-        safe_primes_cap->mode = calloc(1, sizeof(AMVP_SAFE_PRIMES_CAP_MODE));
+        safe_primes_cap->mode = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_SAFE_PRIMES_CAP_MODE));
     }
 
     safe_primes_cap_mode = safe_primes_cap->mode;
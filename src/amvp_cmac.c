@@ -53,12 +53,12 @@ static AMVP_RESULT amvp_cmac_init_tc(AMVP_CTX *ctx,
     memzero_s(stc, sizeof(AMVP_CMAC_TC));
 
     stc->test_type = testtype;
-    stc->msg = calloc(AMVP_CMAC_MSGLEN_MAX_STR, sizeof(unsigned char));
+    stc->msg = amvp_mem_calloc(AMVP_MEM_TC, AMVP_CMAC_MSGLEN_MAX_STR, sizeof(unsigned char));
     if (!stc->msg) { return AMVP_MALLOC_FAIL; }
 
-    stc->mac = calloc(AMVP_CMAC_MACLEN_MAX, sizeof(unsigned char));
+    stc->mac = amvp_mem_calloc(AMVP_MEM_TC, AMVP_CMAC_MACLEN_MAX, sizeof(unsigned char));
     if (!stc->mac) { return AMVP_MALLOC_FAIL; }
-    stc->key = calloc(1, AMVP_CMAC_KEY_MAX);
+    stc->key = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_CMAC_KEY_MAX);
     if (!stc->key) { return AMVP_MALLOC_FAIL; }
     stc->mac_len = mac_len;
 
@@ -70,9 +70,9 @@ static AMVP_RESULT amvp_cmac_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->key2 = calloc(1, AMVP_CMAC_KEY_MAX);
+    stc->key2 = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_CMAC_KEY_MAX);
     if (!stc->key2) { return AMVP_MALLOC_FAIL; }
-    stc->key3 = calloc(1, AMVP_CMAC_KEY_MAX);
+    stc->key3 = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_CMAC_KEY_MAX);
     if (!stc->key3) { return AMVP_MALLOC_FAIL; }
 
     rv = amvp_hexstr_to_bin(msg, stc->msg, AMVP_CMAC_MSGLEN_MAX_STR, NULL);
@@ -154,16 +154,35 @@ end:
  * a test case.
  */
 static AMVP_RESULT amvp_cmac_release_tc(AMVP_CMAC_TC *stc) {
-    if (stc->msg) free(stc->msg);
-    if (stc->mac) free(stc->mac);
-    if (stc->key) free(stc->key);
-    if (stc->key2) free(stc->key2);
-    if (stc->key3) free(stc->key3);
+    if (stc->msg) amvp_mem_free(AMVP_MEM_TC, stc->msg);
+    if (stc->mac) amvp_mem_free(AMVP_MEM_TC, stc->mac);
+    if (stc->key) amvp_mem_free(AMVP_MEM_TC, stc->key);
+    if (stc->key2) amvp_mem_free(AMVP_MEM_TC, stc->key2);
+    if (stc->key3) amvp_mem_free(AMVP_MEM_TC, stc->key3);
     memzero_s(stc, sizeof(AMVP_CMAC_TC));
 
     return AMVP_SUCCESS;
 }
 
+/*
+ * Batch adapters so queued CMAC test cases can be output and released
+ * through the common batch helpers.
+ */
+static AMVP_RESULT amvp_cmac_batch_output_tc(AMVP_CTX *ctx,
+                                             AMVP_TEST_CASE *tc,
+                                             JSON_Object *r_tobj,
+                                             int tc_rv) {
+    if (tc_rv) {
+        AMVP_LOG_ERR("ERROR: crypto module failed the operation");
+        return AMVP_CRYPTO_MODULE_FAIL;
+    }
+    return amvp_cmac_output_tc(ctx, tc->tc.cmac, r_tobj);
+}
+
+static void amvp_cmac_batch_release_tc(AMVP_TEST_CASE *tc) {
+    amvp_cmac_release_tc(tc->tc.cmac);
+}
+
 AMVP_RESULT amvp_cmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     unsigned int tc_id, msglen, keyLen = 0, keyingOption = 0, maclen, verify = 0;
     const char *msg = NULL, *key1 = NULL, *key2 = NULL, *key3 = NULL, *mac = NULL;
@@ -186,9 +205,12 @@ AMVP_RESULT amvp_cmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
-    AMVP_CAPS_LIST *cap;
+    AMVP_CAPS_LIST *cap = NULL;
     AMVP_CMAC_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
+    AMVP_TEST_GROUP group = { 0 };
+    AMVP_CMAC_TC *batch_stc = NULL;
+    AMVP_TC_BATCH batch;
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     AMVP_CIPHER alg_id;
@@ -216,6 +238,7 @@ AMVP_RESULT amvp_cmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
      * Get a reference to the abstracted test case
      */
     tc.tc.cmac = &stc;
+    tc.group = &group;
 
     /*
      * Get the crypto module handler for this hash algorithm
@@ -249,6 +272,16 @@ AMVP_RESULT amvp_cmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         return rv;
     }
 
+    amvp_tc_batch_init(&batch, &amvp_cmac_batch_output_tc, &amvp_cmac_batch_release_tc);
+    if (cap->batch_handler) {
+        batch_stc = calloc(AMVP_BATCH_TC_MAX, sizeof(AMVP_CMAC_TC));
+        if (!batch_stc) {
+            AMVP_LOG_ERR("Unable to malloc batch test cases");
+            rv = AMVP_MALLOC_FAIL;
+            goto err;
+        }
+    }
+
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
     for (i = 0; i < g_cnt; i++) {
@@ -265,6 +298,7 @@ AMVP_RESULT amvp_cmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON group obj");
             rv = AMVP_MALFORMED_JSON;
@@ -344,6 +378,20 @@ AMVP_RESULT amvp_cmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         }
 
 
+        /*
+         * Let the crypto module set up any state shared by the group
+         */
+        group.cipher = alg_id;
+        group.tg_id = tgId;
+        group.test_type = test_type_str;
+        group.key_len = keyLen;
+        group.msg_len = msglen * 8;
+        group.mac_len = maclen * 8;
+        rv = amvp_group_begin(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
         for (j = 0; j < t_cnt; j++) {
@@ -441,6 +489,34 @@ AMVP_RESULT amvp_cmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
             json_object_set_number(r_tobj, "tcId", tc_id);
 
+            if (cap->batch_handler) {
+                /*
+                 * Queue the test case for the crypto module's batch handler,
+                 * the results are output once the batch is flushed.
+                 */
+                AMVP_CMAC_TC *bstc = &batch_stc[batch.count];
+
+                rv = amvp_cmac_init_tc(ctx, bstc, tc_id, testtype, msg, msglen, key1, key2, key3,
+                                       verify, mac, maclen, alg_id);
+                if (rv != AMVP_SUCCESS) {
+                    AMVP_LOG_ERR("Init for stc (test case) failed");
+                    amvp_cmac_release_tc(bstc);
+                    json_value_free(r_tval);
+                    goto err;
+                }
+                batch.tc[batch.count].tc.cmac = bstc;
+                batch.tc[batch.count].group = &group;
+                batch.r_tval[batch.count++] = r_tval;
+
+                if (batch.count == AMVP_BATCH_TC_MAX) {
+                    rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+                    if (rv != AMVP_SUCCESS) {
+                        goto err;
+                    }
+                }
+                continue;
+            }
+
             /*
              * Setup the test case data that will be passed down to
              * the crypto module.
@@ -454,7 +530,7 @@ AMVP_RESULT amvp_cmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("ERROR: crypto module failed the operation");
                 amvp_cmac_release_tc(&stc);
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -481,17 +557,30 @@ AMVP_RESULT amvp_cmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+
+        /* Process any test cases still waiting on the batch handler */
+        rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+        rv = amvp_group_end(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
      AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
 
 err:
+    amvp_group_end(ctx, cap, &group);
+    amvp_tc_batch_discard(&batch);
+    if (batch_stc) free(batch_stc);
     if (rv != AMVP_SUCCESS) {
         amvp_release_json(r_vs_val, r_gval);
     }
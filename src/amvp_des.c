@@ -48,9 +48,9 @@ static AMVP_RESULT amvp_des_release_tc(AMVP_SYM_CIPHER_TC *stc);
 #define OLD_IV_LEN 8
 #define TEXT_COL_LEN 10001
 #define TEXT_ROW_LEN 8
-static unsigned char old_iv[OLD_IV_LEN];
-static unsigned char ptext[TEXT_COL_LEN][TEXT_ROW_LEN];
-static unsigned char ctext[TEXT_COL_LEN][TEXT_ROW_LEN];
+static AMVP_THREAD_LOCAL unsigned char old_iv[OLD_IV_LEN];
+static AMVP_THREAD_LOCAL unsigned char ptext[TEXT_COL_LEN][TEXT_ROW_LEN];
+static AMVP_THREAD_LOCAL unsigned char ctext[TEXT_COL_LEN][TEXT_ROW_LEN];
 
 static void shiftin(unsigned char *dst, int dst_max, unsigned char *src, int nbits) {
     int n = 0, move_bytes = 0, copy_bytes = 0;
@@ -461,7 +461,7 @@ static AMVP_RESULT amvp_des_mct_tc(AMVP_CTX *ctx,
             }
             stc->mct_index = j;    /* indicates init vs. update */
             /* Process the current DES encrypt test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (amvp_crypto_handler(ctx, cap, tc)) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 free(tmp);
                 json_value_free(r_tval);
@@ -567,6 +567,85 @@ static AMVP_RESULT amvp_des_mct_tc(AMVP_CTX *ctx,
     return AMVP_SUCCESS;
 }
 
+/*
+ * This is the MCT handler used when the crypto module registered a
+ * native MCT callback. The module runs the inner loop and prepares the
+ * keys, iv and text of the next outer iteration itself, so libamvp only
+ * records the values of each outer iteration.
+ */
+static AMVP_RESULT amvp_des_mct_native_tc(AMVP_CTX *ctx,
+                                          AMVP_CAPS_LIST *cap,
+                                          AMVP_TEST_CASE *tc,
+                                          AMVP_SYM_CIPHER_TC *stc,
+                                          JSON_Array *res_array) {
+    int i;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    JSON_Value *r_tval = NULL;  /* Response testval */
+    JSON_Object *r_tobj = NULL; /* Response testobj */
+    char *tmp = NULL;
+
+    tmp = calloc(1, AMVP_SYM_CT_MAX + 1);
+    if (!tmp) {
+        AMVP_LOG_ERR("Unable to malloc in amvp_des_mct_native_tc");
+        return AMVP_MALLOC_FAIL;
+    }
+
+    for (i = 0; i < AMVP_DES_MCT_OUTER; ++i) {
+        /*
+         * Create a new test case in the response
+         */
+        r_tval = json_value_init_object();
+        r_tobj = json_value_get_object(r_tval);
+
+        /*
+         * Output the test case request values using JSON
+         */
+        rv = amvp_des_output_mct_tc(ctx, stc, r_tobj);
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("JSON output failure in DES module");
+            goto end;
+        }
+
+        stc->mct_index = i;
+        if (amvp_mct_handler(ctx, cap, tc)) {
+            AMVP_LOG_ERR("crypto module failed the operation");
+            rv = AMVP_CRYPTO_MODULE_FAIL;
+            goto end;
+        }
+
+        memzero_s(tmp, AMVP_SYM_CT_MAX);
+        if (stc->direction == AMVP_SYM_CIPH_DIR_ENCRYPT) {
+            if (stc->cipher == AMVP_TDES_CFB1) {
+                stc->ct[0] &= AMVP_CFB1_BIT_MASK;
+            }
+            rv = amvp_bin_to_hexstr(stc->ct, stc->cipher == AMVP_TDES_CFB1 ? 1 : stc->ct_len,
+                                    tmp, AMVP_SYM_CT_MAX);
+            if (rv != AMVP_SUCCESS) {
+                AMVP_LOG_ERR("hex conversion failure (ct)");
+                goto end;
+            }
+            json_object_set_string(r_tobj, "ct", tmp);
+        } else {
+            rv = amvp_bin_to_hexstr(stc->pt, stc->cipher == AMVP_TDES_CFB1 ? 1 : stc->pt_len,
+                                    tmp, AMVP_SYM_CT_MAX);
+            if (rv != AMVP_SUCCESS) {
+                AMVP_LOG_ERR("hex conversion failure (pt)");
+                goto end;
+            }
+            json_object_set_string(r_tobj, "pt", tmp);
+        }
+
+        /* Append the test response value to array */
+        json_array_append_value(res_array, r_tval);
+        r_tval = NULL;
+    }
+
+end:
+    if (r_tval) json_value_free(r_tval);
+    free(tmp);
+    return rv;
+}
+
 /**
  * @brief Read the \p str reprenting the test type and
  *        convert to enum.
@@ -619,6 +698,25 @@ static AMVP_SYM_CIPH_DIR read_direction(const char *str) {
     return 0;
 }
 
+/*
+ * Batch adapters so queued TDES test cases can be output and released
+ * through the common batch helpers.
+ */
+static AMVP_RESULT amvp_des_batch_output_tc(AMVP_CTX *ctx,
+                                            AMVP_TEST_CASE *tc,
+                                            JSON_Object *r_tobj,
+                                            int tc_rv) {
+    if (tc_rv) {
+        AMVP_LOG_ERR("ERROR: crypto module failed the operation");
+        return AMVP_CRYPTO_MODULE_FAIL;
+    }
+    return amvp_des_output_tc(ctx, tc->tc.symmetric, r_tobj, tc_rv);
+}
+
+static void amvp_des_batch_release_tc(AMVP_TEST_CASE *tc) {
+    amvp_des_release_tc(tc->tc.symmetric);
+}
+
 /*
  * This is the handler for 3DES values.  This will parse
  * a JSON encoded vector set for 3DES.  Each test case is
@@ -645,9 +743,12 @@ AMVP_RESULT amvp_des_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
-    AMVP_CAPS_LIST *cap;
+    AMVP_CAPS_LIST *cap = NULL;
     AMVP_SYM_CIPHER_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
+    AMVP_TEST_GROUP group = { 0 };
+    AMVP_SYM_CIPHER_TC *batch_stc = NULL;
+    AMVP_TC_BATCH batch;
     AMVP_RESULT rv;
 
     const char *alg_str = NULL;
@@ -674,6 +775,7 @@ AMVP_RESULT amvp_des_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
      * Get a reference to the abstracted test case
      */
     tc.tc.symmetric = &stc;
+    tc.group = &group;
 
     /*
      * Get the crypto module handler for DES mode
@@ -707,6 +809,16 @@ AMVP_RESULT amvp_des_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         return rv;
     }
 
+    amvp_tc_batch_init(&batch, &amvp_des_batch_output_tc, &amvp_des_batch_release_tc);
+    if (cap->batch_handler) {
+        batch_stc = calloc(AMVP_BATCH_TC_MAX, sizeof(AMVP_SYM_CIPHER_TC));
+        if (!batch_stc) {
+            AMVP_LOG_ERR("Unable to malloc batch test cases");
+            rv = AMVP_MALLOC_FAIL;
+            goto err;
+        }
+    }
+
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
     for (i = 0; i < g_cnt; i++) {
@@ -721,6 +833,7 @@ AMVP_RESULT amvp_des_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -792,6 +905,18 @@ AMVP_RESULT amvp_des_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         AMVP_LOG_VERBOSE("    ovrflw_ctr: %d", ovrflw_ctr);
         AMVP_LOG_VERBOSE("  keyingOption: %d", keyingOption);
 
+        /*
+         * Let the crypto module set up any state shared by the group
+         */
+        group.cipher = alg_id;
+        group.tg_id = tgId;
+        group.test_type = test_type_str;
+        group.direction = dir;
+        rv = amvp_group_begin(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
         for (j = 0; j < t_cnt; j++) {
@@ -959,6 +1084,38 @@ AMVP_RESULT amvp_des_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
             json_object_set_number(r_tobj, "tcId", tc_id);
 
+            if (cap->batch_handler && test_type != AMVP_SYM_TEST_TYPE_MCT) {
+                /*
+                 * Queue the test case for the crypto module's batch handler,
+                 * the results are output once the batch is flushed.
+                 */
+                AMVP_SYM_CIPHER_TC *bstc = &batch_stc[batch.count];
+
+                rv = amvp_des_init_tc(ctx, bstc, tc_id, test_type, key, pt, ct, iv,
+                                      keylen, ivlen, ptlen, ctlen, alg_id, dir,
+                                      incr_ctr, ovrflw_ctr, keyingOption);
+                if (rv != AMVP_SUCCESS) {
+                    AMVP_LOG_ERR("Init for stc (test case) failed");
+                    amvp_des_release_tc(bstc);
+                    json_value_free(r_tval);
+                    free(key);
+                    goto err;
+                }
+                // Key has been copied, we can free here
+                free(key);
+                batch.tc[batch.count].tc.symmetric = bstc;
+                batch.tc[batch.count].group = &group;
+                batch.r_tval[batch.count++] = r_tval;
+
+                if (batch.count == AMVP_BATCH_TC_MAX) {
+                    rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+                    if (rv != AMVP_SUCCESS) {
+                        goto err;
+                    }
+                }
+                continue;
+            }
+
             /*
              * Setup the test case data that will be passed down to
              * the crypto module.
@@ -979,7 +1136,11 @@ AMVP_RESULT amvp_des_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             if (stc.test_type == AMVP_SYM_TEST_TYPE_MCT) {
                 json_object_set_value(r_tobj, "resultsArray", json_value_init_array());
                 res_tarr = json_object_get_array(r_tobj, "resultsArray");
-                rv = amvp_des_mct_tc(ctx, cap, &tc, &stc, res_tarr);
+                if (cap->mct_handler) {
+                    rv = amvp_des_mct_native_tc(ctx, cap, &tc, &stc, res_tarr);
+                } else {
+                    rv = amvp_des_mct_tc(ctx, cap, &tc, &stc, res_tarr);
+                }
                 if (rv != AMVP_SUCCESS) {
                     json_value_free(r_tval);
                     AMVP_LOG_ERR("crypto module failed the DES MCT operation");
@@ -989,7 +1150,7 @@ AMVP_RESULT amvp_des_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
                 }
             } else {
                 /* Process the current DES encrypt test vector... */
-                int t_rv = (cap->crypto_handler)(&tc);
+                int t_rv = amvp_crypto_handler(ctx, cap, &tc);
                 if (t_rv) {
                     AMVP_LOG_ERR("ERROR: crypto module failed the operation");
                     json_value_free(r_tval);
@@ -1017,17 +1178,30 @@ AMVP_RESULT amvp_des_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+
+        /* Process any test cases still waiting on the batch handler */
+        rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+        rv = amvp_group_end(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
     rv = AMVP_SUCCESS;
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
 
 err:
+    amvp_group_end(ctx, cap, &group);
+    amvp_tc_batch_discard(&batch);
+    if (batch_stc) free(batch_stc);
     if (rv != AMVP_SUCCESS) {
         amvp_release_json(r_vs_val, r_gval);
     }
@@ -1133,17 +1307,17 @@ static AMVP_RESULT amvp_des_init_tc(AMVP_CTX *ctx,
 
     memzero_s(stc, sizeof(AMVP_SYM_CIPHER_TC));
 
-    stc->key = calloc(1, AMVP_SYM_KEY_MAX_BYTES);
+    stc->key = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_SYM_KEY_MAX_BYTES);
     if (!stc->key) { return AMVP_MALLOC_FAIL; }
-    stc->pt = calloc(1, AMVP_SYM_PT_BYTE_MAX);
+    stc->pt = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_SYM_PT_BYTE_MAX);
     if (!stc->pt) { return AMVP_MALLOC_FAIL; }
-    stc->ct = calloc(1, AMVP_SYM_CT_BYTE_MAX);
+    stc->ct = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_SYM_CT_BYTE_MAX);
     if (!stc->ct) { return AMVP_MALLOC_FAIL; }
-    stc->iv = calloc(1, AMVP_SYM_IV_BYTE_MAX);
+    stc->iv = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_SYM_IV_BYTE_MAX);
     if (!stc->iv) { return AMVP_MALLOC_FAIL; }
-    stc->iv_ret = calloc(1, AMVP_SYM_IV_BYTE_MAX);
+    stc->iv_ret = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_SYM_IV_BYTE_MAX);
     if (!stc->iv_ret) { return AMVP_MALLOC_FAIL; }
-    stc->iv_ret_after = calloc(1, AMVP_SYM_IV_BYTE_MAX);
+    stc->iv_ret_after = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_SYM_IV_BYTE_MAX);
     if (!stc->iv_ret_after) { return AMVP_MALLOC_FAIL; }
 
     rv = amvp_hexstr_to_bin(j_key, stc->key, AMVP_SYM_KEY_MAX_BYTES, NULL);
@@ -1222,12 +1396,12 @@ static AMVP_RESULT amvp_des_init_tc(AMVP_CTX *ctx,
  * a test case.
  */
 static AMVP_RESULT amvp_des_release_tc(AMVP_SYM_CIPHER_TC *stc) {
-    if (stc->key) free(stc->key);
-    if (stc->pt) free(stc->pt);
-    if (stc->ct) free(stc->ct);
-    if (stc->iv) free(stc->iv);
-    if (stc->iv_ret) free(stc->iv_ret);
-    if (stc->iv_ret_after) free(stc->iv_ret_after);
+    if (stc->key) amvp_mem_free(AMVP_MEM_TC, stc->key);
+    if (stc->pt) amvp_mem_free(AMVP_MEM_TC, stc->pt);
+    if (stc->ct) amvp_mem_free(AMVP_MEM_TC, stc->ct);
+    if (stc->iv) amvp_mem_free(AMVP_MEM_TC, stc->iv);
+    if (stc->iv_ret) amvp_mem_free(AMVP_MEM_TC, stc->iv_ret);
+    if (stc->iv_ret_after) amvp_mem_free(AMVP_MEM_TC, stc->iv_ret_after);
     memzero_s(stc, sizeof(AMVP_SYM_CIPHER_TC));
 
     return AMVP_SUCCESS;
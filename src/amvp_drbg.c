@@ -70,9 +70,10 @@ AMVP_RESULT amvp_drbg_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
-    AMVP_CAPS_LIST *cap;
+    AMVP_CAPS_LIST *cap = NULL;
     AMVP_DRBG_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
+    AMVP_TEST_GROUP group = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = NULL, *int_use = NULL;
     AMVP_CIPHER alg_id;
@@ -97,6 +98,7 @@ AMVP_RESULT amvp_drbg_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
      * Get a reference to the abstracted test case
      */
     tc.tc.drbg = &stc;
+    tc.group = &group;
 
     /*
      * Get the crypto module handler for this DRBG algorithm
@@ -150,6 +152,7 @@ AMVP_RESULT amvp_drbg_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -257,6 +260,25 @@ AMVP_RESULT amvp_drbg_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         AMVP_LOG_VERBOSE("    nonceLen: %d", nonce_len);
         AMVP_LOG_VERBOSE("    returnedBitsLen: %d", drb_len);
 
+        /*
+         * Let the crypto module set up any state shared by the group
+         */
+        group.cipher = alg_id;
+        group.tg_id = tgId;
+        group.drbg_mode = mode_id;
+        group.pred_resist = pred_resist_enabled;
+        group.reseed = reseed;
+        group.der_func = der_func_enabled;
+        group.entropy_len = entropy_len;
+        group.nonce_len = nonce_len;
+        group.perso_string_len = perso_string_len;
+        group.additional_input_len = additional_input_len;
+        group.drb_len = drb_len;
+        rv = amvp_group_begin(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+
         /*
          * Handle test array
          */
@@ -533,7 +555,7 @@ AMVP_RESULT amvp_drbg_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 rv = AMVP_CRYPTO_MODULE_FAIL;
                 amvp_drbg_release_tc(&stc);
@@ -560,16 +582,21 @@ AMVP_RESULT amvp_drbg_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        rv = amvp_group_end(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
         json_array_append_value(r_garr, r_gval);
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
 
     rv = AMVP_SUCCESS;
 err:
+    amvp_group_end(ctx, cap, &group);
     if (rv != AMVP_SUCCESS) {
         amvp_release_json(r_vs_val, r_gval);
     }
@@ -633,25 +660,25 @@ static AMVP_RESULT amvp_drbg_init_tc(AMVP_CTX *ctx,
 
     memzero_s(stc, sizeof(AMVP_DRBG_TC));
 
-    stc->drb = calloc(AMVP_DRB_BYTE_MAX, sizeof(unsigned char));
+    stc->drb = amvp_mem_calloc(AMVP_MEM_TC, AMVP_DRB_BYTE_MAX, sizeof(unsigned char));
     if (!stc->drb) { return AMVP_MALLOC_FAIL; }
-    stc->additional_input_0 = calloc(AMVP_DRBG_ADDI_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->additional_input_0 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_DRBG_ADDI_IN_BYTE_MAX, sizeof(unsigned char));
     if (!stc->additional_input_0) { return AMVP_MALLOC_FAIL; }
-    stc->additional_input_1 = calloc(AMVP_DRBG_ADDI_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->additional_input_1 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_DRBG_ADDI_IN_BYTE_MAX, sizeof(unsigned char));
     if (!stc->additional_input_1) { return AMVP_MALLOC_FAIL; }
-    stc->additional_input_2 = calloc(AMVP_DRBG_ADDI_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->additional_input_2 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_DRBG_ADDI_IN_BYTE_MAX, sizeof(unsigned char));
     if (!stc->additional_input_2) { return AMVP_MALLOC_FAIL; }
-    stc->entropy = calloc(AMVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->entropy = amvp_mem_calloc(AMVP_MEM_TC, AMVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
     if (!stc->entropy) { return AMVP_MALLOC_FAIL; }
-    stc->entropy_input_pr_0 = calloc(AMVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->entropy_input_pr_0 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
     if (!stc->entropy_input_pr_0) { return AMVP_MALLOC_FAIL; }
-    stc->entropy_input_pr_1 = calloc(AMVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->entropy_input_pr_1 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
     if (!stc->entropy_input_pr_1) { return AMVP_MALLOC_FAIL; }
-    stc->entropy_input_pr_2 = calloc(AMVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
+    stc->entropy_input_pr_2 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_DRBG_ENTPY_IN_BYTE_MAX, sizeof(unsigned char));
     if (!stc->entropy_input_pr_2) { return AMVP_MALLOC_FAIL; }
-    stc->nonce = calloc(AMVP_DRBG_NONCE_BYTE_MAX, sizeof(unsigned char));
+    stc->nonce = amvp_mem_calloc(AMVP_MEM_TC, AMVP_DRBG_NONCE_BYTE_MAX, sizeof(unsigned char));
     if (!stc->nonce) { return AMVP_MALLOC_FAIL; }
-    stc->perso_string = calloc(AMVP_DRBG_PER_SO_BYTE_MAX, sizeof(unsigned char));
+    stc->perso_string = amvp_mem_calloc(AMVP_MEM_TC, AMVP_DRBG_PER_SO_BYTE_MAX, sizeof(unsigned char));
     if (!stc->perso_string) { return AMVP_MALLOC_FAIL; }
 
     if (additional_input_0) {
@@ -758,16 +785,16 @@ static AMVP_RESULT amvp_drbg_init_tc(AMVP_CTX *ctx,
  * a test case.
  */
 static AMVP_RESULT amvp_drbg_release_tc(AMVP_DRBG_TC *stc) {
-    if (stc->drb) free(stc->drb);
-    if (stc->additional_input_0) free(stc->additional_input_0);
-    if (stc->additional_input_1) free(stc->additional_input_1);
-    if (stc->additional_input_2) free(stc->additional_input_2);
-    if (stc->entropy) free(stc->entropy);
-    if (stc->entropy_input_pr_0) free(stc->entropy_input_pr_0);
-    if (stc->entropy_input_pr_1) free(stc->entropy_input_pr_1);
-    if (stc->entropy_input_pr_2) free(stc->entropy_input_pr_2);
-    if (stc->nonce) free(stc->nonce);
-    if (stc->perso_string) free(stc->perso_string);
+    if (stc->drb) amvp_mem_free(AMVP_MEM_TC, stc->drb);
+    if (stc->additional_input_0) amvp_mem_free(AMVP_MEM_TC, stc->additional_input_0);
+    if (stc->additional_input_1) amvp_mem_free(AMVP_MEM_TC, stc->additional_input_1);
+    if (stc->additional_input_2) amvp_mem_free(AMVP_MEM_TC, stc->additional_input_2);
+    if (stc->entropy) amvp_mem_free(AMVP_MEM_TC, stc->entropy);
+    if (stc->entropy_input_pr_0) amvp_mem_free(AMVP_MEM_TC, stc->entropy_input_pr_0);
+    if (stc->entropy_input_pr_1) amvp_mem_free(AMVP_MEM_TC, stc->entropy_input_pr_1);
+    if (stc->entropy_input_pr_2) amvp_mem_free(AMVP_MEM_TC, stc->entropy_input_pr_2);
+    if (stc->nonce) amvp_mem_free(AMVP_MEM_TC, stc->nonce);
+    if (stc->perso_string) amvp_mem_free(AMVP_MEM_TC, stc->perso_string);
 
     memzero_s(stc, sizeof(AMVP_DRBG_TC));
     return AMVP_SUCCESS;
@@ -34,15 +34,15 @@ static AMVP_RESULT amvp_dsa_keygen_init_tc(AMVP_DSA_TC *stc,
         return AMVP_INVALID_ARG;
     }
 
-    stc->p = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->p = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->p) { return AMVP_MALLOC_FAIL; }
-    stc->q = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->q = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->q) { return AMVP_MALLOC_FAIL; }
-    stc->g = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->g = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->g) { return AMVP_MALLOC_FAIL; }
-    stc->x = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->x = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->x) { return AMVP_MALLOC_FAIL; }
-    stc->y = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->y = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->y) { return AMVP_MALLOC_FAIL; }
 
     return AMVP_SUCCESS;
@@ -65,17 +65,17 @@ static AMVP_RESULT amvp_dsa_siggen_init_tc(AMVP_CTX *ctx,
     stc->n = n;
     stc->sha = sha;
 
-    stc->p = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->p = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->p) { return AMVP_MALLOC_FAIL; }
-    stc->q = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->q = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->q) { return AMVP_MALLOC_FAIL; }
-    stc->g = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->g = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->g) { return AMVP_MALLOC_FAIL; }
-    stc->r = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->r = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->r) { return AMVP_MALLOC_FAIL; }
-    stc->s = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->s = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->s) { return AMVP_MALLOC_FAIL; }
-    stc->y = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->y = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->y) { return AMVP_MALLOC_FAIL; }
 
     if (stc->l == 0) {
@@ -85,7 +85,7 @@ static AMVP_RESULT amvp_dsa_siggen_init_tc(AMVP_CTX *ctx,
         return AMVP_INVALID_ARG;
     }
 
-    stc->msg = calloc(1, AMVP_DSA_PQG_MAX);
+    stc->msg = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_PQG_MAX);
     if (!stc->msg) { return AMVP_MALLOC_FAIL; }
 
     rv = amvp_hexstr_to_bin(msg, stc->msg, AMVP_DSA_PQG_MAX, &(stc->msglen));
@@ -121,20 +121,20 @@ static AMVP_RESULT amvp_dsa_sigver_init_tc(AMVP_CTX *ctx,
         return AMVP_INVALID_ARG;
     }
 
-    stc->msg = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->msg = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->msg) { return AMVP_MALLOC_FAIL; }
 
-    stc->p = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->p = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->p) { return AMVP_MALLOC_FAIL; }
-    stc->q = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->q = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->q) { return AMVP_MALLOC_FAIL; }
-    stc->g = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->g = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->g) { return AMVP_MALLOC_FAIL; }
-    stc->r = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->r = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->r) { return AMVP_MALLOC_FAIL; }
-    stc->s = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->s = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->s) { return AMVP_MALLOC_FAIL; }
-    stc->y = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->y = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->y) { return AMVP_MALLOC_FAIL; }
 
     rv = amvp_hexstr_to_bin(msg, stc->msg, AMVP_DSA_MAX_STRING, &(stc->msglen));
@@ -204,21 +204,21 @@ static AMVP_RESULT amvp_dsa_pqgver_init_tc(AMVP_CTX *ctx,
         return AMVP_INVALID_ARG;
     }
 
-    stc->seed = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->seed = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->seed) { return AMVP_MALLOC_FAIL; }
 
-    stc->p = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->p = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->p) { return AMVP_MALLOC_FAIL; }
-    stc->q = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->q = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->q) { return AMVP_MALLOC_FAIL; }
-    stc->g = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->g = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->g) { return AMVP_MALLOC_FAIL; }
 
-    stc->r = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->r = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->r) { return AMVP_MALLOC_FAIL; }
-    stc->s = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->s = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->s) { return AMVP_MALLOC_FAIL; }
-    stc->y = calloc(1, AMVP_DSA_MAX_STRING);
+    stc->y = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_MAX_STRING);
     if (!stc->y) { return AMVP_MALLOC_FAIL; }
 
     stc->index = -1;
@@ -282,13 +282,13 @@ static AMVP_RESULT amvp_dsa_pqggen_init_tc(AMVP_CTX *ctx,
         return AMVP_INVALID_ARG;
     }
 
-    stc->p = calloc(1, AMVP_DSA_PQG_MAX);
+    stc->p = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_PQG_MAX);
     if (!stc->p) { return AMVP_MALLOC_FAIL; }
-    stc->q = calloc(1, AMVP_DSA_PQG_MAX);
+    stc->q = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_PQG_MAX);
     if (!stc->q) { return AMVP_MALLOC_FAIL; }
-    stc->g = calloc(1, AMVP_DSA_PQG_MAX);
+    stc->g = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_PQG_MAX);
     if (!stc->g) { return AMVP_MALLOC_FAIL; }
-    stc->seed = calloc(1, AMVP_DSA_SEED_MAX);
+    stc->seed = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_DSA_SEED_MAX);
     if (!stc->seed) { return AMVP_MALLOC_FAIL; }
 
     stc->gen_pq = gpq;
@@ -472,15 +472,15 @@ err:
  * a test case.
  */
 static AMVP_RESULT amvp_dsa_release_tc(AMVP_DSA_TC *stc) {
-    if (stc->p) free(stc->p);
-    if (stc->q) free(stc->q);
-    if (stc->g) free(stc->g);
-    if (stc->x) free(stc->x);
-    if (stc->y) free(stc->y);
-    if (stc->r) free(stc->r);
-    if (stc->s) free(stc->s);
-    if (stc->seed) free(stc->seed);
-    if (stc->msg) free(stc->msg);
+    if (stc->p) amvp_mem_free(AMVP_MEM_TC, stc->p);
+    if (stc->q) amvp_mem_free(AMVP_MEM_TC, stc->q);
+    if (stc->g) amvp_mem_free(AMVP_MEM_TC, stc->g);
+    if (stc->x) amvp_mem_free(AMVP_MEM_TC, stc->x);
+    if (stc->y) amvp_mem_free(AMVP_MEM_TC, stc->y);
+    if (stc->r) amvp_mem_free(AMVP_MEM_TC, stc->r);
+    if (stc->s) amvp_mem_free(AMVP_MEM_TC, stc->s);
+    if (stc->seed) amvp_mem_free(AMVP_MEM_TC, stc->seed);
+    if (stc->msg) amvp_mem_free(AMVP_MEM_TC, stc->msg);
 
     memzero_s(stc, sizeof(AMVP_DSA_TC));
 
@@ -559,7 +559,7 @@ static AMVP_RESULT amvp_dsa_keygen_handler(AMVP_CTX *ctx,
         }
 
         /* Process the current DSA test vector... */
-        if ((cap->crypto_handler)(&tc)) {
+        if (amvp_crypto_handler(ctx, cap, &tc)) {
             AMVP_LOG_ERR("crypto module failed the operation");
             rv = AMVP_CRYPTO_MODULE_FAIL;
             goto err;
@@ -825,7 +825,7 @@ AMVP_RESULT amvp_dsa_pqggen_handler(AMVP_CTX *ctx,
             }
 
             /* Process the current DSA test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 amvp_dsa_release_tc(stc);
                 json_value_free(r_tval);
@@ -866,7 +866,7 @@ AMVP_RESULT amvp_dsa_pqggen_handler(AMVP_CTX *ctx,
                 return rv;
             }
 
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 amvp_dsa_release_tc(stc);
                 json_value_free(r_tval);
@@ -943,6 +943,20 @@ static AMVP_RESULT amvp_dsa_siggen_handler(AMVP_CTX *ctx,
     AMVP_LOG_VERBOSE("             n: %d", n);
     AMVP_LOG_VERBOSE("           sha: %s", sha_str);
 
+    /*
+     * Let the crypto module set up any state shared by the group,
+     * the caller ends the group once this returns.
+     */
+    tc.group->cipher = AMVP_DSA_SIGGEN;
+    tc.group->tg_id = tg_id;
+    tc.group->l = l;
+    tc.group->n = n;
+    tc.group->hash_alg = sha;
+    rv = amvp_group_begin(ctx, cap, tc.group);
+    if (rv != AMVP_SUCCESS) {
+        return rv;
+    }
+
     tests = json_object_get_array(groupobj, "tests");
     if (!tests) {
         AMVP_LOG_ERR("Failed to include tests. ");
@@ -990,7 +1004,7 @@ static AMVP_RESULT amvp_dsa_siggen_handler(AMVP_CTX *ctx,
         }
 
         /* Process the current DSA test vector... */
-        if ((cap->crypto_handler)(&tc)) {
+        if (amvp_crypto_handler(ctx, cap, &tc)) {
             AMVP_LOG_ERR("crypto module failed the operation");
             rv = AMVP_CRYPTO_MODULE_FAIL;
             goto err;
@@ -1237,7 +1251,7 @@ static AMVP_RESULT amvp_dsa_pqgver_handler(AMVP_CTX *ctx,
         }
 
         /* Process the current DSA test vector... */
-        if ((cap->crypto_handler)(&tc)) {
+        if (amvp_crypto_handler(ctx, cap, &tc)) {
             AMVP_LOG_ERR("crypto module failed the operation");
             amvp_dsa_release_tc(stc);
             return AMVP_CRYPTO_MODULE_FAIL;
@@ -1398,7 +1412,7 @@ static AMVP_RESULT amvp_dsa_sigver_handler(AMVP_CTX *ctx,
         }
 
         /* Process the current DSA test vector... */
-        if ((cap->crypto_handler)(&tc)) {
+        if (amvp_crypto_handler(ctx, cap, &tc)) {
             AMVP_LOG_ERR("crypto module failed the operation");
             amvp_dsa_release_tc(stc);
             return AMVP_CRYPTO_MODULE_FAIL;
@@ -1438,7 +1452,7 @@ static AMVP_RESULT amvp_dsa_pqgver_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
     JSON_Array *groups;
     AMVP_CAPS_LIST *cap;
     AMVP_DSA_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     AMVP_CIPHER alg_id;
@@ -1506,6 +1520,7 @@ static AMVP_RESULT amvp_dsa_pqgver_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -1528,7 +1543,7 @@ static AMVP_RESULT amvp_dsa_pqgver_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
     }
     memzero_s(&stc, sizeof(AMVP_DSA_TC));
     json_array_append_value(reg_arry, r_vs_val);
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     if (!json_result) {
         AMVP_LOG_ERR("JSON unable to be serialized");
         rv = AMVP_JSON_ERR;
@@ -1560,7 +1575,7 @@ static AMVP_RESULT amvp_dsa_pqggen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
     JSON_Array *groups;
     AMVP_CAPS_LIST *cap;
     AMVP_DSA_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     AMVP_CIPHER alg_id;
@@ -1627,6 +1642,7 @@ static AMVP_RESULT amvp_dsa_pqggen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -1650,7 +1666,7 @@ static AMVP_RESULT amvp_dsa_pqggen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
 
     memzero_s(&stc, sizeof(AMVP_DSA_TC));
     json_array_append_value(reg_arry, r_vs_val);
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -1673,9 +1689,10 @@ static AMVP_RESULT amvp_dsa_siggen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
     JSON_Array *reg_arry = NULL;
     JSON_Object *reg_obj = NULL, *r_gobj = NULL;
     JSON_Array *groups;
-    AMVP_CAPS_LIST *cap;
+    AMVP_CAPS_LIST *cap = NULL;
     AMVP_DSA_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
+    AMVP_TEST_GROUP group = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     AMVP_CIPHER alg_id;
@@ -1691,6 +1708,7 @@ static AMVP_RESULT amvp_dsa_siggen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
      * Get a reference to the abstracted test case
      */
     tc.tc.dsa = &stc;
+    tc.group = &group;
     memzero_s(&stc, sizeof(AMVP_DSA_TC));
 
     /*
@@ -1742,6 +1760,7 @@ static AMVP_RESULT amvp_dsa_siggen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -1760,19 +1779,24 @@ static AMVP_RESULT amvp_dsa_siggen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
             goto err;
 
         }
+        rv = amvp_group_end(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
         json_array_append_value(r_garr, r_gval);
         amvp_dsa_release_tc(&stc);
     }
 
     memzero_s(&stc, sizeof(AMVP_DSA_TC));
     json_array_append_value(reg_arry, r_vs_val);
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
 
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
 
 err:
+    amvp_group_end(ctx, cap, &group);
     if (rv != AMVP_SUCCESS) {
         amvp_dsa_release_tc(&stc);
         amvp_release_json(r_vs_val, r_gval);
@@ -1792,7 +1816,7 @@ static AMVP_RESULT amvp_dsa_keygen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
     JSON_Array *groups;
     AMVP_CAPS_LIST *cap;
     AMVP_DSA_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     AMVP_CIPHER alg_id;
@@ -1859,6 +1883,7 @@ static AMVP_RESULT amvp_dsa_keygen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -1882,7 +1907,7 @@ static AMVP_RESULT amvp_dsa_keygen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
 
     memzero_s(&stc, sizeof(AMVP_DSA_TC));
     json_array_append_value(reg_arry, r_vs_val);
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
 
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
@@ -1908,7 +1933,7 @@ static AMVP_RESULT amvp_dsa_sigver_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
     JSON_Array *groups;
     AMVP_CAPS_LIST *cap;
     AMVP_DSA_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     AMVP_CIPHER alg_id;
@@ -1975,6 +2000,7 @@ static AMVP_RESULT amvp_dsa_sigver_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -1998,7 +2024,7 @@ static AMVP_RESULT amvp_dsa_sigver_kat_handler(AMVP_CTX *ctx, JSON_Object *obj)
 
     memzero_s(&stc, sizeof(AMVP_DSA_TC));
     json_array_append_value(reg_arry, r_vs_val);
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     if (!json_result) {
         AMVP_LOG_ERR("JSON unable to be serialized");
         rv = AMVP_JSON_ERR;
@@ -89,12 +89,12 @@ err:
  */
 
 static AMVP_RESULT amvp_ecdsa_release_tc(AMVP_ECDSA_TC *stc) {
-    if (stc->qy) { free(stc->qy); }
-    if (stc->qx) { free(stc->qx); }
-    if (stc->d) { free(stc->d); }
-    if (stc->r) { free(stc->r); }
-    if (stc->s) { free(stc->s); }
-    if (stc->message) { free(stc->message); }
+    if (stc->qy) { amvp_mem_free(AMVP_MEM_TC, stc->qy); }
+    if (stc->qx) { amvp_mem_free(AMVP_MEM_TC, stc->qx); }
+    if (stc->d) { amvp_mem_free(AMVP_MEM_TC, stc->d); }
+    if (stc->r) { amvp_mem_free(AMVP_MEM_TC, stc->r); }
+    if (stc->s) { amvp_mem_free(AMVP_MEM_TC, stc->s); }
+    if (stc->message) { amvp_mem_free(AMVP_MEM_TC, stc->message); }
     memzero_s(stc, sizeof(AMVP_ECDSA_TC));
 
     return AMVP_SUCCESS;
@@ -126,17 +126,17 @@ static AMVP_RESULT amvp_ecdsa_init_tc(AMVP_CTX *ctx,
     stc->secret_gen_mode = secret_gen_mode;
     stc->is_component = is_component;
 
-    stc->qx = calloc(AMVP_RSA_EXP_LEN_MAX, sizeof(char));
+    stc->qx = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_LEN_MAX, sizeof(char));
     if (!stc->qx) { goto err; }
-    stc->qy = calloc(AMVP_RSA_EXP_LEN_MAX, sizeof(char));
+    stc->qy = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_LEN_MAX, sizeof(char));
     if (!stc->qy) { goto err; }
-    stc->d = calloc(AMVP_RSA_EXP_LEN_MAX, sizeof(char));
+    stc->d = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_LEN_MAX, sizeof(char));
     if (!stc->d) { goto err; }
-    stc->s = calloc(AMVP_RSA_EXP_LEN_MAX, sizeof(char));
+    stc->s = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_LEN_MAX, sizeof(char));
     if (!stc->s) { goto err; }
-    stc->r = calloc(AMVP_RSA_EXP_LEN_MAX, sizeof(char));
+    stc->r = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_LEN_MAX, sizeof(char));
     if (!stc->r) { goto err; }
-    stc->message = calloc(AMVP_RSA_EXP_LEN_MAX, sizeof(char));
+    stc->message = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_LEN_MAX, sizeof(char));
     if (!stc->message) { goto err; }
 
     if (cipher == AMVP_ECDSA_KEYVER || cipher == AMVP_ECDSA_SIGVER) {
@@ -183,12 +183,12 @@ static AMVP_RESULT amvp_ecdsa_init_tc(AMVP_CTX *ctx,
 
 err:
     AMVP_LOG_ERR("Failed to allocate buffer in ECDSA test case");
-    if (stc->qx) free(stc->qx);
-    if (stc->qy) free(stc->qy);
-    if (stc->r) free(stc->r);
-    if (stc->s) free(stc->s);
-    if (stc->d) free(stc->d);
-    if (stc->message) free(stc->message);
+    if (stc->qx) amvp_mem_free(AMVP_MEM_TC, stc->qx);
+    if (stc->qy) amvp_mem_free(AMVP_MEM_TC, stc->qy);
+    if (stc->r) amvp_mem_free(AMVP_MEM_TC, stc->r);
+    if (stc->s) amvp_mem_free(AMVP_MEM_TC, stc->s);
+    if (stc->d) amvp_mem_free(AMVP_MEM_TC, stc->d);
+    if (stc->message) amvp_mem_free(AMVP_MEM_TC, stc->message);
     return AMVP_MALLOC_FAIL;
 }
 
@@ -245,9 +245,10 @@ static AMVP_RESULT amvp_ecdsa_kat_handler_internal(AMVP_CTX *ctx, JSON_Object *o
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
-    AMVP_CAPS_LIST *cap;
+    AMVP_CAPS_LIST *cap = NULL;
     AMVP_ECDSA_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
+    AMVP_TEST_GROUP group = { 0 };
     AMVP_RESULT rv;
 
     AMVP_CIPHER alg_id;
@@ -267,6 +268,7 @@ static AMVP_RESULT amvp_ecdsa_kat_handler_internal(AMVP_CTX *ctx, JSON_Object *o
 
     memzero_s(&stc, sizeof(AMVP_ECDSA_TC));
     tc.tc.ecdsa = &stc;
+    tc.group = &group;
     mode_str = json_object_get_string(obj, "mode");
     if (!mode_str) {
         AMVP_LOG_ERR("Server JSON missing 'mode_str'");
@@ -331,6 +333,7 @@ static AMVP_RESULT amvp_ecdsa_kat_handler_internal(AMVP_CTX *ctx, JSON_Object *o
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MISSING_ARG;
@@ -394,6 +397,18 @@ static AMVP_RESULT amvp_ecdsa_kat_handler_internal(AMVP_CTX *ctx, JSON_Object *o
         AMVP_LOG_VERBOSE(" secretGenerationMode: %s", secret_gen_mode_str);
         AMVP_LOG_VERBOSE("              hashAlg: %s", hash_alg_str);
 
+        /*
+         * Let the crypto module set up any state shared by the group
+         */
+        group.cipher = alg_id;
+        group.tg_id = tgId;
+        group.curve = curve;
+        group.hash_alg = hash_alg;
+        rv = amvp_group_begin(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
         if (!t_cnt) {
@@ -467,7 +482,7 @@ static AMVP_RESULT amvp_ecdsa_kat_handler_internal(AMVP_CTX *ctx, JSON_Object *o
 
             /* Process the current test vector... */
             if (rv == AMVP_SUCCESS) {
-                if ((cap->crypto_handler)(&tc)) {
+                if (amvp_crypto_handler(ctx, cap, &tc)) {
                     AMVP_LOG_ERR("ERROR: crypto module failed the operation");
                     rv = AMVP_CRYPTO_MODULE_FAIL;
                     json_value_free(r_tval);
@@ -520,17 +535,22 @@ static AMVP_RESULT amvp_ecdsa_kat_handler_internal(AMVP_CTX *ctx, JSON_Object *o
              */
             amvp_ecdsa_release_tc(&stc);
         }
+        rv = amvp_group_end(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
 
 err:
+    amvp_group_end(ctx, cap, &group);
     if (rv != AMVP_SUCCESS) {
         amvp_ecdsa_release_tc(&stc);
         amvp_release_json(r_vs_val, r_gval);
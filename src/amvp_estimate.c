@@ -0,0 +1,722 @@
+/** @file */
+/*
+ * Copyright (c) 2021, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libamvp/LICENSE
+ */
+
+/*
+ * Cost estimate of a test session, see amvp_estimate_session().
+ *
+ * Every registered capability is one vector set, or two where the
+ * registration asks for both variants (see ctx->vs_count). Its test groups
+ * follow the parameter lists the server generates a group for, such as key
+ * lengths and directions for the symmetric ciphers, or modulus and hash for
+ * RSA signatures, and every group gets the number of test cases of the
+ * model of its AMVP_CAP_TYPE. A Monte Carlo test case costs as many crypto
+ * operations as the MCT has iterations and answers with one result per
+ * outer iteration.
+ *
+ * The time of a crypto operation and the size of a test case in the model
+ * are those of a software module on a current server core. A calibration run
+ * replaces them, per algorithm, with what was measured while its vector sets
+ * were processed on a clone of the ctx, so that the session's counters,
+ * histograms and vector set records are left alone.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "amvp.h"
+#include "amvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+extern AMVP_ALG_HANDLER alg_tbl[];
+
+/* JSON of a vector set and of a test group, without their test cases */
+#define AMVP_ESTIMATE_VS_BYTES 200
+#define AMVP_ESTIMATE_TG_BYTES 120
+
+/* Library time per test case, and per byte parsed or serialized */
+#define AMVP_ESTIMATE_TC_NS 2000
+#define AMVP_ESTIMATE_BYTE_NS 10
+
+/* Heap high-water mark of a vector set, relative to its JSON */
+#define AMVP_ESTIMATE_MEM_FACTOR 2
+
+/* Modulus the op_ns of the RSA models is given for */
+#define AMVP_ESTIMATE_RSA_MODULO 2048.0
+
+#define AMVP_ESTIMATE_ONE(n) ((n) ? (n) : 1)
+
+typedef struct amvp_estimate_model_t {
+    AMVP_CAP_TYPE cap_type;
+    int tests;                      /* test cases per test group */
+    unsigned long long op_ns;       /* crypto operation */
+    unsigned int tc_bytes_in;       /* test case as downloaded */
+    unsigned int tc_bytes_out;      /* and its response */
+} AMVP_ESTIMATE_MODEL;
+
+static const AMVP_ESTIMATE_MODEL amvp_estimate_models[] = {
+    { AMVP_SYM_TYPE,                15,      2000,  250,  150 },
+    { AMVP_HASH_TYPE,              165,      3000, 2000,  150 },
+    { AMVP_DRBG_TYPE,               15,     20000,  400,  300 },
+    { AMVP_HMAC_TYPE,              150,      5000, 1200,  150 },
+    { AMVP_CMAC_TYPE,               30,      3000,  600,  120 },
+    { AMVP_KMAC_TYPE,               50,      5000,  800,  200 },
+    { AMVP_RSA_KEYGEN_TYPE,         10, 150000000,  200, 2500 },
+    { AMVP_RSA_SIGGEN_TYPE,          3,   2000000,  600,  700 },
+    { AMVP_RSA_SIGVER_TYPE,          6,     60000, 1500,   60 },
+    { AMVP_RSA_PRIM_TYPE,           30,   1000000, 1200,  600 },
+    { AMVP_ECDSA_KEYGEN_TYPE,       10,     50000,   40,  250 },
+    { AMVP_ECDSA_KEYVER_TYPE,       12,    100000,  250,   60 },
+    { AMVP_ECDSA_SIGGEN_TYPE,       10,     60000,  300,  250 },
+    { AMVP_ECDSA_SIGVER_TYPE,       15,    150000,  500,   60 },
+    { AMVP_DSA_TYPE,                 5,  50000000, 1500, 1500 },
+    { AMVP_KDF135_SNMP_TYPE,        25,     20000,  300,  200 },
+    { AMVP_KDF135_SSH_TYPE,         25,     20000,  800,  800 },
+    { AMVP_KDF135_SRTP_TYPE,        25,     20000,  300,  500 },
+    { AMVP_KDF135_IKEV2_TYPE,       25,     20000,  800, 1000 },
+    { AMVP_KDF135_IKEV1_TYPE,       25,     20000,  800,  500 },
+    { AMVP_KDF135_X942_TYPE,        25,     20000,  600,  300 },
+    { AMVP_KDF135_X963_TYPE,        25,     20000,  600,  300 },
+    { AMVP_KDF135_TPM_TYPE,         25,     20000,  300,  200 },
+    { AMVP_KDF108_TYPE,             10,     10000,  200,  200 },
+    { AMVP_PBKDF_TYPE,              20,   5000000,  200,  200 },
+    { AMVP_KDF_TLS12_TYPE,          25,     20000,  500,  500 },
+    { AMVP_KDF_TLS13_TYPE,          25,     20000,  500,  800 },
+    { AMVP_KAS_ECC_CDH_TYPE,        25,    200000,  300,  150 },
+    { AMVP_KAS_ECC_COMP_TYPE,       10,    200000,  500,  300 },
+    { AMVP_KAS_ECC_NOCOMP_TYPE,     10,    200000,  500,  300 },
+    { AMVP_KAS_ECC_SSC_TYPE,        10,    200000,  500,  300 },
+    { AMVP_KAS_FFC_COMP_TYPE,       10,   2000000, 2000,  800 },
+    { AMVP_KAS_FFC_SSC_TYPE,        10,   2000000, 2000,  800 },
+    { AMVP_KAS_FFC_NOCOMP_TYPE,     10,   2000000, 2000,  800 },
+    { AMVP_KAS_IFC_TYPE,            10,   3000000, 2500, 1000 },
+    { AMVP_KDA_ONESTEP_TYPE,        10,     20000,  800,  200 },
+    { AMVP_KDA_TWOSTEP_TYPE,        10,     20000,  800,  200 },
+    { AMVP_KDA_HKDF_TYPE,           10,     20000,  800,  200 },
+    { AMVP_KTS_IFC_TYPE,            10,   3000000, 2500, 1000 },
+    { AMVP_SAFE_PRIMES_KEYGEN_TYPE, 10,   2000000,  100, 1000 },
+    { AMVP_SAFE_PRIMES_KEYVER_TYPE, 10,   5000000, 1000,   60 }
+};
+
+/* For a cap type without a model of its own */
+static const AMVP_ESTIMATE_MODEL amvp_estimate_default_model = { AMVP_SYM_TYPE, 10, 100000, 500, 300 };
+
+/*
+ * One vector set of a capability
+ */
+typedef struct amvp_estimate_vs_t {
+    unsigned long long tg;
+    unsigned long long tc;
+    unsigned long long ops;
+    double work;                    /* ops, weighted by their cost relative to op_ns */
+    unsigned long long results;     /* test cases in the response, every MCT iteration counts */
+} AMVP_ESTIMATE_VS;
+
+/*
+ * What the calibration run measured for one algorithm
+ */
+typedef struct amvp_estimate_calib_t {
+    int vs_count;
+    unsigned long long tc;
+    unsigned long long ops;
+    unsigned long long crypto_ns;
+    unsigned long long lib_ns;
+    unsigned long long bytes_in;
+    unsigned long long bytes_out;
+    double mem_factor;
+} AMVP_ESTIMATE_CALIB;
+
+static int amvp_estimate_sl(AMVP_SL_LIST *list) {
+    int n = 0;
+
+    for (; list; list = list->next) {
+        n++;
+    }
+    return n;
+}
+
+static int amvp_estimate_pl(AMVP_PARAM_LIST *list) {
+    int n = 0;
+
+    for (; list; list = list->next) {
+        n++;
+    }
+    return n;
+}
+
+static int amvp_estimate_nl(AMVP_NAME_LIST *list) {
+    int n = 0;
+
+    for (; list; list = list->next) {
+        n++;
+    }
+    return n;
+}
+
+static const AMVP_ESTIMATE_MODEL *amvp_estimate_model(AMVP_CAP_TYPE cap_type) {
+    size_t i;
+
+    for (i = 0; i < sizeof(amvp_estimate_models) / sizeof(amvp_estimate_models[0]); i++) {
+        if (amvp_estimate_models[i].cap_type == cap_type) {
+            return &amvp_estimate_models[i];
+        }
+    }
+    return &amvp_estimate_default_model;
+}
+
+static void amvp_estimate_groups(AMVP_ESTIMATE_VS *vs, int groups, int tests, double weight) {
+    unsigned long long tc = (unsigned long long)groups * tests;
+
+    vs->tg += groups;
+    vs->tc += tc;
+    vs->ops += tc;
+    vs->work += (double)tc * weight;
+    vs->results += tc;
+}
+
+static void amvp_estimate_mct(AMVP_ESTIMATE_VS *vs, int groups, int outer, int inner) {
+    unsigned long long ops = (unsigned long long)groups * outer * inner;
+
+    vs->tg += groups;
+    vs->tc += groups;
+    vs->ops += ops;
+    vs->work += (double)ops;
+    vs->results += (unsigned long long)groups * outer;
+}
+
+static int amvp_estimate_sym(AMVP_CAPS_LIST *cap, const AMVP_ESTIMATE_MODEL *m, AMVP_ESTIMATE_VS *vs) {
+    AMVP_SYM_CIPHER_CAP *sym = cap->cap.sym_cap;
+    int groups = (sym->direction == AMVP_SYM_CIPH_DIR_BOTH ? 2 : 1) * AMVP_ESTIMATE_ONE(amvp_estimate_sl(sym->keylen));
+    int aft = groups;
+
+    switch (cap->cipher) {
+    case AMVP_AES_GCM:
+    case AMVP_AES_GCM_SIV:
+    case AMVP_AES_CCM:
+    case AMVP_AES_GMAC:
+    case AMVP_AES_XPN:
+        aft *= AMVP_ESTIMATE_ONE(amvp_estimate_sl(sym->ptlen)) * AMVP_ESTIMATE_ONE(amvp_estimate_sl(sym->aadlen)) *
+               AMVP_ESTIMATE_ONE(amvp_estimate_sl(sym->taglen)) * AMVP_ESTIMATE_ONE(amvp_estimate_sl(sym->ivlen));
+        break;
+    case AMVP_AES_XTS:
+        aft *= AMVP_ESTIMATE_ONE(amvp_estimate_sl(sym->ptlen)) * AMVP_ESTIMATE_ONE(amvp_estimate_sl(sym->tweak));
+        break;
+    case AMVP_AES_KW:
+    case AMVP_AES_KWP:
+    case AMVP_TDES_KW:
+        aft *= AMVP_ESTIMATE_ONE(amvp_estimate_sl(sym->ptlen));
+        break;
+    default:
+        break;
+    }
+    amvp_estimate_groups(vs, aft, m->tests, 1.0);
+
+    switch (cap->cipher) {
+    case AMVP_AES_ECB:
+    case AMVP_AES_CBC:
+    case AMVP_AES_CFB1:
+    case AMVP_AES_CFB8:
+    case AMVP_AES_CFB128:
+    case AMVP_AES_OFB:
+        amvp_estimate_mct(vs, groups, AMVP_AES_MCT_OUTER, AMVP_AES_MCT_INNER);
+        break;
+    case AMVP_TDES_ECB:
+    case AMVP_TDES_CBC:
+    case AMVP_TDES_CBCI:
+    case AMVP_TDES_OFB:
+    case AMVP_TDES_OFBI:
+    case AMVP_TDES_CFB1:
+    case AMVP_TDES_CFB8:
+    case AMVP_TDES_CFB64:
+    case AMVP_TDES_CFBP1:
+    case AMVP_TDES_CFBP8:
+    case AMVP_TDES_CFBP64:
+        amvp_estimate_mct(vs, groups, AMVP_DES_MCT_OUTER, AMVP_DES_MCT_INNER);
+        break;
+    default:
+        break;
+    }
+
+    /* Internal and external IV generation are separate vector sets */
+    return sym->ivgen_source == AMVP_SYM_CIPH_IVGEN_SRC_EITHER ? 2 : 1;
+}
+
+static void amvp_estimate_rsa(AMVP_CAPS_LIST *cap, const AMVP_ESTIMATE_MODEL *m, AMVP_ESTIMATE_VS *vs) {
+    AMVP_RSA_KEYGEN_CAP *keygen = NULL;
+    AMVP_RSA_SIG_CAP *sig = NULL;
+    AMVP_RSA_MODE_CAPS_LIST *mode = NULL;
+    AMVP_RSA_HASH_PAIR_LIST *pair = NULL;
+    double scale = 0.0;
+    int hashes = 0;
+
+    if (cap->cap_type == AMVP_RSA_KEYGEN_TYPE) {
+        /* Prime generation takes about the cube of the modulus */
+        for (keygen = cap->cap.rsa_keygen_cap; keygen; keygen = keygen->next) {
+            for (mode = keygen->mode_capabilities; mode; mode = mode->next) {
+                scale = mode->modulo / AMVP_ESTIMATE_RSA_MODULO;
+                amvp_estimate_groups(vs, AMVP_ESTIMATE_ONE(amvp_estimate_nl(mode->prime_tests)), m->tests,
+                                     scale * scale * scale);
+            }
+        }
+        return;
+    }
+
+    /* A private key operation takes about the square of the modulus */
+    for (sig = cap->cap.rsa_siggen_cap; sig; sig = sig->next) {
+        for (mode = sig->mode_capabilities; mode; mode = mode->next) {
+            hashes = amvp_estimate_nl(mode->hash_algs);
+            for (pair = mode->hash_pair; pair; pair = pair->next) {
+                hashes++;
+            }
+            scale = cap->cap_type == AMVP_RSA_SIGGEN_TYPE ? mode->modulo / AMVP_ESTIMATE_RSA_MODULO : 1.0;
+            amvp_estimate_groups(vs, AMVP_ESTIMATE_ONE(hashes), m->tests, scale * scale);
+        }
+    }
+}
+
+static int amvp_estimate_ecdsa(AMVP_CAPS_LIST *cap, const AMVP_ESTIMATE_MODEL *m, AMVP_ESTIMATE_VS *vs) {
+    AMVP_ECDSA_CAP *ecdsa = cap->cap.ecdsa_keygen_cap;
+    AMVP_CURVE_ALG_COMPAT_LIST *curve = NULL;
+    int groups = 0, hashes = 0, i;
+
+    for (curve = ecdsa->curves; curve; curve = curve->next) {
+        switch (cap->cap_type) {
+        case AMVP_ECDSA_KEYGEN_TYPE:
+            groups += AMVP_ESTIMATE_ONE(amvp_estimate_nl(ecdsa->secret_gen_modes));
+            break;
+        case AMVP_ECDSA_SIGGEN_TYPE:
+        case AMVP_ECDSA_SIGVER_TYPE:
+            for (i = 0, hashes = 0; i < AMVP_HASH_ALG_MAX; i++) {
+                if (curve->algs[i] || ecdsa->hash_algs[i]) {
+                    hashes++;
+                }
+            }
+            groups += AMVP_ESTIMATE_ONE(hashes);
+            break;
+        default:
+            groups++;
+            break;
+        }
+    }
+    amvp_estimate_groups(vs, AMVP_ESTIMATE_ONE(groups), m->tests, 1.0);
+
+    /* With and without component mode are separate vector sets */
+    return ecdsa->component == AMVP_ECDSA_COMPONENT_MODE_BOTH ? 2 : 1;
+}
+
+static int amvp_estimate_kas(AMVP_CAPS_LIST *cap) {
+    AMVP_KAS_ECC_CAP_MODE *ecc = NULL;
+    AMVP_KAS_ECC_SCHEME *ecc_scheme = NULL;
+    AMVP_KAS_ECC_PSET *ecc_pset = NULL;
+    AMVP_KAS_FFC_CAP_MODE *ffc = NULL;
+    AMVP_KAS_FFC_SCHEME *ffc_scheme = NULL;
+    AMVP_KAS_FFC_PSET *ffc_pset = NULL;
+    int groups = 0, i;
+
+    switch (cap->cap_type) {
+    case AMVP_KAS_ECC_CDH_TYPE:
+    case AMVP_KAS_ECC_COMP_TYPE:
+    case AMVP_KAS_ECC_NOCOMP_TYPE:
+    case AMVP_KAS_ECC_SSC_TYPE:
+        for (i = 0; cap->cap.kas_ecc_cap->kas_ecc_mode && i < AMVP_KAS_ECC_MAX_MODES; i++) {
+            ecc = &cap->cap.kas_ecc_cap->kas_ecc_mode[i];
+            groups += amvp_estimate_pl(ecc->curve);
+            for (ecc_scheme = ecc->scheme; ecc_scheme; ecc_scheme = ecc_scheme->next) {
+                for (ecc_pset = ecc_scheme->pset; ecc_pset; ecc_pset = ecc_pset->next) {
+                    groups += AMVP_ESTIMATE_ONE(amvp_estimate_pl(ecc_scheme->role));
+                }
+            }
+        }
+        break;
+    case AMVP_KAS_FFC_COMP_TYPE:
+    case AMVP_KAS_FFC_SSC_TYPE:
+    case AMVP_KAS_FFC_NOCOMP_TYPE:
+        for (i = 0; cap->cap.kas_ffc_cap->kas_ffc_mode && i < AMVP_KAS_FFC_MAX_MODES; i++) {
+            ffc = &cap->cap.kas_ffc_cap->kas_ffc_mode[i];
+            groups += amvp_estimate_pl(ffc->genmeth);
+            for (ffc_scheme = ffc->scheme; ffc_scheme; ffc_scheme = ffc_scheme->next) {
+                for (ffc_pset = ffc_scheme->pset; ffc_pset; ffc_pset = ffc_pset->next) {
+                    groups += AMVP_ESTIMATE_ONE(amvp_estimate_pl(ffc_scheme->role));
+                }
+            }
+        }
+        break;
+    default:
+        break;
+    }
+    return groups;
+}
+
+/*
+ * Fills vs with one vector set of cap, returns the number of vector sets
+ */
+static int amvp_estimate_cap(AMVP_CAPS_LIST *cap, const AMVP_ESTIMATE_MODEL *m, AMVP_ESTIMATE_VS *vs) {
+    AMVP_DRBG_MODE_LIST *drbg = NULL;
+    AMVP_DRBG_GROUP_LIST *drbg_group = NULL;
+    AMVP_DSA_CAP_MODE *dsa = NULL;
+    AMVP_DSA_ATTRS *attrs = NULL;
+    AMVP_KTS_IFC_SCHEMES *kts = NULL;
+    AMVP_KDF108_CAP *kdf108 = NULL;
+    int groups = 0, i;
+
+    memzero_s(vs, sizeof(AMVP_ESTIMATE_VS));
+    switch (cap->cap_type) {
+    case AMVP_SYM_TYPE:
+        return amvp_estimate_sym(cap, m, vs);
+    case AMVP_HASH_TYPE:
+        amvp_estimate_groups(vs, 1, m->tests, 1.0);
+        amvp_estimate_mct(vs, 1, AMVP_HASH_MCT_OUTER, AMVP_HASH_MCT_INNER);
+        if (cap->cipher == AMVP_HASH_SHAKE_128 || cap->cipher == AMVP_HASH_SHAKE_256) {
+            /* Variable output test */
+            amvp_estimate_groups(vs, 1, 512, 1.0);
+        }
+        return 1;
+    case AMVP_DRBG_TYPE:
+        for (drbg = cap->cap.drbg_cap->drbg_cap_mode; drbg; drbg = drbg->next) {
+            for (drbg_group = drbg->groups; drbg_group; drbg_group = drbg_group->next) {
+                groups++;
+            }
+        }
+        break;
+    case AMVP_CMAC_TYPE:
+        groups = AMVP_ESTIMATE_ONE(cap->cap.cmac_cap->direction_gen + cap->cap.cmac_cap->direction_ver) *
+                 AMVP_ESTIMATE_ONE(amvp_estimate_sl(cap->cap.cmac_cap->key_len));
+        break;
+    case AMVP_RSA_KEYGEN_TYPE:
+    case AMVP_RSA_SIGGEN_TYPE:
+    case AMVP_RSA_SIGVER_TYPE:
+        amvp_estimate_rsa(cap, m, vs);
+        if (!vs->tg) {
+            amvp_estimate_groups(vs, 1, m->tests, 1.0);
+        }
+        return 1;
+    case AMVP_ECDSA_KEYGEN_TYPE:
+    case AMVP_ECDSA_KEYVER_TYPE:
+    case AMVP_ECDSA_SIGGEN_TYPE:
+    case AMVP_ECDSA_SIGVER_TYPE:
+        return amvp_estimate_ecdsa(cap, m, vs);
+    case AMVP_DSA_TYPE:
+        for (i = 0; cap->cap.dsa_cap->dsa_cap_mode && i < AMVP_DSA_MAX_MODES; i++) {
+            dsa = &cap->cap.dsa_cap->dsa_cap_mode[i];
+            for (attrs = dsa->defined ? dsa->dsa_attrs : NULL; attrs; attrs = attrs->next) {
+                groups++;
+            }
+        }
+        break;
+    case AMVP_KDF135_SNMP_TYPE:
+        groups = AMVP_ESTIMATE_ONE(amvp_estimate_sl(cap->cap.kdf135_snmp_cap->pass_lens)) *
+                 AMVP_ESTIMATE_ONE(amvp_estimate_nl(cap->cap.kdf135_snmp_cap->eng_ids));
+        break;
+    case AMVP_KDF135_SSH_TYPE:
+        for (i = 0; i < 4; i++) {
+            groups += cap->cap.kdf135_ssh_cap->method[i] ? 1 : 0;
+        }
+        break;
+    case AMVP_KDF135_SRTP_TYPE:
+        groups = amvp_estimate_sl(cap->cap.kdf135_srtp_cap->aes_keylens);
+        break;
+    case AMVP_KDF135_IKEV2_TYPE:
+        groups = amvp_estimate_nl(cap->cap.kdf135_ikev2_cap->hash_algs);
+        break;
+    case AMVP_KDF135_IKEV1_TYPE:
+        groups = amvp_estimate_nl(cap->cap.kdf135_ikev1_cap->hash_algs);
+        break;
+    case AMVP_KDF135_X942_TYPE:
+        groups = amvp_estimate_nl(cap->cap.kdf135_x942_cap->hash_algs);
+        break;
+    case AMVP_KDF135_X963_TYPE:
+        groups = amvp_estimate_nl(cap->cap.kdf135_x963_cap->hash_algs) *
+                 AMVP_ESTIMATE_ONE(amvp_estimate_sl(cap->cap.kdf135_x963_cap->field_sizes));
+        break;
+    case AMVP_KDF108_TYPE:
+        kdf108 = cap->cap.kdf108_cap;
+        groups = (kdf108->counter_mode.kdf_mode ? AMVP_ESTIMATE_ONE(amvp_estimate_nl(kdf108->counter_mode.mac_mode)) : 0) +
+                 (kdf108->feedback_mode.kdf_mode ? AMVP_ESTIMATE_ONE(amvp_estimate_nl(kdf108->feedback_mode.mac_mode)) : 0) +
+                 (kdf108->dpi_mode.kdf_mode ? AMVP_ESTIMATE_ONE(amvp_estimate_nl(kdf108->dpi_mode.mac_mode)) : 0);
+        break;
+    case AMVP_PBKDF_TYPE:
+        groups = amvp_estimate_nl(cap->cap.pbkdf_cap->hmac_algs);
+        break;
+    case AMVP_KDF_TLS12_TYPE:
+        groups = amvp_estimate_nl(cap->cap.kdf_tls12_cap->hash_algs);
+        break;
+    case AMVP_KDF_TLS13_TYPE:
+        groups = amvp_estimate_nl(cap->cap.kdf_tls13_cap->hmac_algs) *
+                 AMVP_ESTIMATE_ONE(amvp_estimate_pl(cap->cap.kdf_tls13_cap->running_mode));
+        break;
+    case AMVP_KAS_ECC_CDH_TYPE:
+    case AMVP_KAS_ECC_COMP_TYPE:
+    case AMVP_KAS_ECC_NOCOMP_TYPE:
+    case AMVP_KAS_ECC_SSC_TYPE:
+    case AMVP_KAS_FFC_COMP_TYPE:
+    case AMVP_KAS_FFC_SSC_TYPE:
+    case AMVP_KAS_FFC_NOCOMP_TYPE:
+        groups = amvp_estimate_kas(cap);
+        break;
+    case AMVP_KAS_IFC_TYPE:
+        groups = (amvp_estimate_pl(cap->cap.kas_ifc_cap->kas1_roles) + amvp_estimate_pl(cap->cap.kas_ifc_cap->kas2_roles)) *
+                 AMVP_ESTIMATE_ONE(amvp_estimate_sl(cap->cap.kas_ifc_cap->modulo)) *
+                 AMVP_ESTIMATE_ONE(amvp_estimate_pl(cap->cap.kas_ifc_cap->keygen_method));
+        break;
+    case AMVP_KTS_IFC_TYPE:
+        for (kts = cap->cap.kts_ifc_cap->schemes; kts; kts = kts->next) {
+            groups += AMVP_ESTIMATE_ONE(amvp_estimate_pl(kts->roles));
+        }
+        groups *= AMVP_ESTIMATE_ONE(amvp_estimate_sl(cap->cap.kts_ifc_cap->modulo));
+        break;
+    case AMVP_SAFE_PRIMES_KEYGEN_TYPE:
+    case AMVP_SAFE_PRIMES_KEYVER_TYPE:
+        if (cap->cap.safe_primes_keygen_cap->mode) {
+            groups = amvp_estimate_pl(cap->cap.safe_primes_keygen_cap->mode->genmeth);
+        }
+        break;
+    case AMVP_HMAC_TYPE:
+    case AMVP_KMAC_TYPE:
+    case AMVP_RSA_PRIM_TYPE:
+    case AMVP_KDF135_TPM_TYPE:
+    case AMVP_KDA_ONESTEP_TYPE:
+    case AMVP_KDA_TWOSTEP_TYPE:
+    case AMVP_KDA_HKDF_TYPE:
+    default:
+        break;
+    }
+    amvp_estimate_groups(vs, AMVP_ESTIMATE_ONE(groups), m->tests, 1.0);
+    return 1;
+}
+
+static unsigned long long amvp_estimate_json_size(JSON_Value *val) {
+    size_t size = json_serialization_size(val);
+
+    /* The size includes the terminating NUL */
+    return size ? (unsigned long long)size - 1 : 0;
+}
+
+static unsigned long long amvp_estimate_tc_count(JSON_Object *obj) {
+    JSON_Array *groups = json_object_get_array(obj, "testGroups");
+    unsigned long long tc = 0;
+    size_t i;
+
+    for (i = 0; i < json_array_get_count(groups); i++) {
+        tc += json_array_get_count(json_object_get_array(json_array_get_object(groups, i), "tests"));
+    }
+    return tc;
+}
+
+/*
+ * Processes the vector sets of filename with the registered handlers, on a
+ * clone of ctx that shares its capabilities and logging but keeps its
+ * counters and vector set records to itself
+ */
+static AMVP_RESULT amvp_estimate_calibrate(AMVP_CTX *ctx, const char *filename, AMVP_ESTIMATE_CALIB *calib) {
+    AMVP_CTX *cctx = NULL;
+    AMVP_JSON_STREAM *stream = NULL;
+    AMVP_ESTIMATE_CALIB *c = NULL;
+    JSON_Value *val = NULL, *rsp = NULL;
+    JSON_Array *rsp_arr = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    unsigned long long start = 0, parse_ns = 0, elapsed = 0, in = 0, out = 0, tc = 0;
+    double mem_factor = 0.0;
+    int vs_id = 0;
+
+    cctx = calloc(1, sizeof(AMVP_CTX));
+    if (!cctx) {
+        return AMVP_MALLOC_FAIL;
+    }
+    *cctx = *ctx;
+    memzero_s(&cctx->work, sizeof(AMVP_VS_WORK));
+    memzero_s(cctx->latency, sizeof(cctx->latency));
+    cctx->vs_meta = NULL;
+    cctx->perf = NULL;
+    cctx->trace = NULL;
+    cctx->slow_tc_max = 0;
+    cctx->parent = NULL;
+
+    rv = amvp_json_stream_open(&stream, filename);
+    if (rv != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("Unable to open calibration file %s", filename);
+        goto end;
+    }
+    /* The header, or the version of a KAT file */
+    rv = amvp_json_stream_next(stream, &val);
+    if (rv != AMVP_SUCCESS || !val) {
+        AMVP_LOG_ERR("Calibration file %s holds no vector sets", filename);
+        rv = AMVP_JSON_ERR;
+        goto end;
+    }
+
+    AMVP_LOG_STATUS("Running calibration vector sets from %s...", filename);
+    for (;;) {
+        json_value_free(val);
+        val = NULL;
+        amvp_mem_vs_begin();
+        start = amvp_perf_now();
+        rv = amvp_json_stream_next(stream, &val);
+        parse_ns = amvp_perf_now() - start;
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("JSON parse error in calibration file %s", filename);
+            goto end;
+        }
+        if (!val) {
+            break;
+        }
+        vs_id = (int)json_object_get_number(json_value_get_object(val), "vsId");
+        in = amvp_estimate_json_size(val);
+        tc = amvp_estimate_tc_count(json_value_get_object(val));
+
+        memzero_s(&cctx->work.perf, sizeof(AMVP_PERF_COUNTERS));
+        start = amvp_perf_now();
+        rv = amvp_dispatch_vector_set(cctx, json_value_get_object(val));
+        elapsed = amvp_perf_now() - start;
+        if (rv != AMVP_SUCCESS || cctx->work.cipher <= AMVP_CIPHER_START ||
+                cctx->work.cipher >= AMVP_CIPHER_END || !tc) {
+            AMVP_LOG_WARN("Calibration vector set %d was not processed (rv=%d), it is not counted", vs_id, rv);
+            rv = AMVP_SUCCESS;
+            continue;
+        }
+
+        /* The response of this vector set is the last element of kat_resp */
+        rsp_arr = json_value_get_array(cctx->work.kat_resp);
+        rsp = json_array_get_value(rsp_arr, json_array_get_count(rsp_arr) - 1);
+        out = rsp ? amvp_estimate_json_size(rsp) : 0;
+
+        c = &calib[cctx->work.cipher];
+        c->vs_count++;
+        c->tc += tc;
+        c->ops += cctx->work.perf.tc_count;
+        c->crypto_ns += cctx->work.perf.crypto_ns;
+        c->lib_ns += parse_ns + elapsed - cctx->work.perf.crypto_ns;
+        c->bytes_in += in;
+        c->bytes_out += out;
+        mem_factor = (double)amvp_mem_vs_peak() / (double)(in + out ? in + out : 1);
+        if (mem_factor > c->mem_factor) {
+            c->mem_factor = mem_factor;
+        }
+        if (cctx->work.kat_resp) {
+            json_value_free(cctx->work.kat_resp);
+            cctx->work.kat_resp = NULL;
+        }
+    }
+
+end:
+    if (val) json_value_free(val);
+    if (stream) amvp_json_stream_close(stream);
+    if (cctx->work.kat_resp) json_value_free(cctx->work.kat_resp);
+    if (cctx->work.curl_buf) amvp_mem_free(AMVP_MEM_TRANSPORT, cctx->work.curl_buf);
+    amvp_vs_meta_free(&cctx->vs_meta);
+    free(cctx);
+    return rv;
+}
+
+static void amvp_estimate_add(AMVP_ALG_ESTIMATE *to, const AMVP_ALG_ESTIMATE *from) {
+    to->vs_count += from->vs_count;
+    to->tg_count += from->tg_count;
+    to->tc_count += from->tc_count;
+    to->crypto_calls += from->crypto_calls;
+    to->crypto_ns += from->crypto_ns;
+    to->cpu_ns += from->cpu_ns;
+    to->bytes_in += from->bytes_in;
+    to->bytes_out += from->bytes_out;
+    if (from->vs_max_ns > to->vs_max_ns) {
+        to->vs_max_ns = from->vs_max_ns;
+    }
+    if (from->mem_peak > to->mem_peak) {
+        to->mem_peak = from->mem_peak;
+    }
+}
+
+/*
+ * Estimate for the vector sets of one capability
+ */
+static void amvp_estimate_alg(AMVP_CAPS_LIST *cap, const AMVP_ESTIMATE_CALIB *c, AMVP_ALG_ESTIMATE *alg) {
+    const AMVP_ESTIMATE_MODEL *m = amvp_estimate_model(cap->cap_type);
+    AMVP_ESTIMATE_VS vs;
+    unsigned long long crypto_ns = 0, lib_ns = 0, in = 0, out = 0;
+    double mem_factor = AMVP_ESTIMATE_MEM_FACTOR;
+    int vs_count, i;
+
+    vs_count = amvp_estimate_cap(cap, m, &vs);
+
+    in = AMVP_ESTIMATE_VS_BYTES + vs.tg * AMVP_ESTIMATE_TG_BYTES;
+    out = AMVP_ESTIMATE_VS_BYTES + vs.tg * AMVP_ESTIMATE_TG_BYTES / 4;
+    if (c && c->vs_count && c->ops) {
+        crypto_ns = (unsigned long long)((double)vs.ops * c->crypto_ns / c->ops);
+        lib_ns = vs.tc * c->lib_ns / c->tc;
+        in += vs.tc * c->bytes_in / c->tc;
+        out += vs.tc * c->bytes_out / c->tc;
+        if (c->mem_factor > 0.0) {
+            mem_factor = c->mem_factor;
+        }
+        alg->calibrated = 1;
+    } else {
+        crypto_ns = (unsigned long long)(vs.work * m->op_ns);
+        in += vs.tc * m->tc_bytes_in;
+        out += vs.results * m->tc_bytes_out;
+        lib_ns = vs.tc * AMVP_ESTIMATE_TC_NS + (in + out) * AMVP_ESTIMATE_BYTE_NS;
+    }
+
+    for (i = 0; !alg->name && i < AMVP_ALG_MAX; i++) {
+        if (alg_tbl[i].cipher == cap->cipher) {
+            alg->name = alg_tbl[i].name;
+            alg->mode = alg_tbl[i].mode;
+        }
+    }
+    alg->vs_count = vs_count;
+    alg->tg_count = vs.tg * vs_count;
+    alg->tc_count = vs.tc * vs_count;
+    alg->crypto_calls = vs.ops * vs_count;
+    alg->crypto_ns = crypto_ns * vs_count;
+    alg->vs_max_ns = crypto_ns + lib_ns;
+    alg->cpu_ns = alg->vs_max_ns * vs_count;
+    alg->bytes_in = in * vs_count;
+    alg->bytes_out = out * vs_count;
+    alg->mem_peak = (unsigned long long)((in + out) * mem_factor);
+}
+
+AMVP_RESULT amvp_estimate(AMVP_CTX *ctx, const char *calibration_file, AMVP_SESSION_ESTIMATE *est) {
+    AMVP_ESTIMATE_CALIB *calib = NULL;
+    AMVP_CAPS_LIST *cap = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int i, calibrated = 1;
+
+    memzero_s(est, sizeof(AMVP_SESSION_ESTIMATE));
+    if (calibration_file) {
+        calib = calloc(AMVP_CIPHER_END, sizeof(AMVP_ESTIMATE_CALIB));
+        if (!calib) {
+            return AMVP_MALLOC_FAIL;
+        }
+        rv = amvp_estimate_calibrate(ctx, calibration_file, calib);
+        if (rv != AMVP_SUCCESS) {
+            goto end;
+        }
+    }
+
+    for (cap = ctx->caps_list; cap; cap = cap->next) {
+        if (cap->cipher <= AMVP_CIPHER_START || cap->cipher >= AMVP_CIPHER_END) {
+            continue;
+        }
+        amvp_estimate_alg(cap, calib ? &calib[cap->cipher] : NULL, &est->alg[cap->cipher]);
+    }
+    for (i = AMVP_CIPHER_START + 1; i < AMVP_CIPHER_END; i++) {
+        if (est->alg[i].vs_count) {
+            amvp_estimate_add(&est->total, &est->alg[i]);
+            calibrated &= est->alg[i].calibrated;
+        }
+    }
+    est->total.calibrated = est->total.vs_count ? calibrated : 0;
+
+    AMVP_LOG_STATUS("Estimated %d vector sets with %llu test cases, %.1f s of CPU time, "
+                    "%llu KB to download and %llu KB to upload",
+                    est->total.vs_count, est->total.tc_count, est->total.cpu_ns / 1e9,
+                    est->total.bytes_in / 1024, est->total.bytes_out / 1024);
+
+end:
+    if (calib) free(calib);
+    return rv;
+}
@@ -0,0 +1,549 @@
+/** @file */
+/*
+ * Copyright (c) 2021, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libamvp/LICENSE
+ */
+
+/*
+ * File access for offline request and response files.
+ *
+ * Saved vector sets and their responses are large hex encoded JSON files, and
+ * are commonly moved between networks compressed. Every file the library
+ * reads or writes goes through AMVP_FILE so that .gz (zlib, AMVP_USE_ZLIB) and
+ * .zst (zstd, AMVP_USE_ZSTD) files are handled transparently. Files being
+ * read are recognised by their magic bytes, files being written by their
+ * extension. Compression and decompression are streamed through a small
+ * buffer; a compressed file is never held in memory in full.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#ifdef AMVP_USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef AMVP_USE_ZSTD
+#include <zstd.h>
+#endif
+#include "amvp.h"
+#include "amvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+#define AMVP_FILE_GZIP_EXT ".gz"
+#define AMVP_FILE_ZSTD_EXT ".zst"
+#define AMVP_FILE_READ_CHUNK (64 * 1024)
+#define AMVP_FILE_WRITE_BUF_SIZE (1024 * 1024)
+
+struct amvp_file_t {
+    AMVP_FILE_TYPE type;
+    int writing;
+    int eof;
+    int err;
+    FILE *fp;                   /* plain and zstd files */
+#ifdef AMVP_USE_ZLIB
+    gzFile gz;
+    int fd;                     /* underlying fd of gz, for amvp_file_sync() */
+#endif
+#ifdef AMVP_USE_ZSTD
+    ZSTD_CStream *cs;
+    ZSTD_DStream *ds;
+    char *zbuf;                 /* compressed side of the stream */
+    size_t zbuf_max;
+    size_t zbuf_len;            /* compressed bytes in zbuf, reading only */
+    size_t zbuf_pos;            /* next compressed byte in zbuf, reading only */
+#endif
+};
+
+static int amvp_file_has_ext(const char *filename, const char *ext) {
+    size_t len = strnlen_s(filename, AMVP_JSON_FILENAME_MAX + 1);
+    size_t ext_len = strnlen_s(ext, AMVP_JSON_FILENAME_MAX);
+
+    return len > ext_len && !strncmp(filename + len - ext_len, ext, ext_len);
+}
+
+/*
+ * Type of file to write for filename, from its extension
+ */
+AMVP_FILE_TYPE amvp_file_type(const char *filename) {
+    if (!filename) {
+        return AMVP_FILE_PLAIN;
+    }
+    if (amvp_file_has_ext(filename, AMVP_FILE_GZIP_EXT)) {
+        return AMVP_FILE_GZIP;
+    }
+    if (amvp_file_has_ext(filename, AMVP_FILE_ZSTD_EXT)) {
+        return AMVP_FILE_ZSTD;
+    }
+    return AMVP_FILE_PLAIN;
+}
+
+/*
+ * Type of an existing file, from its magic bytes
+ */
+static AMVP_FILE_TYPE amvp_file_sniff(FILE *fp) {
+    unsigned char magic[4] = { 0 };
+    size_t len = 0;
+
+    len = fread(magic, 1, sizeof(magic), fp);
+    rewind(fp);
+    if (len >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        return AMVP_FILE_GZIP;
+    }
+    if (len == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+        return AMVP_FILE_ZSTD;
+    }
+    return AMVP_FILE_PLAIN;
+}
+
+#ifdef AMVP_USE_ZLIB
+static AMVP_RESULT amvp_file_open_gz(AMVP_FILE *f, const char *filename, const char *mode, int level) {
+    char gz_mode[16];
+    int flags = 0;
+
+    if (f->writing) {
+        flags = O_WRONLY | O_CREAT | (mode[0] == 'a' ? O_APPEND : O_TRUNC);
+    } else {
+        flags = O_RDONLY;
+    }
+#ifdef _WIN32
+    f->fd = _open(filename, flags | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    f->fd = open(filename, flags, 0644);
+#endif
+    if (f->fd < 0) {
+        return AMVP_INVALID_ARG;
+    }
+
+    if (!f->writing) {
+        snprintf(gz_mode, sizeof(gz_mode), "rb");
+    } else if (level) {
+        snprintf(gz_mode, sizeof(gz_mode), "%cb%d", mode[0], level > 9 ? 9 : level);
+    } else {
+        snprintf(gz_mode, sizeof(gz_mode), "%cb", mode[0]);
+    }
+    f->gz = gzdopen(f->fd, gz_mode);
+    if (!f->gz) {
+#ifdef _WIN32
+        _close(f->fd);
+#else
+        close(f->fd);
+#endif
+        return AMVP_MALLOC_FAIL;
+    }
+    return AMVP_SUCCESS;
+}
+#endif
+
+#ifdef AMVP_USE_ZSTD
+static AMVP_RESULT amvp_file_open_zstd(AMVP_FILE *f, int level) {
+    if (f->writing) {
+        f->cs = ZSTD_createCStream();
+        if (!f->cs) {
+            return AMVP_MALLOC_FAIL;
+        }
+        if (ZSTD_isError(ZSTD_CCtx_setParameter(f->cs, ZSTD_c_compressionLevel,
+                                                level ? level : ZSTD_CLEVEL_DEFAULT))) {
+            return AMVP_INVALID_ARG;
+        }
+        f->zbuf_max = ZSTD_CStreamOutSize();
+    } else {
+        f->ds = ZSTD_createDStream();
+        if (!f->ds) {
+            return AMVP_MALLOC_FAIL;
+        }
+        f->zbuf_max = ZSTD_DStreamInSize();
+    }
+    f->zbuf = calloc(f->zbuf_max, sizeof(char));
+    if (!f->zbuf) {
+        return AMVP_MALLOC_FAIL;
+    }
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Compress len bytes of buf into the file. With a NULL buf, end the
+ * current frame (ZSTD_e_end) or flush it (ZSTD_e_flush).
+ */
+static int amvp_file_zstd_write(AMVP_FILE *f, const void *buf, size_t len, ZSTD_EndDirective op) {
+    ZSTD_inBuffer in = { buf, len, 0 };
+    ZSTD_outBuffer out;
+    size_t remaining = 0;
+
+    do {
+        out.dst = f->zbuf;
+        out.size = f->zbuf_max;
+        out.pos = 0;
+        remaining = ZSTD_compressStream2(f->cs, &out, &in, op);
+        if (ZSTD_isError(remaining)) {
+            return -1;
+        }
+        if (out.pos && fwrite(f->zbuf, 1, out.pos, f->fp) != out.pos) {
+            return -1;
+        }
+    } while (op == ZSTD_e_continue ? in.pos < in.size : remaining != 0);
+    return 0;
+}
+
+static size_t amvp_file_zstd_read(AMVP_FILE *f, void *buf, size_t len) {
+    ZSTD_outBuffer out = { buf, len, 0 };
+    ZSTD_inBuffer in;
+    size_t prev = 0, ret = 0;
+
+    while (out.pos < out.size && !f->err) {
+        if (f->zbuf_pos == f->zbuf_len && !f->eof) {
+            f->zbuf_len = fread(f->zbuf, 1, f->zbuf_max, f->fp);
+            f->zbuf_pos = 0;
+            if (!f->zbuf_len) {
+                f->eof = 1;
+            }
+        }
+        in.src = f->zbuf;
+        in.size = f->zbuf_len;
+        in.pos = f->zbuf_pos;
+        prev = out.pos;
+        ret = ZSTD_decompressStream(f->ds, &out, &in);
+        f->zbuf_pos = in.pos;
+        if (ZSTD_isError(ret)) {
+            f->err = 1;
+            break;
+        }
+        /* Nothing left to read and nothing buffered in the decoder */
+        if (f->eof && out.pos == prev) {
+            break;
+        }
+    }
+    return out.pos;
+}
+#endif
+
+/*
+ * Open filename for reading ("r"), writing ("w") or appending ("a"). A file
+ * opened for reading is decompressed if it is compressed, whatever its name.
+ * A file opened for writing is compressed as given by type, at level, where 0
+ * selects the default level of the compressor. "r+" opens an existing plain
+ * file for update, which is only used to resume the offline response file.
+ */
+AMVP_RESULT amvp_file_open(AMVP_FILE **file,
+                           const char *filename,
+                           const char *mode,
+                           AMVP_FILE_TYPE type,
+                           int level) {
+    AMVP_FILE *f = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    const char *fmode = NULL;
+
+    if (!file || !filename || !mode) {
+        return AMVP_MISSING_ARG;
+    }
+
+    f = calloc(1, sizeof(AMVP_FILE));
+    if (!f) {
+        return AMVP_MALLOC_FAIL;
+    }
+#ifdef AMVP_USE_ZLIB
+    f->fd = -1;
+#endif
+
+    switch (mode[0]) {
+    case 'r':
+        fmode = mode[1] == '+' ? "r+b" : "rb";
+        f->writing = mode[1] == '+';
+        break;
+    case 'w':
+        fmode = "wb";
+        f->writing = 1;
+        break;
+    case 'a':
+        fmode = "ab";
+        f->writing = 1;
+        break;
+    default:
+        free(f);
+        return AMVP_INVALID_ARG;
+    }
+
+    if (f->writing) {
+        f->type = mode[1] == '+' ? AMVP_FILE_PLAIN : type;
+    } else {
+        f->fp = fopen(filename, fmode);
+        if (!f->fp) {
+            free(f);
+            return AMVP_INVALID_ARG;
+        }
+        f->type = amvp_file_sniff(f->fp);
+    }
+
+    switch (f->type) {
+    case AMVP_FILE_GZIP:
+#ifdef AMVP_USE_ZLIB
+        if (f->fp) {
+            fclose(f->fp);
+            f->fp = NULL;
+        }
+        rv = amvp_file_open_gz(f, filename, mode, level);
+#else
+        rv = AMVP_UNSUPPORTED_OP;
+#endif
+        break;
+    case AMVP_FILE_ZSTD:
+#ifdef AMVP_USE_ZSTD
+        if (!f->fp) {
+            f->fp = fopen(filename, fmode);
+        }
+        rv = f->fp ? amvp_file_open_zstd(f, level) : AMVP_INVALID_ARG;
+#else
+        rv = AMVP_UNSUPPORTED_OP;
+#endif
+        break;
+    case AMVP_FILE_PLAIN:
+    default:
+        if (!f->fp) {
+            f->fp = fopen(filename, fmode);
+        }
+        rv = f->fp ? AMVP_SUCCESS : AMVP_INVALID_ARG;
+        break;
+    }
+    if (rv != AMVP_SUCCESS) {
+        amvp_file_close(f);
+        return rv;
+    }
+    if (f->writing && f->fp) {
+        setvbuf(f->fp, NULL, _IOFBF, AMVP_FILE_WRITE_BUF_SIZE);
+    }
+
+    *file = f;
+    return AMVP_SUCCESS;
+}
+
+AMVP_FILE_TYPE amvp_file_get_type(AMVP_FILE *file) {
+    return file ? file->type : AMVP_FILE_PLAIN;
+}
+
+/*
+ * Read up to len bytes. Returns the number of bytes read, 0 at the end of
+ * the file or on error.
+ */
+size_t amvp_file_read(AMVP_FILE *file, void *buf, size_t len) {
+    size_t got = 0;
+#ifdef AMVP_USE_ZLIB
+    int ret = 0;
+#endif
+
+    if (!file || !buf || file->writing || file->err) {
+        return 0;
+    }
+    switch (file->type) {
+    case AMVP_FILE_GZIP:
+#ifdef AMVP_USE_ZLIB
+        ret = gzread(file->gz, buf, (unsigned int)len);
+        if (ret < 0) {
+            file->err = 1;
+        } else {
+            got = (size_t)ret;
+        }
+#endif
+        break;
+    case AMVP_FILE_ZSTD:
+#ifdef AMVP_USE_ZSTD
+        got = amvp_file_zstd_read(file, buf, len);
+#endif
+        break;
+    case AMVP_FILE_PLAIN:
+    default:
+        got = fread(buf, 1, len, file->fp);
+        if (!got && ferror(file->fp)) {
+            file->err = 1;
+        }
+        break;
+    }
+    return got;
+}
+
+/*
+ * Write len bytes. Returns 0 on success.
+ */
+int amvp_file_write(AMVP_FILE *file, const void *buf, size_t len) {
+    if (!file || !buf || !file->writing) {
+        return -1;
+    }
+    if (!len) {
+        return 0;
+    }
+    switch (file->type) {
+    case AMVP_FILE_GZIP:
+#ifdef AMVP_USE_ZLIB
+        return gzwrite(file->gz, buf, (unsigned int)len) == (int)len ? 0 : -1;
+#else
+        return -1;
+#endif
+    case AMVP_FILE_ZSTD:
+#ifdef AMVP_USE_ZSTD
+        return amvp_file_zstd_write(file, buf, len, ZSTD_e_continue);
+#else
+        return -1;
+#endif
+    case AMVP_FILE_PLAIN:
+    default:
+        return fwrite(buf, 1, len, file->fp) == len ? 0 : -1;
+    }
+}
+
+int amvp_file_puts(AMVP_FILE *file, const char *str) {
+    if (!str) {
+        return -1;
+    }
+    return amvp_file_write(file, str, strnlen_s(str, RSIZE_MAX_STR));
+}
+
+/*
+ * Push everything written so far to disk. Returns 0 on success.
+ */
+int amvp_file_sync(AMVP_FILE *file) {
+    if (!file || !file->writing) {
+        return -1;
+    }
+    switch (file->type) {
+    case AMVP_FILE_GZIP:
+#ifdef AMVP_USE_ZLIB
+        if (gzflush(file->gz, Z_SYNC_FLUSH) != Z_OK) {
+            return -1;
+        }
+#ifdef _WIN32
+        return _commit(file->fd);
+#else
+        return fsync(file->fd);
+#endif
+#else
+        return -1;
+#endif
+    case AMVP_FILE_ZSTD:
+#ifdef AMVP_USE_ZSTD
+        if (amvp_file_zstd_write(file, NULL, 0, ZSTD_e_flush)) {
+            return -1;
+        }
+        break;
+#else
+        return -1;
+#endif
+    case AMVP_FILE_PLAIN:
+    default:
+        break;
+    }
+    if (fflush(file->fp) == EOF) {
+        return -1;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file->fp));
+#else
+    return fsync(fileno(file->fp));
+#endif
+}
+
+/*
+ * Cut a plain file opened with "r+" at offset and position it there
+ */
+AMVP_RESULT amvp_file_truncate(AMVP_FILE *file, unsigned long long offset) {
+    if (!file || !file->fp || file->type != AMVP_FILE_PLAIN) {
+        return AMVP_INVALID_ARG;
+    }
+    if (fflush(file->fp) == EOF) {
+        return AMVP_JSON_ERR;
+    }
+#ifdef _WIN32
+    if (_chsize_s(_fileno(file->fp), (__int64)offset)) {
+#else
+    if (ftruncate(fileno(file->fp), (off_t)offset)) {
+#endif
+        return AMVP_JSON_ERR;
+    }
+    if (fseek(file->fp, 0, SEEK_END)) {
+        return AMVP_JSON_ERR;
+    }
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Finish any compressed stream and close the file. Returns 0 on success.
+ */
+int amvp_file_close(AMVP_FILE *file) {
+    int ret = 0;
+
+    if (!file) {
+        return 0;
+    }
+#ifdef AMVP_USE_ZLIB
+    if (file->gz) {
+        if (gzclose(file->gz) != Z_OK) {
+            ret = -1;
+        }
+    }
+#endif
+#ifdef AMVP_USE_ZSTD
+    if (file->cs) {
+        if (file->fp && amvp_file_zstd_write(file, NULL, 0, ZSTD_e_end)) {
+            ret = -1;
+        }
+        ZSTD_freeCStream(file->cs);
+    }
+    if (file->ds) ZSTD_freeDStream(file->ds);
+    if (file->zbuf) free(file->zbuf);
+#endif
+    if (file->fp) {
+        if (fclose(file->fp) == EOF) {
+            ret = -1;
+        }
+    }
+    if (file->err) {
+        ret = -1;
+    }
+    free(file);
+    return ret;
+}
+
+/*
+ * Same as json_parse_file() but reads compressed files too
+ */
+JSON_Value *amvp_json_parse_file(const char *filename) {
+    AMVP_FILE *file = NULL;
+    JSON_Value *val = NULL;
+    char *buf = NULL, *tmp = NULL;
+    size_t len = 0, max = 0, got = 0;
+
+    if (amvp_file_open(&file, filename, "r", AMVP_FILE_PLAIN, 0) != AMVP_SUCCESS) {
+        return NULL;
+    }
+    do {
+        /* Doubling keeps the copying linear in the size of the file */
+        if (max - len < AMVP_FILE_READ_CHUNK + 1) {
+            max = max ? max * 2 : AMVP_FILE_READ_CHUNK * 2;
+            tmp = realloc(buf, max);
+            if (!tmp) {
+                goto end;
+            }
+            buf = tmp;
+        }
+        got = amvp_file_read(file, buf + len, AMVP_FILE_READ_CHUNK);
+        len += got;
+    } while (got);
+    if (file->err) {
+        goto end;
+    }
+    buf[len] = '\0';
+    val = json_parse_string(buf);
+
+end:
+    amvp_file_close(file);
+    if (buf) free(buf);
+    return val;
+}
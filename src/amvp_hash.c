@@ -127,7 +127,7 @@ static AMVP_RESULT amvp_hash_mct_tc(AMVP_CTX *ctx,
 
         for (j = 0; j < AMVP_HASH_MCT_INNER; ++j) {
             /* Process the current SHA test vector... */
-            rv = (cap->crypto_handler)(tc);
+            rv = amvp_crypto_handler(ctx, cap, tc);
             if (rv != AMVP_SUCCESS) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 free(tmp);
@@ -224,7 +224,7 @@ static AMVP_RESULT amvp_hash_sha3_mct(AMVP_CTX *ctx,
             memzero_s(stc->md, AMVP_HASH_MD_BYTE_MAX);
 
             /* Process the current SHA test vector... */
-            rv = (cap->crypto_handler)(tc);
+            rv = amvp_crypto_handler(ctx, cap, tc);
             if (rv != AMVP_SUCCESS) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -327,7 +327,7 @@ static AMVP_RESULT amvp_hash_shake_mct(AMVP_CTX *ctx,
             memzero_s(stc->md, AMVP_HASH_XOF_MD_BYTE_MAX);
 
             /* Process the current SHA test vector... */
-            rv = (cap->crypto_handler)(tc);
+            rv = amvp_crypto_handler(ctx, cap, tc);
             if (rv != AMVP_SUCCESS) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -364,6 +364,101 @@ end:
     return rv;
 }
 
+/*
+ * This is the MCT handler used when the crypto module registered a
+ * native MCT callback. The module runs the inner loop for each outer
+ * iteration and libamvp only chains the resulting digest into the
+ * seed of the next outer iteration.
+ */
+static AMVP_RESULT amvp_hash_mct_native_tc(AMVP_CTX *ctx,
+                                           AMVP_CAPS_LIST *cap,
+                                           AMVP_TEST_CASE *tc,
+                                           AMVP_HASH_TC *stc,
+                                           JSON_Array *res_array,
+                                           unsigned int min_xof_bits,
+                                           unsigned int max_xof_bits) {
+    int i = 0;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    JSON_Value *r_tval = NULL;  /* Response testval */
+    JSON_Object *r_tobj = NULL; /* Response testobj */
+    unsigned int leftmost_bytes = 16;
+    int is_shake = (stc->cipher == AMVP_HASH_SHAKE_128 || stc->cipher == AMVP_HASH_SHAKE_256);
+
+    if (is_shake) {
+        stc->xof_min_bit_len = min_xof_bits;
+        stc->xof_max_bit_len = max_xof_bits;
+        /* Initial Outputlen = (floor(maxoutlen/8) )*8 */
+        stc->xof_bit_len = (max_xof_bits / 8) * 8;
+        stc->xof_len = (stc->xof_bit_len + 7) / 8;
+    }
+
+    for (i = 0; i < AMVP_HASH_MCT_OUTER; i++) {
+        /*
+         * Create a new test case in the response
+         */
+        r_tval = json_value_init_object();
+        r_tobj = json_value_get_object(r_tval);
+
+        memzero_s(stc->md, is_shake ? AMVP_HASH_XOF_MD_BYTE_MAX : AMVP_HASH_MD_BYTE_MAX);
+
+        /* Run the whole inner loop in the crypto module */
+        if (amvp_mct_handler(ctx, cap, tc)) {
+            AMVP_LOG_ERR("crypto module failed the operation");
+            rv = AMVP_CRYPTO_MODULE_FAIL;
+            goto end;
+        }
+
+        rv = amvp_hash_output_mct_tc(ctx, stc, r_tobj);
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("JSON output failure");
+            goto end;
+        }
+
+        /* Append the test response value to array */
+        json_array_append_value(res_array, r_tval);
+        r_tval = NULL;
+
+        /*
+         * The final digest is the seed of the next outer iteration.
+         * SHAKE only uses the leftmost 128 bits of it.
+         */
+        if (is_shake) {
+            memzero_s(stc->msg, AMVP_SHAKE_MSG_BYTE_MAX);
+            memcpy_s(stc->msg, AMVP_SHAKE_MSG_BYTE_MAX, stc->md,
+                     stc->md_len < leftmost_bytes ? stc->md_len : leftmost_bytes);
+            stc->msg_len = leftmost_bytes;
+        } else {
+            memzero_s(stc->msg, AMVP_HASH_MSG_BYTE_MAX);
+            memcpy_s(stc->msg, AMVP_HASH_MSG_BYTE_MAX, stc->md, stc->md_len);
+            stc->msg_len = stc->md_len;
+        }
+    }
+
+end:
+    if (r_tval) json_value_free(r_tval);
+
+    return rv;
+}
+
+/*
+ * Batch adapters so queued hash test cases can be output and released
+ * through the common batch helpers.
+ */
+static AMVP_RESULT amvp_hash_batch_output_tc(AMVP_CTX *ctx,
+                                             AMVP_TEST_CASE *tc,
+                                             JSON_Object *r_tobj,
+                                             int tc_rv) {
+    if (tc_rv) {
+        AMVP_LOG_ERR("crypto module failed the operation");
+        return AMVP_CRYPTO_MODULE_FAIL;
+    }
+    return amvp_hash_output_tc(ctx, tc->tc.hash, r_tobj);
+}
+
+static void amvp_hash_batch_release_tc(AMVP_TEST_CASE *tc) {
+    amvp_hash_release_tc(tc->tc.hash);
+}
+
 static AMVP_HASH_TESTTYPE read_test_type(const char *tt_str) {
     int diff = 0;
 
@@ -406,9 +501,12 @@ AMVP_RESULT amvp_hash_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
-    AMVP_CAPS_LIST *cap;
+    AMVP_CAPS_LIST *cap = NULL;
     AMVP_HASH_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
+    AMVP_TEST_GROUP group = { 0 };
+    AMVP_HASH_TC *batch_stc = NULL;
+    AMVP_TC_BATCH batch;
     JSON_Array *res_tarr = NULL; /* Response resultsArray */
     AMVP_RESULT rv = AMVP_SUCCESS;
     AMVP_CIPHER alg_id = 0;
@@ -431,6 +529,7 @@ AMVP_RESULT amvp_hash_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
      * Get a reference to the abstracted test case
      */
     tc.tc.hash = &stc;
+    tc.group = &group;
 
     /*
      * Get the crypto module handler for this hash algorithm
@@ -464,6 +563,16 @@ AMVP_RESULT amvp_hash_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         return rv;
     }
 
+    amvp_tc_batch_init(&batch, &amvp_hash_batch_output_tc, &amvp_hash_batch_release_tc);
+    if (cap->batch_handler) {
+        batch_stc = calloc(AMVP_BATCH_TC_MAX, sizeof(AMVP_HASH_TC));
+        if (!batch_stc) {
+            AMVP_LOG_ERR("Unable to malloc batch test cases");
+            rv = AMVP_MALLOC_FAIL;
+            goto err;
+        }
+    }
+
     groups = json_object_get_array(obj, "testGroups");
     g_cnt = json_array_get_count(groups);
     for (i = 0; i < g_cnt; i++) {
@@ -481,6 +590,7 @@ AMVP_RESULT amvp_hash_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -530,6 +640,17 @@ AMVP_RESULT amvp_hash_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
         }
 
+        /*
+         * Let the crypto module set up any state shared by the group
+         */
+        group.cipher = alg_id;
+        group.tg_id = tgId;
+        group.test_type = test_type_str;
+        rv = amvp_group_begin(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
@@ -591,6 +712,33 @@ AMVP_RESULT amvp_hash_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
             json_object_set_number(r_tobj, "tcId", tc_id);
 
+            if (cap->batch_handler && test_type != AMVP_HASH_TEST_TYPE_MCT) {
+                /*
+                 * Queue the test case for the crypto module's batch handler,
+                 * the results are output once the batch is flushed.
+                 */
+                AMVP_HASH_TC *bstc = &batch_stc[batch.count];
+
+                rv = amvp_hash_init_tc(ctx, bstc, tc_id, test_type, msglen, msg, xof_len, alg_id);
+                if (rv != AMVP_SUCCESS) {
+                    AMVP_LOG_ERR("Init for stc (test case) failed");
+                    amvp_hash_release_tc(bstc);
+                    json_value_free(r_tval);
+                    goto err;
+                }
+                batch.tc[batch.count].tc.hash = bstc;
+                batch.tc[batch.count].group = &group;
+                batch.r_tval[batch.count++] = r_tval;
+
+                if (batch.count == AMVP_BATCH_TC_MAX) {
+                    rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+                    if (rv != AMVP_SUCCESS) {
+                        goto err;
+                    }
+                }
+                continue;
+            }
+
             /*
              * Setup the test case data that will be passed down to
              * the crypto module.
@@ -608,7 +756,10 @@ AMVP_RESULT amvp_hash_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
                 json_object_set_value(r_tobj, "resultsArray", json_value_init_array());
                 res_tarr = json_object_get_array(r_tobj, "resultsArray");
 
-                if (alg_id == AMVP_HASH_SHA3_224 || alg_id == AMVP_HASH_SHA3_256 ||
+                if (cap->mct_handler) {
+                    rv = amvp_hash_mct_native_tc(ctx, cap, &tc, &stc,
+                                                 res_tarr, min_xof_len, max_xof_len);
+                } else if (alg_id == AMVP_HASH_SHA3_224 || alg_id == AMVP_HASH_SHA3_256 ||
                     alg_id == AMVP_HASH_SHA3_384 || alg_id == AMVP_HASH_SHA3_512) {
                     rv = amvp_hash_sha3_mct(ctx, cap, &tc, &stc, res_tarr);
                 } else if (alg_id == AMVP_HASH_SHAKE_128 || alg_id == AMVP_HASH_SHAKE_256) {
@@ -626,7 +777,7 @@ AMVP_RESULT amvp_hash_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
                 }
             } else {
                 /* Process the current test vector... */
-                if ((cap->crypto_handler)(&tc)) {
+                if (amvp_crypto_handler(ctx, cap, &tc)) {
                     AMVP_LOG_ERR("crypto module failed the operation");
                     amvp_hash_release_tc(&stc);
                     json_value_free(r_tval);
@@ -653,17 +804,30 @@ AMVP_RESULT amvp_hash_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+
+        /* Process any test cases still waiting on the batch handler */
+        rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+        rv = amvp_group_end(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
 
 err:
+    amvp_group_end(ctx, cap, &group);
+    amvp_tc_batch_discard(&batch);
+    if (batch_stc) free(batch_stc);
     if (rv != AMVP_SUCCESS) {
         amvp_release_json(r_vs_val, r_gval);
     }
@@ -719,44 +883,44 @@ static AMVP_RESULT amvp_hash_init_tc(AMVP_CTX *ctx,
 
     memzero_s(stc, sizeof(AMVP_HASH_TC));
     if (alg_id != AMVP_HASH_SHAKE_128 && alg_id != AMVP_HASH_SHAKE_256) {
-        stc->msg = calloc(1, AMVP_HASH_MSG_BYTE_MAX);
+        stc->msg = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HASH_MSG_BYTE_MAX);
     } else {
-        stc->msg = calloc(1, AMVP_SHAKE_MSG_BYTE_MAX);
+        stc->msg = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_SHAKE_MSG_BYTE_MAX);
     }
     if (!stc->msg) { return AMVP_MALLOC_FAIL; }
 
     if (test_type == AMVP_HASH_TEST_TYPE_AFT) {
         /* AFT */
-        stc->md = calloc(1, AMVP_HASH_MD_BYTE_MAX);
+        stc->md = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HASH_MD_BYTE_MAX);
         if (!stc->md) { return AMVP_MALLOC_FAIL; }
     } else if (test_type == AMVP_HASH_TEST_TYPE_VOT) {
         /* VOT */
-        stc->md = calloc(1, AMVP_HASH_XOF_MD_BYTE_MAX);
+        stc->md = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HASH_XOF_MD_BYTE_MAX);
         if (!stc->md) { return AMVP_MALLOC_FAIL; }
     } else {
         /* MCT */
         if (alg_id == AMVP_HASH_SHA3_224 || alg_id == AMVP_HASH_SHA3_256 ||
             alg_id == AMVP_HASH_SHA3_384 || alg_id == AMVP_HASH_SHA3_512) {
             /* SHA3 only needs the md buffer */
-            stc->md = calloc(1, AMVP_HASH_MD_BYTE_MAX);
+            stc->md = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HASH_MD_BYTE_MAX);
             if (!stc->md) { return AMVP_MALLOC_FAIL; }
         } else if (alg_id == AMVP_HASH_SHAKE_128 ||
                    alg_id == AMVP_HASH_SHAKE_256) {
             /* SHAKE needs the md to support XOF length */
-            stc->md = calloc(1, AMVP_HASH_XOF_MD_BYTE_MAX);
+            stc->md = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HASH_XOF_MD_BYTE_MAX);
             if (!stc->md) { return AMVP_MALLOC_FAIL; }
         } else {
             /* SHA/SHA2 */
-            stc->md = calloc(1, AMVP_HASH_MD_BYTE_MAX);
+            stc->md = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HASH_MD_BYTE_MAX);
             if (!stc->md) { return AMVP_MALLOC_FAIL; }
 
-            stc->m1 = calloc(1, AMVP_HASH_MD_BYTE_MAX);
+            stc->m1 = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HASH_MD_BYTE_MAX);
             if (!stc->m1) { return AMVP_MALLOC_FAIL; }
 
-            stc->m2 = calloc(1, AMVP_HASH_MD_BYTE_MAX);
+            stc->m2 = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HASH_MD_BYTE_MAX);
             if (!stc->m2) { return AMVP_MALLOC_FAIL; }
 
-            stc->m3 = calloc(1, AMVP_HASH_MD_BYTE_MAX);
+            stc->m3 = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HASH_MD_BYTE_MAX);
             if (!stc->m3) { return AMVP_MALLOC_FAIL; }
         }
     }
@@ -785,11 +949,11 @@ static AMVP_RESULT amvp_hash_init_tc(AMVP_CTX *ctx,
  * a test case.
  */
 static AMVP_RESULT amvp_hash_release_tc(AMVP_HASH_TC *stc) {
-    if (stc->msg) free(stc->msg);
-    if (stc->md) free(stc->md);
-    if (stc->m1) free(stc->m1);
-    if (stc->m2) free(stc->m2);
-    if (stc->m3) free(stc->m3);
+    if (stc->msg) amvp_mem_free(AMVP_MEM_TC, stc->msg);
+    if (stc->md) amvp_mem_free(AMVP_MEM_TC, stc->md);
+    if (stc->m1) amvp_mem_free(AMVP_MEM_TC, stc->m1);
+    if (stc->m2) amvp_mem_free(AMVP_MEM_TC, stc->m2);
+    if (stc->m3) amvp_mem_free(AMVP_MEM_TC, stc->m3);
     memzero_s(stc, sizeof(AMVP_HASH_TC));
 
     return AMVP_SUCCESS;
@@ -30,11 +30,11 @@ static AMVP_RESULT amvp_hmac_init_tc(AMVP_CTX *ctx,
 
     memzero_s(stc, sizeof(AMVP_HMAC_TC));
 
-    stc->msg = calloc(1, AMVP_HMAC_MSG_MAX);
+    stc->msg = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HMAC_MSG_MAX);
     if (!stc->msg) { return AMVP_MALLOC_FAIL; }
-    stc->mac = calloc(1, AMVP_HMAC_MAC_BYTE_MAX);
+    stc->mac = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HMAC_MAC_BYTE_MAX);
     if (!stc->mac) { return AMVP_MALLOC_FAIL; }
-    stc->key = calloc(1, AMVP_HMAC_KEY_BYTE_MAX);
+    stc->key = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_HMAC_KEY_BYTE_MAX);
     if (!stc->key) { return AMVP_MALLOC_FAIL; }
 
     rv = amvp_hexstr_to_bin(msg, stc->msg, AMVP_HMAC_MSG_MAX, NULL);
@@ -92,14 +92,33 @@ end:
  * a test case.
  */
 static AMVP_RESULT amvp_hmac_release_tc(AMVP_HMAC_TC *stc) {
-    free(stc->msg);
-    free(stc->mac);
-    free(stc->key);
+    amvp_mem_free(AMVP_MEM_TC, stc->msg);
+    amvp_mem_free(AMVP_MEM_TC, stc->mac);
+    amvp_mem_free(AMVP_MEM_TC, stc->key);
     memzero_s(stc, sizeof(AMVP_HMAC_TC));
 
     return AMVP_SUCCESS;
 }
 
+/*
+ * Batch adapters so queued HMAC test cases can be output and released
+ * through the common batch helpers.
+ */
+static AMVP_RESULT amvp_hmac_batch_output_tc(AMVP_CTX *ctx,
+                                             AMVP_TEST_CASE *tc,
+                                             JSON_Object *r_tobj,
+                                             int tc_rv) {
+    if (tc_rv) {
+        AMVP_LOG_ERR("ERROR: crypto module failed the operation");
+        return AMVP_CRYPTO_MODULE_FAIL;
+    }
+    return amvp_hmac_output_tc(ctx, tc->tc.hmac, r_tobj);
+}
+
+static void amvp_hmac_batch_release_tc(AMVP_TEST_CASE *tc) {
+    amvp_hmac_release_tc(tc->tc.hmac);
+}
+
 AMVP_RESULT amvp_hmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     unsigned int tc_id = 0, msglen = 0, keylen = 0, maclen = 0;
     const char *msg = NULL, *key = NULL;
@@ -122,9 +141,12 @@ AMVP_RESULT amvp_hmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
-    AMVP_CAPS_LIST *cap;
+    AMVP_CAPS_LIST *cap = NULL;
     AMVP_HMAC_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
+    AMVP_TEST_GROUP group = { 0 };
+    AMVP_HMAC_TC *batch_stc = NULL;
+    AMVP_TC_BATCH batch;
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     AMVP_CIPHER alg_id;
@@ -149,6 +171,7 @@ AMVP_RESULT amvp_hmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
      * Get a reference to the abstracted test case
      */
     tc.tc.hmac = &stc;
+    tc.group = &group;
 
     /*
      * Get the crypto module handler for this hash algorithm
@@ -182,6 +205,16 @@ AMVP_RESULT amvp_hmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         return rv;
     }
 
+    amvp_tc_batch_init(&batch, &amvp_hmac_batch_output_tc, &amvp_hmac_batch_release_tc);
+    if (cap->batch_handler) {
+        batch_stc = calloc(AMVP_BATCH_TC_MAX, sizeof(AMVP_HMAC_TC));
+        if (!batch_stc) {
+            AMVP_LOG_ERR("Unable to malloc batch test cases");
+            rv = AMVP_MALLOC_FAIL;
+            goto err;
+        }
+    }
+
     groups = json_object_get_array(obj, "testGroups");
     if (!groups) {
         AMVP_LOG_ERR("Failed to include testGroups. ");
@@ -201,6 +234,7 @@ AMVP_RESULT amvp_hmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -234,6 +268,19 @@ AMVP_RESULT amvp_hmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         AMVP_LOG_VERBOSE("    Test group: %d", i);
         AMVP_LOG_VERBOSE("        msglen: %d", msglen);
 
+        /*
+         * Let the crypto module set up any state shared by the group
+         */
+        group.cipher = alg_id;
+        group.tg_id = tgId;
+        group.msg_len = msglen;
+        group.key_len = keylen;
+        group.mac_len = maclen;
+        rv = amvp_group_begin(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+
         tests = json_object_get_array(groupobj, "tests");
         if (!tests) {
             AMVP_LOG_ERR("Failed to include tests. ");
@@ -303,6 +350,33 @@ AMVP_RESULT amvp_hmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
             json_object_set_number(r_tobj, "tcId", tc_id);
 
+            if (cap->batch_handler) {
+                /*
+                 * Queue the test case for the crypto module's batch handler,
+                 * the results are output once the batch is flushed.
+                 */
+                AMVP_HMAC_TC *bstc = &batch_stc[batch.count];
+
+                rv = amvp_hmac_init_tc(ctx, bstc, tc_id, msglen, msg, maclen, keylen, key, alg_id);
+                if (rv != AMVP_SUCCESS) {
+                    AMVP_LOG_ERR("Init for stc (test case) failed");
+                    amvp_hmac_release_tc(bstc);
+                    json_value_free(r_tval);
+                    goto err;
+                }
+                batch.tc[batch.count].tc.hmac = bstc;
+                batch.tc[batch.count].group = &group;
+                batch.r_tval[batch.count++] = r_tval;
+
+                if (batch.count == AMVP_BATCH_TC_MAX) {
+                    rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+                    if (rv != AMVP_SUCCESS) {
+                        goto err;
+                    }
+                }
+                continue;
+            }
+
             /*
              * Setup the test case data that will be passed down to
              * the crypto module.
@@ -315,7 +389,7 @@ AMVP_RESULT amvp_hmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("ERROR: crypto module failed the operation");
                 amvp_hmac_release_tc(&stc);
                 json_value_free(r_tval);
@@ -341,17 +415,30 @@ AMVP_RESULT amvp_hmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+
+        /* Process any test cases still waiting on the batch handler */
+        rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+        rv = amvp_group_end(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
 
 err:
+    amvp_group_end(ctx, cap, &group);
+    amvp_tc_batch_discard(&batch);
+    if (batch_stc) free(batch_stc);
     if (rv != AMVP_SUCCESS) {
         amvp_release_json(r_vs_val, r_gval);
     }
@@ -0,0 +1,570 @@
+/** @file */
+/*
+ * Copyright (c) 2021, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libamvp/LICENSE
+ */
+
+/*
+ * Streaming reader and writer for the top level JSON array of a request or
+ * response file.
+ *
+ * Offline request files hold a header object followed by one object per
+ * vector set, and can be several GB. Rather than parsing the whole file into
+ * one DOM, the reader scans the array with a small read buffer, copies out one
+ * element at a time and hands only that element to parson. Peak memory scales
+ * with the largest vector set instead of with the file.
+ *
+ * The writer is the other half of the offline path. The response file is
+ * opened once with a large buffer, each response is serialized straight into
+ * it, and on finish the data is synced and the temporary file renamed over the
+ * requested name so a partial response file is never left behind.
+ *
+ * While the temporary file is written, a journal next to it records the index,
+ * vsId and end offset of every element once it is on disk. If the process dies
+ * before the run completes, the next run against the same request file
+ * truncates the temporary file to the last recorded offset and continues from
+ * there. A run that fails on its own would fail the same way again, so it
+ * discards both files instead. Compressed response files are not journaled.
+ *
+ * All files go through AMVP_FILE, so either side may be .gz or .zst.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
+#include "amvp.h"
+#include "amvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+#define AMVP_JSON_STREAM_READ_SIZE (64 * 1024)
+#define AMVP_JSON_STREAM_ELEM_INIT (64 * 1024)
+#define AMVP_JSON_WRITER_TMP_SUFFIX ".tmp"
+#define AMVP_JSON_JOURNAL_SUFFIX ".journal"
+#define AMVP_JSON_JOURNAL_MAGIC "amvp-journal 1"
+
+struct amvp_json_stream_t {
+    AMVP_FILE *file;
+    char rbuf[AMVP_JSON_STREAM_READ_SIZE]; /* read buffer */
+    size_t rlen;                           /* bytes in rbuf */
+    size_t rpos;                           /* next unread byte in rbuf */
+    char *elem;                            /* text of the current element */
+    size_t elem_len;
+    size_t elem_max;
+    int started;                           /* opening '[' has been read */
+    int done;                              /* closing ']' has been read */
+};
+
+struct amvp_json_writer_t {
+    AMVP_FILE *fp;
+    FILE *journal;                         /* NULL when the run is not journaled */
+    char *filename;                        /* final name of the file */
+    char *tmp_filename;                    /* name written to until finish */
+    char *journal_filename;
+    char req_id[64];                       /* identifies the request file */
+    char *buf;                             /* serialization buffer, reused */
+    size_t buf_max;
+    unsigned long long offset;             /* bytes written to fp */
+    int count;                             /* elements written so far */
+};
+
+/*
+ * Returns the next byte of the file, or EOF
+ */
+static int amvp_json_stream_getc(AMVP_JSON_STREAM *stream) {
+    if (stream->rpos == stream->rlen) {
+        stream->rlen = amvp_file_read(stream->file, stream->rbuf, sizeof(stream->rbuf));
+        stream->rpos = 0;
+        if (!stream->rlen) {
+            return EOF;
+        }
+    }
+    return (unsigned char)stream->rbuf[stream->rpos++];
+}
+
+static void amvp_json_stream_ungetc(AMVP_JSON_STREAM *stream) {
+    stream->rpos--;
+}
+
+static int amvp_json_stream_skip_ws(AMVP_JSON_STREAM *stream) {
+    int c = 0;
+
+    do {
+        c = amvp_json_stream_getc(stream);
+    } while (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+    return c;
+}
+
+static AMVP_RESULT amvp_json_stream_put(AMVP_JSON_STREAM *stream, int c) {
+    char *tmp = NULL;
+
+    if (stream->elem_len + 1 >= stream->elem_max) {
+        tmp = realloc(stream->elem, stream->elem_max * 2);
+        if (!tmp) {
+            return AMVP_MALLOC_FAIL;
+        }
+        stream->elem = tmp;
+        stream->elem_max *= 2;
+    }
+    stream->elem[stream->elem_len++] = (char)c;
+    return AMVP_SUCCESS;
+}
+
+AMVP_RESULT amvp_json_stream_open(AMVP_JSON_STREAM **stream, const char *filename) {
+    AMVP_JSON_STREAM *s = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    if (!stream || !filename) {
+        return AMVP_MISSING_ARG;
+    }
+
+    s = calloc(1, sizeof(AMVP_JSON_STREAM));
+    if (!s) {
+        return AMVP_MALLOC_FAIL;
+    }
+    s->elem = calloc(AMVP_JSON_STREAM_ELEM_INIT, sizeof(char));
+    if (!s->elem) {
+        free(s);
+        return AMVP_MALLOC_FAIL;
+    }
+    s->elem_max = AMVP_JSON_STREAM_ELEM_INIT;
+
+    rv = amvp_file_open(&s->file, filename, "r", AMVP_FILE_PLAIN, 0);
+    if (rv != AMVP_SUCCESS) {
+        free(s->elem);
+        free(s);
+        return rv;
+    }
+
+    *stream = s;
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Copy the next element of the top level array into stream->elem. *found is
+ * set to 0 once the end of the array has been reached.
+ */
+static AMVP_RESULT amvp_json_stream_scan(AMVP_JSON_STREAM *stream, int *found) {
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int c = 0, depth = 0, in_str = 0, escaped = 0;
+
+    *found = 0;
+    if (stream->done) {
+        return AMVP_SUCCESS;
+    }
+
+    if (!stream->started) {
+        if (amvp_json_stream_skip_ws(stream) != '[') {
+            return AMVP_MALFORMED_JSON;
+        }
+        stream->started = 1;
+    }
+
+    c = amvp_json_stream_skip_ws(stream);
+    if (c == ',') {
+        c = amvp_json_stream_skip_ws(stream);
+    }
+    if (c == ']') {
+        stream->done = 1;
+        return AMVP_SUCCESS;
+    }
+    if (c == EOF) {
+        return AMVP_MALFORMED_JSON;
+    }
+
+    /*
+     * Copy the element out, tracking strings and nesting so that we stop at
+     * the ',' or ']' that ends it at the top level
+     */
+    stream->elem_len = 0;
+    while (c != EOF) {
+        if (in_str) {
+            if (escaped) {
+                escaped = 0;
+            } else if (c == '\\') {
+                escaped = 1;
+            } else if (c == '"') {
+                in_str = 0;
+            }
+        } else if (c == '"') {
+            in_str = 1;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (!depth) {
+                /* End of the top level array, leave it for the next call */
+                amvp_json_stream_ungetc(stream);
+                break;
+            }
+            depth--;
+        } else if (c == ',' && !depth) {
+            amvp_json_stream_ungetc(stream);
+            break;
+        }
+
+        rv = amvp_json_stream_put(stream, c);
+        if (rv != AMVP_SUCCESS) {
+            return rv;
+        }
+        if (!depth && !in_str && (c == '}' || c == ']')) {
+            break;
+        }
+        c = amvp_json_stream_getc(stream);
+    }
+    if (in_str || depth) {
+        return AMVP_MALFORMED_JSON;
+    }
+    stream->elem[stream->elem_len] = '\0';
+    *found = 1;
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Parse the next element of the top level array into *val. *val is set to
+ * NULL once the end of the array has been reached. The caller owns *val.
+ */
+AMVP_RESULT amvp_json_stream_next(AMVP_JSON_STREAM *stream, JSON_Value **val) {
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int found = 0;
+
+    if (!stream || !val) {
+        return AMVP_MISSING_ARG;
+    }
+    *val = NULL;
+
+    rv = amvp_json_stream_scan(stream, &found);
+    if (rv != AMVP_SUCCESS || !found) {
+        return rv;
+    }
+    *val = json_parse_string(stream->elem);
+    if (!*val) {
+        return AMVP_JSON_ERR;
+    }
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Step over the next count elements of the top level array without parsing
+ * them. Used to pass vector sets that a resumed run has already written.
+ */
+AMVP_RESULT amvp_json_stream_skip(AMVP_JSON_STREAM *stream, int count) {
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int found = 0;
+
+    if (!stream) {
+        return AMVP_MISSING_ARG;
+    }
+    while (count-- > 0) {
+        rv = amvp_json_stream_scan(stream, &found);
+        if (rv != AMVP_SUCCESS) {
+            return rv;
+        }
+        if (!found) {
+            return AMVP_MALFORMED_JSON;
+        }
+    }
+    return AMVP_SUCCESS;
+}
+
+void amvp_json_stream_close(AMVP_JSON_STREAM *stream) {
+    if (!stream) {
+        return;
+    }
+    if (stream->file) amvp_file_close(stream->file);
+    if (stream->elem) free(stream->elem);
+    free(stream);
+}
+
+/*
+ * Look for the journal of an interrupted run writing the same response file
+ * from the same request file. On success returns the number of elements
+ * committed to the temporary file and the offset just past the last one.
+ */
+static int amvp_json_writer_read_journal(AMVP_JSON_WRITER *writer, unsigned long long *offset) {
+    FILE *fp = NULL;
+    char line[128];
+    char expect[128];
+    unsigned long long off = 0, last = 0;
+    int idx = 0, vs_id = 0, count = 0;
+
+    fp = fopen(writer->journal_filename, "rb");
+    if (!fp) {
+        return 0;
+    }
+    snprintf(expect, sizeof(expect), AMVP_JSON_JOURNAL_MAGIC " %s\n", writer->req_id);
+    if (!fgets(line, sizeof(line), fp) || strcmp(line, expect)) {
+        fclose(fp);
+        return 0;
+    }
+    /* Every complete line is a committed element, a torn last line is not */
+    while (fgets(line, sizeof(line), fp)) {
+        if (!strchr(line, '\n') || sscanf(line, "%d %d %llu", &idx, &vs_id, &off) != 3 ||
+                idx != count || off < last) {
+            break;
+        }
+        last = off;
+        count++;
+    }
+    fclose(fp);
+
+    *offset = last;
+    return count;
+}
+
+static int amvp_json_writer_sync(FILE *fp) {
+    if (fflush(fp) == EOF) {
+        return -1;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(fp));
+#else
+    return fsync(fileno(fp));
+#endif
+}
+
+/*
+ * Start the journal of a fresh run. A run that cannot be journaled still
+ * writes its response file, it just cannot be resumed.
+ */
+static void amvp_json_writer_start_journal(AMVP_JSON_WRITER *writer) {
+    writer->journal = fopen(writer->journal_filename, "wb");
+    if (!writer->journal) {
+        return;
+    }
+    if (fprintf(writer->journal, AMVP_JSON_JOURNAL_MAGIC " %s\n", writer->req_id) < 0 ||
+            amvp_json_writer_sync(writer->journal)) {
+        fclose(writer->journal);
+        writer->journal = NULL;
+        remove(writer->journal_filename);
+    }
+}
+
+/*
+ * Free the writer. With keep, the temporary file and the journal are left in
+ * place so that a later run can resume from them.
+ */
+static void amvp_json_writer_free(AMVP_JSON_WRITER *writer, int keep) {
+    if (!writer) {
+        return;
+    }
+    if (writer->fp) {
+        amvp_file_close(writer->fp);
+    }
+    if (writer->journal) {
+        fclose(writer->journal);
+    }
+    if (writer->tmp_filename) {
+        if (!keep) remove(writer->tmp_filename);
+        free(writer->tmp_filename);
+    }
+    if (writer->journal_filename) {
+        if (!keep) remove(writer->journal_filename);
+        free(writer->journal_filename);
+    }
+    if (writer->filename) free(writer->filename);
+    if (writer->buf) free(writer->buf);
+    free(writer);
+}
+
+static char *amvp_json_writer_name(const char *filename, size_t len, const char *suffix) {
+    char *name = NULL;
+    size_t max = len + strnlen_s(suffix, AMVP_JSON_FILENAME_MAX) + 1;
+
+    name = calloc(max, sizeof(char));
+    if (!name) {
+        return NULL;
+    }
+    strcpy_s(name, max, filename);
+    strcat_s(name, max, suffix);
+    return name;
+}
+
+AMVP_RESULT amvp_json_writer_open(AMVP_JSON_WRITER **writer,
+                                  const char *filename,
+                                  const char *req_filename,
+                                  int level,
+                                  int *committed) {
+    AMVP_JSON_WRITER *w = NULL;
+    AMVP_FILE_TYPE type = amvp_file_type(filename);
+    struct stat st;
+    unsigned long long offset = 0;
+    size_t len = 0;
+    int count = 0;
+
+    if (!writer || !filename || !committed) {
+        return AMVP_MISSING_ARG;
+    }
+    *committed = 0;
+
+    w = calloc(1, sizeof(AMVP_JSON_WRITER));
+    if (!w) {
+        return AMVP_MALLOC_FAIL;
+    }
+
+    len = strnlen_s(filename, AMVP_JSON_FILENAME_MAX + 1);
+    w->filename = amvp_json_writer_name(filename, len, "");
+    w->tmp_filename = amvp_json_writer_name(filename, len, AMVP_JSON_WRITER_TMP_SUFFIX);
+    w->journal_filename = amvp_json_writer_name(filename, len, AMVP_JSON_JOURNAL_SUFFIX);
+    if (!w->filename || !w->tmp_filename || !w->journal_filename) {
+        amvp_json_writer_abort(w);
+        return AMVP_MALLOC_FAIL;
+    }
+
+    /*
+     * The journal is only trusted for the request file it was written for,
+     * identified by its size and modification time. A compressed response
+     * cannot be cut back to an element boundary, so it is not journaled.
+     */
+    if (req_filename && type == AMVP_FILE_PLAIN && !stat(req_filename, &st)) {
+        snprintf(w->req_id, sizeof(w->req_id), "%llu %llu",
+                 (unsigned long long)st.st_size, (unsigned long long)st.st_mtime);
+        count = amvp_json_writer_read_journal(w, &offset);
+    }
+
+    if (count) {
+        if (amvp_file_open(&w->fp, w->tmp_filename, "r+", AMVP_FILE_PLAIN, 0) == AMVP_SUCCESS &&
+                amvp_file_truncate(w->fp, offset) == AMVP_SUCCESS) {
+            w->journal = fopen(w->journal_filename, "ab");
+            if (!w->journal) {
+                /* Keep what was committed for a run that can journal again */
+                amvp_json_writer_free(w, 1);
+                return AMVP_JSON_ERR;
+            }
+            w->count = count;
+            w->offset = offset;
+        } else {
+            /* Nothing to resume from, start over */
+            amvp_file_close(w->fp);
+            w->fp = NULL;
+            count = 0;
+        }
+    }
+    if (!count) {
+        amvp_file_open(&w->fp, w->tmp_filename, "w", type, level);
+        if (w->fp && w->req_id[0] && type == AMVP_FILE_PLAIN) {
+            amvp_json_writer_start_journal(w);
+        }
+    }
+    if (!w->fp) {
+        amvp_json_writer_abort(w);
+        return AMVP_JSON_ERR;
+    }
+    *committed = count;
+    *writer = w;
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Append one element to the array. The first element opens the array. When
+ * the run is journaled the element is synced to disk and recorded in the
+ * journal before returning, so a resumed run continues after it.
+ */
+AMVP_RESULT amvp_json_writer_append(AMVP_JSON_WRITER *writer, const JSON_Value *value) {
+    size_t len = 0;
+    char *tmp = NULL;
+
+    if (!writer || !writer->fp || !value) {
+        return AMVP_MISSING_ARG;
+    }
+
+    len = json_serialization_size_pretty(value);
+    if (!len) {
+        return AMVP_JSON_ERR;
+    }
+    if (len > writer->buf_max) {
+        tmp = realloc(writer->buf, len);
+        if (!tmp) {
+            return AMVP_MALLOC_FAIL;
+        }
+        writer->buf = tmp;
+        writer->buf_max = len;
+    }
+    if (json_serialize_to_buffer_pretty(value, writer->buf, writer->buf_max) != JSONSuccess) {
+        return AMVP_JSON_ERR;
+    }
+
+    if (amvp_file_puts(writer->fp, writer->count ? ", " : "[ ")) {
+        return AMVP_JSON_ERR;
+    }
+    /* len includes the terminating NUL */
+    if (amvp_file_write(writer->fp, writer->buf, len - 1)) {
+        return AMVP_JSON_ERR;
+    }
+    writer->offset += len + 1;
+
+    if (writer->journal) {
+        if (amvp_file_sync(writer->fp)) {
+            return AMVP_JSON_ERR;
+        }
+        if (fprintf(writer->journal, "%d %d %llu\n", writer->count,
+                    (int)json_object_get_number(json_value_get_object(value), "vsId"),
+                    writer->offset) < 0 || amvp_json_writer_sync(writer->journal)) {
+            /* Keep writing, the run just cannot be resumed past this point */
+            fclose(writer->journal);
+            writer->journal = NULL;
+        }
+    }
+    writer->count++;
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Close the array, sync the file to disk and move it to its final name.
+ * The writer is freed whether or not this succeeds.
+ */
+AMVP_RESULT amvp_json_writer_finish(AMVP_JSON_WRITER *writer) {
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    if (!writer || !writer->fp) {
+        return AMVP_MISSING_ARG;
+    }
+
+    if (amvp_file_puts(writer->fp, writer->count ? " ]" : "[ ]")) {
+        rv = AMVP_JSON_ERR;
+        goto end;
+    }
+    if (amvp_file_sync(writer->fp)) {
+        rv = AMVP_JSON_ERR;
+        goto end;
+    }
+    if (amvp_file_close(writer->fp)) {
+        writer->fp = NULL;
+        rv = AMVP_JSON_ERR;
+        goto end;
+    }
+    writer->fp = NULL;
+
+#ifdef _WIN32
+    if (!MoveFileExA(writer->tmp_filename, writer->filename,
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+#else
+    if (rename(writer->tmp_filename, writer->filename)) {
+#endif
+        rv = AMVP_JSON_ERR;
+        goto end;
+    }
+    /* The response file is complete, there is nothing left to resume */
+    writer->count = 0;
+
+end:
+    amvp_json_writer_abort(writer);
+    return rv;
+}
+
+/*
+ * Free the writer and discard anything written so far
+ */
+void amvp_json_writer_abort(AMVP_JSON_WRITER *writer) {
+    amvp_json_writer_free(writer, 0);
+}
@@ -150,7 +150,7 @@ static AMVP_RESULT amvp_kas_ecc_init_cdh_tc(AMVP_CTX *ctx,
     stc->curve = curve;
     stc->test_type = test_type;
 
-    stc->psx = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->psx = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->psx) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(psx, stc->psx, AMVP_KAS_ECC_BYTE_MAX, &(stc->psxlen));
     if (rv != AMVP_SUCCESS) {
@@ -158,7 +158,7 @@ static AMVP_RESULT amvp_kas_ecc_init_cdh_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->psy = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->psy = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->psy) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(psy, stc->psy, AMVP_KAS_ECC_BYTE_MAX, &(stc->psylen));
     if (rv != AMVP_SUCCESS) {
@@ -166,16 +166,16 @@ static AMVP_RESULT amvp_kas_ecc_init_cdh_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->pix = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->pix = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->pix) { return AMVP_MALLOC_FAIL; }
-    stc->piy = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->piy = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->piy) { return AMVP_MALLOC_FAIL; }
 
-    stc->z = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->z) { return AMVP_MALLOC_FAIL; }
-    stc->d = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->d = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->d) { return AMVP_MALLOC_FAIL; }
-    stc->chash = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->chash = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->chash) { return AMVP_MALLOC_FAIL; }
 
     return AMVP_SUCCESS;
@@ -199,7 +199,7 @@ static AMVP_RESULT amvp_kas_ecc_init_comp_tc(AMVP_CTX *ctx,
     stc->md = hash;
     stc->test_type = test_type;
 
-    stc->psx = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->psx = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->psx) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(psx, stc->psx, AMVP_KAS_ECC_BYTE_MAX, &(stc->psxlen));
     if (rv != AMVP_SUCCESS) {
@@ -207,7 +207,7 @@ static AMVP_RESULT amvp_kas_ecc_init_comp_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->psy = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->psy = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->psy) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(psy, stc->psy, AMVP_KAS_ECC_BYTE_MAX, &(stc->psylen));
     if (rv != AMVP_SUCCESS) {
@@ -215,15 +215,15 @@ static AMVP_RESULT amvp_kas_ecc_init_comp_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->pix = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->pix = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->pix) { return AMVP_MALLOC_FAIL; }
-    stc->piy = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->piy = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->piy) { return AMVP_MALLOC_FAIL; }
-    stc->d = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->d = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->d) { return AMVP_MALLOC_FAIL; }
-    stc->z = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->z) { return AMVP_MALLOC_FAIL; }
-    stc->chash = calloc(1, AMVP_KAS_ECC_BYTE_MAX);
+    stc->chash = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_ECC_BYTE_MAX);
     if (!stc->chash) { return AMVP_MALLOC_FAIL; }
 
     if (stc->test_type == AMVP_KAS_ECC_TT_VAL) {
@@ -264,13 +264,13 @@ static AMVP_RESULT amvp_kas_ecc_init_comp_tc(AMVP_CTX *ctx,
  * a test case.
  */
 static AMVP_RESULT amvp_kas_ecc_release_tc(AMVP_KAS_ECC_TC *stc) {
-    if (stc->chash) free(stc->chash);
-    if (stc->psx) free(stc->psx);
-    if (stc->psy) free(stc->psy);
-    if (stc->pix) free(stc->pix);
-    if (stc->piy) free(stc->piy);
-    if (stc->d) free(stc->d);
-    if (stc->z) free(stc->z);
+    if (stc->chash) amvp_mem_free(AMVP_MEM_TC, stc->chash);
+    if (stc->psx) amvp_mem_free(AMVP_MEM_TC, stc->psx);
+    if (stc->psy) amvp_mem_free(AMVP_MEM_TC, stc->psy);
+    if (stc->pix) amvp_mem_free(AMVP_MEM_TC, stc->pix);
+    if (stc->piy) amvp_mem_free(AMVP_MEM_TC, stc->piy);
+    if (stc->d) amvp_mem_free(AMVP_MEM_TC, stc->d);
+    if (stc->z) amvp_mem_free(AMVP_MEM_TC, stc->z);
 
     memzero_s(stc, sizeof(AMVP_KAS_ECC_TC));
 
@@ -326,6 +326,7 @@ static AMVP_RESULT amvp_kas_ecc_cdh(AMVP_CTX *ctx,
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -428,8 +429,10 @@ static AMVP_RESULT amvp_kas_ecc_cdh(AMVP_CTX *ctx,
                 goto err;
             }
 
+            stc->tc_id = tc_id;
+
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (amvp_crypto_handler(ctx, cap, tc)) {
                 amvp_kas_ecc_release_tc(stc);
                 AMVP_LOG_ERR("crypto module failed the operation");
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -505,6 +508,7 @@ static AMVP_RESULT amvp_kas_ecc_comp(AMVP_CTX *ctx,
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -693,8 +697,10 @@ static AMVP_RESULT amvp_kas_ecc_comp(AMVP_CTX *ctx,
                 goto err;
             }
 
+            stc->tc_id = tc_id;
+
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (amvp_crypto_handler(ctx, cap, tc)) {
                 amvp_kas_ecc_release_tc(stc);
                 AMVP_LOG_ERR("crypto module failed the operation");
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -740,7 +746,7 @@ AMVP_RESULT amvp_kas_ecc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
     JSON_Object *reg_obj = NULL;
     AMVP_CAPS_LIST *cap;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_KAS_ECC_TC stc;
     AMVP_RESULT rv = AMVP_SUCCESS;
     const char *alg_str = NULL;
@@ -852,7 +858,7 @@ AMVP_RESULT amvp_kas_ecc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -982,6 +988,7 @@ static AMVP_RESULT amvp_kas_ecc_ssc(AMVP_CTX *ctx,
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -1206,8 +1213,10 @@ static AMVP_RESULT amvp_kas_ecc_ssc(AMVP_CTX *ctx,
                 goto err;
             }
 
+            stc->tc_id = tc_id;
+
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (amvp_crypto_handler(ctx, cap, tc)) {
                 amvp_kas_ecc_release_tc(stc);
                 AMVP_LOG_ERR("crypto module failed the operation");
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -1253,7 +1262,7 @@ AMVP_RESULT amvp_kas_ecc_ssc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
     JSON_Object *reg_obj = NULL;
     AMVP_CAPS_LIST *cap;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_KAS_ECC_TC stc;
     AMVP_RESULT rv = AMVP_SUCCESS;
     const char *alg_str = NULL;
@@ -1306,7 +1315,7 @@ AMVP_RESULT amvp_kas_ecc_ssc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -175,7 +175,7 @@ static AMVP_RESULT amvp_kas_ffc_init_comp_tc(AMVP_CTX *ctx,
     stc->test_type = test_type;
 
     if ((dgm == AMVP_KAS_FFC_FB) || (dgm == AMVP_KAS_FFC_FC)) {
-        stc->p = calloc(1, AMVP_KAS_FFC_BYTE_MAX);
+        stc->p = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_FFC_BYTE_MAX);
         if (!stc->p) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(p, stc->p, AMVP_KAS_FFC_BYTE_MAX, &(stc->plen));
         if (rv != AMVP_SUCCESS) {
@@ -183,7 +183,7 @@ static AMVP_RESULT amvp_kas_ffc_init_comp_tc(AMVP_CTX *ctx,
             return rv;
         }
 
-        stc->q = calloc(1, AMVP_KAS_FFC_BYTE_MAX);
+        stc->q = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_FFC_BYTE_MAX);
         if (!stc->q) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(q, stc->q, AMVP_KAS_FFC_BYTE_MAX, &(stc->qlen));
         if (rv != AMVP_SUCCESS) {
@@ -191,7 +191,7 @@ static AMVP_RESULT amvp_kas_ffc_init_comp_tc(AMVP_CTX *ctx,
            return rv;
         }
 
-        stc->g = calloc(1, AMVP_KAS_FFC_BYTE_MAX);
+        stc->g = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_FFC_BYTE_MAX);
         if (!stc->g) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(g, stc->g, AMVP_KAS_FFC_BYTE_MAX, &(stc->glen));
         if (rv != AMVP_SUCCESS) {
@@ -199,7 +199,7 @@ static AMVP_RESULT amvp_kas_ffc_init_comp_tc(AMVP_CTX *ctx,
             return rv;
         }
     }
-    stc->eps = calloc(1, AMVP_KAS_FFC_BYTE_MAX);
+    stc->eps = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_FFC_BYTE_MAX);
     if (!stc->eps) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(eps, stc->eps, AMVP_KAS_FFC_BYTE_MAX, &(stc->epslen));
     if (rv != AMVP_SUCCESS) {
@@ -207,16 +207,16 @@ static AMVP_RESULT amvp_kas_ffc_init_comp_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->epri = calloc(1, AMVP_KAS_FFC_BYTE_MAX);
+    stc->epri = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_FFC_BYTE_MAX);
     if (!stc->epri) { return AMVP_MALLOC_FAIL; }
-    stc->epui = calloc(1, AMVP_KAS_FFC_BYTE_MAX);
+    stc->epui = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_FFC_BYTE_MAX);
     if (!stc->epui) { return AMVP_MALLOC_FAIL; }
-    stc->chash = calloc(1, AMVP_KAS_FFC_BYTE_MAX);
+    stc->chash = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_FFC_BYTE_MAX);
     if (!stc->chash) { return AMVP_MALLOC_FAIL; }
-    stc->piut = calloc(1, AMVP_KAS_FFC_BYTE_MAX);
+    stc->piut = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_FFC_BYTE_MAX);
     if (!stc->piut) { return AMVP_MALLOC_FAIL; }
 
-    stc->z = calloc(1, AMVP_KAS_FFC_BYTE_MAX);
+    stc->z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_FFC_BYTE_MAX);
     if (!stc->z) { return AMVP_MALLOC_FAIL; }
 
     if (stc->test_type == AMVP_KAS_FFC_TT_VAL) {
@@ -246,15 +246,15 @@ static AMVP_RESULT amvp_kas_ffc_init_comp_tc(AMVP_CTX *ctx,
  * a test case.
  */
 static AMVP_RESULT amvp_kas_ffc_release_tc(AMVP_KAS_FFC_TC *stc) {
-    if (stc->piut) free(stc->piut);
-    if (stc->epri) free(stc->epri);
-    if (stc->epui) free(stc->epui);
-    if (stc->eps) free(stc->eps);
-    if (stc->z) free(stc->z);
-    if (stc->chash) free(stc->chash);
-    if (stc->p) free(stc->p);
-    if (stc->q) free(stc->q);
-    if (stc->g) free(stc->g);
+    if (stc->piut) amvp_mem_free(AMVP_MEM_TC, stc->piut);
+    if (stc->epri) amvp_mem_free(AMVP_MEM_TC, stc->epri);
+    if (stc->epui) amvp_mem_free(AMVP_MEM_TC, stc->epui);
+    if (stc->eps) amvp_mem_free(AMVP_MEM_TC, stc->eps);
+    if (stc->z) amvp_mem_free(AMVP_MEM_TC, stc->z);
+    if (stc->chash) amvp_mem_free(AMVP_MEM_TC, stc->chash);
+    if (stc->p) amvp_mem_free(AMVP_MEM_TC, stc->p);
+    if (stc->q) amvp_mem_free(AMVP_MEM_TC, stc->q);
+    if (stc->g) amvp_mem_free(AMVP_MEM_TC, stc->g);
     memzero_s(stc, sizeof(AMVP_KAS_FFC_TC));
     return AMVP_SUCCESS;
 }
@@ -310,6 +310,7 @@ static AMVP_RESULT amvp_kas_ffc_comp(AMVP_CTX *ctx,
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -503,8 +504,10 @@ static AMVP_RESULT amvp_kas_ffc_comp(AMVP_CTX *ctx,
                 goto err;
             }
 
+            stc->tc_id = tc_id;
+
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (amvp_crypto_handler(ctx, cap, tc)) {
                 amvp_kas_ffc_release_tc(stc);
                 AMVP_LOG_ERR("crypto module failed the operation");
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -550,7 +553,7 @@ AMVP_RESULT amvp_kas_ffc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
     JSON_Object *reg_obj = NULL;
     AMVP_CAPS_LIST *cap;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_KAS_FFC_TC stc;
     AMVP_RESULT rv = AMVP_SUCCESS;
     const char *alg_str = NULL;
@@ -648,7 +651,7 @@ AMVP_RESULT amvp_kas_ffc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -700,6 +703,7 @@ static AMVP_RESULT amvp_kas_ffc_ssc(AMVP_CTX *ctx,
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -925,8 +929,10 @@ static AMVP_RESULT amvp_kas_ffc_ssc(AMVP_CTX *ctx,
                 goto err;
             }
 
+            stc->tc_id = tc_id;
+
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (amvp_crypto_handler(ctx, cap, tc)) {
                 amvp_kas_ffc_release_tc(stc);
                 AMVP_LOG_ERR("crypto module failed the operation");
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -972,7 +978,7 @@ AMVP_RESULT amvp_kas_ffc_ssc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
     JSON_Object *reg_obj = NULL;
     AMVP_CAPS_LIST *cap;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_KAS_FFC_TC stc;
     AMVP_RESULT rv = AMVP_SUCCESS;
     const char *alg_str = NULL;
@@ -1024,7 +1030,7 @@ AMVP_RESULT amvp_kas_ffc_ssc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -218,7 +218,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     stc->modulo = modulo;
 
     if (p) {
-        stc->p = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+        stc->p = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
         if (!stc->p) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(p, stc->p, AMVP_KAS_IFC_BYTE_MAX, &(stc->plen));
         if (rv != AMVP_SUCCESS) {
@@ -228,7 +228,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     }
 
     if (q) {
-        stc->q = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+        stc->q = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
         if (!stc->q) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(q, stc->q, AMVP_KAS_IFC_BYTE_MAX, &(stc->qlen));
         if (rv != AMVP_SUCCESS) {
@@ -238,7 +238,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     }
 
     if (d) {
-        stc->d = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+        stc->d = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
         if (!stc->d) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(d, stc->d, AMVP_KAS_IFC_BYTE_MAX, &(stc->dlen));
         if (rv != AMVP_SUCCESS) {
@@ -248,7 +248,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     }
 
     if (n) {
-        stc->n = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+        stc->n = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
         if (!stc->n) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(n, stc->n, AMVP_KAS_IFC_BYTE_MAX, &(stc->nlen));
         if (rv != AMVP_SUCCESS) {
@@ -258,7 +258,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     }
 
     if (e) {
-        stc->e = calloc(1, AMVP_RSA_EXP_LEN_MAX);
+        stc->e = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_RSA_EXP_LEN_MAX);
         if (!stc->e) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(e, stc->e, AMVP_RSA_EXP_LEN_MAX, &(stc->elen));
         if (rv != AMVP_SUCCESS) {
@@ -268,7 +268,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     }
 
     if (dmp1) {
-        stc->dmp1 = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+        stc->dmp1 = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
         if (!stc->dmp1) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(dmp1, stc->dmp1, AMVP_KAS_IFC_BYTE_MAX, &(stc->dmp1_len));
         if (rv != AMVP_SUCCESS) {
@@ -278,7 +278,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     }
 
     if (dmq1) {
-        stc->dmq1 = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+        stc->dmq1 = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
         if (!stc->dmq1) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(dmq1, stc->dmq1, AMVP_KAS_IFC_BYTE_MAX, &(stc->dmq1_len));
         if (rv != AMVP_SUCCESS) {
@@ -288,7 +288,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     }
 
     if (iqmp) {
-        stc->iqmp = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+        stc->iqmp = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
         if (!stc->iqmp) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(iqmp, stc->iqmp, AMVP_KAS_IFC_BYTE_MAX, &(stc->iqmp_len));
         if (rv != AMVP_SUCCESS) {
@@ -298,7 +298,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     }
 
     if (server_ct_z) {
-        stc->server_ct_z = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+        stc->server_ct_z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
         if (!stc->server_ct_z) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(server_ct_z, stc->server_ct_z, AMVP_KAS_IFC_BYTE_MAX, &(stc->server_ct_z_len));
         if (rv != AMVP_SUCCESS) {
@@ -308,7 +308,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     }
 
     if (kas2_z) {
-        stc->provided_kas2_z = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+        stc->provided_kas2_z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
         if (!stc->provided_kas2_z) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(kas2_z, stc->provided_kas2_z, AMVP_KAS_IFC_BYTE_MAX, &(stc->provided_kas2_z_len));
         if (rv != AMVP_SUCCESS) {
@@ -318,7 +318,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     }
 
     if (server_n) {
-        stc->server_n = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+        stc->server_n = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
         if (!stc->server_n) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(server_n, stc->server_n, AMVP_KAS_IFC_BYTE_MAX, &(stc->server_nlen));
         if (rv != AMVP_SUCCESS) {
@@ -328,7 +328,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
     }
 
     if (server_e) {
-        stc->server_e = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+        stc->server_e = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
         if (!stc->server_e) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(server_e, stc->server_e, AMVP_RSA_EXP_LEN_MAX, &(stc->server_elen));
         if (rv != AMVP_SUCCESS) {
@@ -337,7 +337,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->iut_ct_z = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+    stc->iut_ct_z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
     if (!stc->iut_ct_z) { return AMVP_MALLOC_FAIL; }
     if (ct_z) {
         rv = amvp_hexstr_to_bin(ct_z, stc->iut_ct_z, AMVP_KAS_IFC_BYTE_MAX, &(stc->iut_ct_z_len));
@@ -346,7 +346,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
             return rv;
         }
     }
-    stc->iut_pt_z = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+    stc->iut_pt_z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
     if (!stc->iut_pt_z) { return AMVP_MALLOC_FAIL; }
     if (pt_z) {
         rv = amvp_hexstr_to_bin(pt_z, stc->iut_pt_z, AMVP_KAS_IFC_BYTE_MAX, &(stc->iut_pt_z_len));
@@ -355,12 +355,12 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
             return rv;
         }
     }
-    stc->server_pt_z = calloc(1, AMVP_KAS_IFC_BYTE_MAX + 1);
+    stc->server_pt_z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX + 1);
     if (!stc->server_pt_z) { return AMVP_MALLOC_FAIL; }
 
     if (stc->test_type == AMVP_KAS_IFC_TT_VAL) {
         if (stc->kas_role == AMVP_KAS_IFC_INITIATOR) {
-            stc->provided_ct_z = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+            stc->provided_ct_z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
             if (!stc->provided_ct_z) { return AMVP_MALLOC_FAIL; }
             rv = amvp_hexstr_to_bin(ct_z, stc->provided_ct_z, AMVP_KAS_IFC_BYTE_MAX, &(stc->provided_ct_z_len));
             if (rv != AMVP_SUCCESS) {
@@ -368,7 +368,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
                 return rv;
             }
         } else {
-            stc->provided_pt_z = calloc(1, AMVP_KAS_IFC_BYTE_MAX);
+            stc->provided_pt_z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KAS_IFC_BYTE_MAX);
             if (!stc->provided_pt_z) { return AMVP_MALLOC_FAIL; }
             rv = amvp_hexstr_to_bin(pt_z, stc->provided_pt_z, AMVP_KAS_IFC_BYTE_MAX, &(stc->provided_pt_z_len));
             if (rv != AMVP_SUCCESS) {
@@ -386,23 +386,23 @@ static AMVP_RESULT amvp_kas_ifc_ssc_init_tc(AMVP_CTX *ctx,
  * a test case.
  */
 static AMVP_RESULT amvp_kas_ifc_release_tc(AMVP_KAS_IFC_TC *stc) {
-    if (stc->server_n) free(stc->server_n);
-    if (stc->server_e) free(stc->server_e);
-    if (stc->p) free(stc->p);
-    if (stc->q) free(stc->q);
-    if (stc->d) free(stc->d);
-    if (stc->e) free(stc->e);
-    if (stc->n) free(stc->n);
-    if (stc->dmp1) free(stc->dmp1);
-    if (stc->dmq1) free(stc->dmq1);
-    if (stc->iqmp) free(stc->iqmp);
-    if (stc->iut_ct_z) free(stc->iut_ct_z);
-    if (stc->iut_pt_z) free(stc->iut_pt_z);
-    if (stc->provided_ct_z) free(stc->provided_ct_z);
-    if (stc->provided_pt_z) free(stc->provided_pt_z);
-    if (stc->server_pt_z) free(stc->server_pt_z);
-    if (stc->server_ct_z) free(stc->server_ct_z);
-    if (stc->provided_kas2_z) free(stc->provided_kas2_z);
+    if (stc->server_n) amvp_mem_free(AMVP_MEM_TC, stc->server_n);
+    if (stc->server_e) amvp_mem_free(AMVP_MEM_TC, stc->server_e);
+    if (stc->p) amvp_mem_free(AMVP_MEM_TC, stc->p);
+    if (stc->q) amvp_mem_free(AMVP_MEM_TC, stc->q);
+    if (stc->d) amvp_mem_free(AMVP_MEM_TC, stc->d);
+    if (stc->e) amvp_mem_free(AMVP_MEM_TC, stc->e);
+    if (stc->n) amvp_mem_free(AMVP_MEM_TC, stc->n);
+    if (stc->dmp1) amvp_mem_free(AMVP_MEM_TC, stc->dmp1);
+    if (stc->dmq1) amvp_mem_free(AMVP_MEM_TC, stc->dmq1);
+    if (stc->iqmp) amvp_mem_free(AMVP_MEM_TC, stc->iqmp);
+    if (stc->iut_ct_z) amvp_mem_free(AMVP_MEM_TC, stc->iut_ct_z);
+    if (stc->iut_pt_z) amvp_mem_free(AMVP_MEM_TC, stc->iut_pt_z);
+    if (stc->provided_ct_z) amvp_mem_free(AMVP_MEM_TC, stc->provided_ct_z);
+    if (stc->provided_pt_z) amvp_mem_free(AMVP_MEM_TC, stc->provided_pt_z);
+    if (stc->server_pt_z) amvp_mem_free(AMVP_MEM_TC, stc->server_pt_z);
+    if (stc->server_ct_z) amvp_mem_free(AMVP_MEM_TC, stc->server_ct_z);
+    if (stc->provided_kas2_z) amvp_mem_free(AMVP_MEM_TC, stc->provided_kas2_z);
     memzero_s(stc, sizeof(AMVP_KAS_IFC_TC));
     return AMVP_SUCCESS;
 }
@@ -484,6 +484,7 @@ static AMVP_RESULT amvp_kas_ifc_ssc(AMVP_CTX *ctx,
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -881,8 +882,10 @@ static AMVP_RESULT amvp_kas_ifc_ssc(AMVP_CTX *ctx,
                 goto err;
             }
 
+            stc->tc_id = tc_id;
+
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (amvp_crypto_handler(ctx, cap, tc)) {
                 amvp_kas_ifc_release_tc(stc);
                 AMVP_LOG_ERR("crypto module failed the operation");
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -932,7 +935,7 @@ AMVP_RESULT amvp_kas_ifc_ssc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
     JSON_Object *reg_obj = NULL;
     AMVP_CAPS_LIST *cap;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_KAS_IFC_TC stc;
     AMVP_RESULT rv = AMVP_SUCCESS;
     const char *alg_str = NULL;
@@ -984,7 +987,7 @@ AMVP_RESULT amvp_kas_ifc_ssc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -139,7 +139,7 @@ static AMVP_RESULT amvp_kda_onestep_init_tc(AMVP_CTX *ctx,
         return rv;
     } 
     if (salt) {
-        stc->salt = calloc(1, AMVP_KDA_SALT_BYTE_MAX);
+        stc->salt = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_SALT_BYTE_MAX);
         if (!stc->salt) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(salt, stc->salt, AMVP_KDA_SALT_BYTE_MAX, &(stc->saltLen));
         if (rv != AMVP_SUCCESS || (saltLen != 0 && stc->saltLen != saltLen / 8)) {
@@ -148,7 +148,7 @@ static AMVP_RESULT amvp_kda_onestep_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->z = calloc(1, AMVP_KDA_Z_BYTE_MAX);
+    stc->z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_Z_BYTE_MAX);
     if (!stc->z) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(z, stc->z, AMVP_KDA_Z_BYTE_MAX, &(stc->zLen));
     if (rv != AMVP_SUCCESS) {
@@ -157,7 +157,7 @@ static AMVP_RESULT amvp_kda_onestep_init_tc(AMVP_CTX *ctx,
     }
 
     if (t) {
-        stc->t = calloc(1, AMVP_KDA_Z_BYTE_MAX);
+        stc->t = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_Z_BYTE_MAX);
         if (!stc->t) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(t, stc->t, AMVP_KDA_Z_BYTE_MAX, &(stc->tLen));
         if (rv != AMVP_SUCCESS) {
@@ -166,7 +166,7 @@ static AMVP_RESULT amvp_kda_onestep_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->uPartyId = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+    stc->uPartyId = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
     if (!stc->uPartyId) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(uparty, stc->uPartyId, AMVP_KDA_FIXED_BYTE_MAX, &(stc->uPartyIdLen));
     if (rv != AMVP_SUCCESS) {
@@ -174,7 +174,7 @@ static AMVP_RESULT amvp_kda_onestep_init_tc(AMVP_CTX *ctx,
         return rv;
     }
     if (uephemeral) {
-        stc->uEphemeralData = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->uEphemeralData = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->uEphemeralData) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(uephemeral, stc->uEphemeralData, AMVP_KDA_FIXED_BYTE_MAX, &(stc->uEphemeralLen));
         if (rv != AMVP_SUCCESS) {
@@ -183,7 +183,7 @@ static AMVP_RESULT amvp_kda_onestep_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->vPartyId = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+    stc->vPartyId = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
     if (!stc->vPartyId) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(vparty, stc->vPartyId, AMVP_KDA_FIXED_BYTE_MAX, &(stc->vPartyIdLen));
     if (rv != AMVP_SUCCESS) {
@@ -191,7 +191,7 @@ static AMVP_RESULT amvp_kda_onestep_init_tc(AMVP_CTX *ctx,
         return rv;
     }
     if (vephemeral) {
-        stc->vEphemeralData = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->vEphemeralData = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->vEphemeralData) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(vephemeral, stc->vEphemeralData, AMVP_KDA_FIXED_BYTE_MAX, &(stc->vEphemeralLen));
         if (rv != AMVP_SUCCESS) {
@@ -201,7 +201,7 @@ static AMVP_RESULT amvp_kda_onestep_init_tc(AMVP_CTX *ctx,
     }
 
     if (algid) {
-        stc->algorithmId = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->algorithmId = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->algorithmId) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(algid, stc->algorithmId, AMVP_KDA_FIXED_BYTE_MAX, &(stc->algIdLen));
         if (rv != AMVP_SUCCESS) {
@@ -211,7 +211,7 @@ static AMVP_RESULT amvp_kda_onestep_init_tc(AMVP_CTX *ctx,
     }
 
     if (label) {
-        stc->label = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->label = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->label) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(label, stc->label, AMVP_KDA_FIXED_BYTE_MAX, &(stc->labelLen));
         if (rv != AMVP_SUCCESS) {
@@ -221,7 +221,7 @@ static AMVP_RESULT amvp_kda_onestep_init_tc(AMVP_CTX *ctx,
     }
 
     if (context) {
-        stc->context = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->context = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->context) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(context, stc->context, AMVP_KDA_FIXED_BYTE_MAX, &(stc->contextLen));
         if (rv != AMVP_SUCCESS) {
@@ -230,14 +230,14 @@ static AMVP_RESULT amvp_kda_onestep_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->outputDkm = calloc(AMVP_KDA_DKM_BYTE_MAX, 1);
+    stc->outputDkm = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDA_DKM_BYTE_MAX, 1);
     if (!stc->outputDkm) { 
         AMVP_LOG_ERR("Failed to allocate outputDkm initializing test case");
         return AMVP_MALLOC_FAIL; 
     }
 
     if (stc->type == AMVP_KDA_TT_VAL) {
-        stc->providedDkm = calloc(AMVP_KDA_DKM_BYTE_MAX, 1);
+        stc->providedDkm = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDA_DKM_BYTE_MAX, 1);
         if (!stc->providedDkm) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(providedDkm, stc->providedDkm, AMVP_KDA_DKM_BYTE_MAX, NULL);
         if (rv != AMVP_SUCCESS) {
@@ -336,7 +336,7 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
         return rv;
     } 
 
-    stc->salt = calloc(1, AMVP_KDA_SALT_BYTE_MAX);
+    stc->salt = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_SALT_BYTE_MAX);
     if (!stc->salt) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(salt, stc->salt, AMVP_KDA_SALT_BYTE_MAX, &(stc->saltLen));
     if (rv != AMVP_SUCCESS || (saltLen != 0 && stc->saltLen != saltLen / 8)) {
@@ -345,7 +345,7 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
     }
 
 
-    stc->z = calloc(1, AMVP_KDA_Z_BYTE_MAX);
+    stc->z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_Z_BYTE_MAX);
     if (!stc->z) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(z, stc->z, AMVP_KDA_Z_BYTE_MAX, &(stc->zLen));
     if (rv != AMVP_SUCCESS) {
@@ -354,7 +354,7 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
     }
 
     if (iv) {
-        stc->iv = calloc(1, AMVP_KDA_Z_BYTE_MAX);
+        stc->iv = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_Z_BYTE_MAX);
         if (!stc->iv) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(iv, stc->iv, AMVP_KDA_Z_BYTE_MAX, &(stc->ivLen));
         if (rv != AMVP_SUCCESS || (ivLen != 0 && stc->ivLen != ivLen / 8)) {
@@ -364,7 +364,7 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
     }
 
     if (t) {
-        stc->t = calloc(1, AMVP_KDA_Z_BYTE_MAX);
+        stc->t = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_Z_BYTE_MAX);
         if (!stc->t) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(t, stc->t, AMVP_KDA_Z_BYTE_MAX, &(stc->tLen));
         if (rv != AMVP_SUCCESS) {
@@ -373,7 +373,7 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->uPartyId = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+    stc->uPartyId = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
     if (!stc->uPartyId) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(uparty, stc->uPartyId, AMVP_KDA_FIXED_BYTE_MAX, &(stc->uPartyIdLen));
     if (rv != AMVP_SUCCESS) {
@@ -381,7 +381,7 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
         return rv;
     }
     if (uephemeral) {
-        stc->uEphemeralData = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->uEphemeralData = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->uEphemeralData) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(uephemeral, stc->uEphemeralData, AMVP_KDA_FIXED_BYTE_MAX, &(stc->uEphemeralLen));
         if (rv != AMVP_SUCCESS) {
@@ -390,7 +390,7 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->vPartyId = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+    stc->vPartyId = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
     if (!stc->vPartyId) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(vparty, stc->vPartyId, AMVP_KDA_FIXED_BYTE_MAX, &(stc->vPartyIdLen));
     if (rv != AMVP_SUCCESS) {
@@ -398,7 +398,7 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
         return rv;
     }
     if (vephemeral) {
-        stc->vEphemeralData = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->vEphemeralData = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->vEphemeralData) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(vephemeral, stc->vEphemeralData, AMVP_KDA_FIXED_BYTE_MAX, &(stc->vEphemeralLen));
         if (rv != AMVP_SUCCESS) {
@@ -408,7 +408,7 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
     }
 
     if (algid) {
-        stc->algorithmId = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->algorithmId = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->algorithmId) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(algid, stc->algorithmId, AMVP_KDA_FIXED_BYTE_MAX, &(stc->algIdLen));
         if (rv != AMVP_SUCCESS) {
@@ -418,7 +418,7 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
     }
 
     if (label) {
-        stc->label = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->label = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->label) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(label, stc->label, AMVP_KDA_FIXED_BYTE_MAX, &(stc->labelLen));
         if (rv != AMVP_SUCCESS) {
@@ -428,7 +428,7 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
     }
 
     if (context) {
-        stc->context = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->context = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->context) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(context, stc->context, AMVP_KDA_FIXED_BYTE_MAX, &(stc->contextLen));
         if (rv != AMVP_SUCCESS) {
@@ -437,14 +437,14 @@ static AMVP_RESULT amvp_kda_twostep_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->outputDkm = calloc(AMVP_KDA_DKM_BYTE_MAX, 1);
+    stc->outputDkm = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDA_DKM_BYTE_MAX, 1);
     if (!stc->outputDkm) { 
         AMVP_LOG_ERR("Failed to allocate outputDkm initializing test case");
         return AMVP_MALLOC_FAIL; 
     }
 
     if (stc->type == AMVP_KDA_TT_VAL) {
-        stc->providedDkm = calloc(AMVP_KDA_DKM_BYTE_MAX, 1);
+        stc->providedDkm = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDA_DKM_BYTE_MAX, 1);
         if (!stc->providedDkm) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(providedDkm, stc->providedDkm, AMVP_KDA_DKM_BYTE_MAX, NULL);
         if (rv != AMVP_SUCCESS) {
@@ -494,7 +494,7 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
         return rv;
     } 
 
-    stc->salt = calloc(1, AMVP_KDA_SALT_BYTE_MAX);
+    stc->salt = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_SALT_BYTE_MAX);
     if (!stc->salt) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(salt, stc->salt, AMVP_KDA_SALT_BYTE_MAX, &(stc->saltLen));
     if (rv != AMVP_SUCCESS || stc->saltLen != saltLen / 8) {
@@ -502,7 +502,7 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->z = calloc(1, AMVP_KDA_Z_BYTE_MAX);
+    stc->z = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_Z_BYTE_MAX);
     if (!stc->z) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(z, stc->z, AMVP_KDA_Z_BYTE_MAX, &(stc->zLen));
     if (rv != AMVP_SUCCESS) {
@@ -511,7 +511,7 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
     }
 
     if (t) {
-        stc->t = calloc(1, AMVP_KDA_Z_BYTE_MAX);
+        stc->t = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_Z_BYTE_MAX);
         if (!stc->t) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(t, stc->t, AMVP_KDA_Z_BYTE_MAX, &(stc->tLen));
         if (rv != AMVP_SUCCESS) {
@@ -520,7 +520,7 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->uPartyId = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+    stc->uPartyId = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
     if (!stc->uPartyId) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(uparty, stc->uPartyId, AMVP_KDA_FIXED_BYTE_MAX, &(stc->uPartyIdLen));
     if (rv != AMVP_SUCCESS) {
@@ -528,7 +528,7 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
         return rv;
     }
     if (uephemeral) {
-        stc->uEphemeralData = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->uEphemeralData = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->uEphemeralData) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(uephemeral, stc->uEphemeralData, AMVP_KDA_FIXED_BYTE_MAX, &(stc->uEphemeralLen));
         if (rv != AMVP_SUCCESS) {
@@ -537,7 +537,7 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->vPartyId = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+    stc->vPartyId = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
     if (!stc->vPartyId) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(vparty, stc->vPartyId, AMVP_KDA_FIXED_BYTE_MAX, &(stc->vPartyIdLen));
     if (rv != AMVP_SUCCESS) {
@@ -545,7 +545,7 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
         return rv;
     }
     if (vephemeral) {
-        stc->vEphemeralData = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->vEphemeralData = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->vEphemeralData) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(vephemeral, stc->vEphemeralData, AMVP_KDA_FIXED_BYTE_MAX, &(stc->vEphemeralLen));
         if (rv != AMVP_SUCCESS) {
@@ -555,7 +555,7 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
     }
 
     if (algid) {
-        stc->algorithmId = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->algorithmId = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->algorithmId) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(algid, stc->algorithmId, AMVP_KDA_FIXED_BYTE_MAX, &(stc->algIdLen));
         if (rv != AMVP_SUCCESS) {
@@ -565,7 +565,7 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
     }
 
     if (label) {
-        stc->label = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->label = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->label) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(label, stc->label, AMVP_KDA_FIXED_BYTE_MAX, &(stc->labelLen));
         if (rv != AMVP_SUCCESS) {
@@ -575,7 +575,7 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
     }
 
     if (context) {
-        stc->context = calloc(1, AMVP_KDA_FIXED_BYTE_MAX);
+        stc->context = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDA_FIXED_BYTE_MAX);
         if (!stc->context) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(context, stc->context, AMVP_KDA_FIXED_BYTE_MAX, &(stc->contextLen));
         if (rv != AMVP_SUCCESS) {
@@ -584,14 +584,14 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->outputDkm = calloc(AMVP_KDA_DKM_BYTE_MAX, 1);
+    stc->outputDkm = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDA_DKM_BYTE_MAX, 1);
     if (!stc->outputDkm) { 
         AMVP_LOG_ERR("Failed to allocate outputDkm initializing test case");
         return AMVP_MALLOC_FAIL; 
     }
 
     if (stc->type == AMVP_KDA_TT_VAL) {
-        stc->providedDkm = calloc(AMVP_KDA_DKM_BYTE_MAX, 1);
+        stc->providedDkm = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDA_DKM_BYTE_MAX, 1);
         if (!stc->providedDkm) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(providedDkm, stc->providedDkm, AMVP_KDA_DKM_BYTE_MAX, NULL);
         if (rv != AMVP_SUCCESS) {
@@ -610,52 +610,52 @@ static AMVP_RESULT amvp_kda_hkdf_init_tc(AMVP_CTX *ctx,
 static AMVP_RESULT amvp_kda_release_tc(AMVP_CIPHER cipher, AMVP_TEST_CASE *tc) {
     if (cipher == AMVP_KDA_HKDF) {
         AMVP_KDA_HKDF_TC *stc = tc->tc.kda_hkdf;
-        if (stc->salt) free(stc->salt);
-        if (stc->z) free(stc->z);
-        if (stc->t) free(stc->t);
-        if (stc->literalCandidate) free(stc->literalCandidate);
-        if (stc->algorithmId) free(stc->algorithmId);
-        if (stc->label) free(stc->label);
-        if (stc->context) free(stc->context);
-        if (stc->uPartyId) free(stc->uPartyId);
-        if (stc->uEphemeralData) free(stc->uEphemeralData);
-        if (stc->vPartyId) free(stc->vPartyId);
-        if (stc->vEphemeralData) free(stc->vEphemeralData);
-        if (stc->providedDkm) free(stc->providedDkm);
-        if (stc->outputDkm) free(stc->outputDkm);
+        if (stc->salt) amvp_mem_free(AMVP_MEM_TC, stc->salt);
+        if (stc->z) amvp_mem_free(AMVP_MEM_TC, stc->z);
+        if (stc->t) amvp_mem_free(AMVP_MEM_TC, stc->t);
+        if (stc->literalCandidate) amvp_mem_free(AMVP_MEM_TC, stc->literalCandidate);
+        if (stc->algorithmId) amvp_mem_free(AMVP_MEM_TC, stc->algorithmId);
+        if (stc->label) amvp_mem_free(AMVP_MEM_TC, stc->label);
+        if (stc->context) amvp_mem_free(AMVP_MEM_TC, stc->context);
+        if (stc->uPartyId) amvp_mem_free(AMVP_MEM_TC, stc->uPartyId);
+        if (stc->uEphemeralData) amvp_mem_free(AMVP_MEM_TC, stc->uEphemeralData);
+        if (stc->vPartyId) amvp_mem_free(AMVP_MEM_TC, stc->vPartyId);
+        if (stc->vEphemeralData) amvp_mem_free(AMVP_MEM_TC, stc->vEphemeralData);
+        if (stc->providedDkm) amvp_mem_free(AMVP_MEM_TC, stc->providedDkm);
+        if (stc->outputDkm) amvp_mem_free(AMVP_MEM_TC, stc->outputDkm);
         memzero_s(stc, sizeof(AMVP_KDA_HKDF_TC));
     } else if (cipher == AMVP_KDA_ONESTEP) {
         AMVP_KDA_ONESTEP_TC *stc = tc->tc.kda_onestep;
-        if (stc->salt) free(stc->salt);
-        if (stc->z) free(stc->z);
-        if (stc->t) free(stc->t);
-        if (stc->literalCandidate) free(stc->literalCandidate);
-        if (stc->algorithmId) free(stc->algorithmId);
-        if (stc->label) free(stc->label);
-        if (stc->context) free(stc->context);
-        if (stc->uPartyId) free(stc->uPartyId);
-        if (stc->uEphemeralData) free(stc->uEphemeralData);
-        if (stc->vPartyId) free(stc->vPartyId);
-        if (stc->vEphemeralData) free(stc->vEphemeralData);
-        if (stc->providedDkm) free(stc->providedDkm);
-        if (stc->outputDkm) free(stc->outputDkm);
+        if (stc->salt) amvp_mem_free(AMVP_MEM_TC, stc->salt);
+        if (stc->z) amvp_mem_free(AMVP_MEM_TC, stc->z);
+        if (stc->t) amvp_mem_free(AMVP_MEM_TC, stc->t);
+        if (stc->literalCandidate) amvp_mem_free(AMVP_MEM_TC, stc->literalCandidate);
+        if (stc->algorithmId) amvp_mem_free(AMVP_MEM_TC, stc->algorithmId);
+        if (stc->label) amvp_mem_free(AMVP_MEM_TC, stc->label);
+        if (stc->context) amvp_mem_free(AMVP_MEM_TC, stc->context);
+        if (stc->uPartyId) amvp_mem_free(AMVP_MEM_TC, stc->uPartyId);
+        if (stc->uEphemeralData) amvp_mem_free(AMVP_MEM_TC, stc->uEphemeralData);
+        if (stc->vPartyId) amvp_mem_free(AMVP_MEM_TC, stc->vPartyId);
+        if (stc->vEphemeralData) amvp_mem_free(AMVP_MEM_TC, stc->vEphemeralData);
+        if (stc->providedDkm) amvp_mem_free(AMVP_MEM_TC, stc->providedDkm);
+        if (stc->outputDkm) amvp_mem_free(AMVP_MEM_TC, stc->outputDkm);
         memzero_s(stc, sizeof(AMVP_KDA_ONESTEP_TC));
     } else if (cipher == AMVP_KDA_TWOSTEP) {
         AMVP_KDA_TWOSTEP_TC *stc = tc->tc.kda_twostep;
-        if (stc->salt) free(stc->salt);
+        if (stc->salt) amvp_mem_free(AMVP_MEM_TC, stc->salt);
         if (stc->iv) free (stc->iv);
-        if (stc->z) free(stc->z);
-        if (stc->t) free(stc->t);
-        if (stc->literalCandidate) free(stc->literalCandidate);
-        if (stc->algorithmId) free(stc->algorithmId);
-        if (stc->label) free(stc->label);
-        if (stc->context) free(stc->context);
-        if (stc->uPartyId) free(stc->uPartyId);
-        if (stc->uEphemeralData) free(stc->uEphemeralData);
-        if (stc->vPartyId) free(stc->vPartyId);
-        if (stc->vEphemeralData) free(stc->vEphemeralData);
-        if (stc->providedDkm) free(stc->providedDkm);
-        if (stc->outputDkm) free(stc->outputDkm);
+        if (stc->z) amvp_mem_free(AMVP_MEM_TC, stc->z);
+        if (stc->t) amvp_mem_free(AMVP_MEM_TC, stc->t);
+        if (stc->literalCandidate) amvp_mem_free(AMVP_MEM_TC, stc->literalCandidate);
+        if (stc->algorithmId) amvp_mem_free(AMVP_MEM_TC, stc->algorithmId);
+        if (stc->label) amvp_mem_free(AMVP_MEM_TC, stc->label);
+        if (stc->context) amvp_mem_free(AMVP_MEM_TC, stc->context);
+        if (stc->uPartyId) amvp_mem_free(AMVP_MEM_TC, stc->uPartyId);
+        if (stc->uEphemeralData) amvp_mem_free(AMVP_MEM_TC, stc->uEphemeralData);
+        if (stc->vPartyId) amvp_mem_free(AMVP_MEM_TC, stc->vPartyId);
+        if (stc->vEphemeralData) amvp_mem_free(AMVP_MEM_TC, stc->vEphemeralData);
+        if (stc->providedDkm) amvp_mem_free(AMVP_MEM_TC, stc->providedDkm);
+        if (stc->outputDkm) amvp_mem_free(AMVP_MEM_TC, stc->outputDkm);
         memzero_s(stc, sizeof(AMVP_KDA_TWOSTEP_TC));
     } else {
         return AMVP_UNSUPPORTED_OP;
@@ -935,6 +935,7 @@ static AMVP_RESULT amvp_kda_process(AMVP_CTX *ctx,
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -1396,7 +1397,7 @@ static AMVP_RESULT amvp_kda_process(AMVP_CTX *ctx,
                 goto err;
             }
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (amvp_crypto_handler(ctx, cap, tc)) {
                 if (cipher == AMVP_KDA_HKDF) {
                     amvp_kda_release_tc(AMVP_KDA_HKDF, tc);
                 } else if (cipher == AMVP_KDA_ONESTEP) {
@@ -1474,7 +1475,7 @@ AMVP_RESULT amvp_kda_hkdf_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
     JSON_Object *reg_obj = NULL;
     AMVP_CAPS_LIST *cap;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_KDA_HKDF_TC stc;
     AMVP_RESULT rv = AMVP_SUCCESS;
     const char *alg_str = NULL;
@@ -1549,7 +1550,7 @@ AMVP_RESULT amvp_kda_hkdf_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -1570,7 +1571,7 @@ AMVP_RESULT amvp_kda_onestep_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
     JSON_Object *reg_obj = NULL;
     AMVP_CAPS_LIST *cap;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_KDA_ONESTEP_TC stc;
     AMVP_RESULT rv = AMVP_SUCCESS;
     const char *alg_str = NULL;
@@ -1645,7 +1646,7 @@ AMVP_RESULT amvp_kda_onestep_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -1666,7 +1667,7 @@ AMVP_RESULT amvp_kda_twostep_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
     JSON_Object *reg_obj = NULL;
     AMVP_CAPS_LIST *cap;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_KDA_TWOSTEP_TC stc;
     AMVP_RESULT rv = AMVP_SUCCESS;
     const char *alg_str = NULL;
@@ -1741,7 +1742,7 @@ AMVP_RESULT amvp_kda_twostep_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -102,7 +102,7 @@ static AMVP_RESULT amvp_kdf108_init_tc(AMVP_KDF108_TC *stc,
     memzero_s(stc, sizeof(AMVP_KDF108_TC));
 
     // Allocate space for the key_in (binary)
-    stc->key_in = calloc(key_in_len, sizeof(unsigned char));
+    stc->key_in = amvp_mem_calloc(AMVP_MEM_TC, key_in_len, sizeof(unsigned char));
     if (!stc->key_in) { return AMVP_MALLOC_FAIL; }
 
     // Convert key_in from hex string to binary
@@ -114,7 +114,7 @@ static AMVP_RESULT amvp_kdf108_init_tc(AMVP_KDF108_TC *stc,
          * Feedback mode.
          * Allocate space for the iv.
          */
-        stc->iv = calloc(iv_len, sizeof(unsigned char));
+        stc->iv = amvp_mem_calloc(AMVP_MEM_TC, iv_len, sizeof(unsigned char));
         if (!stc->iv) { return AMVP_MALLOC_FAIL; }
 
         // Convert iv from hex string to binary
@@ -126,14 +126,14 @@ static AMVP_RESULT amvp_kdf108_init_tc(AMVP_KDF108_TC *stc,
      * Allocate space for the key_out
      * User supplies the data.
      */
-    stc->key_out = calloc(key_out_len, sizeof(unsigned char));
+    stc->key_out = amvp_mem_calloc(AMVP_MEM_TC, key_out_len, sizeof(unsigned char));
     if (!stc->key_out) { return AMVP_MALLOC_FAIL; }
 
     /*
      * Allocate space for the fixed_data.
      * User supplies the data.
      */
-    stc->fixed_data = calloc(AMVP_KDF108_FIXED_DATA_BYTE_MAX,
+    stc->fixed_data = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF108_FIXED_DATA_BYTE_MAX,
                              sizeof(unsigned char));
     if (!stc->fixed_data) { return AMVP_MALLOC_FAIL; }
 
@@ -155,10 +155,10 @@ static AMVP_RESULT amvp_kdf108_init_tc(AMVP_KDF108_TC *stc,
  * a test case.
  */
 static AMVP_RESULT amvp_kdf108_release_tc(AMVP_KDF108_TC *stc) {
-    if (stc->key_in) free(stc->key_in);
-    if (stc->key_out) free(stc->key_out);
-    if (stc->fixed_data) free(stc->fixed_data);
-    if (stc->iv) free(stc->iv);
+    if (stc->key_in) amvp_mem_free(AMVP_MEM_TC, stc->key_in);
+    if (stc->key_out) amvp_mem_free(AMVP_MEM_TC, stc->key_out);
+    if (stc->fixed_data) amvp_mem_free(AMVP_MEM_TC, stc->fixed_data);
+    if (stc->iv) amvp_mem_free(AMVP_MEM_TC, stc->iv);
 
     memzero_s(stc, sizeof(AMVP_KDF108_TC));
     return AMVP_SUCCESS;
@@ -306,7 +306,7 @@ AMVP_RESULT amvp_kdf108_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     AMVP_CAPS_LIST *cap;
     AMVP_KDF108_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = NULL;
     AMVP_CIPHER alg_id = 0;
@@ -382,6 +382,7 @@ AMVP_RESULT amvp_kdf108_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -534,7 +535,7 @@ AMVP_RESULT amvp_kdf108_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 amvp_kdf108_release_tc(&stc);
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -572,7 +573,7 @@ AMVP_RESULT amvp_kdf108_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
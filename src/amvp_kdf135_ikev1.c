@@ -96,7 +96,7 @@ static AMVP_RESULT amvp_kdf135_ikev1_init_tc(AMVP_CTX *ctx,
     stc->dh_secret_len = AMVP_BIT2BYTE(dh_secret_len);
     stc->psk_len = AMVP_BIT2BYTE(psk_len);
 
-    stc->init_nonce = calloc(AMVP_KDF135_IKEV1_INIT_NONCE_BYTE_MAX,
+    stc->init_nonce = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV1_INIT_NONCE_BYTE_MAX,
                              sizeof(unsigned char));
     if (!stc->init_nonce) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(init_nonce, stc->init_nonce, AMVP_KDF135_IKEV1_INIT_NONCE_BYTE_MAX, NULL);
@@ -105,7 +105,7 @@ static AMVP_RESULT amvp_kdf135_ikev1_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->resp_nonce = calloc(AMVP_KDF135_IKEV1_RESP_NONCE_BYTE_MAX,
+    stc->resp_nonce = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV1_RESP_NONCE_BYTE_MAX,
                              sizeof(unsigned char));
     if (!stc->resp_nonce) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(resp_nonce, stc->resp_nonce, AMVP_KDF135_IKEV1_RESP_NONCE_BYTE_MAX, NULL);
@@ -114,7 +114,7 @@ static AMVP_RESULT amvp_kdf135_ikev1_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->init_ckey = calloc(AMVP_KDF135_IKEV1_COOKIE_BYTE_MAX,
+    stc->init_ckey = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV1_COOKIE_BYTE_MAX,
                             sizeof(unsigned char));
     if (!stc->init_ckey) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(init_ckey, stc->init_ckey, AMVP_KDF135_IKEV1_COOKIE_BYTE_MAX, NULL);
@@ -123,7 +123,7 @@ static AMVP_RESULT amvp_kdf135_ikev1_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->resp_ckey = calloc(AMVP_KDF135_IKEV1_COOKIE_BYTE_MAX,
+    stc->resp_ckey = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV1_COOKIE_BYTE_MAX,
                             sizeof(unsigned char));
     if (!stc->resp_ckey) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(resp_ckey, stc->resp_ckey, AMVP_KDF135_IKEV1_COOKIE_BYTE_MAX, NULL);
@@ -132,7 +132,7 @@ static AMVP_RESULT amvp_kdf135_ikev1_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->gxy = calloc(AMVP_KDF135_IKEV1_DH_SHARED_SECRET_BYTE_MAX,
+    stc->gxy = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV1_DH_SHARED_SECRET_BYTE_MAX,
                       sizeof(unsigned char));
     if (!stc->gxy) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(gxy, stc->gxy, AMVP_KDF135_IKEV1_DH_SHARED_SECRET_BYTE_MAX, NULL);
@@ -143,7 +143,7 @@ static AMVP_RESULT amvp_kdf135_ikev1_init_tc(AMVP_CTX *ctx,
 
     if (psk != NULL) {
         /* Only for PSK authentication method */
-        stc->psk = calloc(AMVP_KDF135_IKEV1_PSK_BYTE_MAX,
+        stc->psk = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV1_PSK_BYTE_MAX,
                           sizeof(unsigned char));
         if (!stc->psk) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(psk, stc->psk, AMVP_KDF135_IKEV1_PSK_BYTE_MAX, NULL);
@@ -153,16 +153,16 @@ static AMVP_RESULT amvp_kdf135_ikev1_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->s_key_id = calloc(AMVP_KDF135_IKEV1_SKEY_BYTE_MAX,
+    stc->s_key_id = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV1_SKEY_BYTE_MAX,
                            sizeof(unsigned char));
     if (!stc->s_key_id) { return AMVP_MALLOC_FAIL; }
-    stc->s_key_id_a = calloc(AMVP_KDF135_IKEV1_SKEY_BYTE_MAX,
+    stc->s_key_id_a = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV1_SKEY_BYTE_MAX,
                              sizeof(unsigned char));
     if (!stc->s_key_id_a) { return AMVP_MALLOC_FAIL; }
-    stc->s_key_id_d = calloc(AMVP_KDF135_IKEV1_SKEY_BYTE_MAX,
+    stc->s_key_id_d = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV1_SKEY_BYTE_MAX,
                              sizeof(unsigned char));
     if (!stc->s_key_id_d) { return AMVP_MALLOC_FAIL; }
-    stc->s_key_id_e = calloc(AMVP_KDF135_IKEV1_SKEY_BYTE_MAX,
+    stc->s_key_id_e = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV1_SKEY_BYTE_MAX,
                              sizeof(unsigned char));
     if (!stc->s_key_id_e) { return AMVP_MALLOC_FAIL; }
 
@@ -170,16 +170,16 @@ static AMVP_RESULT amvp_kdf135_ikev1_init_tc(AMVP_CTX *ctx,
 }
 
 static AMVP_RESULT amvp_kdf135_ikev1_release_tc(AMVP_KDF135_IKEV1_TC *stc) {
-    if (stc->init_nonce) { free(stc->init_nonce); }
-    if (stc->resp_nonce) { free(stc->resp_nonce); }
-    if (stc->init_ckey) { free(stc->init_ckey); }
-    if (stc->resp_ckey) { free(stc->resp_ckey); }
-    if (stc->gxy) { free(stc->gxy); }
-    if (stc->psk) { free(stc->psk); }
-    if (stc->s_key_id) { free(stc->s_key_id); }
-    if (stc->s_key_id_d) { free(stc->s_key_id_d); }
-    if (stc->s_key_id_a) { free(stc->s_key_id_a); }
-    if (stc->s_key_id_e) { free(stc->s_key_id_e); }
+    if (stc->init_nonce) { amvp_mem_free(AMVP_MEM_TC, stc->init_nonce); }
+    if (stc->resp_nonce) { amvp_mem_free(AMVP_MEM_TC, stc->resp_nonce); }
+    if (stc->init_ckey) { amvp_mem_free(AMVP_MEM_TC, stc->init_ckey); }
+    if (stc->resp_ckey) { amvp_mem_free(AMVP_MEM_TC, stc->resp_ckey); }
+    if (stc->gxy) { amvp_mem_free(AMVP_MEM_TC, stc->gxy); }
+    if (stc->psk) { amvp_mem_free(AMVP_MEM_TC, stc->psk); }
+    if (stc->s_key_id) { amvp_mem_free(AMVP_MEM_TC, stc->s_key_id); }
+    if (stc->s_key_id_d) { amvp_mem_free(AMVP_MEM_TC, stc->s_key_id_d); }
+    if (stc->s_key_id_a) { amvp_mem_free(AMVP_MEM_TC, stc->s_key_id_a); }
+    if (stc->s_key_id_e) { amvp_mem_free(AMVP_MEM_TC, stc->s_key_id_e); }
     memzero_s(stc, sizeof(AMVP_KDF135_IKEV1_TC));
     return AMVP_SUCCESS;
 }
@@ -222,7 +222,7 @@ AMVP_RESULT amvp_kdf135_ikev1_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
     AMVP_KDF135_IKEV1_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     const char *mode_str = NULL;
@@ -302,6 +302,7 @@ AMVP_RESULT amvp_kdf135_ikev1_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -511,7 +512,7 @@ AMVP_RESULT amvp_kdf135_ikev1_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the KDF IKEv1 operation");
                 amvp_kdf135_ikev1_release_tc(&stc);
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -542,7 +543,7 @@ AMVP_RESULT amvp_kdf135_ikev1_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -102,7 +102,7 @@ static AMVP_RESULT amvp_kdf135_ikev2_init_tc(AMVP_CTX *ctx,
     stc->dh_secret_len = dh_secret_len;
     stc->keying_material_len = AMVP_BIT2BYTE(keying_material_len);
 
-    stc->init_nonce = calloc(AMVP_KDF135_IKEV2_INIT_NONCE_BYTE_MAX,
+    stc->init_nonce = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV2_INIT_NONCE_BYTE_MAX,
                              sizeof(unsigned char));
     if (!stc->init_nonce) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(init_nonce, stc->init_nonce, AMVP_KDF135_IKEV2_INIT_NONCE_BYTE_MAX, &(stc->init_nonce_len));
@@ -111,7 +111,7 @@ static AMVP_RESULT amvp_kdf135_ikev2_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->resp_nonce = calloc(AMVP_KDF135_IKEV2_RESP_NONCE_BYTE_MAX,
+    stc->resp_nonce = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV2_RESP_NONCE_BYTE_MAX,
                              sizeof(unsigned char));
     if (!stc->resp_nonce) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(resp_nonce, stc->resp_nonce, AMVP_KDF135_IKEV2_RESP_NONCE_BYTE_MAX, &(stc->resp_nonce_len));
@@ -120,7 +120,7 @@ static AMVP_RESULT amvp_kdf135_ikev2_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->init_spi = calloc(AMVP_KDF135_IKEV2_SPI_BYTE_MAX,
+    stc->init_spi = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV2_SPI_BYTE_MAX,
                            sizeof(unsigned char));
     if (!stc->init_spi) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(init_spi, stc->init_spi, AMVP_KDF135_IKEV2_SPI_BYTE_MAX, &(stc->init_spi_len));
@@ -129,7 +129,7 @@ static AMVP_RESULT amvp_kdf135_ikev2_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->resp_spi = calloc(AMVP_KDF135_IKEV2_SPI_BYTE_MAX,
+    stc->resp_spi = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV2_SPI_BYTE_MAX,
                            sizeof(unsigned char));
     if (!stc->resp_spi) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(resp_spi, stc->resp_spi, AMVP_KDF135_IKEV2_SPI_BYTE_MAX, &(stc->resp_spi_len));
@@ -138,7 +138,7 @@ static AMVP_RESULT amvp_kdf135_ikev2_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->gir = calloc(AMVP_KDF135_IKEV2_DH_SHARED_SECRET_BYTE_MAX,
+    stc->gir = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV2_DH_SHARED_SECRET_BYTE_MAX,
                       sizeof(unsigned char));
     if (!stc->gir) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(gir, stc->gir, AMVP_KDF135_IKEV2_DH_SHARED_SECRET_BYTE_MAX, &(stc->gir_len));
@@ -147,7 +147,7 @@ static AMVP_RESULT amvp_kdf135_ikev2_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->gir_new = calloc(AMVP_KDF135_IKEV2_DH_SHARED_SECRET_BYTE_MAX,
+    stc->gir_new = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV2_DH_SHARED_SECRET_BYTE_MAX,
                           sizeof(unsigned char));
     if (!stc->gir_new) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(gir_new, stc->gir_new, AMVP_KDF135_IKEV2_DH_SHARED_SECRET_BYTE_MAX, &(stc->gir_new_len));
@@ -157,23 +157,23 @@ static AMVP_RESULT amvp_kdf135_ikev2_init_tc(AMVP_CTX *ctx,
     }
 
     /* allocate memory for answers so app doesn't have to touch library memory */
-    stc->s_key_seed = calloc(AMVP_KDF135_IKEV2_SKEY_SEED_BYTE_MAX,
+    stc->s_key_seed = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV2_SKEY_SEED_BYTE_MAX,
                              sizeof(unsigned char));
     if (!stc->s_key_seed) { return AMVP_MALLOC_FAIL; }
 
-    stc->s_key_seed_rekey = calloc(AMVP_KDF135_IKEV2_SKEY_SEED_BYTE_MAX,
+    stc->s_key_seed_rekey = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV2_SKEY_SEED_BYTE_MAX,
                                    sizeof(unsigned char));
     if (!stc->s_key_seed_rekey) { return AMVP_MALLOC_FAIL; }
 
-    stc->derived_keying_material = calloc(AMVP_KDF135_IKEV2_DKEY_MATERIAL_BYTE_MAX,
+    stc->derived_keying_material = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV2_DKEY_MATERIAL_BYTE_MAX,
                                           sizeof(unsigned char));
     if (!stc->derived_keying_material) { return AMVP_MALLOC_FAIL; }
 
-    stc->derived_keying_material_child_dh = calloc(AMVP_KDF135_IKEV2_DKEY_MATERIAL_BYTE_MAX,
+    stc->derived_keying_material_child_dh = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV2_DKEY_MATERIAL_BYTE_MAX,
                                                    sizeof(unsigned char));
     if (!stc->derived_keying_material_child_dh) { return AMVP_MALLOC_FAIL; }
 
-    stc->derived_keying_material_child = calloc(AMVP_KDF135_IKEV2_DKEY_MATERIAL_BYTE_MAX,
+    stc->derived_keying_material_child = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_IKEV2_DKEY_MATERIAL_BYTE_MAX,
                                                 sizeof(unsigned char));
     if (!stc->derived_keying_material_child) { return AMVP_MALLOC_FAIL; }
 
@@ -181,17 +181,17 @@ static AMVP_RESULT amvp_kdf135_ikev2_init_tc(AMVP_CTX *ctx,
 }
 
 static AMVP_RESULT amvp_kdf135_ikev2_release_tc(AMVP_KDF135_IKEV2_TC *stc) {
-    if (stc->init_nonce) { free(stc->init_nonce); }
-    if (stc->resp_nonce) { free(stc->resp_nonce); }
-    if (stc->init_spi) { free(stc->init_spi); }
-    if (stc->resp_spi) { free(stc->resp_spi); }
-    if (stc->gir) { free(stc->gir); }
-    if (stc->gir_new) { free(stc->gir_new); }
-    if (stc->s_key_seed) { free(stc->s_key_seed); }
-    if (stc->s_key_seed_rekey) { free(stc->s_key_seed_rekey); }
-    if (stc->derived_keying_material) { free(stc->derived_keying_material); }
-    if (stc->derived_keying_material_child) { free(stc->derived_keying_material_child); }
-    if (stc->derived_keying_material_child_dh) { free(stc->derived_keying_material_child_dh); }
+    if (stc->init_nonce) { amvp_mem_free(AMVP_MEM_TC, stc->init_nonce); }
+    if (stc->resp_nonce) { amvp_mem_free(AMVP_MEM_TC, stc->resp_nonce); }
+    if (stc->init_spi) { amvp_mem_free(AMVP_MEM_TC, stc->init_spi); }
+    if (stc->resp_spi) { amvp_mem_free(AMVP_MEM_TC, stc->resp_spi); }
+    if (stc->gir) { amvp_mem_free(AMVP_MEM_TC, stc->gir); }
+    if (stc->gir_new) { amvp_mem_free(AMVP_MEM_TC, stc->gir_new); }
+    if (stc->s_key_seed) { amvp_mem_free(AMVP_MEM_TC, stc->s_key_seed); }
+    if (stc->s_key_seed_rekey) { amvp_mem_free(AMVP_MEM_TC, stc->s_key_seed_rekey); }
+    if (stc->derived_keying_material) { amvp_mem_free(AMVP_MEM_TC, stc->derived_keying_material); }
+    if (stc->derived_keying_material_child) { amvp_mem_free(AMVP_MEM_TC, stc->derived_keying_material_child); }
+    if (stc->derived_keying_material_child_dh) { amvp_mem_free(AMVP_MEM_TC, stc->derived_keying_material_child_dh); }
     memzero_s(stc, sizeof(AMVP_KDF135_IKEV2_TC));
     return AMVP_SUCCESS;
 }
@@ -219,7 +219,7 @@ AMVP_RESULT amvp_kdf135_ikev2_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
     AMVP_KDF135_IKEV2_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     const char *mode_str = NULL;
@@ -299,6 +299,7 @@ AMVP_RESULT amvp_kdf135_ikev2_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -484,7 +485,7 @@ AMVP_RESULT amvp_kdf135_ikev2_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed");
                 amvp_kdf135_ikev2_release_tc(&stc);
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -515,7 +516,7 @@ AMVP_RESULT amvp_kdf135_ikev2_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
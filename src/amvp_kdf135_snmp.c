@@ -56,7 +56,7 @@ AMVP_RESULT amvp_kdf135_snmp_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
     AMVP_KDF135_SNMP_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     const char *mode_str = NULL;
@@ -139,6 +139,7 @@ AMVP_RESULT amvp_kdf135_snmp_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -229,7 +230,7 @@ AMVP_RESULT amvp_kdf135_snmp_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 amvp_kdf135_snmp_release_tc(&stc);
                 json_value_free(r_tval);
@@ -260,7 +261,7 @@ AMVP_RESULT amvp_kdf135_snmp_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -307,10 +308,10 @@ static AMVP_RESULT amvp_kdf135_snmp_init_tc(AMVP_CTX *ctx,
 
     memzero_s(stc, sizeof(AMVP_KDF135_SNMP_TC));
 
-    stc->s_key = calloc(AMVP_KDF135_SNMP_SKEY_MAX * 2, sizeof(char));
+    stc->s_key = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SNMP_SKEY_MAX * 2, sizeof(char));
     if (!stc->s_key) { return AMVP_MALLOC_FAIL; }
 
-    stc->engine_id = calloc(AMVP_KDF135_SNMP_ENGID_MAX_BYTES, sizeof(char));
+    stc->engine_id = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SNMP_ENGID_MAX_BYTES, sizeof(char));
     if (!stc->engine_id) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(engine_id, stc->engine_id,
                             AMVP_KDF135_SNMP_ENGID_MAX_BYTES, (int*)&stc->engine_id_len);
@@ -333,8 +334,8 @@ static AMVP_RESULT amvp_kdf135_snmp_init_tc(AMVP_CTX *ctx,
  * a test case.
  */
 static AMVP_RESULT amvp_kdf135_snmp_release_tc(AMVP_KDF135_SNMP_TC *stc) {
-    if (stc->s_key) free(stc->s_key);
-    if (stc->engine_id) free(stc->engine_id);
+    if (stc->s_key) amvp_mem_free(AMVP_MEM_TC, stc->s_key);
+    if (stc->engine_id) amvp_mem_free(AMVP_MEM_TC, stc->engine_id);
     memzero_s(stc, sizeof(AMVP_KDF135_SNMP_TC));
     return AMVP_SUCCESS;
 }
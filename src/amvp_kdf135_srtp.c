@@ -88,17 +88,17 @@ err:
  * a test case.
  */
 static AMVP_RESULT amvp_kdf135_srtp_release_tc(AMVP_KDF135_SRTP_TC *stc) {
-    if (stc->kdr) free(stc->kdr);
-    if (stc->master_key) free(stc->master_key);
-    if (stc->master_salt) free(stc->master_salt);
-    if (stc->idx) free(stc->idx);
-    if (stc->srtcp_idx) free(stc->srtcp_idx);
-    if (stc->srtp_ke) free(stc->srtp_ke);
-    if (stc->srtp_ka) free(stc->srtp_ka);
-    if (stc->srtp_ks) free(stc->srtp_ks);
-    if (stc->srtcp_ke) free(stc->srtcp_ke);
-    if (stc->srtcp_ka) free(stc->srtcp_ka);
-    if (stc->srtcp_ks) free(stc->srtcp_ks);
+    if (stc->kdr) amvp_mem_free(AMVP_MEM_TC, stc->kdr);
+    if (stc->master_key) amvp_mem_free(AMVP_MEM_TC, stc->master_key);
+    if (stc->master_salt) amvp_mem_free(AMVP_MEM_TC, stc->master_salt);
+    if (stc->idx) amvp_mem_free(AMVP_MEM_TC, stc->idx);
+    if (stc->srtcp_idx) amvp_mem_free(AMVP_MEM_TC, stc->srtcp_idx);
+    if (stc->srtp_ke) amvp_mem_free(AMVP_MEM_TC, stc->srtp_ke);
+    if (stc->srtp_ka) amvp_mem_free(AMVP_MEM_TC, stc->srtp_ka);
+    if (stc->srtp_ks) amvp_mem_free(AMVP_MEM_TC, stc->srtp_ks);
+    if (stc->srtcp_ke) amvp_mem_free(AMVP_MEM_TC, stc->srtcp_ke);
+    if (stc->srtcp_ka) amvp_mem_free(AMVP_MEM_TC, stc->srtcp_ka);
+    if (stc->srtcp_ks) amvp_mem_free(AMVP_MEM_TC, stc->srtcp_ks);
     memzero_s(stc, sizeof(AMVP_KDF135_SRTP_TC));
     return AMVP_SUCCESS;
 }
@@ -124,7 +124,7 @@ static AMVP_RESULT amvp_kdf135_srtp_init_tc(AMVP_CTX *ctx,
     stc->tc_id = tc_id;
     stc->aes_keylen = aes_keylen;
 
-    stc->kdr = calloc(AMVP_KDF135_SRTP_KDR_STR_MAX, sizeof(char));
+    stc->kdr = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SRTP_KDR_STR_MAX, sizeof(char));
     if (!stc->kdr) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(kdr, stc->kdr, AMVP_KDF135_SRTP_KDR_STR_MAX, &(stc->kdr_len));
     if (rv != AMVP_SUCCESS) {
@@ -132,7 +132,7 @@ static AMVP_RESULT amvp_kdf135_srtp_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->master_key = calloc(AMVP_KDF135_SRTP_MASTER_MAX, sizeof(char));
+    stc->master_key = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SRTP_MASTER_MAX, sizeof(char));
     if (!stc->master_key) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(master_key, (unsigned char *)stc->master_key,
                             AMVP_KDF135_SRTP_MASTER_MAX, NULL);
@@ -141,7 +141,7 @@ static AMVP_RESULT amvp_kdf135_srtp_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->master_salt = calloc(AMVP_KDF135_SRTP_MASTER_MAX, sizeof(char));
+    stc->master_salt = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SRTP_MASTER_MAX, sizeof(char));
     if (!stc->master_salt) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(master_salt, (unsigned char *)stc->master_salt,
                             AMVP_KDF135_SRTP_MASTER_MAX, NULL);
@@ -150,7 +150,7 @@ static AMVP_RESULT amvp_kdf135_srtp_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->idx = calloc(AMVP_KDF135_SRTP_INDEX_MAX, sizeof(char));
+    stc->idx = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SRTP_INDEX_MAX, sizeof(char));
     if (!stc->idx) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(idx, (unsigned char *)stc->idx, AMVP_KDF135_SRTP_INDEX_MAX,
                             NULL);
@@ -159,7 +159,7 @@ static AMVP_RESULT amvp_kdf135_srtp_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->srtcp_idx = calloc(AMVP_KDF135_SRTP_INDEX_MAX, sizeof(char));
+    stc->srtcp_idx = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SRTP_INDEX_MAX, sizeof(char));
     if (!stc->srtcp_idx) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(srtcp_idx, (unsigned char *)stc->srtcp_idx,
                             AMVP_KDF135_SRTP_INDEX_MAX, NULL);
@@ -168,17 +168,17 @@ static AMVP_RESULT amvp_kdf135_srtp_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->srtp_ka = calloc(AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
+    stc->srtp_ka = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
     if (!stc->srtp_ka) { return AMVP_MALLOC_FAIL; }
-    stc->srtp_ke = calloc(AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
+    stc->srtp_ke = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
     if (!stc->srtp_ke) { return AMVP_MALLOC_FAIL; }
-    stc->srtp_ks = calloc(AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
+    stc->srtp_ks = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
     if (!stc->srtp_ks) { return AMVP_MALLOC_FAIL; }
-    stc->srtcp_ka = calloc(AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
+    stc->srtcp_ka = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
     if (!stc->srtcp_ka) { return AMVP_MALLOC_FAIL; }
-    stc->srtcp_ke = calloc(AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
+    stc->srtcp_ke = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
     if (!stc->srtcp_ke) { return AMVP_MALLOC_FAIL; }
-    stc->srtcp_ks = calloc(AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
+    stc->srtcp_ks = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SRTP_OUTPUT_MAX, sizeof(char));
     if (!stc->srtcp_ks) { return AMVP_MALLOC_FAIL; }
 
     return AMVP_SUCCESS;
@@ -207,7 +207,7 @@ AMVP_RESULT amvp_kdf135_srtp_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
     AMVP_KDF135_SRTP_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     const char *mode_str = NULL;
@@ -283,6 +283,7 @@ AMVP_RESULT amvp_kdf135_srtp_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -375,7 +376,7 @@ AMVP_RESULT amvp_kdf135_srtp_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed");
                 amvp_kdf135_srtp_release_tc(&stc);
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -406,7 +407,7 @@ AMVP_RESULT amvp_kdf135_srtp_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
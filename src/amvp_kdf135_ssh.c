@@ -59,7 +59,7 @@ AMVP_RESULT amvp_kdf135_ssh_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
     AMVP_KDF135_SSH_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
 
     AMVP_CIPHER alg_id;
@@ -156,6 +156,7 @@ AMVP_RESULT amvp_kdf135_ssh_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -313,7 +314,7 @@ AMVP_RESULT amvp_kdf135_ssh_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the KDF SSH operation");
                 amvp_kdf135_ssh_release_tc(&stc);
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -344,7 +345,7 @@ AMVP_RESULT amvp_kdf135_ssh_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -457,11 +458,11 @@ static AMVP_RESULT amvp_kdf135_ssh_init_tc(AMVP_KDF135_SSH_TC *stc,
     shared_secret_len = strnlen_s(shared_secret_k, AMVP_KDF135_SSH_STR_IN_MAX) / 2;
     session_id_len = strnlen_s(session_id, AMVP_KDF135_SSH_STR_IN_MAX) / 2;
 
-    stc->shared_secret_k = calloc(shared_secret_len, sizeof(unsigned char));
+    stc->shared_secret_k = amvp_mem_calloc(AMVP_MEM_TC, shared_secret_len, sizeof(unsigned char));
     if (!stc->shared_secret_k) { return AMVP_MALLOC_FAIL; }
-    stc->hash_h = calloc(hash_len, sizeof(unsigned char));
+    stc->hash_h = amvp_mem_calloc(AMVP_MEM_TC, hash_len, sizeof(unsigned char));
     if (!stc->hash_h) { return AMVP_MALLOC_FAIL; }
-    stc->session_id = calloc(session_id_len, sizeof(unsigned char));
+    stc->session_id = amvp_mem_calloc(AMVP_MEM_TC, session_id_len, sizeof(unsigned char));
     if (!stc->session_id) { return AMVP_MALLOC_FAIL; }
 
     // Convert from hex string to binary
@@ -476,19 +477,19 @@ static AMVP_RESULT amvp_kdf135_ssh_init_tc(AMVP_KDF135_SSH_TC *stc,
     if (rv != AMVP_SUCCESS) return rv;
 
     // Allocate answer buffers
-    stc->cs_init_iv = calloc(AMVP_KDF135_SSH_IV_MAX, sizeof(unsigned char));
+    stc->cs_init_iv = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SSH_IV_MAX, sizeof(unsigned char));
     if (!stc->cs_init_iv) { return AMVP_MALLOC_FAIL; }
-    stc->sc_init_iv = calloc(AMVP_KDF135_SSH_IV_MAX, sizeof(unsigned char));
+    stc->sc_init_iv = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SSH_IV_MAX, sizeof(unsigned char));
     if (!stc->sc_init_iv) { return AMVP_MALLOC_FAIL; }
 
-    stc->cs_encrypt_key = calloc(AMVP_KDF135_SSH_EKEY_MAX, sizeof(unsigned char));
+    stc->cs_encrypt_key = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SSH_EKEY_MAX, sizeof(unsigned char));
     if (!stc->cs_encrypt_key) { return AMVP_MALLOC_FAIL; }
-    stc->sc_encrypt_key = calloc(AMVP_KDF135_SSH_EKEY_MAX, sizeof(unsigned char));
+    stc->sc_encrypt_key = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SSH_EKEY_MAX, sizeof(unsigned char));
     if (!stc->sc_encrypt_key) { return AMVP_MALLOC_FAIL; }
 
-    stc->cs_integrity_key = calloc(AMVP_KDF135_SSH_IKEY_MAX, sizeof(unsigned char));
+    stc->cs_integrity_key = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SSH_IKEY_MAX, sizeof(unsigned char));
     if (!stc->cs_integrity_key) { return AMVP_MALLOC_FAIL; }
-    stc->sc_integrity_key = calloc(AMVP_KDF135_SSH_IKEY_MAX, sizeof(unsigned char));
+    stc->sc_integrity_key = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_SSH_IKEY_MAX, sizeof(unsigned char));
     if (!stc->sc_integrity_key) { return AMVP_MALLOC_FAIL; }
 
     stc->tc_id = tc_id;
@@ -509,15 +510,15 @@ static AMVP_RESULT amvp_kdf135_ssh_init_tc(AMVP_KDF135_SSH_TC *stc,
  * a test case.
  */
 static AMVP_RESULT amvp_kdf135_ssh_release_tc(AMVP_KDF135_SSH_TC *stc) {
-    if (stc->shared_secret_k) free(stc->shared_secret_k);
-    if (stc->hash_h) free(stc->hash_h);
-    if (stc->session_id) free(stc->session_id);
-    if (stc->cs_init_iv) free(stc->cs_init_iv);
-    if (stc->sc_init_iv) free(stc->sc_init_iv);
-    if (stc->cs_encrypt_key) free(stc->cs_encrypt_key);
-    if (stc->sc_encrypt_key) free(stc->sc_encrypt_key);
-    if (stc->cs_integrity_key) free(stc->cs_integrity_key);
-    if (stc->sc_integrity_key) free(stc->sc_integrity_key);
+    if (stc->shared_secret_k) amvp_mem_free(AMVP_MEM_TC, stc->shared_secret_k);
+    if (stc->hash_h) amvp_mem_free(AMVP_MEM_TC, stc->hash_h);
+    if (stc->session_id) amvp_mem_free(AMVP_MEM_TC, stc->session_id);
+    if (stc->cs_init_iv) amvp_mem_free(AMVP_MEM_TC, stc->cs_init_iv);
+    if (stc->sc_init_iv) amvp_mem_free(AMVP_MEM_TC, stc->sc_init_iv);
+    if (stc->cs_encrypt_key) amvp_mem_free(AMVP_MEM_TC, stc->cs_encrypt_key);
+    if (stc->sc_encrypt_key) amvp_mem_free(AMVP_MEM_TC, stc->sc_encrypt_key);
+    if (stc->cs_integrity_key) amvp_mem_free(AMVP_MEM_TC, stc->cs_integrity_key);
+    if (stc->sc_integrity_key) amvp_mem_free(AMVP_MEM_TC, stc->sc_integrity_key);
 
     memzero_s(stc, sizeof(AMVP_KDF135_SSH_TC));
 
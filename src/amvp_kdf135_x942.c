@@ -55,13 +55,13 @@ err:
  * a test case.
  */
 static AMVP_RESULT amvp_kdf135_x942_release_tc(AMVP_KDF135_X942_TC *stc) {
-    if (stc->oid) free(stc->oid);
-    if (stc->zz) free(stc->zz);
-    if (stc->party_u_info) free(stc->party_u_info);
-    if (stc->party_v_info) free(stc->party_v_info);
-    if (stc->supp_pub_info) free(stc->supp_pub_info);
-    if (stc->supp_priv_info) free(stc->supp_priv_info);
-    if (stc->dkm) free(stc->dkm);
+    if (stc->oid) amvp_mem_free(AMVP_MEM_TC, stc->oid);
+    if (stc->zz) amvp_mem_free(AMVP_MEM_TC, stc->zz);
+    if (stc->party_u_info) amvp_mem_free(AMVP_MEM_TC, stc->party_u_info);
+    if (stc->party_v_info) amvp_mem_free(AMVP_MEM_TC, stc->party_v_info);
+    if (stc->supp_pub_info) amvp_mem_free(AMVP_MEM_TC, stc->supp_pub_info);
+    if (stc->supp_priv_info) amvp_mem_free(AMVP_MEM_TC, stc->supp_priv_info);
+    if (stc->dkm) amvp_mem_free(AMVP_MEM_TC, stc->dkm);
     memzero_s(stc, sizeof(AMVP_KDF135_X942_TC));
     return AMVP_SUCCESS;
 }
@@ -87,10 +87,10 @@ static AMVP_RESULT amvp_kdf135_x942_init_tc(AMVP_CTX *ctx,
     stc->key_len = key_len / 8;
     stc->type = type;
 
-    stc->dkm = calloc(AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
+    stc->dkm = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
     if (!stc->dkm) { return AMVP_MALLOC_FAIL; }
 
-    stc->oid = calloc(AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
+    stc->oid = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
     if (!stc->oid) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(oid, stc->oid, AMVP_KDF135_X942_BYTE_MAX, &stc->oid_len);
     if (rv != AMVP_SUCCESS) {
@@ -98,7 +98,7 @@ static AMVP_RESULT amvp_kdf135_x942_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->zz = calloc(AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
+    stc->zz = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
     if (!stc->zz) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(zz, stc->zz, AMVP_KDF135_X942_BYTE_MAX, &stc->zz_len);
     if (rv != AMVP_SUCCESS) {
@@ -106,7 +106,7 @@ static AMVP_RESULT amvp_kdf135_x942_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->party_u_info = calloc(AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
+    stc->party_u_info = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
     if (!stc->party_u_info) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(party_u_info, stc->party_u_info, AMVP_KDF135_X942_BYTE_MAX, &stc->party_u_len);
     if (rv != AMVP_SUCCESS) {
@@ -114,7 +114,7 @@ static AMVP_RESULT amvp_kdf135_x942_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->party_v_info = calloc(AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
+    stc->party_v_info = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
     if (!stc->party_v_info) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(party_v_info, stc->party_v_info, AMVP_KDF135_X942_BYTE_MAX, &stc->party_v_len);
     if (rv != AMVP_SUCCESS) {
@@ -122,7 +122,7 @@ static AMVP_RESULT amvp_kdf135_x942_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->supp_pub_info = calloc(AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
+    stc->supp_pub_info = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
     if (!stc->supp_pub_info) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(supp_pub_info, stc->supp_pub_info, AMVP_KDF135_X942_BYTE_MAX, &stc->supp_pub_len);
     if (rv != AMVP_SUCCESS) {
@@ -130,7 +130,7 @@ static AMVP_RESULT amvp_kdf135_x942_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->supp_priv_info = calloc(AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
+    stc->supp_priv_info = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_X942_BYTE_MAX, sizeof(unsigned char));
     if (!stc->supp_priv_info) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(supp_priv_info, stc->supp_priv_info, AMVP_KDF135_X942_BYTE_MAX, &stc->supp_priv_len);
     if (rv != AMVP_SUCCESS) {
@@ -161,7 +161,7 @@ AMVP_RESULT amvp_kdf135_x942_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     AMVP_CAPS_LIST *cap;
     AMVP_KDF135_X942_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     int tc_id = 0, i = 0, g_cnt = 0, j = 0, t_cnt = 0, diff = 0, len = 0, key_len = 0;
     const char *alg_str = NULL, *mode_str = NULL, *kdf_type_str = NULL, *oid = NULL, *party_u = NULL,
@@ -252,6 +252,7 @@ AMVP_RESULT amvp_kdf135_x942_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -440,7 +441,7 @@ AMVP_RESULT amvp_kdf135_x942_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the KDF X942 operation");
                 amvp_kdf135_x942_release_tc(&stc);
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -471,7 +472,7 @@ AMVP_RESULT amvp_kdf135_x942_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
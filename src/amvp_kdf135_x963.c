@@ -49,9 +49,9 @@ err:
  * a test case.
  */
 static AMVP_RESULT amvp_kdf135_x963_release_tc(AMVP_KDF135_X963_TC *stc) {
-    if (stc->z) free(stc->z);
-    if (stc->shared_info) free(stc->shared_info);
-    if (stc->key_data) free(stc->key_data);
+    if (stc->z) amvp_mem_free(AMVP_MEM_TC, stc->z);
+    if (stc->shared_info) amvp_mem_free(AMVP_MEM_TC, stc->shared_info);
+    if (stc->key_data) amvp_mem_free(AMVP_MEM_TC, stc->key_data);
     memzero_s(stc, sizeof(AMVP_KDF135_X963_TC));
     return AMVP_SUCCESS;
 }
@@ -80,7 +80,7 @@ static AMVP_RESULT amvp_kdf135_x963_init_tc(AMVP_CTX *ctx,
     stc->key_data_len = key_data_length / 8;
     stc->shared_info_len = shared_info_length / 8;
 
-    stc->z = calloc(AMVP_KDF135_X963_INPUT_MAX, sizeof(char));
+    stc->z = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_X963_INPUT_MAX, sizeof(char));
     if (!stc->z) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(z, stc->z, AMVP_KDF135_X963_INPUT_MAX, &stc->z_len);
     if (rv != AMVP_SUCCESS) {
@@ -88,7 +88,7 @@ static AMVP_RESULT amvp_kdf135_x963_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->shared_info = calloc(AMVP_KDF135_X963_INPUT_MAX, sizeof(char));
+    stc->shared_info = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_X963_INPUT_MAX, sizeof(char));
     if (!stc->shared_info) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(shared_info, stc->shared_info, AMVP_KDF135_X963_INPUT_MAX, NULL);
     if (rv != AMVP_SUCCESS) {
@@ -96,7 +96,7 @@ static AMVP_RESULT amvp_kdf135_x963_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->key_data = calloc(AMVP_KDF135_X963_KEYDATA_MAX_BYTES, sizeof(char));
+    stc->key_data = amvp_mem_calloc(AMVP_MEM_TC, AMVP_KDF135_X963_KEYDATA_MAX_BYTES, sizeof(char));
     if (!stc->key_data) { return AMVP_MALLOC_FAIL; }
 
     return AMVP_SUCCESS;
@@ -125,7 +125,7 @@ AMVP_RESULT amvp_kdf135_x963_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
     AMVP_KDF135_X963_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = NULL;
     const char *mode_str = NULL;
@@ -217,6 +217,7 @@ AMVP_RESULT amvp_kdf135_x963_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -327,7 +328,7 @@ AMVP_RESULT amvp_kdf135_x963_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the KDF SSH operation");
                 amvp_kdf135_x963_release_tc(&stc);
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -358,7 +359,7 @@ AMVP_RESULT amvp_kdf135_x963_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
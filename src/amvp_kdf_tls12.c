@@ -59,7 +59,7 @@ AMVP_RESULT amvp_kdf_tls12_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
     AMVP_KDF_TLS12_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     const char *mode_str = NULL;
@@ -138,6 +138,7 @@ AMVP_RESULT amvp_kdf_tls12_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -251,7 +252,7 @@ AMVP_RESULT amvp_kdf_tls12_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 amvp_kdf_tls12_release_tc(&stc);
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -283,7 +284,7 @@ AMVP_RESULT amvp_kdf_tls12_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -347,7 +348,7 @@ static AMVP_RESULT amvp_kdf_tls12_init_tc(AMVP_CTX *ctx,
 
     memzero_s(stc, sizeof(AMVP_KDF_TLS12_TC));
 
-    stc->pm_secret = calloc(1, AMVP_KDF_TLS12_MSG_MAX);
+    stc->pm_secret = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS12_MSG_MAX);
     if (!stc->pm_secret) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(pm_secret, stc->pm_secret, AMVP_KDF_TLS12_MSG_MAX, NULL);
     if (rv != AMVP_SUCCESS) {
@@ -355,7 +356,7 @@ static AMVP_RESULT amvp_kdf_tls12_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->session_hash = calloc(1, AMVP_KDF_TLS12_MSG_MAX);
+    stc->session_hash = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS12_MSG_MAX);
     if (!stc->session_hash) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(session_hash, stc->session_hash, AMVP_KDF_TLS12_MSG_MAX, &(stc->session_hash_len));
     if (rv != AMVP_SUCCESS) {
@@ -363,7 +364,7 @@ static AMVP_RESULT amvp_kdf_tls12_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->c_rnd = calloc(1, AMVP_KDF_TLS12_MSG_MAX);
+    stc->c_rnd = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS12_MSG_MAX);
     if (!stc->c_rnd) { return AMVP_MALLOC_FAIL; }
 
     rv = amvp_hexstr_to_bin(c_rnd, stc->c_rnd, AMVP_KDF_TLS12_MSG_MAX, &(stc->c_rnd_len));
@@ -372,7 +373,7 @@ static AMVP_RESULT amvp_kdf_tls12_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->s_rnd = calloc(1, AMVP_KDF_TLS12_MSG_MAX);
+    stc->s_rnd = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS12_MSG_MAX);
     if (!stc->s_rnd) { return AMVP_MALLOC_FAIL; }
 
     rv = amvp_hexstr_to_bin(s_rnd, stc->s_rnd, AMVP_KDF_TLS12_MSG_MAX, &(stc->s_rnd_len));
@@ -381,9 +382,9 @@ static AMVP_RESULT amvp_kdf_tls12_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->msecret = calloc(1, AMVP_KDF_TLS12_MSG_MAX);
+    stc->msecret = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS12_MSG_MAX);
     if (!stc->msecret) { return AMVP_MALLOC_FAIL; }
-    stc->kblock = calloc(1, AMVP_KDF_TLS12_MSG_MAX);
+    stc->kblock = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS12_MSG_MAX);
     if (!stc->kblock) { return AMVP_MALLOC_FAIL; }
 
     stc->tc_id = tc_id;
@@ -400,12 +401,12 @@ static AMVP_RESULT amvp_kdf_tls12_init_tc(AMVP_CTX *ctx,
  * a test case.
  */
 static AMVP_RESULT amvp_kdf_tls12_release_tc(AMVP_KDF_TLS12_TC *stc) {
-    if (stc->pm_secret) free(stc->pm_secret);
-    if (stc->session_hash) free(stc->session_hash);
-    if (stc->c_rnd) free(stc->c_rnd);
-    if (stc->s_rnd) free(stc->s_rnd);
-    if (stc->msecret) free(stc->msecret);
-    if (stc->kblock) free(stc->kblock);
+    if (stc->pm_secret) amvp_mem_free(AMVP_MEM_TC, stc->pm_secret);
+    if (stc->session_hash) amvp_mem_free(AMVP_MEM_TC, stc->session_hash);
+    if (stc->c_rnd) amvp_mem_free(AMVP_MEM_TC, stc->c_rnd);
+    if (stc->s_rnd) amvp_mem_free(AMVP_MEM_TC, stc->s_rnd);
+    if (stc->msecret) amvp_mem_free(AMVP_MEM_TC, stc->msecret);
+    if (stc->kblock) amvp_mem_free(AMVP_MEM_TC, stc->kblock);
 
     memzero_s(stc, sizeof(AMVP_KDF_TLS12_TC));
     return AMVP_SUCCESS;
@@ -85,7 +85,7 @@ AMVP_RESULT amvp_kdf_tls13_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
     AMVP_KDF_TLS13_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     const char *mode_str = NULL;
@@ -163,6 +163,7 @@ AMVP_RESULT amvp_kdf_tls13_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -317,7 +318,7 @@ AMVP_RESULT amvp_kdf_tls13_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 amvp_kdf_tls13_release_tc(&stc);
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -349,7 +350,7 @@ AMVP_RESULT amvp_kdf_tls13_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -519,7 +520,7 @@ static AMVP_RESULT amvp_kdf_tls13_init_tc(AMVP_CTX *ctx,
     stc->running_mode = run_mode;
     stc->hmac_alg = hmac;
 
-    stc->psk = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->psk = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->psk) { return AMVP_MALLOC_FAIL; }
     if (psk) {
         rv = amvp_hexstr_to_bin(psk, stc->psk, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX, &(stc->psk_len));
@@ -529,7 +530,7 @@ static AMVP_RESULT amvp_kdf_tls13_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->dhe = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->dhe = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->dhe) { return AMVP_MALLOC_FAIL; }
     if (dhe) {
         rv = amvp_hexstr_to_bin(dhe, stc->dhe, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX, &(stc->dhe_len));
@@ -540,7 +541,7 @@ static AMVP_RESULT amvp_kdf_tls13_init_tc(AMVP_CTX *ctx,
     }
 
 
-    stc->c_hello_rand = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->c_hello_rand = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->c_hello_rand) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(c_hello_rand, stc->c_hello_rand, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX, &(stc->c_hello_rand_len));
     if (rv != AMVP_SUCCESS) {
@@ -548,7 +549,7 @@ static AMVP_RESULT amvp_kdf_tls13_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->s_hello_rand = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->s_hello_rand = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->s_hello_rand) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(s_hello_rand, stc->s_hello_rand, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX, &(stc->s_hello_rand_len));
     if (rv != AMVP_SUCCESS) {
@@ -556,7 +557,7 @@ static AMVP_RESULT amvp_kdf_tls13_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->fin_c_hello_rand = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->fin_c_hello_rand = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->fin_c_hello_rand) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(fin_c_hello_rand, stc->fin_c_hello_rand, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX, &(stc->fin_c_hello_rand_len));
     if (rv != AMVP_SUCCESS) {
@@ -564,7 +565,7 @@ static AMVP_RESULT amvp_kdf_tls13_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->fin_s_hello_rand = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->fin_s_hello_rand = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->fin_s_hello_rand) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(fin_s_hello_rand, stc->fin_s_hello_rand, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX, &(stc->fin_s_hello_rand_len));
     if (rv != AMVP_SUCCESS) {
@@ -572,21 +573,21 @@ static AMVP_RESULT amvp_kdf_tls13_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->c_early_traffic_secret = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->c_early_traffic_secret = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->c_early_traffic_secret) { return AMVP_MALLOC_FAIL; }
-    stc->early_expt_master_secret = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->early_expt_master_secret = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->early_expt_master_secret) { return AMVP_MALLOC_FAIL; }
-    stc->c_hs_traffic_secret = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->c_hs_traffic_secret = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->c_hs_traffic_secret) { return AMVP_MALLOC_FAIL; }
-    stc->s_hs_traffic_secret = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->s_hs_traffic_secret = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->s_hs_traffic_secret) { return AMVP_MALLOC_FAIL; }
-    stc->c_app_traffic_secret = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->c_app_traffic_secret = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->c_app_traffic_secret) { return AMVP_MALLOC_FAIL; }
-    stc->s_app_traffic_secret = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->s_app_traffic_secret = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->s_app_traffic_secret) { return AMVP_MALLOC_FAIL; }
-    stc->expt_master_secret = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->expt_master_secret = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->expt_master_secret) { return AMVP_MALLOC_FAIL; }
-    stc->resume_master_secret = calloc(1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
+    stc->resume_master_secret = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KDF_TLS13_DATA_LEN_BYTE_MAX);
     if (!stc->resume_master_secret) { return AMVP_MALLOC_FAIL; }
 
     return AMVP_SUCCESS;
@@ -597,20 +598,20 @@ static AMVP_RESULT amvp_kdf_tls13_init_tc(AMVP_CTX *ctx,
  * a test case.
  */
 static AMVP_RESULT amvp_kdf_tls13_release_tc(AMVP_KDF_TLS13_TC *stc) {
-    if (stc->psk) free(stc->psk);
-    if (stc->dhe) free(stc->dhe);
-    if (stc->c_hello_rand) free(stc->c_hello_rand);
-    if (stc->s_hello_rand) free(stc->s_hello_rand);
-    if (stc->fin_c_hello_rand) free(stc->fin_c_hello_rand);
-    if (stc->fin_s_hello_rand) free(stc->fin_s_hello_rand);
-    if (stc->c_early_traffic_secret) free(stc->c_early_traffic_secret);
-    if (stc->early_expt_master_secret) free(stc->early_expt_master_secret);
-    if (stc->c_hs_traffic_secret) free(stc->c_hs_traffic_secret);
-    if (stc->s_hs_traffic_secret) free(stc->s_hs_traffic_secret);
-    if (stc->c_app_traffic_secret) free(stc->c_app_traffic_secret);
-    if (stc->s_app_traffic_secret) free(stc->s_app_traffic_secret);
-    if (stc->expt_master_secret) free(stc->expt_master_secret);
-    if (stc->resume_master_secret) free(stc->resume_master_secret);
+    if (stc->psk) amvp_mem_free(AMVP_MEM_TC, stc->psk);
+    if (stc->dhe) amvp_mem_free(AMVP_MEM_TC, stc->dhe);
+    if (stc->c_hello_rand) amvp_mem_free(AMVP_MEM_TC, stc->c_hello_rand);
+    if (stc->s_hello_rand) amvp_mem_free(AMVP_MEM_TC, stc->s_hello_rand);
+    if (stc->fin_c_hello_rand) amvp_mem_free(AMVP_MEM_TC, stc->fin_c_hello_rand);
+    if (stc->fin_s_hello_rand) amvp_mem_free(AMVP_MEM_TC, stc->fin_s_hello_rand);
+    if (stc->c_early_traffic_secret) amvp_mem_free(AMVP_MEM_TC, stc->c_early_traffic_secret);
+    if (stc->early_expt_master_secret) amvp_mem_free(AMVP_MEM_TC, stc->early_expt_master_secret);
+    if (stc->c_hs_traffic_secret) amvp_mem_free(AMVP_MEM_TC, stc->c_hs_traffic_secret);
+    if (stc->s_hs_traffic_secret) amvp_mem_free(AMVP_MEM_TC, stc->s_hs_traffic_secret);
+    if (stc->c_app_traffic_secret) amvp_mem_free(AMVP_MEM_TC, stc->c_app_traffic_secret);
+    if (stc->s_app_traffic_secret) amvp_mem_free(AMVP_MEM_TC, stc->s_app_traffic_secret);
+    if (stc->expt_master_secret) amvp_mem_free(AMVP_MEM_TC, stc->expt_master_secret);
+    if (stc->resume_master_secret) amvp_mem_free(AMVP_MEM_TC, stc->resume_master_secret);
 
     memzero_s(stc, sizeof(AMVP_KDF_TLS13_TC));
     return AMVP_SUCCESS;
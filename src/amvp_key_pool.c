@@ -0,0 +1,355 @@
+/** @file */
+/*
+ * Copyright (c) 2021, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libamvp/LICENSE
+ */
+
+/*
+ * SigGen key pre-generation pool.
+ *
+ * RSA, ECDSA and DSA SigGen test groups each need a fresh key pair, and
+ * generating it is by far the slowest step of those vector sets. The
+ * registered capabilities already tell us every modulus, curve and L/N pair
+ * the server can ask for, so once registration is done a few worker threads
+ * call the capability's key_gen handler for each of them and keep up to
+ * ctx->key_pregen_depth keys ready per parameter set. amvp_group_begin() then
+ * takes a key from the pool, or generates one on demand if none is ready.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#include "amvp.h"
+#include "amvp_lcl.h"
+#include "safe_lib.h"
+
+/*
+ * One slot per distinct key parameter set of a capability
+ */
+typedef struct amvp_key_pool_slot_t {
+    AMVP_CAPS_LIST *cap;
+    AMVP_TEST_GROUP params;  /* cipher and key parameters only */
+    void *keys[AMVP_KEY_PREGEN_DEPTH_MAX];
+    int ready;               /* number of keys in keys[] */
+    int pending;             /* number of keys being generated */
+    int failed;              /* key_gen failed, stop pre-generating */
+    struct amvp_key_pool_slot_t *next;
+} AMVP_KEY_POOL_SLOT;
+
+struct amvp_key_pool_t {
+    AMVP_KEY_POOL_SLOT *slots;
+    int depth;
+#ifndef _WIN32
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond;   /* a slot needs a key, or stop was set */
+    pthread_cond_t ready_cond;  /* a key generation finished */
+    pthread_t threads[AMVP_KEY_PREGEN_THREADS_MAX];
+    int thread_cnt;
+    int stop;
+#endif
+};
+
+static int amvp_key_params_match(AMVP_TEST_GROUP *a, AMVP_TEST_GROUP *b) {
+    return a->cipher == b->cipher && a->modulo == b->modulo && a->curve == b->curve &&
+           a->l == b->l && a->n == b->n;
+}
+
+static AMVP_KEY_POOL_SLOT *amvp_key_pool_find(struct amvp_key_pool_t *pool, AMVP_TEST_GROUP *params) {
+    AMVP_KEY_POOL_SLOT *slot = pool->slots;
+
+    while (slot) {
+        if (amvp_key_params_match(&slot->params, params)) {
+            return slot;
+        }
+        slot = slot->next;
+    }
+    return NULL;
+}
+
+static AMVP_RESULT amvp_key_pool_add(struct amvp_key_pool_t *pool,
+                                     AMVP_CAPS_LIST *cap,
+                                     AMVP_TEST_GROUP *params) {
+    AMVP_KEY_POOL_SLOT *slot = NULL;
+
+    if (amvp_key_pool_find(pool, params)) {
+        return AMVP_SUCCESS;
+    }
+    slot = calloc(1, sizeof(AMVP_KEY_POOL_SLOT));
+    if (!slot) {
+        return AMVP_MALLOC_FAIL;
+    }
+    slot->cap = cap;
+    slot->params = *params;
+    slot->next = pool->slots;
+    pool->slots = slot;
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Add a slot for every key parameter set registered for a SigGen capability
+ */
+static AMVP_RESULT amvp_key_pool_add_cap(struct amvp_key_pool_t *pool, AMVP_CAPS_LIST *cap) {
+    AMVP_TEST_GROUP params;
+    AMVP_RSA_SIG_CAP *rsa_cap = NULL;
+    AMVP_RSA_MODE_CAPS_LIST *rsa_mode = NULL;
+    AMVP_CURVE_ALG_COMPAT_LIST *curve = NULL;
+    AMVP_DSA_ATTRS *attrs = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    memzero_s(&params, sizeof(AMVP_TEST_GROUP));
+    params.cipher = cap->cipher;
+
+    switch (cap->cipher) {
+    case AMVP_RSA_SIGGEN:
+        for (rsa_cap = cap->cap.rsa_siggen_cap; rsa_cap; rsa_cap = rsa_cap->next) {
+            for (rsa_mode = rsa_cap->mode_capabilities; rsa_mode; rsa_mode = rsa_mode->next) {
+                params.modulo = rsa_mode->modulo;
+                rv = amvp_key_pool_add(pool, cap, &params);
+                if (rv != AMVP_SUCCESS) return rv;
+            }
+        }
+        break;
+    case AMVP_ECDSA_SIGGEN:
+        for (curve = cap->cap.ecdsa_siggen_cap->curves; curve; curve = curve->next) {
+            params.curve = curve->curve;
+            rv = amvp_key_pool_add(pool, cap, &params);
+            if (rv != AMVP_SUCCESS) return rv;
+        }
+        break;
+    case AMVP_DSA_SIGGEN:
+        attrs = cap->cap.dsa_cap->dsa_cap_mode[AMVP_DSA_MODE_SIGGEN - 1].dsa_attrs;
+        for (; attrs; attrs = attrs->next) {
+            switch (attrs->modulo) {
+            case AMVP_DSA_LN1024_160:
+                params.l = 1024;
+                params.n = 160;
+                break;
+            case AMVP_DSA_LN2048_224:
+                params.l = 2048;
+                params.n = 224;
+                break;
+            case AMVP_DSA_LN2048_256:
+                params.l = 2048;
+                params.n = 256;
+                break;
+            case AMVP_DSA_LN3072_256:
+                params.l = 3072;
+                params.n = 256;
+                break;
+            default:
+                continue;
+            }
+            rv = amvp_key_pool_add(pool, cap, &params);
+            if (rv != AMVP_SUCCESS) return rv;
+        }
+        break;
+    default:
+        break;
+    }
+    return rv;
+}
+
+/*
+ * Generate a key for the parameters in group using the capability's key_gen
+ * handler. The key is left in group->key.
+ */
+static int amvp_key_generate(AMVP_CAPS_LIST *cap, AMVP_TEST_GROUP *group) {
+    group->key = NULL;
+    if ((cap->key_gen)(group)) {
+        return 1;
+    }
+    return group->key ? 0 : 1;
+}
+
+static void amvp_key_pool_free_slots(struct amvp_key_pool_t *pool) {
+    AMVP_KEY_POOL_SLOT *slot = pool->slots, *next = NULL;
+
+    while (slot) {
+        next = slot->next;
+        while (slot->ready) {
+            (slot->cap->key_free)(slot->keys[--slot->ready]);
+        }
+        free(slot);
+        slot = next;
+    }
+    pool->slots = NULL;
+}
+
+#ifndef _WIN32
+static void *amvp_key_pool_worker(void *arg) {
+    struct amvp_key_pool_t *pool = arg;
+    AMVP_KEY_POOL_SLOT *slot = NULL;
+    AMVP_TEST_GROUP group;
+    int rc = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stop) {
+        for (slot = pool->slots; slot; slot = slot->next) {
+            if (!slot->failed && slot->ready + slot->pending < pool->depth) {
+                break;
+            }
+        }
+        if (!slot) {
+            pthread_cond_wait(&pool->work_cond, &pool->lock);
+            continue;
+        }
+        slot->pending++;
+        pthread_mutex_unlock(&pool->lock);
+
+        group = slot->params;
+        rc = amvp_key_generate(slot->cap, &group);
+
+        pthread_mutex_lock(&pool->lock);
+        slot->pending--;
+        if (rc) {
+            slot->failed = 1;
+        } else {
+            slot->keys[slot->ready++] = group.key;
+        }
+        pthread_cond_broadcast(&pool->ready_cond);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+#endif
+
+/*
+ * Build the key pool from the registered SigGen capabilities and start the
+ * worker threads. Called right after registration; a no-op when background
+ * key generation is disabled or no capability has a key_gen handler.
+ */
+AMVP_RESULT amvp_key_pool_start(AMVP_CTX *ctx) {
+#ifdef _WIN32
+    return AMVP_SUCCESS;
+#else
+    struct amvp_key_pool_t *pool = NULL;
+    AMVP_CAPS_LIST *cap = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int i = 0;
+
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (ctx->key_pool || ctx->key_pregen_threads <= 0) {
+        return AMVP_SUCCESS;
+    }
+
+    pool = calloc(1, sizeof(struct amvp_key_pool_t));
+    if (!pool) {
+        return AMVP_MALLOC_FAIL;
+    }
+    pool->depth = ctx->key_pregen_depth > 0 ? ctx->key_pregen_depth : 1;
+
+    for (cap = ctx->caps_list; cap; cap = cap->next) {
+        if (!cap->key_gen) {
+            continue;
+        }
+        rv = amvp_key_pool_add_cap(pool, cap);
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("Failed to build key pre-generation pool");
+            goto err;
+        }
+    }
+    if (!pool->slots) {
+        free(pool);
+        return AMVP_SUCCESS;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->ready_cond, NULL);
+    ctx->key_pool = pool;
+
+    for (i = 0; i < ctx->key_pregen_threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, amvp_key_pool_worker, pool)) {
+            AMVP_LOG_WARN("Unable to start key pre-generation thread, continuing with %d", i);
+            break;
+        }
+        pool->thread_cnt++;
+    }
+    AMVP_LOG_STATUS("Pre-generating SigGen keys on %d thread(s)", pool->thread_cnt);
+    return AMVP_SUCCESS;
+
+err:
+    amvp_key_pool_free_slots(pool);
+    free(pool);
+    return rv;
+#endif
+}
+
+/*
+ * Get the key for a SigGen test group. A pre-generated key is used when one is
+ * ready, or about to be; otherwise the key is generated on the calling thread.
+ */
+AMVP_RESULT amvp_key_pool_take(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_GROUP *group) {
+    struct amvp_key_pool_t *pool = ctx->key_pool;
+    AMVP_KEY_POOL_SLOT *slot = NULL;
+
+    group->key = NULL;
+#ifndef _WIN32
+    if (pool) {
+        pthread_mutex_lock(&pool->lock);
+        slot = amvp_key_pool_find(pool, group);
+        if (slot) {
+            while (!slot->ready && slot->pending) {
+                pthread_cond_wait(&pool->ready_cond, &pool->lock);
+            }
+            if (slot->ready) {
+                group->key = slot->keys[--slot->ready];
+                /* Let a worker replace the key we just took */
+                pthread_cond_signal(&pool->work_cond);
+            }
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+#endif
+    if (group->key) {
+        AMVP_LOG_VERBOSE("Using pre-generated key for test group %u", group->tg_id);
+        return AMVP_SUCCESS;
+    }
+
+    if (amvp_key_generate(cap, group)) {
+        AMVP_LOG_ERR("crypto module failed to generate key for test group %u", group->tg_id);
+        return AMVP_CRYPTO_MODULE_FAIL;
+    }
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Stop the worker threads and release any keys that were never used
+ */
+void amvp_key_pool_free(AMVP_CTX *ctx) {
+    struct amvp_key_pool_t *pool = NULL;
+#ifndef _WIN32
+    int i = 0;
+#endif
+
+    if (!ctx || !ctx->key_pool) {
+        return;
+    }
+    pool = ctx->key_pool;
+
+#ifndef _WIN32
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+    for (i = 0; i < pool->thread_cnt; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_cond_destroy(&pool->ready_cond);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_mutex_destroy(&pool->lock);
+#endif
+
+    amvp_key_pool_free_slots(pool);
+    free(pool);
+    ctx->key_pool = NULL;
+}
@@ -36,17 +36,17 @@ static AMVP_RESULT amvp_kmac_init_tc(AMVP_CTX *ctx,
     int len = 0;
     memzero_s(stc, sizeof(AMVP_KMAC_TC));
 
-    stc->msg = calloc(1, AMVP_KMAC_MSG_BYTE_MAX);
+    stc->msg = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KMAC_MSG_BYTE_MAX);
     if (!stc->msg) { return AMVP_MALLOC_FAIL; }
-    stc->mac = calloc(1, AMVP_KMAC_MAC_BYTE_MAX);
+    stc->mac = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KMAC_MAC_BYTE_MAX);
     if (!stc->mac) { return AMVP_MALLOC_FAIL; }
-    stc->key = calloc(1, AMVP_KMAC_KEY_BYTE_MAX);
+    stc->key = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KMAC_KEY_BYTE_MAX);
     if (!stc->key) { return AMVP_MALLOC_FAIL; }
     if (hex_customization) {
-        stc->custom_hex = calloc(1, AMVP_KMAC_CUSTOM_HEX_BYTE_MAX);
+        stc->custom_hex = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KMAC_CUSTOM_HEX_BYTE_MAX);
         if (!stc->custom_hex) { return AMVP_MALLOC_FAIL; }
     } else {
-        stc->custom = calloc(1, AMVP_KMAC_CUSTOM_STR_MAX);
+        stc->custom = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KMAC_CUSTOM_STR_MAX);
         if (!stc->custom) { return AMVP_MALLOC_FAIL; }
     }
 
@@ -138,11 +138,11 @@ end:
  * a test case.
  */
 static AMVP_RESULT amvp_kmac_release_tc(AMVP_KMAC_TC *stc) {
-    if (stc->msg) free(stc->msg);
-    if (stc->mac) free(stc->mac);
-    if (stc->key) free(stc->key);
-    if (stc->custom) free(stc->custom);
-    if (stc->custom_hex) free(stc->custom_hex);
+    if (stc->msg) amvp_mem_free(AMVP_MEM_TC, stc->msg);
+    if (stc->mac) amvp_mem_free(AMVP_MEM_TC, stc->mac);
+    if (stc->key) amvp_mem_free(AMVP_MEM_TC, stc->key);
+    if (stc->custom) amvp_mem_free(AMVP_MEM_TC, stc->custom);
+    if (stc->custom_hex) amvp_mem_free(AMVP_MEM_TC, stc->custom_hex);
     memzero_s(stc, sizeof(AMVP_KMAC_TC));
 
     return AMVP_SUCCESS;
@@ -160,6 +160,25 @@ static AMVP_KMAC_TESTTYPE read_test_type(const char *str) {
     return 0;
 }
 
+/*
+ * Batch adapters so queued KMAC test cases can be output and released
+ * through the common batch helpers.
+ */
+static AMVP_RESULT amvp_kmac_batch_output_tc(AMVP_CTX *ctx,
+                                             AMVP_TEST_CASE *tc,
+                                             JSON_Object *r_tobj,
+                                             int tc_rv) {
+    if (tc_rv) {
+        AMVP_LOG_ERR("ERROR: crypto module failed the operation");
+        return AMVP_CRYPTO_MODULE_FAIL;
+    }
+    return amvp_kmac_output_tc(ctx, tc->tc.kmac, r_tobj);
+}
+
+static void amvp_kmac_batch_release_tc(AMVP_TEST_CASE *tc) {
+    amvp_kmac_release_tc(tc->tc.kmac);
+}
+
 AMVP_RESULT amvp_kmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     int tc_id = 0, msglen = 0, keylen = 0, maclen = 0;
     const char *msg = NULL, *key = NULL, *mac = NULL, *type_str = NULL, *custom = NULL;
@@ -184,9 +203,12 @@ AMVP_RESULT amvp_kmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
-    AMVP_CAPS_LIST *cap;
+    AMVP_CAPS_LIST *cap = NULL;
     AMVP_KMAC_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
+    AMVP_TEST_GROUP group = { 0 };
+    AMVP_KMAC_TC *batch_stc = NULL;
+    AMVP_TC_BATCH batch;
     AMVP_RESULT rv;
     const char *alg_str = json_object_get_string(obj, "algorithm");
     AMVP_CIPHER alg_id;
@@ -209,6 +231,7 @@ AMVP_RESULT amvp_kmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     /* Get a reference to the abstracted test case */
     tc.tc.kmac = &stc;
+    tc.group = &group;
 
     /* Get the crypto module handler for this kmac algorithm */
     alg_id = amvp_lookup_cipher_index(alg_str);
@@ -240,6 +263,16 @@ AMVP_RESULT amvp_kmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         return rv;
     }
 
+    amvp_tc_batch_init(&batch, &amvp_kmac_batch_output_tc, &amvp_kmac_batch_release_tc);
+    if (cap->batch_handler) {
+        batch_stc = calloc(AMVP_BATCH_TC_MAX, sizeof(AMVP_KMAC_TC));
+        if (!batch_stc) {
+            AMVP_LOG_ERR("Unable to malloc batch test cases");
+            rv = AMVP_MALLOC_FAIL;
+            goto err;
+        }
+    }
+
     groups = json_object_get_array(obj, "testGroups");
     if (!groups) {
         AMVP_LOG_ERR("Failed to include testGroups. ");
@@ -259,6 +292,7 @@ AMVP_RESULT amvp_kmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -289,6 +323,17 @@ AMVP_RESULT amvp_kmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         AMVP_LOG_VERBOSE("           xof: %d", xof);
         AMVP_LOG_VERBOSE("     hexCustom: %d", hex_customization);
 
+        /*
+         * Let the crypto module set up any state shared by the group
+         */
+        group.cipher = alg_id;
+        group.tg_id = tgId;
+        group.test_type = type_str;
+        rv = amvp_group_begin(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+
         tests = json_object_get_array(groupobj, "tests");
         if (!tests) {
             AMVP_LOG_ERR("Failed to include tests. ");
@@ -415,6 +460,34 @@ AMVP_RESULT amvp_kmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
             json_object_set_number(r_tobj, "tcId", tc_id);
 
+            if (cap->batch_handler) {
+                /*
+                 * Queue the test case for the crypto module's batch handler,
+                 * the results are output once the batch is flushed.
+                 */
+                AMVP_KMAC_TC *bstc = &batch_stc[batch.count];
+
+                rv = amvp_kmac_init_tc(ctx, bstc, alg_id, tc_id, type, xof, hex_customization,
+                                         msg, msglen, mac, maclen, key, keylen, custom);
+                if (rv != AMVP_SUCCESS) {
+                    AMVP_LOG_ERR("Init for stc (test case) failed");
+                    amvp_kmac_release_tc(bstc);
+                    json_value_free(r_tval);
+                    goto err;
+                }
+                batch.tc[batch.count].tc.kmac = bstc;
+                batch.tc[batch.count].group = &group;
+                batch.r_tval[batch.count++] = r_tval;
+
+                if (batch.count == AMVP_BATCH_TC_MAX) {
+                    rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+                    if (rv != AMVP_SUCCESS) {
+                        goto err;
+                    }
+                }
+                continue;
+            }
+
             /*
              * Setup the test case data that will be passed down to
              * the crypto module.
@@ -429,7 +502,7 @@ AMVP_RESULT amvp_kmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("ERROR: crypto module failed the operation");
                 amvp_kmac_release_tc(&stc);
                 json_value_free(r_tval);
@@ -455,17 +528,30 @@ AMVP_RESULT amvp_kmac_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+
+        /* Process any test cases still waiting on the batch handler */
+        rv = amvp_tc_batch_flush(ctx, cap, &batch, r_tarr);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+        rv = amvp_group_end(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
 
 err:
+    amvp_group_end(ctx, cap, &group);
+    amvp_tc_batch_discard(&batch);
+    if (batch_stc) free(batch_stc);
     if (rv != AMVP_SUCCESS) {
         amvp_release_json(r_vs_val, r_gval);
     }
@@ -87,10 +87,10 @@ static AMVP_RESULT amvp_kts_ifc_init_tc(AMVP_CTX *ctx,
     stc->kts_role = role;
     stc->key_gen = key_gen;
 
-    stc->ct = calloc(1, AMVP_KTS_IFC_BYTE_MAX);
+    stc->ct = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KTS_IFC_BYTE_MAX);
     if (!stc->ct) { return AMVP_MALLOC_FAIL; }
 
-    stc->pt = calloc(1, AMVP_KTS_IFC_BYTE_MAX);
+    stc->pt = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KTS_IFC_BYTE_MAX);
     if (!stc->pt) { return AMVP_MALLOC_FAIL; }
 
     /* Both test types responder needs these */
@@ -101,7 +101,7 @@ static AMVP_RESULT amvp_kts_ifc_init_tc(AMVP_CTX *ctx,
             return rv;
         }
 
-        stc->p = calloc(1, AMVP_KTS_IFC_BYTE_MAX);
+        stc->p = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KTS_IFC_BYTE_MAX);
         if (!stc->p) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(p, stc->p, AMVP_KTS_IFC_BYTE_MAX, &(stc->plen));
         if (rv != AMVP_SUCCESS) {
@@ -109,7 +109,7 @@ static AMVP_RESULT amvp_kts_ifc_init_tc(AMVP_CTX *ctx,
             return rv;
         }
 
-        stc->q = calloc(1, AMVP_KTS_IFC_BYTE_MAX);
+        stc->q = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KTS_IFC_BYTE_MAX);
         if (!stc->q) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(q, stc->q, AMVP_KTS_IFC_BYTE_MAX, &(stc->qlen));
         if (rv != AMVP_SUCCESS) {
@@ -118,7 +118,7 @@ static AMVP_RESULT amvp_kts_ifc_init_tc(AMVP_CTX *ctx,
         }
 
         if (d) {
-            stc->d = calloc(1, AMVP_KTS_IFC_BYTE_MAX);
+            stc->d = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KTS_IFC_BYTE_MAX);
             if (!stc->d) { return AMVP_MALLOC_FAIL; }
             rv = amvp_hexstr_to_bin(d, stc->d, AMVP_KTS_IFC_BYTE_MAX, &(stc->dlen));
             if (rv != AMVP_SUCCESS) {
@@ -128,7 +128,7 @@ static AMVP_RESULT amvp_kts_ifc_init_tc(AMVP_CTX *ctx,
         }
 
         if (key_gen == AMVP_KTS_IFC_RSAKPG1_CRT || key_gen == AMVP_KTS_IFC_RSAKPG2_CRT) {
-            stc->dmp1 = calloc(1, AMVP_KTS_IFC_BYTE_MAX);
+            stc->dmp1 = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KTS_IFC_BYTE_MAX);
             if (!stc->dmp1) { return AMVP_MALLOC_FAIL; }
             rv = amvp_hexstr_to_bin(dmp1, stc->dmp1, AMVP_KTS_IFC_BYTE_MAX, &(stc->dmp1_len));
             if (rv != AMVP_SUCCESS) {
@@ -136,7 +136,7 @@ static AMVP_RESULT amvp_kts_ifc_init_tc(AMVP_CTX *ctx,
                 return rv;
             }
 
-            stc->dmq1 = calloc(1, AMVP_KTS_IFC_BYTE_MAX);
+            stc->dmq1 = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KTS_IFC_BYTE_MAX);
             if (!stc->dmq1) { return AMVP_MALLOC_FAIL; }
             rv = amvp_hexstr_to_bin(dmq1, stc->dmq1, AMVP_KTS_IFC_BYTE_MAX, &(stc->dmq1_len));
             if (rv != AMVP_SUCCESS) {
@@ -144,7 +144,7 @@ static AMVP_RESULT amvp_kts_ifc_init_tc(AMVP_CTX *ctx,
                 return rv;
             }
 
-            stc->iqmp = calloc(1, AMVP_KTS_IFC_BYTE_MAX);
+            stc->iqmp = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KTS_IFC_BYTE_MAX);
             if (!stc->iqmp) { return AMVP_MALLOC_FAIL; }
             rv = amvp_hexstr_to_bin(iqmp, stc->iqmp, AMVP_KTS_IFC_BYTE_MAX, &(stc->iqmp_len));
             if (rv != AMVP_SUCCESS) {
@@ -155,7 +155,7 @@ static AMVP_RESULT amvp_kts_ifc_init_tc(AMVP_CTX *ctx,
     }
 
     /* Both test types both roles needs these */
-    stc->n = calloc(1, AMVP_KTS_IFC_BYTE_MAX);
+    stc->n = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_KTS_IFC_BYTE_MAX);
     if (!stc->n) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(n, stc->n, AMVP_KTS_IFC_BYTE_MAX, &(stc->nlen));
     if (rv != AMVP_SUCCESS) {
@@ -163,7 +163,7 @@ static AMVP_RESULT amvp_kts_ifc_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->e = calloc(1, AMVP_RSA_EXP_LEN_MAX);
+    stc->e = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_RSA_EXP_LEN_MAX);
     if (!stc->e) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(e, stc->e, AMVP_RSA_EXP_LEN_MAX, &(stc->elen));
     if (rv != AMVP_SUCCESS) {
@@ -179,16 +179,16 @@ static AMVP_RESULT amvp_kts_ifc_init_tc(AMVP_CTX *ctx,
  * a test case.
  */
 static AMVP_RESULT amvp_kts_ifc_release_tc(AMVP_KTS_IFC_TC *stc) {
-    if (stc->p) free(stc->p);
-    if (stc->q) free(stc->q);
-    if (stc->d) free(stc->d);
-    if (stc->e) free(stc->e);
-    if (stc->n) free(stc->n);
-    if (stc->dmp1) free(stc->dmp1);
-    if (stc->dmq1) free(stc->dmq1);
-    if (stc->iqmp) free(stc->iqmp);
-    if (stc->ct) free(stc->ct);
-    if (stc->pt) free(stc->pt);
+    if (stc->p) amvp_mem_free(AMVP_MEM_TC, stc->p);
+    if (stc->q) amvp_mem_free(AMVP_MEM_TC, stc->q);
+    if (stc->d) amvp_mem_free(AMVP_MEM_TC, stc->d);
+    if (stc->e) amvp_mem_free(AMVP_MEM_TC, stc->e);
+    if (stc->n) amvp_mem_free(AMVP_MEM_TC, stc->n);
+    if (stc->dmp1) amvp_mem_free(AMVP_MEM_TC, stc->dmp1);
+    if (stc->dmq1) amvp_mem_free(AMVP_MEM_TC, stc->dmq1);
+    if (stc->iqmp) amvp_mem_free(AMVP_MEM_TC, stc->iqmp);
+    if (stc->ct) amvp_mem_free(AMVP_MEM_TC, stc->ct);
+    if (stc->pt) amvp_mem_free(AMVP_MEM_TC, stc->pt);
     memzero_s(stc, sizeof(AMVP_KTS_IFC_TC));
     return AMVP_SUCCESS;
 }
@@ -268,6 +268,7 @@ static AMVP_RESULT amvp_kts_ifc(AMVP_CTX *ctx,
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -593,8 +594,10 @@ static AMVP_RESULT amvp_kts_ifc(AMVP_CTX *ctx,
                 goto err;
             }
 
+            stc->tc_id = tc_id;
+
             /* Process the current KAT test vector... */
-            if ((cap->crypto_handler)(tc)) {
+            if (amvp_crypto_handler(ctx, cap, tc)) {
                 amvp_kts_ifc_release_tc(stc);
                 AMVP_LOG_ERR("crypto module failed the operation");
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -640,7 +643,7 @@ AMVP_RESULT amvp_kts_ifc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Array *reg_arry = NULL;
     JSON_Object *reg_obj = NULL;
     AMVP_CAPS_LIST *cap;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_KTS_IFC_TC stc;
     AMVP_RESULT rv = AMVP_SUCCESS;
     const char *alg_str = NULL;
@@ -692,7 +695,7 @@ AMVP_RESULT amvp_kts_ifc_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
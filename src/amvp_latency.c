@@ -0,0 +1,264 @@
+/** @file */
+/*
+ * Copyright (c) 2021, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libamvp/LICENSE
+ */
+
+/*
+ * Latency histograms of the crypto module's handlers.
+ *
+ * amvp_crypto_handler() and amvp_mct_handler() hand the time of every call
+ * into the module to amvp_latency_record(), which counts it in the histogram
+ * of the ctx's AMVP_VS_WORK and, with amvp_set_slow_tc_capture(), keeps the
+ * slowest test cases of the vector set. amvp_perf_flush() calls amvp_latency_flush() once
+ * per vector set to add them to the session's histogram of the algorithm, so
+ * vector set workers only take the lock that often.
+ *
+ * The histograms are log-linear, like HdrHistogram with one significant
+ * digit in base 2: values below 1 << AMVP_LATENCY_SUB_BITS ns have a bucket
+ * each, above that every power of two is split in as many buckets, so any
+ * value is known within 1/16 of itself.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
+#include "amvp.h"
+#include "amvp_lcl.h"
+#include "safe_lib.h"
+
+#define AMVP_LATENCY_SUB_COUNT (1 << AMVP_LATENCY_SUB_BITS)
+
+/* Serializes adding vector set workers' histograms to the session's */
+#ifdef _WIN32
+static SRWLOCK amvp_latency_lock = SRWLOCK_INIT;
+#define amvp_latency_lock_acquire() AcquireSRWLockExclusive(&amvp_latency_lock)
+#define amvp_latency_lock_release() ReleaseSRWLockExclusive(&amvp_latency_lock)
+#else
+static pthread_mutex_t amvp_latency_lock = PTHREAD_MUTEX_INITIALIZER;
+#define amvp_latency_lock_acquire() pthread_mutex_lock(&amvp_latency_lock)
+#define amvp_latency_lock_release() pthread_mutex_unlock(&amvp_latency_lock)
+#endif
+
+static int amvp_latency_bucket(unsigned long long ns) {
+    int mag = AMVP_LATENCY_SUB_BITS;
+
+    if (ns < AMVP_LATENCY_SUB_COUNT) {
+        return (int)ns;
+    }
+    if (ns >> AMVP_LATENCY_MAG_MAX) {
+        return AMVP_LATENCY_BUCKETS - 1;
+    }
+#if defined __GNUC__
+    mag = 63 - __builtin_clzll(ns);
+#else
+    while (ns >> (mag + 1)) {
+        mag++;
+    }
+#endif
+    return ((mag - AMVP_LATENCY_SUB_BITS + 1) << AMVP_LATENCY_SUB_BITS) +
+           (int)((ns >> (mag - AMVP_LATENCY_SUB_BITS)) & (AMVP_LATENCY_SUB_COUNT - 1));
+}
+
+/*
+ * Highest value that is counted in the given bucket
+ */
+static unsigned long long amvp_latency_bucket_max(int idx) {
+    int mag = 0;
+    unsigned long long sub = 0;
+
+    if (idx < AMVP_LATENCY_SUB_COUNT) {
+        return (unsigned long long)idx;
+    }
+    mag = (idx >> AMVP_LATENCY_SUB_BITS) - 1 + AMVP_LATENCY_SUB_BITS;
+    sub = (unsigned long long)(idx & (AMVP_LATENCY_SUB_COUNT - 1));
+    return ((AMVP_LATENCY_SUB_COUNT + sub + 1) << (mag - AMVP_LATENCY_SUB_BITS)) - 1;
+}
+
+/*
+ * Inserts slow into the slowest-first list of lat if it is among the max
+ * slowest
+ */
+static void amvp_latency_slow_add(AMVP_LATENCY *lat, int max, const AMVP_SLOW_TC *slow) {
+    int i;
+
+    if (lat->slow_count == max && (!max || slow->ns <= lat->slow[max - 1].ns)) {
+        return;
+    }
+    i = lat->slow_count < max ? lat->slow_count++ : max - 1;
+    for (; i > 0 && lat->slow[i - 1].ns < slow->ns; i--) {
+        lat->slow[i] = lat->slow[i - 1];
+    }
+    lat->slow[i] = *slow;
+}
+
+static void amvp_latency_add(AMVP_LATENCY *to, const AMVP_LATENCY *from, int slow_max) {
+    int i;
+
+    if (!from->count) {
+        return;
+    }
+    if (!to->count || from->min_ns < to->min_ns) {
+        to->min_ns = from->min_ns;
+    }
+    if (from->max_ns > to->max_ns) {
+        to->max_ns = from->max_ns;
+    }
+    to->count += from->count;
+    to->sum_ns += from->sum_ns;
+    for (i = 0; i < AMVP_LATENCY_BUCKETS; i++) {
+        to->bucket[i] += from->bucket[i];
+    }
+    for (i = 0; i < from->slow_count; i++) {
+        amvp_latency_slow_add(to, slow_max, &from->slow[i]);
+    }
+}
+
+/*
+ * Counts a test case that took ns in the crypto module's handler. tc is NULL
+ * for the test cases of a batch, which are only counted in the histogram.
+ */
+void amvp_latency_record(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_CASE *tc,
+                         unsigned long long ns) {
+    AMVP_LATENCY *lat = &ctx->work.latency;
+    AMVP_SLOW_TC slow;
+
+    if (!lat->count || ns < lat->min_ns) {
+        lat->min_ns = ns;
+    }
+    if (ns > lat->max_ns) {
+        lat->max_ns = ns;
+    }
+    lat->count++;
+    lat->sum_ns += ns;
+    lat->bucket[amvp_latency_bucket(ns)]++;
+
+    if (!tc || !ctx->slow_tc_max ||
+        (lat->slow_count == ctx->slow_tc_max && ns <= lat->slow[lat->slow_count - 1].ns)) {
+        return;
+    }
+    slow.vs_id = ctx->work.vs_id;
+    slow.tg_id = ctx->work.tg_id;
+    slow.tc_id = amvp_tc_id(cap, tc);
+    slow.ns = ns;
+    amvp_latency_slow_add(lat, ctx->slow_tc_max, &slow);
+}
+
+/*
+ * Adds the latencies gathered by ctx since the last flush to the session's
+ * histogram of the given algorithm, after logging the slowest test cases of
+ * the vector set
+ */
+void amvp_latency_flush(AMVP_CTX *ctx, AMVP_CIPHER cipher) {
+    AMVP_CTX *session = ctx->parent ? ctx->parent : ctx;
+    AMVP_LATENCY *lat = &ctx->work.latency;
+    char buf[AMVP_SLOW_TC_MAX * 48] = {0};
+    int i, len = 0;
+
+    if (!lat->count) {
+        return;
+    }
+    if (cipher <= AMVP_CIPHER_START || cipher >= AMVP_CIPHER_END) {
+        cipher = AMVP_CIPHER_START;
+    }
+
+    for (i = 0; i < lat->slow_count && len < (int)sizeof(buf); i++) {
+        len += snprintf(buf + len, sizeof(buf) - len, "%stcId %d (tgId %d) %.3f ms",
+                        i ? ", " : "", lat->slow[i].tc_id, lat->slow[i].tg_id,
+                        (double)lat->slow[i].ns / 1000000.0);
+    }
+    if (lat->slow_count) {
+        AMVP_LOG_STATUS("Slowest test cases of vector set %d: %s", ctx->work.vs_id, buf);
+    }
+
+    amvp_latency_lock_acquire();
+    if (!session->latency[cipher]) {
+        session->latency[cipher] = calloc(1, sizeof(AMVP_LATENCY));
+    }
+    if (session->latency[cipher]) {
+        amvp_latency_add(session->latency[cipher], lat, session->slow_tc_max);
+    }
+    amvp_latency_lock_release();
+    memzero_s(lat, sizeof(AMVP_LATENCY));
+}
+
+static unsigned long long amvp_latency_percentile(const AMVP_LATENCY *lat, double pct) {
+    double rank = (double)lat->count * pct / 100.0;
+    unsigned long long target = 0, seen = 0, value = 0;
+    int i;
+
+    /* The smallest value that at least pct percent of the test cases do not exceed */
+    target = (unsigned long long)rank;
+    if ((double)target < rank || !target) {
+        target++;
+    }
+    for (i = 0; i < AMVP_LATENCY_BUCKETS; i++) {
+        seen += lat->bucket[i];
+        if (seen >= target) {
+            break;
+        }
+    }
+    value = amvp_latency_bucket_max(i < AMVP_LATENCY_BUCKETS ? i : AMVP_LATENCY_BUCKETS - 1);
+    if (value > lat->max_ns) {
+        value = lat->max_ns;
+    }
+    if (value < lat->min_ns) {
+        value = lat->min_ns;
+    }
+    return value;
+}
+
+AMVP_RESULT amvp_latency_copy(AMVP_CTX *ctx, AMVP_CIPHER cipher, AMVP_LATENCY_STATS *stats) {
+    AMVP_LATENCY *lat = NULL;
+    int i;
+
+    lat = calloc(1, sizeof(AMVP_LATENCY));
+    if (!lat) {
+        return AMVP_MALLOC_FAIL;
+    }
+    amvp_latency_lock_acquire();
+    for (i = AMVP_CIPHER_START; i < AMVP_CIPHER_END; i++) {
+        if (ctx->latency[i] && (cipher == AMVP_CIPHER_START || (AMVP_CIPHER)i == cipher)) {
+            amvp_latency_add(lat, ctx->latency[i], AMVP_SLOW_TC_MAX);
+        }
+    }
+    amvp_latency_lock_release();
+
+    memzero_s(stats, sizeof(AMVP_LATENCY_STATS));
+    if (lat->count) {
+        stats->count = lat->count;
+        stats->min_ns = lat->min_ns;
+        stats->mean_ns = lat->sum_ns / lat->count;
+        stats->p50_ns = amvp_latency_percentile(lat, 50.0);
+        stats->p90_ns = amvp_latency_percentile(lat, 90.0);
+        stats->p99_ns = amvp_latency_percentile(lat, 99.0);
+        stats->p999_ns = amvp_latency_percentile(lat, 99.9);
+        stats->max_ns = lat->max_ns;
+    }
+    stats->slow_count = lat->slow_count < ctx->slow_tc_max ? lat->slow_count : ctx->slow_tc_max;
+    for (i = 0; i < stats->slow_count; i++) {
+        stats->slow[i] = lat->slow[i];
+    }
+    free(lat);
+    return AMVP_SUCCESS;
+}
+
+void amvp_latency_free(AMVP_CTX *ctx) {
+    int i;
+
+    for (i = 0; i < AMVP_CIPHER_END; i++) {
+        if (ctx->latency[i]) {
+            free(ctx->latency[i]);
+            ctx->latency[i] = NULL;
+        }
+    }
+}
@@ -0,0 +1,247 @@
+/** @file */
+/*
+ * Copyright (c) 2021, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libamvp/LICENSE
+ */
+
+/*
+ * Heap accounting per subsystem.
+ *
+ * The JSON parser (through json_set_allocation_functions()), the test case
+ * buffers of the algorithm handlers, the transport buffers and the
+ * capability structures allocate through amvp_mem_malloc(),
+ * amvp_mem_calloc() and amvp_mem_free() with an AMVP_MEM_TAG. The size of a
+ * block is asked from the allocator instead of being kept in a header, so a
+ * block that is released with plain free(), or that was allocated before
+ * the accounting was installed, can only skew the counters and never
+ * corrupts the heap. Where the C library has no way to tell the size of a
+ * block nothing is counted.
+ *
+ * The process wide counters are updated with relaxed atomics. Each thread
+ * also counts what it allocates and frees in thread local counters that
+ * amvp_mem_vs_begin() resets when the thread starts on a vector set, which
+ * gives the high-water mark of every vector set without taking a lock.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined _WIN32
+#include <Windows.h>
+#include <malloc.h>
+#define amvp_mem_block_size(ptr) _msize(ptr)
+#elif defined __APPLE__
+#include <malloc/malloc.h>
+#define amvp_mem_block_size(ptr) malloc_size(ptr)
+#elif defined __FreeBSD__
+#include <malloc_np.h>
+#define amvp_mem_block_size(ptr) malloc_usable_size(ptr)
+#elif defined __GLIBC__ || defined __linux__
+#include <malloc.h>
+#define amvp_mem_block_size(ptr) malloc_usable_size(ptr)
+#else
+#define amvp_mem_block_size(ptr) 0
+#endif
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#include "amvp.h"
+#include "amvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+#define AMVP_MEM_TOTAL AMVP_MEM_TAG_MAX
+
+#ifdef _WIN32
+#define amvp_mem_atomic_add(p, v) (InterlockedExchangeAdd64((volatile LONG64 *)(p), (v)) + (v))
+#define amvp_mem_atomic_load(p) InterlockedCompareExchange64((volatile LONG64 *)(p), 0, 0)
+#define amvp_mem_atomic_cas(p, old, new) \
+    (InterlockedCompareExchange64((volatile LONG64 *)(p), (new), (old)) == (old))
+#else
+#define amvp_mem_atomic_add(p, v) __atomic_add_fetch((p), (v), __ATOMIC_RELAXED)
+#define amvp_mem_atomic_load(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define amvp_mem_atomic_cas(p, old, new) \
+    __atomic_compare_exchange_n((p), &(old), (new), 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#endif
+
+typedef struct amvp_mem_count_t {
+    long long current;
+    long long peak;
+    long long allocs;
+} AMVP_MEM_COUNT;
+
+static const char *amvp_mem_tag_names[AMVP_MEM_TAG_MAX] = {
+    "JSON", "test cases", "transport", "capabilities"
+};
+
+/* Process wide, indexed by AMVP_MEM_TAG plus AMVP_MEM_TOTAL */
+static AMVP_MEM_COUNT amvp_mem_counts[AMVP_MEM_TAG_MAX + 1];
+
+/* Of the vector set the thread is working on */
+static AMVP_THREAD_LOCAL AMVP_MEM_COUNT amvp_mem_vs_counts[AMVP_MEM_TAG_MAX + 1];
+
+/* Serializes the session's per vector set high-water marks */
+#ifdef _WIN32
+static SRWLOCK amvp_mem_lock = SRWLOCK_INIT;
+#define amvp_mem_lock_acquire() AcquireSRWLockExclusive(&amvp_mem_lock)
+#define amvp_mem_lock_release() ReleaseSRWLockExclusive(&amvp_mem_lock)
+#else
+static pthread_mutex_t amvp_mem_lock = PTHREAD_MUTEX_INITIALIZER;
+#define amvp_mem_lock_acquire() pthread_mutex_lock(&amvp_mem_lock)
+#define amvp_mem_lock_release() pthread_mutex_unlock(&amvp_mem_lock)
+#endif
+
+static void amvp_mem_raise_peak(long long *peak, long long current) {
+    long long old = amvp_mem_atomic_load(peak);
+
+    while (current > old) {
+        if (amvp_mem_atomic_cas(peak, old, current)) {
+            break;
+        }
+        old = amvp_mem_atomic_load(peak);
+    }
+}
+
+static void amvp_mem_count(AMVP_MEM_TAG tag, long long size, int alloc) {
+    int idx[2] = { tag, AMVP_MEM_TOTAL };
+    AMVP_MEM_COUNT *vs = NULL;
+    long long current = 0;
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        current = amvp_mem_atomic_add(&amvp_mem_counts[idx[i]].current, size);
+        if (alloc) {
+            amvp_mem_atomic_add(&amvp_mem_counts[idx[i]].allocs, 1);
+            amvp_mem_raise_peak(&amvp_mem_counts[idx[i]].peak, current);
+        }
+        vs = &amvp_mem_vs_counts[idx[i]];
+        vs->current += size;
+        if (alloc) {
+            vs->allocs++;
+            if (vs->current > vs->peak) {
+                vs->peak = vs->current;
+            }
+        }
+    }
+}
+
+void *amvp_mem_malloc(AMVP_MEM_TAG tag, size_t size) {
+    void *ptr = malloc(size);
+
+    if (ptr) {
+        amvp_mem_count(tag, (long long)amvp_mem_block_size(ptr), 1);
+    }
+    return ptr;
+}
+
+void *amvp_mem_calloc(AMVP_MEM_TAG tag, size_t count, size_t size) {
+    void *ptr = calloc(count, size);
+
+    if (ptr) {
+        amvp_mem_count(tag, (long long)amvp_mem_block_size(ptr), 1);
+    }
+    return ptr;
+}
+
+void amvp_mem_free(AMVP_MEM_TAG tag, void *ptr) {
+    if (!ptr) {
+        return;
+    }
+    amvp_mem_count(tag, -(long long)amvp_mem_block_size(ptr), 0);
+    free(ptr);
+}
+
+static void *amvp_mem_json_malloc(size_t size) {
+    return amvp_mem_malloc(AMVP_MEM_JSON, size);
+}
+
+static void amvp_mem_json_free(void *ptr) {
+    amvp_mem_free(AMVP_MEM_JSON, ptr);
+}
+
+/*
+ * Route the allocations of the JSON parser through the accounting. Called
+ * for every new test session; parson only keeps two function pointers, so
+ * setting them again is harmless.
+ */
+void amvp_mem_init(void) {
+    json_set_allocation_functions(amvp_mem_json_malloc, amvp_mem_json_free);
+}
+
+/*
+ * The calling thread starts on a vector set
+ */
+void amvp_mem_vs_begin(void) {
+    memzero_s(amvp_mem_vs_counts, sizeof(amvp_mem_vs_counts));
+}
+
+/*
+ * The thread running on ctx is done with the vector set ctx->work.vs_id. Logs
+ * its high-water marks, keeps them on the session ctx if they are the
+ * highest so far, and starts counting for the next vector set.
+ */
+void amvp_mem_vs_end(AMVP_CTX *ctx) {
+    AMVP_CTX *session = ctx->parent ? ctx->parent : ctx;
+    AMVP_MEM_COUNT *vs = amvp_mem_vs_counts;
+    int i;
+
+    AMVP_LOG_STATUS("Memory high-water mark of vector set %d: %lld KB "
+                    "(%s %lld KB, %s %lld KB, %s %lld KB, %s %lld KB)",
+                    ctx->work.vs_id, vs[AMVP_MEM_TOTAL].peak / 1024,
+                    amvp_mem_tag_names[AMVP_MEM_JSON], vs[AMVP_MEM_JSON].peak / 1024,
+                    amvp_mem_tag_names[AMVP_MEM_TC], vs[AMVP_MEM_TC].peak / 1024,
+                    amvp_mem_tag_names[AMVP_MEM_TRANSPORT], vs[AMVP_MEM_TRANSPORT].peak / 1024,
+                    amvp_mem_tag_names[AMVP_MEM_CAPS], vs[AMVP_MEM_CAPS].peak / 1024);
+
+    amvp_mem_lock_acquire();
+    session->mem_vs_count++;
+    if (session->mem_vs_count == 1 || vs[AMVP_MEM_TOTAL].peak > session->mem_peak_vs[AMVP_MEM_TOTAL]) {
+        session->mem_peak_vs_id = ctx->work.vs_id;
+        for (i = 0; i <= AMVP_MEM_TOTAL; i++) {
+            session->mem_peak_vs[i] = vs[i].peak > 0 ? vs[i].peak : 0;
+        }
+    }
+    amvp_mem_lock_release();
+    amvp_mem_vs_begin();
+}
+
+/*
+ * High-water mark of the vector set the calling thread is working on, so far
+ */
+unsigned long long amvp_mem_vs_peak(void) {
+    long long peak = amvp_mem_vs_counts[AMVP_MEM_TOTAL].peak;
+
+    return peak > 0 ? (unsigned long long)peak : 0;
+}
+
+static void amvp_mem_copy_count(AMVP_MEM_COUNTERS *dst, AMVP_MEM_COUNT *src) {
+    long long current = amvp_mem_atomic_load(&src->current);
+
+    /* Blocks released with the wrong tag can drive a counter below zero */
+    dst->current = current > 0 ? (unsigned long long)current : 0;
+    dst->peak = (unsigned long long)amvp_mem_atomic_load(&src->peak);
+    dst->allocs = (unsigned long long)amvp_mem_atomic_load(&src->allocs);
+}
+
+void amvp_mem_copy(AMVP_CTX *ctx, AMVP_MEM_STATS *stats) {
+    int i;
+
+    memzero_s(stats, sizeof(AMVP_MEM_STATS));
+    for (i = 0; i < AMVP_MEM_TAG_MAX; i++) {
+        amvp_mem_copy_count(&stats->tag[i], &amvp_mem_counts[i]);
+    }
+    amvp_mem_copy_count(&stats->total, &amvp_mem_counts[AMVP_MEM_TOTAL]);
+
+    amvp_mem_lock_acquire();
+    stats->vs_count = ctx->mem_vs_count;
+    stats->peak_vs_id = ctx->mem_peak_vs_id;
+    for (i = 0; i < AMVP_MEM_TAG_MAX; i++) {
+        stats->peak_vs[i] = (unsigned long long)ctx->mem_peak_vs[i];
+    }
+    stats->peak_vs_total = (unsigned long long)ctx->mem_peak_vs[AMVP_MEM_TOTAL];
+    amvp_mem_lock_release();
+}
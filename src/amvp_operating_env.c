@@ -714,7 +714,7 @@ static AMVP_RESULT match_dependencies_page(AMVP_CTX *ctx,
     }
     *match = 0;
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->work.curl_buf);
     if (!val) {
         AMVP_LOG_ERR("JSON parse error");
         return AMVP_JSON_ERR;
@@ -1019,7 +1019,7 @@ static AMVP_RESULT match_oes_page(AMVP_CTX *ctx,
     }
     *match = 0;
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->work.curl_buf);
     if (!val) {
         AMVP_LOG_ERR("JSON parse error");
         return AMVP_JSON_ERR;
@@ -1612,7 +1612,7 @@ static AMVP_RESULT query_vendor_contacts(AMVP_CTX *ctx,
         return rv;
     }
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->work.curl_buf);
     if (!val) {
         AMVP_LOG_ERR("JSON parse error");
         return AMVP_JSON_ERR;
@@ -1760,7 +1760,7 @@ static AMVP_RESULT match_vendors_page(AMVP_CTX *ctx,
     }
     *match = 0;
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->work.curl_buf);
     if (!val) {
         AMVP_LOG_ERR("JSON parse error");
         return AMVP_JSON_ERR;
@@ -2100,7 +2100,7 @@ static AMVP_RESULT match_modules_page(AMVP_CTX *ctx,
     }
     *match = 0;
 
-    val = json_parse_string(ctx->curl_buf);
+    val = json_parse_string(ctx->work.curl_buf);
     if (!val) {
         AMVP_LOG_ERR("JSON parse error");
         return AMVP_JSON_ERR;
@@ -3416,7 +3416,7 @@ AMVP_RESULT amvp_oe_ingest_metadata(AMVP_CTX *ctx, const char *metadata_file) {
         return AMVP_INVALID_ARG;
     }
 
-    val = json_parse_file(metadata_file);
+    val = amvp_json_parse_file(metadata_file);
     if (!val) {
         AMVP_LOG_ERR("Failed to parse JSON in metadata file");
         return AMVP_JSON_ERR;
@@ -78,7 +78,7 @@ static AMVP_RESULT amvp_pbkdf_init_tc(AMVP_PBKDF_TC *stc,
     stc->key_len = key_len;
 
     // Allocate space for the salt (binary)
-    stc->salt = calloc(salt_len, sizeof(unsigned char));
+    stc->salt = amvp_mem_calloc(AMVP_MEM_TC, salt_len, sizeof(unsigned char));
     if (!stc->salt) { return AMVP_MALLOC_FAIL; }
     stc->salt_len = salt_len;
 
@@ -88,7 +88,7 @@ static AMVP_RESULT amvp_pbkdf_init_tc(AMVP_PBKDF_TC *stc,
     if (rv != AMVP_SUCCESS) return rv;
 
     //copy password (string) to TC
-    stc->password = calloc(password_len + 1, sizeof(char));
+    stc->password = amvp_mem_calloc(AMVP_MEM_TC, password_len + 1, sizeof(char));
     if (!stc->password) { return AMVP_MALLOC_FAIL; }
     tmp = strncpy_s(stc->password, password_len + 1, password, password_len);
     if (tmp) { return AMVP_DATA_TOO_LARGE; }
@@ -97,7 +97,7 @@ static AMVP_RESULT amvp_pbkdf_init_tc(AMVP_PBKDF_TC *stc,
     stc->iterationCount = iterationCount;
 
     //Allocate space for output (key)
-    stc->key = calloc(AMVP_PBKDF_KEY_BYTE_MAX + 1, sizeof(unsigned char));
+    stc->key = amvp_mem_calloc(AMVP_MEM_TC, AMVP_PBKDF_KEY_BYTE_MAX + 1, sizeof(unsigned char));
     if (!stc->key) { return AMVP_MALLOC_FAIL; }
 
     return AMVP_SUCCESS;
@@ -108,9 +108,9 @@ static AMVP_RESULT amvp_pbkdf_init_tc(AMVP_PBKDF_TC *stc,
  * a test case.
  */
 static AMVP_RESULT amvp_pbkdf_release_tc(AMVP_PBKDF_TC *stc) {
-    if (stc->salt) free(stc->salt);
-    if (stc->password) free(stc->password);
-    if (stc->key) free(stc->key);
+    if (stc->salt) amvp_mem_free(AMVP_MEM_TC, stc->salt);
+    if (stc->password) amvp_mem_free(AMVP_MEM_TC, stc->password);
+    if (stc->key) amvp_mem_free(AMVP_MEM_TC, stc->key);
 
     memzero_s(stc, sizeof(AMVP_PBKDF_TC));
     return AMVP_SUCCESS;
@@ -210,7 +210,7 @@ AMVP_RESULT amvp_pbkdf_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     AMVP_CAPS_LIST *cap;
     AMVP_PBKDF_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
     const char *alg_str = NULL;
     AMVP_CIPHER alg_id = 0;
@@ -285,6 +285,7 @@ AMVP_RESULT amvp_pbkdf_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -420,7 +421,7 @@ AMVP_RESULT amvp_pbkdf_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
             }
 
             /* Process the current test vector... */
-            if ((cap->crypto_handler)(&tc)) {
+            if (amvp_crypto_handler(ctx, cap, &tc)) {
                 AMVP_LOG_ERR("crypto module failed the operation");
                 amvp_pbkdf_release_tc(&stc);
                 rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -458,7 +459,7 @@ AMVP_RESULT amvp_pbkdf_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -0,0 +1,521 @@
+/** @file */
+/*
+ * Copyright (c) 2021, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libamvp/LICENSE
+ */
+
+/*
+ * Record and replay of the HTTP exchanges of a test session.
+ *
+ * When amvp_set_transport_record() was called, every request the transport
+ * sends and the response to it are appended to the recording as one JSON
+ * object per line:
+ *
+ *   {"seq":1,"startUs":0,"durationUs":81234,"method":"POST",
+ *    "url":"https://host:443/amvp/v1/login",
+ *    "requestHeaders":["Content-Type:application/json"],
+ *    "requestBody":"...","status":200,"responseHeaders":[],
+ *    "responseBody":"..."}
+ *
+ * startUs is the time the request was sent, in microseconds since the
+ * recording was opened, and durationUs how long the server took to answer.
+ * The Authorization header and the "accessToken" and "password" values of
+ * the bodies are redacted. A name ending in .gz or .zst is compressed, as
+ * for the other files the library writes.
+ *
+ * amvp_set_transport_replay() loads such a recording and answers the
+ * requests of the session from it instead of sending them. A request is
+ * answered by the first recorded exchange with the same method and URL path
+ * that was not used yet, so the polls for one vector set are answered in
+ * the order they were recorded while concurrent vector sets may be
+ * interleaved differently than in the recorded session. Once all exchanges
+ * for a URL were used the last one is repeated. With realtime set every
+ * answer is delayed by the recorded durationUs and the library waits out the
+ * retry periods as it would against the server; the other gaps between the
+ * recorded startUs are the client's own time and are not reproduced.
+ * Otherwise answers are served as fast as possible and the library does not
+ * wait before retrying either.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <time.h>
+#include <pthread.h>
+#endif
+#include "amvp.h"
+#include "amvp_lcl.h"
+#include "parson.h"
+#include "safe_lib.h"
+
+#define AMVP_RECORD_REDACTED "[redacted]"
+#define AMVP_RECORD_READ_CHUNK (1024 * 1024)
+
+static const char *amvp_http_method_names[] = { "GET", "POST", "PUT", "DELETE" };
+
+/* Values of the bodies that are not written to the recording */
+static const char *amvp_record_secrets[] = { "accessToken", "password" };
+
+struct amvp_record_t {
+    AMVP_FILE *fp;
+    unsigned long long epoch; /* amvp_perf_now() when the recording was opened */
+    int seq;
+#ifndef _WIN32
+    pthread_mutex_t lock;
+#endif
+};
+
+typedef struct amvp_replay_entry_t {
+    AMVP_HTTP_METHOD method;
+    char *path;           /* URL without the scheme and server */
+    long status;
+    unsigned long long duration_us;
+    char *etag;           /* ETag response header, NULL if none */
+    char *body;
+    int body_len;
+    int used;
+} AMVP_REPLAY_ENTRY;
+
+struct amvp_replay_t {
+    AMVP_REPLAY_ENTRY *entries;
+    int count;
+    int realtime;
+#ifndef _WIN32
+    pthread_mutex_t lock;
+#endif
+};
+
+#ifndef _WIN32
+#define amvp_record_lock(m) pthread_mutex_lock(m)
+#define amvp_record_unlock(m) pthread_mutex_unlock(m)
+#else
+#define amvp_record_lock(m)
+#define amvp_record_unlock(m)
+#endif
+
+/*
+ * The part of url after the scheme and server, so that a recording can be
+ * replayed against another server name or port
+ */
+static const char *amvp_record_url_path(const char *url) {
+    const char *p = strstr(url, "://");
+
+    if (!p) {
+        return url;
+    }
+    p = strchr(p + 3, '/');
+    return p ? p : "/";
+}
+
+static void amvp_record_redact_value(JSON_Value *val) {
+    JSON_Object *obj = NULL;
+    JSON_Array *arr = NULL;
+    size_t i = 0, j = 0;
+
+    switch (json_value_get_type(val)) {
+    case JSONObject:
+        obj = json_value_get_object(val);
+        for (i = 0; i < sizeof(amvp_record_secrets) / sizeof(amvp_record_secrets[0]); i++) {
+            if (json_object_has_value_of_type(obj, amvp_record_secrets[i], JSONString)) {
+                json_object_set_string(obj, amvp_record_secrets[i], AMVP_RECORD_REDACTED);
+            }
+        }
+        for (j = 0; j < json_object_get_count(obj); j++) {
+            amvp_record_redact_value(json_object_get_value_at(obj, j));
+        }
+        break;
+    case JSONArray:
+        arr = json_value_get_array(val);
+        for (j = 0; j < json_array_get_count(arr); j++) {
+            amvp_record_redact_value(json_array_get_value(arr, j));
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ * Copy of the len bytes of body with the secrets redacted. Only bodies that
+ * mention one of the secrets are parsed, which keeps the vector sets fast.
+ */
+static char *amvp_record_body(const char *body, int len) {
+    char *copy = NULL, *redacted = NULL;
+    JSON_Value *val = NULL;
+    size_t i = 0;
+    int secret = 0;
+
+    copy = calloc(len + 1, sizeof(char));
+    if (!copy) {
+        return NULL;
+    }
+    if (len) {
+        memcpy_s(copy, len + 1, body, len);
+    }
+    for (i = 0; i < sizeof(amvp_record_secrets) / sizeof(amvp_record_secrets[0]); i++) {
+        if (strstr(copy, amvp_record_secrets[i])) {
+            secret = 1;
+        }
+    }
+    if (!secret) {
+        return copy;
+    }
+    val = json_parse_string(copy);
+    if (!val) {
+        /* Not JSON, keep nothing rather than a secret */
+        free(copy);
+        return strdup(AMVP_RECORD_REDACTED);
+    }
+    amvp_record_redact_value(val);
+    redacted = json_serialize_to_string(val, NULL);
+    json_value_free(val);
+    free(copy);
+    return redacted;
+}
+
+AMVP_RESULT amvp_record_open(AMVP_CTX *ctx, const char *path) {
+    struct amvp_record_t *record = NULL;
+
+    record = calloc(1, sizeof(struct amvp_record_t));
+    if (!record) {
+        return AMVP_MALLOC_FAIL;
+    }
+    if (amvp_file_open(&record->fp, path, "w", amvp_file_type(path),
+                       ctx->file_compress_level) != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("Unable to open transport recording %s", path);
+        free(record);
+        return AMVP_INVALID_ARG;
+    }
+#ifndef _WIN32
+    pthread_mutex_init(&record->lock, NULL);
+#endif
+    record->epoch = amvp_perf_now();
+    ctx->record = record;
+    return AMVP_SUCCESS;
+}
+
+void amvp_record_close(AMVP_CTX *ctx) {
+    struct amvp_record_t *record = ctx->record;
+
+    if (!record) {
+        return;
+    }
+    ctx->record = NULL;
+    amvp_file_close(record->fp);
+#ifndef _WIN32
+    pthread_mutex_destroy(&record->lock);
+#endif
+    free(record);
+}
+
+/*
+ * Append the exchange that was just completed to the recording. start is the
+ * amvp_perf_now() at which the request was sent, auth tells if it carried an
+ * Authorization header and etag is the If-None-Match value it carried, if
+ * any. The response is read from ctx->work.
+ */
+void amvp_record_http(AMVP_CTX *ctx, AMVP_HTTP_METHOD method, const char *url,
+                      int auth, const char *etag, const char *data, int data_len,
+                      long http_code, unsigned long long start) {
+    struct amvp_record_t *record = ctx->record;
+    unsigned long long end = amvp_perf_now();
+    JSON_Value *val = NULL;
+    JSON_Object *obj = NULL;
+    JSON_Array *hdrs = NULL;
+    char hdr[AMVP_ETAG_MAX + sizeof("If-None-Match: ")];
+    char *body = NULL, *line = NULL;
+
+    if (!record) {
+        return;
+    }
+    if (start < record->epoch) {
+        start = record->epoch;
+    }
+
+    val = json_value_init_object();
+    obj = json_value_get_object(val);
+    json_object_set_number(obj, "seq", 0);
+    json_object_set_number(obj, "startUs", (double)((start - record->epoch) / 1000));
+    json_object_set_number(obj, "durationUs", (double)((end - start) / 1000));
+    json_object_set_string(obj, "method", amvp_http_method_names[method]);
+    json_object_set_string(obj, "url", url);
+
+    json_object_set_value(obj, "requestHeaders", json_value_init_array());
+    hdrs = json_object_get_array(obj, "requestHeaders");
+    if (method != AMVP_HTTP_GET) {
+        json_array_append_string(hdrs, "Content-Type:application/json");
+    }
+    if (auth) {
+        json_array_append_string(hdrs, "Authorization: Bearer " AMVP_RECORD_REDACTED);
+    }
+    if (etag && etag[0]) {
+        snprintf(hdr, sizeof(hdr), "If-None-Match: %s", etag);
+        json_array_append_string(hdrs, hdr);
+    }
+    if (data) {
+        body = amvp_record_body(data, data_len);
+        json_object_set_string(obj, "requestBody", body ? body : "");
+        free(body);
+    }
+
+    json_object_set_number(obj, "status", (double)http_code);
+    json_object_set_value(obj, "responseHeaders", json_value_init_array());
+    hdrs = json_object_get_array(obj, "responseHeaders");
+    if (etag && ctx->work.etag[0]) {
+        snprintf(hdr, sizeof(hdr), "ETag: %s", ctx->work.etag);
+        json_array_append_string(hdrs, hdr);
+    }
+    body = amvp_record_body(ctx->work.curl_buf ? ctx->work.curl_buf : "",
+                            ctx->work.curl_buf ? ctx->work.curl_read_ctr : 0);
+    json_object_set_string(obj, "responseBody", body ? body : "");
+    free(body);
+
+    amvp_record_lock(&record->lock);
+    json_object_set_number(obj, "seq", ++record->seq);
+    line = json_serialize_to_string(val, NULL);
+    if (!line || amvp_file_puts(record->fp, line) || amvp_file_puts(record->fp, "\n")) {
+        AMVP_LOG_ERR("Failed to write the transport recording");
+    }
+    amvp_record_unlock(&record->lock);
+    if (line) json_free_serialized_string(line);
+    json_value_free(val);
+}
+
+static void amvp_replay_free(struct amvp_replay_t *replay) {
+    int i = 0;
+
+    for (i = 0; i < replay->count; i++) {
+        free(replay->entries[i].path);
+        free(replay->entries[i].etag);
+        free(replay->entries[i].body);
+    }
+    free(replay->entries);
+    free(replay);
+}
+
+static AMVP_RESULT amvp_replay_add(struct amvp_replay_t *replay, JSON_Object *obj) {
+    AMVP_REPLAY_ENTRY *entry = NULL;
+    JSON_Array *hdrs = NULL;
+    const char *method = NULL, *url = NULL, *body = NULL, *hdr = NULL;
+    size_t i = 0;
+
+    method = json_object_get_string(obj, "method");
+    url = json_object_get_string(obj, "url");
+    body = json_object_get_string(obj, "responseBody");
+    if (!method || !url || !body) {
+        return AMVP_JSON_ERR;
+    }
+
+    entry = &replay->entries[replay->count];
+    memzero_s(entry, sizeof(AMVP_REPLAY_ENTRY));
+    for (i = 0; i < sizeof(amvp_http_method_names) / sizeof(amvp_http_method_names[0]); i++) {
+        if (!strcmp(method, amvp_http_method_names[i])) {
+            break;
+        }
+    }
+    if (i == sizeof(amvp_http_method_names) / sizeof(amvp_http_method_names[0])) {
+        return AMVP_JSON_ERR;
+    }
+    entry->method = (AMVP_HTTP_METHOD)i;
+    entry->status = (long)json_object_get_number(obj, "status");
+    entry->duration_us = (unsigned long long)json_object_get_number(obj, "durationUs");
+    entry->body_len = (int)strnlen_s(body, AMVP_CURL_BUF_MAX);
+    entry->path = strdup(amvp_record_url_path(url));
+    entry->body = strdup(body);
+    hdrs = json_object_get_array(obj, "responseHeaders");
+    for (i = 0; i < json_array_get_count(hdrs); i++) {
+        hdr = json_array_get_string(hdrs, i);
+        if (hdr && !strncmp(hdr, "ETag: ", 6)) {
+            entry->etag = strdup(hdr + 6);
+        }
+    }
+    replay->count++;
+    if (!entry->path || !entry->body) {
+        return AMVP_MALLOC_FAIL;
+    }
+    return AMVP_SUCCESS;
+}
+
+AMVP_RESULT amvp_replay_open(AMVP_CTX *ctx, const char *path, int realtime) {
+    struct amvp_replay_t *replay = NULL;
+    AMVP_FILE *fp = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    JSON_Value *val = NULL;
+    char *buf = NULL, *tmp = NULL, *line = NULL, *next = NULL;
+    size_t len = 0, size = 0, n = 0;
+    int lines = 0, lineno = 0;
+
+    if (amvp_file_open(&fp, path, "r", AMVP_FILE_PLAIN, 0) != AMVP_SUCCESS) {
+        AMVP_LOG_ERR("Unable to open transport recording %s", path);
+        return AMVP_INVALID_ARG;
+    }
+    do {
+        if (size - len < AMVP_RECORD_READ_CHUNK + 1) {
+            size = size ? size * 2 : AMVP_RECORD_READ_CHUNK * 2;
+            tmp = realloc(buf, size);
+            if (!tmp) {
+                rv = AMVP_MALLOC_FAIL;
+                goto end;
+            }
+            buf = tmp;
+        }
+        n = amvp_file_read(fp, buf + len, AMVP_RECORD_READ_CHUNK);
+        len += n;
+    } while (n);
+    if (!buf) {
+        rv = AMVP_JSON_ERR;
+        goto end;
+    }
+    buf[len] = 0;
+
+    for (n = 0; n < len; n++) {
+        if (buf[n] == '\n') lines++;
+    }
+    replay = calloc(1, sizeof(struct amvp_replay_t));
+    if (!replay) {
+        rv = AMVP_MALLOC_FAIL;
+        goto end;
+    }
+    replay->entries = calloc(lines + 1, sizeof(AMVP_REPLAY_ENTRY));
+    if (!replay->entries) {
+        rv = AMVP_MALLOC_FAIL;
+        goto end;
+    }
+    replay->realtime = realtime;
+
+    /* JSON strings can not hold a raw newline, each line is one exchange */
+    for (line = buf; line && *line; line = next) {
+        next = strchr(line, '\n');
+        if (next) {
+            *next++ = 0;
+        }
+        lineno++;
+        if (!*line) {
+            continue;
+        }
+        val = json_parse_string(line);
+        rv = val ? amvp_replay_add(replay, json_value_get_object(val)) : AMVP_JSON_ERR;
+        json_value_free(val);
+        if (rv != AMVP_SUCCESS) {
+            AMVP_LOG_ERR("Invalid exchange on line %d of transport recording %s", lineno, path);
+            goto end;
+        }
+    }
+    AMVP_LOG_STATUS("Replaying %d HTTP exchanges from %s", replay->count, path);
+#ifndef _WIN32
+    pthread_mutex_init(&replay->lock, NULL);
+#endif
+    ctx->replay = replay;
+    replay = NULL;
+
+end:
+    if (replay) amvp_replay_free(replay);
+    free(buf);
+    amvp_file_close(fp);
+    return rv;
+}
+
+void amvp_replay_close(AMVP_CTX *ctx) {
+    struct amvp_replay_t *replay = ctx->replay;
+
+    if (!replay) {
+        return;
+    }
+    ctx->replay = NULL;
+#ifndef _WIN32
+    pthread_mutex_destroy(&replay->lock);
+#endif
+    amvp_replay_free(replay);
+}
+
+/*
+ * Answer a request from the recording instead of sending it. Leaves
+ * ctx->work as the curl transport would and returns the recorded HTTP
+ * status, or 0 when nothing was recorded for the request, which the
+ * transport reports like a failed connection.
+ */
+long amvp_replay_http(AMVP_CTX *ctx, AMVP_HTTP_METHOD method, const char *url) {
+    struct amvp_replay_t *replay = ctx->replay;
+    AMVP_REPLAY_ENTRY *entry = NULL;
+#ifndef _WIN32
+    struct timespec delay;
+#endif
+    const char *path = amvp_record_url_path(url);
+    int use_etag = ctx->work.use_etag;
+    int i = 0, len = 0;
+
+    /* Single use like in the curl transport */
+    ctx->use_tmp_jwt = 0;
+    ctx->work.use_etag = 0;
+    ctx->work.not_modified = 0;
+    ctx->work.curl_read_ctr = 0;
+
+    amvp_record_lock(&replay->lock);
+    for (i = 0; i < replay->count; i++) {
+        if (replay->entries[i].method == method && !strcmp(replay->entries[i].path, path)) {
+            entry = &replay->entries[i];
+            if (!entry->used) {
+                break;
+            }
+        }
+    }
+    if (entry) {
+        entry->used = 1;
+    }
+    amvp_record_unlock(&replay->lock);
+
+    if (!entry) {
+        AMVP_LOG_ERR("No recorded exchange for %s %s", amvp_http_method_names[method], url);
+        return 0;
+    }
+
+    if (!ctx->work.curl_buf) {
+        ctx->work.curl_buf = amvp_mem_calloc(AMVP_MEM_TRANSPORT, AMVP_CURL_BUF_MAX, sizeof(char));
+        if (!ctx->work.curl_buf) {
+            AMVP_LOG_ERR("unable to allocate memory.");
+            return 0;
+        }
+    }
+    len = entry->body_len;
+    if (len > AMVP_CURL_BUF_MAX - 1) {
+        AMVP_LOG_ERR("Recorded response exceeds the transport buffer, truncating");
+        len = AMVP_CURL_BUF_MAX - 1;
+    }
+    memcpy_s(ctx->work.curl_buf, AMVP_CURL_BUF_MAX, entry->body, len);
+    ctx->work.curl_buf[len] = 0;
+    ctx->work.curl_read_ctr = len;
+    if (use_etag) {
+        if (entry->etag) {
+            strncpy_s(ctx->work.etag, AMVP_ETAG_MAX + 1, entry->etag, AMVP_ETAG_MAX);
+        }
+        if (entry->status == 304) {
+            ctx->work.not_modified = 1;
+        }
+    }
+
+    if (replay->realtime && entry->duration_us) {
+#ifdef _WIN32
+        Sleep((DWORD)(entry->duration_us / 1000));
+#else
+        delay.tv_sec = (time_t)(entry->duration_us / 1000000);
+        delay.tv_nsec = (long)(entry->duration_us % 1000000) * 1000;
+        nanosleep(&delay, NULL);
+#endif
+    }
+    return entry->status;
+}
+
+/*
+ * Whether the session is replayed as fast as possible, in which case the
+ * retry periods asked for by the recording are not waited out
+ */
+int amvp_replay_fast(AMVP_CTX *ctx) {
+    return ctx->replay && !ctx->replay->realtime;
+}
@@ -164,18 +164,18 @@ err:
  */
 
 static AMVP_RESULT amvp_rsa_keygen_release_tc(AMVP_RSA_KEYGEN_TC *stc) {
-    if (stc->e) { free(stc->e); }
-    if (stc->seed) { free(stc->seed); }
-    if (stc->p) { free(stc->p); }
-    if (stc->q) { free(stc->q); }
-    if (stc->n) { free(stc->n); }
-    if (stc->d) { free(stc->d); }
-    if (stc->xp1) { free(stc->xp1); }
-    if (stc->xp2) { free(stc->xp2); }
-    if (stc->xp) { free(stc->xp); }
-    if (stc->xq1) { free(stc->xq1); }
-    if (stc->xq2) { free(stc->xq2); }
-    if (stc->xq) { free(stc->xq); }
+    if (stc->e) { amvp_mem_free(AMVP_MEM_TC, stc->e); }
+    if (stc->seed) { amvp_mem_free(AMVP_MEM_TC, stc->seed); }
+    if (stc->p) { amvp_mem_free(AMVP_MEM_TC, stc->p); }
+    if (stc->q) { amvp_mem_free(AMVP_MEM_TC, stc->q); }
+    if (stc->n) { amvp_mem_free(AMVP_MEM_TC, stc->n); }
+    if (stc->d) { amvp_mem_free(AMVP_MEM_TC, stc->d); }
+    if (stc->xp1) { amvp_mem_free(AMVP_MEM_TC, stc->xp1); }
+    if (stc->xp2) { amvp_mem_free(AMVP_MEM_TC, stc->xp2); }
+    if (stc->xp) { amvp_mem_free(AMVP_MEM_TC, stc->xp); }
+    if (stc->xq1) { amvp_mem_free(AMVP_MEM_TC, stc->xq1); }
+    if (stc->xq2) { amvp_mem_free(AMVP_MEM_TC, stc->xq2); }
+    if (stc->xq) { amvp_mem_free(AMVP_MEM_TC, stc->xq); }
 
     memzero_s(stc, sizeof(AMVP_RSA_KEYGEN_TC));
 
@@ -220,28 +220,28 @@ static AMVP_RESULT amvp_rsa_keygen_init_tc(AMVP_CTX *ctx,
     stc->pub_exp_mode = pub_exp_mode;
     stc->key_format = key_format;
 
-    stc->e = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->e = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->e) { return AMVP_MALLOC_FAIL; }
-    stc->p = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->p = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->p) { return AMVP_MALLOC_FAIL; }
-    stc->q = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->q = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->q) { return AMVP_MALLOC_FAIL; }
-    stc->n = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->n = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->n) { return AMVP_MALLOC_FAIL; }
-    stc->d = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->d = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->d) { return AMVP_MALLOC_FAIL; }
     if (rand_pq == AMVP_RSA_KEYGEN_B36 || !info_gen_by_server) {
-        stc->xp = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->xp = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->xp) { return AMVP_MALLOC_FAIL; }
-        stc->xp1 = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->xp1 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->xp1) { return AMVP_MALLOC_FAIL; }
-        stc->xp2 = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->xp2 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->xp2) { return AMVP_MALLOC_FAIL; }
-        stc->xq = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->xq = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->xq) { return AMVP_MALLOC_FAIL; }
-        stc->xq1 = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->xq1 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->xq1) { return AMVP_MALLOC_FAIL; }
-        stc->xq2 = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->xq2 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->xq2) { return AMVP_MALLOC_FAIL; }
     }
     if (rand_pq == AMVP_RSA_KEYGEN_B36) {
@@ -297,7 +297,7 @@ static AMVP_RESULT amvp_rsa_keygen_init_tc(AMVP_CTX *ctx,
         return rv;
     }
 
-    stc->seed = calloc(AMVP_RSA_SEEDLEN_MAX, sizeof(unsigned char));
+    stc->seed = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_SEEDLEN_MAX, sizeof(unsigned char));
     if (!stc->seed) { return AMVP_MALLOC_FAIL; }
 
     if (info_gen_by_server) {
@@ -394,7 +394,7 @@ AMVP_RESULT amvp_rsa_keygen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
     AMVP_RSA_KEYGEN_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
 
     AMVP_CIPHER alg_id;
@@ -479,6 +479,7 @@ AMVP_RESULT amvp_rsa_keygen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -736,7 +737,7 @@ AMVP_RESULT amvp_rsa_keygen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
             /* Process the current test vector... */
             if (rv == AMVP_SUCCESS) {
-                if ((cap->crypto_handler)(&tc)) {
+                if (amvp_crypto_handler(ctx, cap, &tc)) {
                     AMVP_LOG_ERR("ERROR: crypto module failed the operation");
                     rv = AMVP_CRYPTO_MODULE_FAIL;
                     json_value_free(r_tval);
@@ -767,7 +768,7 @@ AMVP_RESULT amvp_rsa_keygen_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
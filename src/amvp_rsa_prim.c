@@ -94,28 +94,28 @@ err:
 }
 
 static AMVP_RESULT amvp_rsa_decprim_release_tc(AMVP_RSA_PRIM_TC *stc) {
-    if (stc->e) { free(stc->e); }
-    if (stc->n) { free(stc->n); }
-    if (stc->pt) { free(stc->pt); }
-    if (stc->cipher) { free(stc->cipher); }
-    if (stc->plaintext) { free(stc->plaintext); }
+    if (stc->e) { amvp_mem_free(AMVP_MEM_TC, stc->e); }
+    if (stc->n) { amvp_mem_free(AMVP_MEM_TC, stc->n); }
+    if (stc->pt) { amvp_mem_free(AMVP_MEM_TC, stc->pt); }
+    if (stc->cipher) { amvp_mem_free(AMVP_MEM_TC, stc->cipher); }
+    if (stc->plaintext) { amvp_mem_free(AMVP_MEM_TC, stc->plaintext); }
     memzero_s(stc, sizeof(AMVP_RSA_PRIM_TC));
 
     return AMVP_SUCCESS;
 }
 
 static AMVP_RESULT amvp_rsa_sigprim_release_tc(AMVP_RSA_PRIM_TC *stc) {
-    if (stc->e) { free(stc->e); }
-    if (stc->d) { free(stc->d); }
-    if (stc->n) { free(stc->n); }
-    if (stc->p) { free(stc->p); }
-    if (stc->q) { free(stc->q); }
-    if (stc->dmp1) { free(stc->dmp1); }
-    if (stc->dmq1) { free(stc->dmq1); }
-    if (stc->iqmp) { free(stc->iqmp); }
-    if (stc->pt) { free(stc->pt); }
-    if (stc->msg) { free(stc->msg); }
-    if (stc->signature) { free(stc->signature); }
+    if (stc->e) { amvp_mem_free(AMVP_MEM_TC, stc->e); }
+    if (stc->d) { amvp_mem_free(AMVP_MEM_TC, stc->d); }
+    if (stc->n) { amvp_mem_free(AMVP_MEM_TC, stc->n); }
+    if (stc->p) { amvp_mem_free(AMVP_MEM_TC, stc->p); }
+    if (stc->q) { amvp_mem_free(AMVP_MEM_TC, stc->q); }
+    if (stc->dmp1) { amvp_mem_free(AMVP_MEM_TC, stc->dmp1); }
+    if (stc->dmq1) { amvp_mem_free(AMVP_MEM_TC, stc->dmq1); }
+    if (stc->iqmp) { amvp_mem_free(AMVP_MEM_TC, stc->iqmp); }
+    if (stc->pt) { amvp_mem_free(AMVP_MEM_TC, stc->pt); }
+    if (stc->msg) { amvp_mem_free(AMVP_MEM_TC, stc->msg); }
+    if (stc->signature) { amvp_mem_free(AMVP_MEM_TC, stc->signature); }
     memzero_s(stc, sizeof(AMVP_RSA_PRIM_TC));
 
     return AMVP_SUCCESS;
@@ -138,20 +138,20 @@ static AMVP_RESULT amvp_rsa_decprim_init_tc(AMVP_CTX *ctx,
     stc->pass = pass;
     stc->fail = fail;
     stc->cipher_len = cipher_len;
-    stc->cipher = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->cipher = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->cipher) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(cipher, stc->cipher, AMVP_RSA_EXP_BYTE_MAX, &(stc->cipher_len));
     if (rv != AMVP_SUCCESS) {
         AMVP_LOG_ERR("Hex conversion failure (cipher)");
         return rv;
     }
-    stc->plaintext = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->plaintext = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->plaintext) { return AMVP_MALLOC_FAIL; }
-    stc->e = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->e = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->e) { return AMVP_MALLOC_FAIL; }
-    stc->n = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->n = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->n) { return AMVP_MALLOC_FAIL; }
-    stc->pt = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->pt = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->pt) { return AMVP_MALLOC_FAIL; }
 
     return AMVP_SUCCESS;
@@ -175,7 +175,7 @@ static AMVP_RESULT amvp_rsa_sigprim_init_tc(AMVP_CTX *ctx,
 
     memzero_s(stc, sizeof(AMVP_RSA_PRIM_TC));
 
-    stc->e = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->e = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->e) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(e_str, stc->e, AMVP_RSA_EXP_BYTE_MAX, &(stc->e_len));
     if (rv != AMVP_SUCCESS) {
@@ -184,7 +184,7 @@ static AMVP_RESULT amvp_rsa_sigprim_init_tc(AMVP_CTX *ctx,
     }
 
     if (d_str) {
-        stc->d = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->d = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->d) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(d_str, stc->d, AMVP_RSA_EXP_BYTE_MAX, &(stc->d_len));
         if (rv != AMVP_SUCCESS) {
@@ -193,7 +193,7 @@ static AMVP_RESULT amvp_rsa_sigprim_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->n = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->n = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->n) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(n_str, stc->n, AMVP_RSA_EXP_BYTE_MAX, &(stc->n_len));
     if (rv != AMVP_SUCCESS) {
@@ -202,7 +202,7 @@ static AMVP_RESULT amvp_rsa_sigprim_init_tc(AMVP_CTX *ctx,
     }
 
     if (p_str) {
-        stc->p = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->p = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->p) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(p_str, stc->p, AMVP_RSA_EXP_BYTE_MAX, &(stc->p_len));
         if (rv != AMVP_SUCCESS) {
@@ -212,7 +212,7 @@ static AMVP_RESULT amvp_rsa_sigprim_init_tc(AMVP_CTX *ctx,
     }
 
     if (q_str) {
-        stc->q = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->q = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->q) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(q_str, stc->q, AMVP_RSA_EXP_BYTE_MAX, &(stc->q_len));
         if (rv != AMVP_SUCCESS) {
@@ -222,7 +222,7 @@ static AMVP_RESULT amvp_rsa_sigprim_init_tc(AMVP_CTX *ctx,
     }
 
     if (dmp1_str) {
-        stc->dmp1 = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->dmp1 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->dmp1) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(dmp1_str, stc->dmp1, AMVP_RSA_EXP_BYTE_MAX, &(stc->dmp1_len));
         if (rv != AMVP_SUCCESS) {
@@ -232,7 +232,7 @@ static AMVP_RESULT amvp_rsa_sigprim_init_tc(AMVP_CTX *ctx,
     }
 
     if (dmq1_str) {
-        stc->dmq1 = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->dmq1 = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->dmq1) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(dmq1_str, stc->dmq1, AMVP_RSA_EXP_BYTE_MAX, &(stc->dmq1_len));
         if (rv != AMVP_SUCCESS) {
@@ -242,7 +242,7 @@ static AMVP_RESULT amvp_rsa_sigprim_init_tc(AMVP_CTX *ctx,
     }
 
     if (iqmp_str) {
-        stc->iqmp = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+        stc->iqmp = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
         if (!stc->iqmp) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(iqmp_str, stc->iqmp, AMVP_RSA_EXP_BYTE_MAX, &(stc->iqmp_len));
         if (rv != AMVP_SUCCESS) {
@@ -251,7 +251,7 @@ static AMVP_RESULT amvp_rsa_sigprim_init_tc(AMVP_CTX *ctx,
         }
     }
 
-    stc->msg = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->msg = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->msg) { return AMVP_MALLOC_FAIL; }
     rv = amvp_hexstr_to_bin(msg, stc->msg, AMVP_RSA_EXP_BYTE_MAX, &(stc->msg_len));
     if (rv != AMVP_SUCCESS) {
@@ -261,7 +261,7 @@ static AMVP_RESULT amvp_rsa_sigprim_init_tc(AMVP_CTX *ctx,
 
     stc->modulo = modulo;
     stc->key_format = keyformat;
-    stc->signature = calloc(AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
+    stc->signature = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_BYTE_MAX, sizeof(unsigned char));
     if (!stc->signature) { return AMVP_MALLOC_FAIL; }
 
     return AMVP_SUCCESS;
@@ -294,7 +294,7 @@ AMVP_RESULT amvp_rsa_decprim_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL, *r_cobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
     AMVP_RSA_PRIM_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_RESULT rv;
 
     AMVP_CIPHER alg_id;
@@ -370,6 +370,7 @@ AMVP_RESULT amvp_rsa_decprim_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -473,7 +474,7 @@ AMVP_RESULT amvp_rsa_decprim_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
                    fail = stc.fail;
                    pass = stc.pass;
                    do { 
-                       if ((cap->crypto_handler)(&tc)) {
+                       if (amvp_crypto_handler(ctx, cap, &tc)) {
                            AMVP_LOG_ERR("ERROR: crypto module failed the operation");
                            rv = AMVP_CRYPTO_MODULE_FAIL;
                            json_value_free(r_tval);
@@ -511,7 +512,7 @@ AMVP_RESULT amvp_rsa_decprim_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -547,7 +548,7 @@ AMVP_RESULT amvp_rsa_sigprim_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
     AMVP_RSA_PRIM_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     int diff = 0;
     unsigned int mod = 0;
     unsigned int keyformat = 0;
@@ -630,6 +631,7 @@ AMVP_RESULT amvp_rsa_sigprim_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -764,7 +766,7 @@ AMVP_RESULT amvp_rsa_sigprim_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
             /* Process the current test vector... */
             if (rv == AMVP_SUCCESS) {
-                if ((cap->crypto_handler)(&tc)) {
+                if (amvp_crypto_handler(ctx, cap, &tc)) {
                     AMVP_LOG_ERR("ERROR: crypto module failed the operation");
                     rv = AMVP_CRYPTO_MODULE_FAIL;
                     json_value_free(r_tval);
@@ -795,7 +797,7 @@ AMVP_RESULT amvp_rsa_sigprim_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
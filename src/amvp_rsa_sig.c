@@ -56,11 +56,11 @@ err:
  */
 
 static AMVP_RESULT amvp_rsa_siggen_release_tc(AMVP_RSA_SIG_TC *stc) {
-    if (stc->msg) { free(stc->msg); }
-    if (stc->e) { free(stc->e); }
-    if (stc->n) { free(stc->n); }
-    if (stc->signature) { free(stc->signature); }
-    if (stc->salt) { free(stc->salt); }
+    if (stc->msg) { amvp_mem_free(AMVP_MEM_TC, stc->msg); }
+    if (stc->e) { amvp_mem_free(AMVP_MEM_TC, stc->e); }
+    if (stc->n) { amvp_mem_free(AMVP_MEM_TC, stc->n); }
+    if (stc->signature) { amvp_mem_free(AMVP_MEM_TC, stc->signature); }
+    if (stc->salt) { amvp_mem_free(AMVP_MEM_TC, stc->salt); }
     memzero_s(stc, sizeof(AMVP_RSA_SIG_TC));
     return AMVP_SUCCESS;
 }
@@ -83,16 +83,16 @@ static AMVP_RESULT amvp_rsa_sig_init_tc(AMVP_CTX *ctx,
 
     memzero_s(stc, sizeof(AMVP_RSA_SIG_TC));
 
-    stc->msg = calloc(AMVP_RSA_MSGLEN_MAX, sizeof(char));
+    stc->msg = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_MSGLEN_MAX, sizeof(char));
     if (!stc->msg) { return AMVP_MALLOC_FAIL; }
-    stc->signature = calloc(AMVP_RSA_SIGNATURE_MAX, sizeof(char));
+    stc->signature = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_SIGNATURE_MAX, sizeof(char));
     if (!stc->signature) { return AMVP_MALLOC_FAIL; }
-    stc->salt = calloc(AMVP_RSA_SIGNATURE_MAX, sizeof(char));
+    stc->salt = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_SIGNATURE_MAX, sizeof(char));
     if (!stc->salt) { return AMVP_MALLOC_FAIL; }
 
-    stc->e = calloc(AMVP_RSA_EXP_LEN_MAX, sizeof(char));
+    stc->e = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_LEN_MAX, sizeof(char));
     if (!stc->e) { return AMVP_MALLOC_FAIL; }
-    stc->n = calloc(AMVP_RSA_EXP_LEN_MAX, sizeof(char));
+    stc->n = amvp_mem_calloc(AMVP_MEM_TC, AMVP_RSA_EXP_LEN_MAX, sizeof(char));
     if (!stc->n) { goto err; }
 
     rv = amvp_hexstr_to_bin(msg, stc->msg, AMVP_RSA_MSGLEN_MAX, &(stc->msg_len));
@@ -140,7 +140,7 @@ static AMVP_RESULT amvp_rsa_sig_init_tc(AMVP_CTX *ctx,
 
 err:
     AMVP_LOG_ERR("Failed to allocate buffer in RSA test case");
-    if (stc->n) free(stc->n);
+    if (stc->n) amvp_mem_free(AMVP_MEM_TC, stc->n);
     return AMVP_MALLOC_FAIL;
 }
 
@@ -194,9 +194,10 @@ static AMVP_RESULT amvp_rsa_sig_kat_handler_internal(AMVP_CTX *ctx, JSON_Object
     JSON_Array *r_tarr = NULL, *r_garr = NULL;  /* Response testarray, grouparray */
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
-    AMVP_CAPS_LIST *cap;
+    AMVP_CAPS_LIST *cap = NULL;
     AMVP_RSA_SIG_TC stc;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
+    AMVP_TEST_GROUP group = { 0 };
 
     AMVP_CIPHER alg_id;
     char *json_result = NULL;
@@ -233,6 +234,7 @@ static AMVP_RESULT amvp_rsa_sig_kat_handler_internal(AMVP_CTX *ctx, JSON_Object
     }
 
     tc.tc.rsa_sig = &stc;
+    tc.group = &group;
     memzero_s(&stc, sizeof(AMVP_RSA_SIG_TC));
     stc.sig_mode = alg_id;
 
@@ -281,6 +283,7 @@ static AMVP_RESULT amvp_rsa_sig_kat_handler_internal(AMVP_CTX *ctx, JSON_Object
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tgId = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tgId);
         if (!tgId) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MALFORMED_JSON;
@@ -354,6 +357,19 @@ static AMVP_RESULT amvp_rsa_sig_kat_handler_internal(AMVP_CTX *ctx, JSON_Object
         AMVP_LOG_VERBOSE("           modulo: %d", mod);
         AMVP_LOG_VERBOSE("          hashAlg: %s", hash_alg_str);
 
+        /*
+         * Let the crypto module set up any state shared by the group
+         */
+        group.cipher = alg_id;
+        group.tg_id = tgId;
+        group.test_type = sig_type_str;
+        group.modulo = mod;
+        group.hash_alg = hash_alg;
+        rv = amvp_group_begin(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
+
         tests = json_object_get_array(groupobj, "tests");
         t_cnt = json_array_get_count(tests);
 
@@ -443,7 +459,7 @@ static AMVP_RESULT amvp_rsa_sig_kat_handler_internal(AMVP_CTX *ctx, JSON_Object
 
             /* Process the current test vector... */
             if (rv == AMVP_SUCCESS) {
-                if ((cap->crypto_handler)(&tc)) {
+                if (amvp_crypto_handler(ctx, cap, &tc)) {
                     AMVP_LOG_ERR("ERROR: crypto module failed the operation");
                     rv = AMVP_CRYPTO_MODULE_FAIL;
                     json_value_free(r_tval);
@@ -497,17 +513,22 @@ static AMVP_RESULT amvp_rsa_sig_kat_handler_internal(AMVP_CTX *ctx, JSON_Object
             /* Append the test response value to array */
             json_array_append_value(r_tarr, r_tval);
         }
+        rv = amvp_group_end(ctx, cap, &group);
+        if (rv != AMVP_SUCCESS) {
+            goto err;
+        }
         json_array_append_value(r_garr, r_gval);
     }
 
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
 
 err:
+    amvp_group_end(ctx, cap, &group);
     if (rv != AMVP_SUCCESS) {
         amvp_rsa_siggen_release_tc(&stc);
         amvp_release_json(r_vs_val, r_gval);
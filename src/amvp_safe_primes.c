@@ -62,8 +62,8 @@ static AMVP_SAFE_PRIMES_PARAM amvp_convert_dgm_string(const char *dgm_str)
  * a test case.
  */
 static AMVP_RESULT amvp_safe_primes_release_tc(AMVP_SAFE_PRIMES_TC *stc) {
-    if (stc->x) free(stc->x);
-    if (stc->y) free(stc->y);
+    if (stc->x) amvp_mem_free(AMVP_MEM_TC, stc->x);
+    if (stc->y) amvp_mem_free(AMVP_MEM_TC, stc->y);
     memzero_s(stc, sizeof(AMVP_SAFE_PRIMES_TC));
     return AMVP_SUCCESS;
 }
@@ -131,14 +131,14 @@ static AMVP_RESULT amvp_safe_primes_init_tc(AMVP_CTX *ctx,
     stc-> cipher = alg_id;
 
     if (alg_id == AMVP_SAFE_PRIMES_KEYVER) {
-        stc->y = calloc(1, AMVP_SAFE_PRIMES_BYTE_MAX);
+        stc->y = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_SAFE_PRIMES_BYTE_MAX);
         if (!stc->y) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(y, stc->y, AMVP_SAFE_PRIMES_BYTE_MAX, &(stc->ylen));
         if (rv != AMVP_SUCCESS) {
             AMVP_LOG_ERR("Hex conversion failure (y)");
             return rv;
         }
-        stc->x = calloc(1, AMVP_SAFE_PRIMES_BYTE_MAX);
+        stc->x = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_SAFE_PRIMES_BYTE_MAX);
         if (!stc->x) { return AMVP_MALLOC_FAIL; }
         rv = amvp_hexstr_to_bin(x, stc->x, AMVP_SAFE_PRIMES_BYTE_MAX, &(stc->xlen));
         if (rv != AMVP_SUCCESS) {
@@ -146,9 +146,9 @@ static AMVP_RESULT amvp_safe_primes_init_tc(AMVP_CTX *ctx,
             return rv;
         }
     } else {
-        stc->x = calloc(1, AMVP_SAFE_PRIMES_BYTE_MAX);
+        stc->x = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_SAFE_PRIMES_BYTE_MAX);
         if (!stc->x) { return AMVP_MALLOC_FAIL; }
-        stc->y = calloc(1, AMVP_SAFE_PRIMES_BYTE_MAX);
+        stc->y = amvp_mem_calloc(AMVP_MEM_TC, 1, AMVP_SAFE_PRIMES_BYTE_MAX);
         if (!stc->y) { return AMVP_MALLOC_FAIL; }
     }
     return AMVP_SUCCESS;
@@ -172,7 +172,7 @@ AMVP_RESULT amvp_safe_primes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     JSON_Value *r_tval = NULL, *r_gval = NULL;  /* Response testval, groupval */
     JSON_Object *r_tobj = NULL, *r_gobj = NULL; /* Response testobj, groupobj */
     AMVP_CAPS_LIST *cap;
-    AMVP_TEST_CASE tc;
+    AMVP_TEST_CASE tc = { 0 };
     AMVP_SAFE_PRIMES_TC stc;
     AMVP_RESULT rv = AMVP_SUCCESS;
     const char *alg_str = NULL, *dgm_str = NULL, *test_type_str = NULL;
@@ -254,6 +254,7 @@ AMVP_RESULT amvp_safe_primes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
         r_gval = json_value_init_object();
         r_gobj = json_value_get_object(r_gval);
         tg_id = json_object_get_number(groupobj, "tgId");
+        amvp_trace_group(ctx, tg_id);
         if (!tg_id) {
             AMVP_LOG_ERR("Missing tgid from server JSON groub obj");
             rv = AMVP_MISSING_ARG;
@@ -339,7 +340,7 @@ AMVP_RESULT amvp_safe_primes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
                 }
 
                 /* Process the current KAT test vector... */
-                if ((cap->crypto_handler)(&tc)) {
+                if (amvp_crypto_handler(ctx, cap, &tc)) {
                     amvp_safe_primes_release_tc(&stc);
                     AMVP_LOG_ERR("crypto module failed the operation");
                     rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -436,7 +437,7 @@ AMVP_RESULT amvp_safe_primes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
                 }
 
                 /* Process the current KAT test vector... */
-                if ((cap->crypto_handler)(&tc)) {
+                if (amvp_crypto_handler(ctx, cap, &tc)) {
                     amvp_safe_primes_release_tc(&stc);
                     AMVP_LOG_ERR("crypto module failed the operation");
                     rv = AMVP_CRYPTO_MODULE_FAIL;
@@ -483,7 +484,7 @@ AMVP_RESULT amvp_safe_primes_kat_handler(AMVP_CTX *ctx, JSON_Object *obj) {
     }
     json_array_append_value(reg_arry, r_vs_val);
 
-    json_result = json_serialize_to_string_pretty(ctx->kat_resp, NULL);
+    json_result = json_serialize_to_string_pretty(ctx->work.kat_resp, NULL);
     AMVP_LOG_VERBOSE("\n\n%s\n\n", json_result);
     json_free_serialized_string(json_result);
     rv = AMVP_SUCCESS;
@@ -0,0 +1,212 @@
+/** @file */
+/*
+ * Copyright (c) 2021, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libamvp/LICENSE
+ */
+
+/*
+ * Session timeline in the Chrome trace event format.
+ *
+ * When amvp_set_trace_file() was called, login, registration, every
+ * download, retry wait, processing and upload of a vector set, every test
+ * group and every results poll is written to the trace file as a complete
+ * ("X") event, which chrome://tracing and https://ui.perfetto.dev can load.
+ * Timestamps are microseconds since the trace file was opened. Each thread
+ * processing vector sets gets its own tid, so concurrent vector sets show up
+ * on separate tracks.
+ *
+ * The file is a JSON array that is only closed by amvp_trace_close(), the
+ * trace viewers also accept it without the closing bracket if the
+ * application did not get that far.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#include "amvp.h"
+#include "amvp_lcl.h"
+#include "safe_lib.h"
+
+#define AMVP_TRACE_SESSION_TID 1
+
+struct amvp_trace_t {
+    FILE *fp;
+    unsigned long long epoch; /* amvp_perf_now() when the file was opened */
+    int next_tid;
+#ifndef _WIN32
+    pthread_mutex_t lock;
+#endif
+};
+
+static void amvp_trace_lock(struct amvp_trace_t *trace) {
+#ifndef _WIN32
+    pthread_mutex_lock(&trace->lock);
+#else
+    (void)trace;
+#endif
+}
+
+static void amvp_trace_unlock(struct amvp_trace_t *trace) {
+#ifndef _WIN32
+    pthread_mutex_unlock(&trace->lock);
+#else
+    (void)trace;
+#endif
+}
+
+/*
+ * Write str as the contents of a JSON string
+ */
+static void amvp_trace_put_str(FILE *fp, const char *str) {
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\') {
+            fprintf(fp, "\\%c", *str);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(fp, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, fp);
+        }
+    }
+}
+
+static void amvp_trace_thread_name(struct amvp_trace_t *trace, int tid, const char *name) {
+    fprintf(trace->fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"", tid);
+    amvp_trace_put_str(trace->fp, name);
+    fprintf(trace->fp, "\"}},\n");
+}
+
+AMVP_RESULT amvp_trace_open(AMVP_CTX *ctx, const char *path) {
+    struct amvp_trace_t *trace = NULL;
+
+    trace = calloc(1, sizeof(struct amvp_trace_t));
+    if (!trace) {
+        return AMVP_MALLOC_FAIL;
+    }
+    trace->fp = fopen(path, "w");
+    if (!trace->fp) {
+        AMVP_LOG_ERR("Unable to open trace file %s", path);
+        free(trace);
+        return AMVP_INVALID_ARG;
+    }
+#ifndef _WIN32
+    pthread_mutex_init(&trace->lock, NULL);
+#endif
+    trace->epoch = amvp_perf_now();
+    trace->next_tid = AMVP_TRACE_SESSION_TID + 1;
+
+    fprintf(trace->fp, "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+            "\"args\":{\"name\":\"libamvp\"}},\n", AMVP_TRACE_SESSION_TID);
+    amvp_trace_thread_name(trace, AMVP_TRACE_SESSION_TID, "session");
+    ctx->trace = trace;
+    ctx->trace_tid = AMVP_TRACE_SESSION_TID;
+    return AMVP_SUCCESS;
+}
+
+void amvp_trace_close(AMVP_CTX *ctx) {
+    struct amvp_trace_t *trace = ctx->trace;
+
+    if (!trace) {
+        return;
+    }
+    ctx->trace = NULL;
+    /* An end marker without a trailing "," closes the array */
+    fprintf(trace->fp, "{\"name\":\"trace_end\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%d,\"ts\":%llu}\n]\n",
+            AMVP_TRACE_SESSION_TID, (amvp_perf_now() - trace->epoch) / 1000);
+    fclose(trace->fp);
+#ifndef _WIN32
+    pthread_mutex_destroy(&trace->lock);
+#endif
+    free(trace);
+}
+
+/*
+ * Give the thread running on ctx, a worker clone of the session ctx, a
+ * track of its own in the trace
+ */
+void amvp_trace_thread(AMVP_CTX *ctx, const char *name) {
+    struct amvp_trace_t *trace = ctx->trace;
+
+    if (!trace) {
+        return;
+    }
+    amvp_trace_lock(trace);
+    ctx->trace_tid = trace->next_tid++;
+    amvp_trace_thread_name(trace, ctx->trace_tid, name);
+    amvp_trace_unlock(trace);
+}
+
+unsigned long long amvp_trace_begin(AMVP_CTX *ctx) {
+    return ctx->trace ? amvp_perf_now() : 0;
+}
+
+/*
+ * Write a span that began at start, a value returned by amvp_trace_begin(),
+ * and ends now. vs_id, tg_id and url are added as arguments when set.
+ */
+static void amvp_trace_write(AMVP_CTX *ctx, const char *cat, const char *name,
+                             unsigned long long start, int vs_id, int tg_id, const char *url) {
+    struct amvp_trace_t *trace = ctx->trace;
+    unsigned long long end = amvp_perf_now();
+
+    if (start < trace->epoch) {
+        start = trace->epoch;
+    }
+    amvp_trace_lock(trace);
+    fprintf(trace->fp, "{\"name\":\"");
+    amvp_trace_put_str(trace->fp, name);
+    fprintf(trace->fp, "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":%d,\"args\":{",
+            cat, (start - trace->epoch) / 1000, (end - start) / 1000, ctx->trace_tid);
+    if (vs_id) {
+        fprintf(trace->fp, "\"vsId\":%d%s", vs_id, tg_id || url ? "," : "");
+    }
+    if (tg_id) {
+        fprintf(trace->fp, "\"tgId\":%d%s", tg_id, url ? "," : "");
+    }
+    if (url) {
+        fprintf(trace->fp, "\"url\":\"");
+        amvp_trace_put_str(trace->fp, url);
+        fprintf(trace->fp, "\"");
+    }
+    fprintf(trace->fp, "}},\n");
+    amvp_trace_unlock(trace);
+}
+
+void amvp_trace_span(AMVP_CTX *ctx, const char *cat, const char *name,
+                     unsigned long long start, int vs_id, const char *url) {
+    if (!ctx->trace || !start) {
+        return;
+    }
+    amvp_trace_write(ctx, cat, name, start, vs_id, 0, url);
+}
+
+/*
+ * Called by the algorithm handlers at the start of every test group. Ends
+ * the span of the previous group of the vector set and starts the one of
+ * tg_id; a tg_id of 0 only ends the previous one. The group is also noted for
+ * amvp_latency_record() and the group_start/group_done USDT probes.
+ */
+void amvp_trace_group(AMVP_CTX *ctx, int tg_id) {
+    if (ctx->work.tg_id) {
+        AMVP_PROBE2(group_done, ctx->work.vs_id, ctx->work.tg_id);
+    }
+    if (tg_id) {
+        AMVP_PROBE2(group_start, ctx->work.vs_id, tg_id);
+    }
+    ctx->work.tg_id = tg_id;
+    if (!ctx->trace) {
+        return;
+    }
+    if (ctx->work.trace_tg_id) {
+        amvp_trace_write(ctx, "test group", "test group", ctx->work.trace_tg_start,
+                         ctx->work.vs_id, ctx->work.trace_tg_id, NULL);
+    }
+    ctx->work.trace_tg_id = tg_id;
+    ctx->work.trace_tg_start = tg_id ? amvp_perf_now() : 0;
+}
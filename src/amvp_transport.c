@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <ctype.h>
 #include "amvp.h"
 #include "amvp_lcl.h"
 #include "amvp_error.h"
@@ -46,6 +47,7 @@
  * Macros
  */
 #define HTTP_OK    200
+#define HTTP_NOT_MODIFIED 304
 #define HTTP_UNAUTH    401
 #define HTTP_BAD_REQ 400
 
@@ -148,26 +150,60 @@ static size_t amvp_curl_write_callback(void *ptr, size_t size, size_t nmemb, voi
         return 0;
     }
 
-    if (!ctx->curl_buf) {
-        ctx->curl_buf = calloc(AMVP_CURL_BUF_MAX, sizeof(char));
-        if (!ctx->curl_buf) {
+    if (!ctx->work.curl_buf) {
+        ctx->work.curl_buf = amvp_mem_calloc(AMVP_MEM_TRANSPORT, AMVP_CURL_BUF_MAX, sizeof(char));
+        if (!ctx->work.curl_buf) {
             fprintf(stderr, "\nmalloc failed in curl write reg func\n");
             return 0;
         }
     }
 
-    if ((ctx->curl_read_ctr + nmemb) > AMVP_CURL_BUF_MAX) {
+    if ((ctx->work.curl_read_ctr + nmemb) > AMVP_CURL_BUF_MAX) {
         fprintf(stderr, "\nServer response is too large\n");
         return 0;
     }
 
-    memcpy_s(&ctx->curl_buf[ctx->curl_read_ctr], (AMVP_CURL_BUF_MAX - ctx->curl_read_ctr), ptr, nmemb);
-    ctx->curl_buf[ctx->curl_read_ctr + nmemb] = 0;
-    ctx->curl_read_ctr += nmemb;
+    memcpy_s(&ctx->work.curl_buf[ctx->work.curl_read_ctr], (AMVP_CURL_BUF_MAX - ctx->work.curl_read_ctr), ptr, nmemb);
+    ctx->work.curl_buf[ctx->work.curl_read_ctr + nmemb] = 0;
+    ctx->work.curl_read_ctr += nmemb;
 
     return nmemb;
 }
 
+/*
+ * This is a callback used by curl for each HTTP response header of a
+ * conditional GET. The ETag is kept so that the next GET of the same
+ * document can be answered with 304 Not Modified.
+ */
+static size_t amvp_curl_header_callback(char *buffer, size_t size, size_t nitems, void *userdata) {
+    AMVP_CTX *ctx = (AMVP_CTX *)userdata;
+    const char *name = "etag:";
+    size_t len = size * nitems;
+    size_t name_len = strlen(name);
+    size_t start = 0, end = 0;
+
+    if (len <= name_len) {
+        return len;
+    }
+    for (start = 0; start < name_len; start++) {
+        if (tolower((unsigned char)buffer[start]) != name[start]) {
+            return len;
+        }
+    }
+    while (start < len && (buffer[start] == ' ' || buffer[start] == '\t')) {
+        start++;
+    }
+    end = len;
+    while (end > start && (buffer[end - 1] == '\r' || buffer[end - 1] == '\n' || buffer[end - 1] == ' ')) {
+        end--;
+    }
+    if (end > start && end - start <= AMVP_ETAG_MAX) {
+        memcpy_s(ctx->work.etag, AMVP_ETAG_MAX + 1, &buffer[start], end - start);
+        ctx->work.etag[end - start] = 0;
+    }
+    return len;
+}
+
 /*
  * This function uses libcurl to send a simple HTTP GET
  * request with no Content-Type header.
@@ -185,13 +221,26 @@ static long amvp_curl_http_get(AMVP_CTX *ctx, const char *url) {
     CURL *hnd = NULL;
     struct curl_slist *slist = NULL;
     CURLcode crv = CURLE_OK;
+    char cond_hdr[AMVP_ETAG_MAX + sizeof("If-None-Match: ")];
+    int use_etag = ctx->work.use_etag;
 
     /*
      * Create the Authorzation header if needed
      */
     slist = amvp_add_auth_hdr(ctx, slist);
 
-    ctx->curl_read_ctr = 0;
+    /*
+     * A conditional GET is single use, like the tmp_jwt.
+     * The library turns it back on for each results poll.
+     */
+    ctx->work.use_etag = 0;
+    ctx->work.not_modified = 0;
+    if (use_etag && ctx->work.etag[0]) {
+        snprintf(cond_hdr, sizeof(cond_hdr), "If-None-Match: %s", ctx->work.etag);
+        slist = curl_slist_append(slist, cond_hdr);
+    }
+
+    ctx->work.curl_read_ctr = 0;
 
     //Setup Curl
     hnd = curl_easy_init();
@@ -236,10 +285,16 @@ static long amvp_curl_http_get(AMVP_CTX *ctx, const char *url) {
     if (crv) { AMVP_LOG_ERR("Error setting curl option CURLOPT_WRITEDATA, stopping"); goto end; }
     crv = curl_easy_setopt(hnd, CURLOPT_WRITEFUNCTION, amvp_curl_write_callback);
     if (crv) { AMVP_LOG_ERR("Error setting curl option CURLOPT_WRITEFUNCTION, stopping"); goto end; }
+    if (use_etag) {
+        crv = curl_easy_setopt(hnd, CURLOPT_HEADERDATA, ctx);
+        if (crv) { AMVP_LOG_ERR("Error setting curl option CURLOPT_HEADERDATA, stopping"); goto end; }
+        crv = curl_easy_setopt(hnd, CURLOPT_HEADERFUNCTION, amvp_curl_header_callback);
+        if (crv) { AMVP_LOG_ERR("Error setting curl option CURLOPT_HEADERFUNCTION, stopping"); goto end; }
+    }
 
-    if (ctx->curl_buf) {
+    if (ctx->work.curl_buf) {
         /* Clear the HTTP buffer for next server response */
-        memzero_s(ctx->curl_buf, AMVP_CURL_BUF_MAX);
+        memzero_s(ctx->work.curl_buf, AMVP_CURL_BUF_MAX);
     }
 
     //crv = curl_easy_setopt(hnd, CURLOPT_VERBOSE, 1L);
@@ -249,12 +304,15 @@ static long amvp_curl_http_get(AMVP_CTX *ctx, const char *url) {
     curl_easy_perform(hnd);
 
     if (ctx->log_lvl == AMVP_LOG_LVL_VERBOSE) {
-        printf("\nHTTP GET RSP:\n\n%s\n", ctx->curl_buf);
+        printf("\nHTTP GET RSP:\n\n%s\n", ctx->work.curl_buf);
     }
     /*
      * Get the HTTP reponse status code from the server
      */
     curl_easy_getinfo(hnd, CURLINFO_RESPONSE_CODE, &http_code);
+    if (use_etag && http_code == HTTP_NOT_MODIFIED) {
+        ctx->work.not_modified = 1;
+    }
 
 end:
     if (hnd) curl_easy_cleanup(hnd);
@@ -296,7 +354,7 @@ static long amvp_curl_http_post(AMVP_CTX *ctx, const char *url, const char *data
      */
     slist = amvp_add_auth_hdr(ctx, slist);
 
-    ctx->curl_read_ctr = 0;
+    ctx->work.curl_read_ctr = 0;
 
    //Setup Curl
     hnd = curl_easy_init();
@@ -347,9 +405,9 @@ static long amvp_curl_http_post(AMVP_CTX *ctx, const char *url, const char *data
     crv = curl_easy_setopt(hnd, CURLOPT_WRITEFUNCTION, amvp_curl_write_callback);
     if (crv) { AMVP_LOG_ERR("Error setting curl option CURLOPT_WRITEFUNCTION, stopping"); goto end; }
 
-    if (ctx->curl_buf) {
+    if (ctx->work.curl_buf) {
         /* Clear the HTTP buffer for next server response */
-        memzero_s(ctx->curl_buf, AMVP_CURL_BUF_MAX);
+        memzero_s(ctx->work.curl_buf, AMVP_CURL_BUF_MAX);
     }
     //crv = curl_easy_setopt(hnd, CURLOPT_VERBOSE, 1L);
     
@@ -361,7 +419,7 @@ static long amvp_curl_http_post(AMVP_CTX *ctx, const char *url, const char *data
         AMVP_LOG_ERR("Curl failed with code %d (%s)", crv, curl_easy_strerror(crv));
     }
     if (ctx->log_lvl == AMVP_LOG_LVL_VERBOSE) {
-        printf("\nHTTP POST RSP:\n\n%s\n", ctx->curl_buf);
+        printf("\nHTTP POST RSP:\n\n%s\n", ctx->work.curl_buf);
     }
 
     /*
@@ -398,7 +456,7 @@ static long amvp_curl_http_put(AMVP_CTX *ctx, const char *url, const char *data,
     struct curl_slist *slist = NULL;
 
 
-    ctx->curl_read_ctr = 0;
+    ctx->work.curl_read_ctr = 0;
     /*
      * Set the Content-Type header in the HTTP request
      */
@@ -456,9 +514,9 @@ static long amvp_curl_http_put(AMVP_CTX *ctx, const char *url, const char *data,
     crv = curl_easy_setopt(hnd, CURLOPT_WRITEFUNCTION, amvp_curl_write_callback);
     if (crv) { AMVP_LOG_ERR("Error setting curl option CURLOPT_WRITEFUNCTION, stopping"); goto end; }
 
-    if (ctx->curl_buf) {
+    if (ctx->work.curl_buf) {
         /* Clear the HTTP buffer for next server response */
-        memzero_s(ctx->curl_buf, AMVP_CURL_BUF_MAX);
+        memzero_s(ctx->work.curl_buf, AMVP_CURL_BUF_MAX);
     }
 
     if (ctx->log_lvl == AMVP_LOG_LVL_VERBOSE) {
@@ -475,7 +533,7 @@ static long amvp_curl_http_put(AMVP_CTX *ctx, const char *url, const char *data,
     }
 
     if (ctx->log_lvl == AMVP_LOG_LVL_VERBOSE) {
-        printf("\nHTTP PUT RSP:\n\n%s\n", ctx->curl_buf);
+        printf("\nHTTP PUT RSP:\n\n%s\n", ctx->work.curl_buf);
     }
 
     /*
@@ -512,7 +570,7 @@ static long amvp_curl_http_delete(AMVP_CTX *ctx, const char *url) {
     struct curl_slist *slist = NULL;
 
 
-    ctx->curl_read_ctr = 0;
+    ctx->work.curl_read_ctr = 0;
     /*
      * Set the Content-Type header in the HTTP request
      */
@@ -566,9 +624,9 @@ static long amvp_curl_http_delete(AMVP_CTX *ctx, const char *url) {
     crv = curl_easy_setopt(hnd, CURLOPT_WRITEFUNCTION, amvp_curl_write_callback);
     if (crv) { AMVP_LOG_ERR("Error setting curl option CURLOPT_WRITEFUNCTION, stopping"); goto end; }
 
-    if (ctx->curl_buf) {
+    if (ctx->work.curl_buf) {
         /* Clear the HTTP buffer for next server response */
-        memzero_s(ctx->curl_buf, AMVP_CURL_BUF_MAX);
+        memzero_s(ctx->work.curl_buf, AMVP_CURL_BUF_MAX);
     }
 
     if (ctx->log_lvl == AMVP_LOG_LVL_VERBOSE) {
@@ -597,6 +655,62 @@ end:
     return http_code;
 }
 
+/*
+ * Every HTTP request of execute_network_action() goes through here. The
+ * request is answered from the recording loaded by
+ * amvp_set_transport_replay() if there is one, and sent with libcurl
+ * otherwise; either way the exchange is added to the recording of
+ * amvp_set_transport_record(), see amvp_record.c.
+ *
+ * Return value is the HTTP status value from the server
+ */
+static long amvp_http_request(AMVP_CTX *ctx,
+                              AMVP_HTTP_METHOD method,
+                              const char *url,
+                              const char *data,
+                              int data_len) {
+    long http_code = 0;
+    unsigned long long start = 0;
+    char etag[AMVP_ETAG_MAX + 1] = {0};
+    int auth = 0;
+
+    if (ctx->record) {
+        /* The request headers, before the transport consumes them */
+        auth = ctx->jwt_token || (ctx->tmp_jwt && ctx->use_tmp_jwt);
+        if (method == AMVP_HTTP_GET && ctx->work.use_etag) {
+            strcpy_s(etag, sizeof(etag), ctx->work.etag);
+        }
+        start = amvp_perf_now();
+    }
+
+    if (ctx->replay) {
+        http_code = amvp_replay_http(ctx, method, url);
+    } else {
+        switch (method) {
+        case AMVP_HTTP_GET:
+            http_code = amvp_curl_http_get(ctx, url);
+            break;
+        case AMVP_HTTP_POST:
+            http_code = amvp_curl_http_post(ctx, url, data, data_len);
+            break;
+        case AMVP_HTTP_PUT:
+            http_code = amvp_curl_http_put(ctx, url, data, data_len);
+            break;
+        case AMVP_HTTP_DELETE:
+        default:
+            http_code = amvp_curl_http_delete(ctx, url);
+            break;
+        }
+    }
+
+    if (ctx->record) {
+        amvp_record_http(ctx, method, url, auth, etag, data, data_len, http_code, start);
+    }
+    ctx->work.http_code = (int)http_code;
+    return http_code;
+}
+
+
 
 static AMVP_RESULT sanity_check_ctx(AMVP_CTX *ctx) {
     if (!ctx) {
@@ -1003,7 +1117,10 @@ static AMVP_RESULT inspect_http_code(AMVP_CTX *ctx, int code) {
     if (code == HTTP_OK) {
         /* 200 */
         return AMVP_SUCCESS;
-    } else if (amvp_is_protocol_error_message(ctx->curl_buf)) {
+    } else if (code == HTTP_NOT_MODIFIED && ctx->work.not_modified) {
+        /* 304 to a conditional GET, the caller keeps its copy */
+        return AMVP_SUCCESS;
+    } else if (amvp_is_protocol_error_message(ctx->work.curl_buf)) {
         return AMVP_PROTOCOL_RSP_ERR; /* Let the caller parse the error */
     }
 
@@ -1014,7 +1131,7 @@ static AMVP_RESULT inspect_http_code(AMVP_CTX *ctx, int code) {
     if (code == HTTP_UNAUTH) {
         char *diff = NULL;
 
-        root_value = json_parse_string(ctx->curl_buf);
+        root_value = json_parse_string(ctx->work.curl_buf);
 
         arr = json_value_get_array(root_value);
         if (!arr) {
@@ -1078,6 +1195,7 @@ static AMVP_RESULT execute_network_action(AMVP_CTX *ctx,
 #endif
     int resp_len = 0;
     int rc = 0;
+    unsigned long long start = amvp_perf_now(), serialize_ns = 0;
 
     switch(action) {
     case AMVP_NET_GET:
@@ -1085,22 +1203,25 @@ static AMVP_RESULT execute_network_action(AMVP_CTX *ctx,
     case AMVP_NET_GET_DOCS:
     case AMVP_NET_GET_VS_RESULT:
     case AMVP_NET_GET_VS_SAMPLE:
-        rc = amvp_curl_http_get(ctx, url);
+        rc = amvp_http_request(ctx, AMVP_HTTP_GET, url, NULL, 0);
         break;
 
     case AMVP_NET_POST:
     case AMVP_NET_POST_LOGIN:
     case AMVP_NET_POST_REG:
-        rc = amvp_curl_http_post(ctx, url, data, data_len);
+        rc = amvp_http_request(ctx, AMVP_HTTP_POST, url, data, data_len);
         break;
 
     case AMVP_NET_PUT:
     case AMVP_NET_PUT_VALIDATION:
-        rc = amvp_curl_http_put(ctx, url, data, data_len);
+        rc = amvp_http_request(ctx, AMVP_HTTP_PUT, url, data, data_len);
         break;
 
     case AMVP_NET_POST_VS_RESP:
-        resp = json_serialize_to_string(ctx->kat_resp, &resp_len);
+        resp = json_serialize_to_string(ctx->work.kat_resp, &resp_len);
+        serialize_ns = amvp_perf_now() - start;
+        ctx->work.perf.serialize_ns += serialize_ns;
+        AMVP_PROBE2(serialize, ctx->work.vs_id, resp_len);
         if (!resp) {
             AMVP_LOG_ERR("Failed to post vector set responses");
             return AMVP_JSON_ERR;
@@ -1120,27 +1241,31 @@ static AMVP_RESULT execute_network_action(AMVP_CTX *ctx,
             result = amvp_notify_large(ctx, url, large_url, resp_len);
             if (result != AMVP_SUCCESS) goto end;
 
-            rc = amvp_curl_http_post(ctx, large_url, resp, resp_len);
+            rc = amvp_http_request(ctx, AMVP_HTTP_POST, large_url, resp, resp_len);
         } else {
 #endif
-            rc = amvp_curl_http_post(ctx, url, resp, resp_len);
+            rc = amvp_http_request(ctx, AMVP_HTTP_POST, url, resp, resp_len);
             //Check for code 400, which means we are reuploading a resp and must use PUT instead
             result = inspect_http_code(ctx, rc);
             if (result == AMVP_UNSUPPORTED_OP) {
-                rc = amvp_curl_http_put(ctx, url, resp, resp_len);
+                rc = amvp_http_request(ctx, AMVP_HTTP_PUT, url, resp, resp_len);
             }
 #ifdef AMVP_DEPRECATED
         }
 #endif
         break;
     case AMVP_NET_DELETE:
-        rc = amvp_curl_http_delete(ctx, url);
+        rc = amvp_http_request(ctx, AMVP_HTTP_DELETE, url, NULL, 0);
         break;
     default:
         AMVP_LOG_ERR("Unknown AMVP_NET_ACTION");
         return AMVP_INVALID_ARG;
     }
 
+    ctx->work.perf.network_ns += amvp_perf_now() - start - serialize_ns;
+    ctx->work.perf.bytes_out += resp ? resp_len : data_len;
+    ctx->work.perf.bytes_in += ctx->work.curl_read_ctr;
+
     /* Peek at the HTTP code */
     result = inspect_http_code(ctx, rc);
     if (result == AMVP_PROTOCOL_RSP_ERR) {
@@ -1173,37 +1298,37 @@ static AMVP_RESULT execute_network_action(AMVP_CTX *ctx,
             case AMVP_NET_GET_DOCS:
             case AMVP_NET_GET_VS_RESULT:
             case AMVP_NET_GET_VS_SAMPLE:
-                rc = amvp_curl_http_get(ctx, url);
+                rc = amvp_http_request(ctx, AMVP_HTTP_GET, url, NULL, 0);
                 break;
 
             case AMVP_NET_POST:
             case AMVP_NET_POST_REG:
-                rc = amvp_curl_http_post(ctx, url, data, data_len);
+                rc = amvp_http_request(ctx, AMVP_HTTP_POST, url, data, data_len);
                 break;
 
             case AMVP_NET_PUT:
             case AMVP_NET_PUT_VALIDATION:
-                rc = amvp_curl_http_put(ctx, url, data, data_len);
+                rc = amvp_http_request(ctx, AMVP_HTTP_PUT, url, data, data_len);
                 break;
 
             case AMVP_NET_POST_VS_RESP:
 #ifdef AMVP_DEPRECATED
                 if (large_submission) {
-                    rc = amvp_curl_http_post(ctx, large_url, resp, resp_len);
+                    rc = amvp_http_request(ctx, AMVP_HTTP_POST, large_url, resp, resp_len);
                 } else {
 #endif
-                    rc = amvp_curl_http_post(ctx, url, resp, resp_len);
+                    rc = amvp_http_request(ctx, AMVP_HTTP_POST, url, resp, resp_len);
                     //Check for code 400, which means we are reuploading a resp and must use PUT instead
                     result = inspect_http_code(ctx, rc);
                     if (result == AMVP_UNSUPPORTED_OP) {
-                        rc = amvp_curl_http_put(ctx, url, resp, resp_len);
+                        rc = amvp_http_request(ctx, AMVP_HTTP_PUT, url, resp, resp_len);
                     }
 #ifdef AMVP_DEPRECATED
                 }
 #endif
                 break;
             case AMVP_NET_DELETE:
-                amvp_curl_http_delete(ctx, url);
+                amvp_http_request(ctx, AMVP_HTTP_DELETE, url, NULL, 0);
                 break;
             case AMVP_NET_POST_LOGIN:
             default:
@@ -1246,33 +1371,33 @@ static void log_network_status(AMVP_CTX *ctx,
     switch(action) {
     case AMVP_NET_GET:
         AMVP_LOG_VERBOSE("GET...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                      curl_code, url, ctx->curl_buf);
+                      curl_code, url, ctx->work.curl_buf);
         break;
     case AMVP_NET_GET_VS:
         AMVP_LOG_STATUS("GET Vector Set...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                         curl_code, url, ctx->curl_buf);
+                         curl_code, url, ctx->work.curl_buf);
         break;
     case AMVP_NET_GET_DOCS:
         AMVP_LOG_STATUS("GET SP and DC...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                         curl_code, url, ctx->curl_buf);
+                         curl_code, url, ctx->work.curl_buf);
         break;
     case AMVP_NET_GET_VS_RESULT:
         AMVP_LOG_STATUS("GET Vector Set Result...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                        curl_code, url, ctx->curl_buf);
+                        curl_code, url, ctx->work.curl_buf);
         break;
     case AMVP_NET_GET_VS_SAMPLE:
         AMVP_LOG_VERBOSE("GET Vector Set Sample...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                        curl_code, url, ctx->curl_buf);
+                        curl_code, url, ctx->work.curl_buf);
         break;
     case AMVP_NET_POST:
         AMVP_LOG_STATUS("POST...\n\tStatus: %d\n\tUrl: %s\n\tResp: %s\n",
-                        curl_code, url, ctx->curl_buf);
+                        curl_code, url, ctx->work.curl_buf);
         break;
     case AMVP_NET_POST_LOGIN:
         AMVP_LOG_VERBOSE("POST Login...\n\tStatus: %d\n\tUrl: %s\n\tResp: Recieved\n",
                       curl_code, url);
         AMVP_LOG_STATUS("POST Login...\n\tStatus: %d\n\tUrl: %s\n\tResp: %s\n",
-                      curl_code, url, ctx->curl_buf);
+                      curl_code, url, ctx->work.curl_buf);
         break;
     case AMVP_NET_POST_REG:
         AMVP_LOG_VERBOSE("POST Registration...\n\tStatus: %d\n\tUrl: %s\n\tResp: Recieved\n",
@@ -1282,23 +1407,23 @@ static void log_network_status(AMVP_CTX *ctx,
         break;
     case AMVP_NET_POST_VS_RESP:
         AMVP_LOG_VERBOSE("POST Response Submission...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                      curl_code, url, ctx->curl_buf);
+                      curl_code, url, ctx->work.curl_buf);
         AMVP_LOG_STATUS("POST Response Submission...\n\tStatus: %d\n\tUrl: %s",
                       curl_code, url);
         break;
     case AMVP_NET_PUT:
         AMVP_LOG_VERBOSE("PUT...\n\tStatus: %d\n\tUrl: %s\n\tResp: %s\n",
-                        curl_code, url, ctx->curl_buf);
+                        curl_code, url, ctx->work.curl_buf);
         AMVP_LOG_STATUS("PUT Response Submission...\n\tStatus: %d\n\tUrl: %s",
                       curl_code, url);
         break;
     case AMVP_NET_PUT_VALIDATION:
         AMVP_LOG_STATUS("PUT testSession Validation...\n\tStatus: %d\n\tUrl: %s\n\tResp: %s\n",
-                        curl_code, url, ctx->curl_buf);
+                        curl_code, url, ctx->work.curl_buf);
         break;
     case AMVP_NET_DELETE:
         AMVP_LOG_VERBOSE("DELETE...\n\tStatus: %d\n\tUrl: %s\n\tResp:\n%s\n",
-                       curl_code, url, ctx->curl_buf);
+                       curl_code, url, ctx->work.curl_buf);
         break;
     default:
         AMVP_LOG_ERR("We should never be here!");
@@ -1308,9 +1433,10 @@ static void log_network_status(AMVP_CTX *ctx,
 
     if (curl_code == 0) {
         AMVP_LOG_ERR("Received no response from server.");
-    } else if (curl_code < 200 || curl_code >= 300) {
+    } else if ((curl_code < 200 || curl_code >= 300) &&
+               !(curl_code == HTTP_NOT_MODIFIED && ctx->work.not_modified)) {
         AMVP_LOG_ERR("%d error received from server. Message:", curl_code);
-        AMVP_LOG_ERR("%s", ctx->curl_buf);
+        AMVP_LOG_ERR("%s", ctx->work.curl_buf);
     }
 
 }
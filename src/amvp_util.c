@@ -13,6 +13,12 @@
 #include <string.h>
 #include <stdarg.h>
 #include <ctype.h>
+#include <time.h>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
 #include "amvp.h"
 #include "amvp_lcl.h"
 #include "amvp_error.h"
@@ -26,43 +32,225 @@
 
 extern AMVP_ALG_HANDLER alg_tbl[];
 
+#ifndef _WIN32
+/* Serializes the application's log callback between vector set workers */
+static pthread_mutex_t amvp_log_lock = PTHREAD_MUTEX_INITIALIZER;
+/* Serializes updates of the session vector set metadata between workers */
+static pthread_mutex_t amvp_vs_meta_lock = PTHREAD_MUTEX_INITIALIZER;
+/* Serializes adding vector set workers' counters to the session's */
+static pthread_mutex_t amvp_perf_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 static int amvp_char_to_int(char ch);
 
 /*
  * Basic logging for libamvp
  */
+#ifndef _WIN32
+/*
+ * Asynchronous log sink. Messages are copied into a ring of fixed size slots
+ * and handed to the application's callback by a background thread, so the
+ * threads running test cases never wait on stdout. When the ring is full,
+ * info and verbose messages are dropped and counted; more important ones
+ * wait for a free slot.
+ */
+typedef struct amvp_log_entry_t {
+    AMVP_LOG_LVL level;
+    char msg[AMVP_LOG_MAX_MSG_LEN + 1];
+} AMVP_LOG_ENTRY;
+
+struct amvp_log_ring_t {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    AMVP_LOG_ENTRY *entries;
+    int slots;
+    int head;       /* oldest entry, next to be handed to the callback */
+    int count;
+    int stop;
+    unsigned long dropped;
+    AMVP_RESULT (*cb) (char *msg, AMVP_LOG_LVL level);
+};
+
+static void *amvp_log_ring_run(void *arg) {
+    struct amvp_log_ring_t *ring = arg;
+    AMVP_LOG_ENTRY *entry = NULL;
+    unsigned long dropped = 0;
+    char tmp[64];
+
+    pthread_mutex_lock(&ring->lock);
+    while (1) {
+        while (!ring->count && !ring->stop) {
+            pthread_cond_wait(&ring->not_empty, &ring->lock);
+        }
+        if (!ring->count) {
+            break;
+        }
+        /* Producers only write past head + count, so the entry can be read unlocked */
+        entry = &ring->entries[ring->head];
+        dropped = ring->dropped;
+        ring->dropped = 0;
+        pthread_mutex_unlock(&ring->lock);
+
+        ring->cb(entry->msg, entry->level);
+        if (dropped) {
+            snprintf(tmp, sizeof(tmp), "%lu log messages dropped", dropped);
+            ring->cb(tmp, AMVP_LOG_LVL_WARN);
+        }
+        fflush(stdout);
+
+        pthread_mutex_lock(&ring->lock);
+        ring->head = (ring->head + 1) % ring->slots;
+        ring->count--;
+        pthread_cond_signal(&ring->not_full);
+    }
+    pthread_mutex_unlock(&ring->lock);
+    return NULL;
+}
+
+static void amvp_log_ring_put(struct amvp_log_ring_t *ring, AMVP_LOG_LVL level, const char *msg) {
+    AMVP_LOG_ENTRY *entry = NULL;
+
+    pthread_mutex_lock(&ring->lock);
+    if (ring->count == ring->slots && level >= AMVP_LOG_LVL_INFO) {
+        ring->dropped++;
+        pthread_mutex_unlock(&ring->lock);
+        return;
+    }
+    while (ring->count == ring->slots) {
+        pthread_cond_wait(&ring->not_full, &ring->lock);
+    }
+    entry = &ring->entries[(ring->head + ring->count) % ring->slots];
+    entry->level = level;
+    strncpy_s(entry->msg, AMVP_LOG_MAX_MSG_LEN + 1, msg, AMVP_LOG_MAX_MSG_LEN);
+    ring->count++;
+    pthread_cond_signal(&ring->not_empty);
+    pthread_mutex_unlock(&ring->lock);
+}
+#endif
+
+/*
+ * Starts the asynchronous log sink with the given number of slots. Must be
+ * called before any vector set workers are started.
+ */
+AMVP_RESULT amvp_log_ring_start(AMVP_CTX *ctx, int slots) {
+#ifndef _WIN32
+    struct amvp_log_ring_t *ring = NULL;
+
+    if (!ctx->test_progress_cb) {
+        return AMVP_MISSING_ARG;
+    }
+    ring = calloc(1, sizeof(struct amvp_log_ring_t));
+    if (!ring) {
+        return AMVP_MALLOC_FAIL;
+    }
+    ring->entries = calloc(slots, sizeof(AMVP_LOG_ENTRY));
+    if (!ring->entries) {
+        free(ring);
+        return AMVP_MALLOC_FAIL;
+    }
+    ring->slots = slots;
+    ring->cb = ctx->test_progress_cb;
+    pthread_mutex_init(&ring->lock, NULL);
+    pthread_cond_init(&ring->not_empty, NULL);
+    pthread_cond_init(&ring->not_full, NULL);
+    if (pthread_create(&ring->thread, NULL, amvp_log_ring_run, ring)) {
+        pthread_cond_destroy(&ring->not_full);
+        pthread_cond_destroy(&ring->not_empty);
+        pthread_mutex_destroy(&ring->lock);
+        free(ring->entries);
+        free(ring);
+        return AMVP_INTERNAL_ERR;
+    }
+    ctx->log_ring = ring;
+    return AMVP_SUCCESS;
+#else
+    return AMVP_UNSUPPORTED_OP;
+#endif
+}
+
+/*
+ * Delivers every queued message, then stops the asynchronous log sink.
+ * Later messages are logged synchronously again.
+ */
+void amvp_log_ring_free(AMVP_CTX *ctx) {
+#ifndef _WIN32
+    struct amvp_log_ring_t *ring = ctx->log_ring;
+
+    if (!ring) {
+        return;
+    }
+    pthread_mutex_lock(&ring->lock);
+    ring->stop = 1;
+    pthread_cond_signal(&ring->not_empty);
+    pthread_mutex_unlock(&ring->lock);
+    pthread_join(ring->thread, NULL);
+
+    ctx->log_ring = NULL;
+    pthread_cond_destroy(&ring->not_full);
+    pthread_cond_destroy(&ring->not_empty);
+    pthread_mutex_destroy(&ring->lock);
+    free(ring->entries);
+    free(ring);
+#endif
+}
+
+/*
+ * Hands a formatted message to the application, through the asynchronous
+ * sink when there is one. Only messages of status level and above flush
+ * stdout, verbose output is left to stdio buffering.
+ */
+static void amvp_log_deliver(AMVP_CTX *ctx, AMVP_LOG_LVL level, char *msg) {
+#ifndef _WIN32
+    if (ctx->log_ring) {
+        amvp_log_ring_put(ctx->log_ring, level, msg);
+        return;
+    }
+    pthread_mutex_lock(&amvp_log_lock);
+#endif
+    ctx->test_progress_cb(msg, level);
+    if (level <= AMVP_LOG_LVL_STATUS) {
+        fflush(stdout);
+    }
+#ifndef _WIN32
+    pthread_mutex_unlock(&amvp_log_lock);
+#endif
+}
+
 void amvp_log_msg(AMVP_CTX *ctx, AMVP_LOG_LVL level, const char *func, int line, const char *fmt, ...) {
     va_list arguments;
     int iter = 0, ret = 0;
     //One extra char for null terminator
     char tmp[AMVP_LOG_MAX_MSG_LEN + 1];
-    tmp[AMVP_LOG_MAX_MSG_LEN] = '\0';
 
-    if (!ctx) {
+    if (!ctx || !ctx->test_progress_cb || ctx->log_lvl < level) {
         return;
     }
+    tmp[AMVP_LOG_MAX_MSG_LEN] = '\0';
 
+    if (ctx->parent && ctx->work.vs_id) {
+        /* Tag messages of concurrent vector set workers */
+        iter = snprintf(tmp, AMVP_LOG_MAX_MSG_LEN, "[vsId %d] ", ctx->work.vs_id);
+    }
     if (ctx->debug) {
-        iter = snprintf(tmp, AMVP_LOG_MAX_MSG_LEN, "[%s:%d]: ", func, line);
-    }
-
-    if (ctx->test_progress_cb && (ctx->log_lvl >= level)) {
-        /*  Pull the arguments from the stack and invoke the logger function */
-        va_start(arguments, fmt);
-        ret = vsnprintf(tmp + iter, AMVP_LOG_MAX_MSG_LEN + 1 - iter, fmt, arguments);
-        if (ret < 0 || ret >= AMVP_LOG_MAX_MSG_LEN + 1 - iter) {
-            memcpy_s(tmp + AMVP_LOG_MAX_MSG_LEN - AMVP_LOG_TRUNCATED_STR_LEN,
-                     AMVP_LOG_TRUNCATED_STR_LEN,
-                     AMVP_LOG_TRUNCATED_STR, AMVP_LOG_TRUNCATED_STR_LEN);
-            tmp[AMVP_LOG_MAX_MSG_LEN] = '\0';
-        } else {
-            iter += ret;
-            tmp[iter] = '\0';
-        }
-        ctx->test_progress_cb(tmp, level);
-        va_end(arguments);
-        fflush(stdout);
+        iter += snprintf(tmp + iter, AMVP_LOG_MAX_MSG_LEN - iter, "[%s:%d]: ", func, line);
+    }
+
+    /*  Pull the arguments from the stack and invoke the logger function */
+    va_start(arguments, fmt);
+    ret = vsnprintf(tmp + iter, AMVP_LOG_MAX_MSG_LEN + 1 - iter, fmt, arguments);
+    va_end(arguments);
+    if (ret < 0 || ret >= AMVP_LOG_MAX_MSG_LEN + 1 - iter) {
+        memcpy_s(tmp + AMVP_LOG_MAX_MSG_LEN - AMVP_LOG_TRUNCATED_STR_LEN,
+                 AMVP_LOG_TRUNCATED_STR_LEN,
+                 AMVP_LOG_TRUNCATED_STR, AMVP_LOG_TRUNCATED_STR_LEN);
+        tmp[AMVP_LOG_MAX_MSG_LEN] = '\0';
+    } else {
+        iter += ret;
+        tmp[iter] = '\0';
     }
+    amvp_log_deliver(ctx, level, tmp);
 }
 
 /*
@@ -70,9 +258,13 @@ void amvp_log_msg(AMVP_CTX *ctx, AMVP_LOG_LVL level, const char *func, int line,
  * the app handler to deal with it instead of making assumptions about output
  */
 void amvp_log_newline(AMVP_CTX *ctx) {
-     char tmp[] = "\n";
-     ctx->test_progress_cb(tmp, AMVP_LOG_LVL_STATUS);
- }
+    char tmp[] = "\n";
+
+    if (!ctx || !ctx->test_progress_cb) {
+        return;
+    }
+    amvp_log_deliver(ctx, AMVP_LOG_LVL_STATUS, tmp);
+}
 
 /*!
  *
@@ -957,10 +1149,10 @@ AMVP_RESULT amvp_setup_json_rsp_group(AMVP_CTX **ctx,
                                       JSON_Object **r_vs,
                                       const char *alg_str,
                                       JSON_Array **groups_arr) {
-    if ((*ctx)->kat_resp) {
-        json_value_free((*ctx)->kat_resp);
+    if ((*ctx)->work.kat_resp) {
+        json_value_free((*ctx)->work.kat_resp);
     }
-    (*ctx)->kat_resp = *outer_arr_val;
+    (*ctx)->work.kat_resp = *outer_arr_val;
 
     *r_vs_val = json_value_init_object();
     *r_vs = json_value_get_object(*r_vs_val);
@@ -968,7 +1160,7 @@ AMVP_RESULT amvp_setup_json_rsp_group(AMVP_CTX **ctx,
         return AMVP_JSON_ERR;
     } 
 
-    if (json_object_set_number(*r_vs, "vsId", (*ctx)->vs_id) != JSONSuccess ||
+    if (json_object_set_number(*r_vs, "vsId", (*ctx)->work.vs_id) != JSONSuccess ||
             json_object_set_string(*r_vs, "algorithm", alg_str) != JSONSuccess) {
         return AMVP_JSON_ERR;
     }
@@ -989,10 +1181,10 @@ AMVP_RESULT amvp_setup_json_ev_group(AMVP_CTX **ctx,
                                       JSON_Value **r_vs_val,
                                       JSON_Object **r_vs,
                                       JSON_Array **groups_arr) {
-    if ((*ctx)->kat_resp) {
-        json_value_free((*ctx)->kat_resp);
+    if ((*ctx)->work.kat_resp) {
+        json_value_free((*ctx)->work.kat_resp);
     }
-    (*ctx)->kat_resp = *outer_arr_val;
+    (*ctx)->work.kat_resp = *outer_arr_val;
 
     *r_vs_val = json_value_init_object();
     *r_vs = json_value_get_object(*r_vs_val);
@@ -1000,7 +1192,7 @@ AMVP_RESULT amvp_setup_json_ev_group(AMVP_CTX **ctx,
         return AMVP_JSON_ERR;
     } 
 
-    if (json_object_set_number(*r_vs, "ieId", (*ctx)->vs_id) != JSONSuccess) {
+    if (json_object_set_number(*r_vs, "ieId", (*ctx)->work.vs_id) != JSONSuccess) {
         return AMVP_JSON_ERR;
     }
 
@@ -1035,6 +1227,130 @@ void amvp_release_json(JSON_Value *r_vs_val,
     if (r_vs_val) json_value_free(r_vs_val);
 }
 
+/*
+ * Notify the crypto module that a test group is starting. The caller fills in
+ * the group parameters, including the cipher; a group with cipher 0 is not
+ * considered started. SigGen groups of a capability with a key_gen handler get
+ * their key pair here, from the pre-generation pool when one is ready.
+ */
+AMVP_RESULT amvp_group_begin(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_GROUP *group) {
+    if (cap->key_gen && amvp_key_pool_take(ctx, cap, group) != AMVP_SUCCESS) {
+        memzero_s(group, sizeof(AMVP_TEST_GROUP));
+        return AMVP_CRYPTO_MODULE_FAIL;
+    }
+    if (cap->group_begin && (cap->group_begin)(group)) {
+        AMVP_LOG_ERR("crypto module failed to set up test group %u", group->tg_id);
+        if (group->key && cap->key_free) {
+            (cap->key_free)(group->key);
+        }
+        memzero_s(group, sizeof(AMVP_TEST_GROUP));
+        return AMVP_CRYPTO_MODULE_FAIL;
+    }
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Notify the crypto module that a test group is finished and reset the group.
+ * Safe to call for a group that was never started, so handlers can use it on
+ * their error paths.
+ */
+AMVP_RESULT amvp_group_end(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_GROUP *group) {
+    int rv = 0;
+
+    if (!group->cipher) {
+        return AMVP_SUCCESS;
+    }
+    if (cap && cap->group_end) {
+        rv = (cap->group_end)(group);
+    }
+    if (group->key && cap && cap->key_free) {
+        (cap->key_free)(group->key);
+    }
+    memzero_s(group, sizeof(AMVP_TEST_GROUP));
+    if (rv) {
+        AMVP_LOG_ERR("crypto module failed to tear down test group");
+        return AMVP_CRYPTO_MODULE_FAIL;
+    }
+    return AMVP_SUCCESS;
+}
+
+void amvp_tc_batch_init(AMVP_TC_BATCH *batch,
+                        AMVP_RESULT (*output_tc)(AMVP_CTX *ctx, AMVP_TEST_CASE *tc,
+                                                 JSON_Object *r_tobj, int tc_rv),
+                        void (*release_tc)(AMVP_TEST_CASE *tc)) {
+    memzero_s(batch, sizeof(AMVP_TC_BATCH));
+    batch->output_tc = output_tc;
+    batch->release_tc = release_tc;
+}
+
+/*
+ * Hand every queued test case to the capability's batch_handler, then output
+ * the results in the order the test cases were queued. The batch is always
+ * emptied; on failure the remaining response objects are freed instead of
+ * being appended to \p r_tarr.
+ */
+AMVP_RESULT amvp_tc_batch_flush(AMVP_CTX *ctx,
+                                AMVP_CAPS_LIST *cap,
+                                AMVP_TC_BATCH *batch,
+                                JSON_Array *r_tarr) {
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    unsigned long long start = 0, ns = 0;
+    int i = 0, rc = 0;
+
+    if (!batch->count) {
+        return AMVP_SUCCESS;
+    }
+
+    memzero_s(batch->tc_rv, sizeof(batch->tc_rv));
+    AMVP_PROBE3(batch_start, ctx->work.vs_id, ctx->work.tg_id, batch->count);
+    start = amvp_perf_now();
+    rc = (cap->batch_handler)(batch->tc, batch->tc_rv, batch->count);
+    AMVP_PROBE4(batch_done, ctx->work.vs_id, ctx->work.tg_id, batch->count, rc);
+    if (rc) {
+        AMVP_LOG_ERR("crypto module failed the batch operation");
+        rv = AMVP_CRYPTO_MODULE_FAIL;
+    }
+    ns = amvp_perf_now() - start;
+    ctx->work.perf.crypto_ns += ns;
+    ctx->work.perf.tc_count += batch->count;
+    /* The time of a single test case of the batch is not known */
+    for (i = 0; i < batch->count; i++) {
+        amvp_latency_record(ctx, cap, NULL, ns / batch->count);
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        if (rv == AMVP_SUCCESS) {
+            rv = (batch->output_tc)(ctx, &batch->tc[i],
+                                    json_value_get_object(batch->r_tval[i]),
+                                    batch->tc_rv[i]);
+        }
+        if (rv == AMVP_SUCCESS) {
+            json_array_append_value(r_tarr, batch->r_tval[i]);
+        } else {
+            json_value_free(batch->r_tval[i]);
+        }
+        batch->r_tval[i] = NULL;
+        (batch->release_tc)(&batch->tc[i]);
+    }
+    batch->count = 0;
+
+    return rv;
+}
+
+/*
+ * Release any test cases still queued in the batch without processing them.
+ */
+void amvp_tc_batch_discard(AMVP_TC_BATCH *batch) {
+    int i = 0;
+
+    for (i = 0; i < batch->count; i++) {
+        if (batch->r_tval[i]) json_value_free(batch->r_tval[i]);
+        batch->r_tval[i] = NULL;
+        (batch->release_tc)(&batch->tc[i]);
+    }
+    batch->count = 0;
+}
+
 /**
  * @brief Determine if the given \p string fits within the \p max_allowed length.
  *
@@ -1086,7 +1402,7 @@ AMVP_RESULT amvp_append_sl_list(AMVP_SL_LIST **list, int length) {
     }
     
     if (*list == NULL) {
-        *list = calloc(1, sizeof(AMVP_SL_LIST));
+        *list = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_SL_LIST));
         if (!*list) {
             return AMVP_MALLOC_FAIL;
         }
@@ -1096,7 +1412,7 @@ AMVP_RESULT amvp_append_sl_list(AMVP_SL_LIST **list, int length) {
     current = *list;
     while (current) {
         if (!current->next) {
-            current->next = calloc(1, sizeof(AMVP_SL_LIST));
+            current->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_SL_LIST));
             if (!current->next) {
                 return AMVP_MALLOC_FAIL;
             }
@@ -1121,7 +1437,7 @@ AMVP_RESULT amvp_append_param_list(AMVP_PARAM_LIST **list, int param) {
     }
     
     if (*list == NULL) {
-        *list = calloc(1, sizeof(AMVP_PARAM_LIST));
+        *list = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_PARAM_LIST));
         if (!*list) {
             return AMVP_MALLOC_FAIL;
         }
@@ -1131,7 +1447,7 @@ AMVP_RESULT amvp_append_param_list(AMVP_PARAM_LIST **list, int param) {
     current = *list;
     while (current) {
         if (!current->next) {
-            current->next = calloc(1, sizeof(AMVP_PARAM_LIST));
+            current->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_PARAM_LIST));
             if (!current->next) {
                 return AMVP_MALLOC_FAIL;
             }
@@ -1159,7 +1475,7 @@ AMVP_RESULT amvp_append_name_list(AMVP_NAME_LIST **list, const char *string) {
     }
 
     if (!*list) {
-        *list = calloc(1, sizeof(AMVP_NAME_LIST));
+        *list = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_NAME_LIST));
         if (!*list) {
             return AMVP_MALLOC_FAIL;
         }
@@ -1171,7 +1487,7 @@ AMVP_RESULT amvp_append_name_list(AMVP_NAME_LIST **list, const char *string) {
             return AMVP_SUCCESS;
         }
         if (!current->next) {
-            current->next = calloc(1, sizeof(AMVP_NAME_LIST));
+            current->next = amvp_mem_calloc(AMVP_MEM_CAPS, 1, sizeof(AMVP_NAME_LIST));
             if (!current->next) {
                 return AMVP_MALLOC_FAIL;
             }
@@ -1272,6 +1588,209 @@ int amvp_lookup_str_list(AMVP_STRING_LIST **list, const char *string) {
     return 0;
 }
 
+/*
+ * Record the algorithm and mode of a vector set on the session ctx. Worker
+ * ctxs record on the session ctx they were cloned from. A vector set that is
+ * already recorded is left as is.
+ */
+AMVP_RESULT amvp_vs_meta_add(AMVP_CTX *ctx, int vs_id, const char *alg, const char *mode) {
+    AMVP_CTX *sctx = NULL;
+    AMVP_VS_META *meta = NULL, *tmp = NULL;
+
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!vs_id || !alg) {
+        return AMVP_MISSING_ARG;
+    }
+    if (strnlen_s(alg, AMVP_ALG_NAME_MAX + 1) > AMVP_ALG_NAME_MAX ||
+            (mode && strnlen_s(mode, AMVP_ALG_MODE_MAX + 1) > AMVP_ALG_MODE_MAX)) {
+        return AMVP_INVALID_ARG;
+    }
+    sctx = ctx->parent ? ctx->parent : ctx;
+
+    meta = calloc(1, sizeof(AMVP_VS_META));
+    if (!meta) {
+        return AMVP_MALLOC_FAIL;
+    }
+    meta->vs_id = vs_id;
+    strcpy_s(meta->alg, AMVP_ALG_NAME_MAX + 1, alg);
+    if (mode) {
+        strcpy_s(meta->mode, AMVP_ALG_MODE_MAX + 1, mode);
+    }
+
+#ifndef _WIN32
+    pthread_mutex_lock(&amvp_vs_meta_lock);
+#endif
+    for (tmp = sctx->vs_meta; tmp && tmp->vs_id != vs_id; tmp = tmp->next) {
+        ;
+    }
+    if (tmp) {
+        free(meta);
+    } else {
+        meta->next = sctx->vs_meta;
+        sctx->vs_meta = meta;
+    }
+#ifndef _WIN32
+    pthread_mutex_unlock(&amvp_vs_meta_lock);
+#endif
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Look up the recorded metadata of the vector set at vsid_url, which ends
+ * in the vsId. Returns NULL if the vector set was not recorded.
+ */
+const AMVP_VS_META *amvp_vs_meta_lookup(AMVP_CTX *ctx, const char *vsid_url) {
+    AMVP_VS_META *meta = NULL;
+    const char *ptr = NULL;
+    int vs_id = 0;
+
+    if (!ctx || !vsid_url) {
+        return NULL;
+    }
+    ptr = strrchr(vsid_url, '/');
+    vs_id = atoi(ptr ? ptr + 1 : vsid_url);
+    if (!vs_id) {
+        return NULL;
+    }
+
+#ifndef _WIN32
+    pthread_mutex_lock(&amvp_vs_meta_lock);
+#endif
+    for (meta = ctx->vs_meta; meta && meta->vs_id != vs_id; meta = meta->next) {
+        ;
+    }
+#ifndef _WIN32
+    pthread_mutex_unlock(&amvp_vs_meta_lock);
+#endif
+    return meta;
+}
+
+/*
+ * Build the "vectorSets" array of the session info file from the recorded
+ * metadata, or return NULL if nothing was recorded
+ */
+JSON_Value *amvp_vs_meta_to_json(AMVP_CTX *ctx) {
+    JSON_Value *arr_val = NULL, *meta_val = NULL;
+    JSON_Object *meta_obj = NULL;
+    AMVP_VS_META *meta = NULL;
+
+    if (!ctx || !ctx->vs_meta) {
+        return NULL;
+    }
+    arr_val = json_value_init_array();
+    for (meta = ctx->vs_meta; meta; meta = meta->next) {
+        meta_val = json_value_init_object();
+        meta_obj = json_value_get_object(meta_val);
+        json_object_set_number(meta_obj, "vsId", meta->vs_id);
+        json_object_set_string(meta_obj, "algorithm", meta->alg);
+        if (meta->mode[0]) {
+            json_object_set_string(meta_obj, "mode", meta->mode);
+        }
+        json_array_append_value(json_array(arr_val), meta_val);
+    }
+    return arr_val;
+}
+
+/*
+ * Load the "vectorSets" array of a session info file. Malformed entries are
+ * skipped, those vector sets are looked up on the server when needed.
+ */
+AMVP_RESULT amvp_vs_meta_from_json(AMVP_CTX *ctx, JSON_Array *arr) {
+    JSON_Object *meta_obj = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    int i = 0, count = 0;
+
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    count = (int)json_array_get_count(arr);
+    for (i = count - 1; i >= 0; i--) {
+        meta_obj = json_array_get_object(arr, i);
+        rv = amvp_vs_meta_add(ctx, (int)json_object_get_number(meta_obj, "vsId"),
+                              json_object_get_string(meta_obj, "algorithm"),
+                              json_object_get_string(meta_obj, "mode"));
+        if (rv == AMVP_MALLOC_FAIL) {
+            return rv;
+        }
+    }
+    return AMVP_SUCCESS;
+}
+
+void amvp_vs_meta_free(AMVP_VS_META **list) {
+    AMVP_VS_META *tmp = NULL;
+
+    if (!list) {
+        return;
+    }
+    while (*list) {
+        tmp = *list;
+        *list = tmp->next;
+        free(tmp);
+    }
+}
+
+/*
+ * Record the final status of a vector set on the session ctx. Only the
+ * results monitor records, and the session thread reads the list after the
+ * monitor was stopped, so no lock is taken.
+ */
+AMVP_RESULT amvp_vs_graded_add(AMVP_CTX *ctx, int vs_id, int failed) {
+    AMVP_CTX *sctx = NULL;
+    AMVP_VS_GRADED *graded = NULL;
+
+    if (!ctx) {
+        return AMVP_NO_CTX;
+    }
+    if (!vs_id) {
+        return AMVP_MISSING_ARG;
+    }
+    sctx = ctx->parent ? ctx->parent : ctx;
+    if (amvp_vs_graded_lookup(sctx, vs_id)) {
+        return AMVP_SUCCESS;
+    }
+
+    graded = calloc(1, sizeof(AMVP_VS_GRADED));
+    if (!graded) {
+        return AMVP_MALLOC_FAIL;
+    }
+    graded->vs_id = vs_id;
+    graded->failed = failed;
+    graded->next = sctx->vs_graded;
+    sctx->vs_graded = graded;
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Look up the recorded final status of a vector set. Returns NULL if the
+ * vector set was not graded yet when it was last seen.
+ */
+const AMVP_VS_GRADED *amvp_vs_graded_lookup(AMVP_CTX *ctx, int vs_id) {
+    AMVP_VS_GRADED *graded = NULL;
+
+    if (!ctx || !vs_id) {
+        return NULL;
+    }
+    for (graded = ctx->vs_graded; graded && graded->vs_id != vs_id; graded = graded->next) {
+        ;
+    }
+    return graded;
+}
+
+void amvp_vs_graded_free(AMVP_VS_GRADED **list) {
+    AMVP_VS_GRADED *tmp = NULL;
+
+    if (!list) {
+        return;
+    }
+    while (*list) {
+        tmp = *list;
+        *list = tmp->next;
+        free(tmp);
+    }
+}
+
 /**
  * Simple utility for searching if a value already exists in a
  * param list.
@@ -1300,49 +1819,49 @@ int amvp_is_domain_already_set(AMVP_JSON_DOMAIN_OBJ *domain) {
     return domain->min + domain->max + domain->increment;
 }
 
-AMVP_RESULT amvp_json_serialize_to_file_pretty_a(const JSON_Value *value, const char *filename) {
+AMVP_RESULT amvp_json_serialize_to_file_pretty_a(AMVP_CTX *ctx, const JSON_Value *value, const char *filename) {
     AMVP_RESULT return_code = AMVP_SUCCESS;
-    FILE *fp = NULL;
+    AMVP_FILE *fp = NULL;
     char *serialized_string = NULL; 
 
     if (!filename) {
         return AMVP_INVALID_ARG;
     }
 
-    fp = fopen(filename, "a");
-    if (fp == NULL) {
+    if (amvp_file_open(&fp, filename, "a", amvp_file_type(filename),
+                       ctx ? ctx->file_compress_level : 0) != AMVP_SUCCESS) {
         return AMVP_JSON_ERR;
     }
     if (!value) {
-        if (fputs(" ]", fp) == EOF) {
+        if (amvp_file_puts(fp, " ]")) {
             return_code = AMVP_JSON_ERR;
         }
     } else {
 
         serialized_string = json_serialize_to_string_pretty(value, NULL);
         if (serialized_string == NULL) {
-            fclose(fp);
+            amvp_file_close(fp);
             return AMVP_JSON_ERR;
         }
-        if (fputs(", ", fp) == EOF) {
+        if (amvp_file_puts(fp, ", ")) {
             return_code = AMVP_JSON_ERR;
             goto end;
         }
-        if (fputs(serialized_string, fp) == EOF) {
+        if (amvp_file_puts(fp, serialized_string)) {
             return_code = AMVP_JSON_ERR;
         }
     }
 end:
-    if (fclose(fp) == EOF) {
+    if (amvp_file_close(fp)) {
         return_code = AMVP_JSON_ERR;
     }
     json_free_serialized_string(serialized_string);
     return return_code;
 }
 
-AMVP_RESULT amvp_json_serialize_to_file_pretty_w(const JSON_Value *value, const char *filename) {
+AMVP_RESULT amvp_json_serialize_to_file_pretty_w(AMVP_CTX *ctx, const JSON_Value *value, const char *filename) {
     AMVP_RESULT return_code = AMVP_SUCCESS;
-    FILE *fp = NULL;
+    AMVP_FILE *fp = NULL;
     char *serialized_string = NULL;
 
     if (!value) {
@@ -1356,23 +1875,230 @@ AMVP_RESULT amvp_json_serialize_to_file_pretty_w(const JSON_Value *value, const
     if (serialized_string == NULL) {
         return AMVP_JSON_ERR;
     }
-    fp = fopen(filename, "w");
-    if (fp == NULL) {
+    if (amvp_file_open(&fp, filename, "w", amvp_file_type(filename),
+                       ctx ? ctx->file_compress_level : 0) != AMVP_SUCCESS) {
         json_free_serialized_string(serialized_string);
         return AMVP_JSON_ERR;
     }
-    if (fputs("[ ", fp) == EOF) {
+    if (amvp_file_puts(fp, "[ ")) {
         return_code = AMVP_JSON_ERR;
         goto end;
     }
-    if (fputs(serialized_string, fp) == EOF) {
-        json_free_serialized_string(serialized_string);
+    if (amvp_file_puts(fp, serialized_string)) {
         return_code = AMVP_JSON_ERR;
     }
 end:
-    if (fclose(fp) == EOF) {
+    if (amvp_file_close(fp)) {
         return_code = AMVP_JSON_ERR;
     }
     json_free_serialized_string(serialized_string);
     return return_code;
 }
+
+/*
+ * Monotonic clock in nanoseconds, for the profiling counters
+ */
+unsigned long long amvp_perf_now(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+
+    if (!freq.QuadPart) {
+        QueryPerformanceFrequency(&freq);
+    }
+    QueryPerformanceCounter(&now);
+    return (unsigned long long)(now.QuadPart / freq.QuadPart) * 1000000000ULL +
+           (unsigned long long)(now.QuadPart % freq.QuadPart) * 1000000000ULL / freq.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+#endif
+}
+
+/*
+ * Test case id of tc, from the member of the union that cap's handler fills
+ */
+int amvp_tc_id(AMVP_CAPS_LIST *cap, AMVP_TEST_CASE *tc) {
+    switch (cap->cap_type) {
+    case AMVP_SYM_TYPE:
+        return (int)tc->tc.symmetric->tc_id;
+    case AMVP_HASH_TYPE:
+        return (int)tc->tc.hash->tc_id;
+    case AMVP_DRBG_TYPE:
+        return (int)tc->tc.drbg->tc_id;
+    case AMVP_HMAC_TYPE:
+        return (int)tc->tc.hmac->tc_id;
+    case AMVP_CMAC_TYPE:
+        return (int)tc->tc.cmac->tc_id;
+    case AMVP_KMAC_TYPE:
+        return tc->tc.kmac->tc_id;
+    case AMVP_RSA_KEYGEN_TYPE:
+        return (int)tc->tc.rsa_keygen->tc_id;
+    case AMVP_RSA_SIGGEN_TYPE:
+    case AMVP_RSA_SIGVER_TYPE:
+        return (int)tc->tc.rsa_sig->tc_id;
+    case AMVP_RSA_PRIM_TYPE:
+        return (int)tc->tc.rsa_prim->tc_id;
+    case AMVP_ECDSA_KEYGEN_TYPE:
+    case AMVP_ECDSA_KEYVER_TYPE:
+    case AMVP_ECDSA_SIGGEN_TYPE:
+    case AMVP_ECDSA_SIGVER_TYPE:
+        return (int)tc->tc.ecdsa->tc_id;
+    case AMVP_DSA_TYPE:
+        return tc->tc.dsa->tc_id;
+    case AMVP_KDF135_SNMP_TYPE:
+        return (int)tc->tc.kdf135_snmp->tc_id;
+    case AMVP_KDF135_SSH_TYPE:
+        return (int)tc->tc.kdf135_ssh->tc_id;
+    case AMVP_KDF135_SRTP_TYPE:
+        return (int)tc->tc.kdf135_srtp->tc_id;
+    case AMVP_KDF135_IKEV2_TYPE:
+        return (int)tc->tc.kdf135_ikev2->tc_id;
+    case AMVP_KDF135_IKEV1_TYPE:
+        return (int)tc->tc.kdf135_ikev1->tc_id;
+    case AMVP_KDF135_X942_TYPE:
+        return (int)tc->tc.kdf135_x942->tc_id;
+    case AMVP_KDF135_X963_TYPE:
+        return (int)tc->tc.kdf135_x963->tc_id;
+    case AMVP_KDF108_TYPE:
+        return (int)tc->tc.kdf108->tc_id;
+    case AMVP_PBKDF_TYPE:
+        return (int)tc->tc.pbkdf->tc_id;
+    case AMVP_KDF_TLS12_TYPE:
+        return (int)tc->tc.kdf_tls12->tc_id;
+    case AMVP_KDF_TLS13_TYPE:
+        return (int)tc->tc.kdf_tls13->tc_id;
+    case AMVP_KAS_ECC_CDH_TYPE:
+    case AMVP_KAS_ECC_COMP_TYPE:
+    case AMVP_KAS_ECC_NOCOMP_TYPE:
+    case AMVP_KAS_ECC_SSC_TYPE:
+        return (int)tc->tc.kas_ecc->tc_id;
+    case AMVP_KAS_FFC_COMP_TYPE:
+    case AMVP_KAS_FFC_SSC_TYPE:
+    case AMVP_KAS_FFC_NOCOMP_TYPE:
+        return (int)tc->tc.kas_ffc->tc_id;
+    case AMVP_KAS_IFC_TYPE:
+        return (int)tc->tc.kas_ifc->tc_id;
+    case AMVP_KDA_ONESTEP_TYPE:
+        return (int)tc->tc.kda_onestep->tc_id;
+    case AMVP_KDA_TWOSTEP_TYPE:
+        return (int)tc->tc.kda_twostep->tc_id;
+    case AMVP_KDA_HKDF_TYPE:
+        return (int)tc->tc.kda_hkdf->tc_id;
+    case AMVP_KTS_IFC_TYPE:
+        return (int)tc->tc.kts_ifc->tc_id;
+    case AMVP_SAFE_PRIMES_KEYGEN_TYPE:
+    case AMVP_SAFE_PRIMES_KEYVER_TYPE:
+        return tc->tc.safe_primes->tc_id;
+    case AMVP_KDF135_TPM_TYPE:
+    default:
+        return 0;
+    }
+}
+
+/*
+ * Hands one test case to the given handler of the crypto module, counting it
+ * and its time, see amvp_latency.c
+ */
+static int amvp_module_call(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_CASE *tc,
+                            int (*handler)(AMVP_TEST_CASE *test_case)) {
+    unsigned long long start = 0, ns = 0;
+    int rc = 0;
+
+    AMVP_PROBE3(tc_start, ctx->work.vs_id, ctx->work.tg_id, amvp_tc_id(cap, tc));
+    start = amvp_perf_now();
+    rc = handler(tc);
+    ns = amvp_perf_now() - start;
+    AMVP_PROBE4(tc_done, ctx->work.vs_id, ctx->work.tg_id, amvp_tc_id(cap, tc), rc);
+
+    ctx->work.perf.crypto_ns += ns;
+    ctx->work.perf.tc_count++;
+    amvp_latency_record(ctx, cap, tc, ns);
+    return rc;
+}
+
+int amvp_crypto_handler(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_CASE *tc) {
+    return amvp_module_call(ctx, cap, tc, cap->crypto_handler);
+}
+
+/*
+ * Hands one outer iteration of a Monte Carlo test to the native MCT handler
+ */
+int amvp_mct_handler(AMVP_CTX *ctx, AMVP_CAPS_LIST *cap, AMVP_TEST_CASE *tc) {
+    return amvp_module_call(ctx, cap, tc, cap->mct_handler);
+}
+
+static void amvp_perf_add(AMVP_PERF_COUNTERS *to, const AMVP_PERF_COUNTERS *from) {
+    to->vs_count += from->vs_count;
+    to->tc_count += from->tc_count;
+    to->parse_ns += from->parse_ns;
+    to->decode_ns += from->decode_ns;
+    to->crypto_ns += from->crypto_ns;
+    to->serialize_ns += from->serialize_ns;
+    to->network_ns += from->network_ns;
+    to->bytes_in += from->bytes_in;
+    to->bytes_out += from->bytes_out;
+}
+
+/*
+ * Adds the counters gathered by ctx since the last flush to the session's,
+ * under the given algorithm. Called once per vector set, so vector set
+ * workers only contend for the lock that often.
+ */
+void amvp_perf_flush(AMVP_CTX *ctx, AMVP_CIPHER cipher) {
+    AMVP_CTX *session = ctx->parent ? ctx->parent : ctx;
+    AMVP_PERF_COUNTERS *alg = NULL;
+    int i;
+
+    amvp_latency_flush(ctx, cipher);
+    if (cipher <= AMVP_CIPHER_START || cipher >= AMVP_CIPHER_END) {
+        cipher = AMVP_CIPHER_START;
+    }
+#ifndef _WIN32
+    pthread_mutex_lock(&amvp_perf_lock);
+#endif
+    if (!session->perf) {
+        session->perf = calloc(1, sizeof(AMVP_PERF_STATS));
+    }
+    if (session->perf) {
+        alg = &session->perf->alg[cipher];
+        for (i = 0; !alg->name && cipher != AMVP_CIPHER_START && i < AMVP_ALG_MAX; i++) {
+            if (alg_tbl[i].cipher == cipher) {
+                alg->name = alg_tbl[i].name;
+                alg->mode = alg_tbl[i].mode;
+            }
+        }
+        amvp_perf_add(alg, &ctx->work.perf);
+        amvp_perf_add(&session->perf->total, &ctx->work.perf);
+    }
+#ifndef _WIN32
+    pthread_mutex_unlock(&amvp_perf_lock);
+#endif
+    memzero_s(&ctx->work.perf, sizeof(AMVP_PERF_COUNTERS));
+}
+
+AMVP_RESULT amvp_perf_copy(AMVP_CTX *ctx, AMVP_PERF_STATS *stats) {
+    /* Work done outside of vector sets since the last flush */
+    amvp_perf_flush(ctx, AMVP_CIPHER_START);
+#ifndef _WIN32
+    pthread_mutex_lock(&amvp_perf_lock);
+#endif
+    if (ctx->perf) {
+        memcpy_s(stats, sizeof(AMVP_PERF_STATS), ctx->perf, sizeof(AMVP_PERF_STATS));
+    } else {
+        memzero_s(stats, sizeof(AMVP_PERF_STATS));
+    }
+#ifndef _WIN32
+    pthread_mutex_unlock(&amvp_perf_lock);
+#endif
+    return ctx->perf ? AMVP_SUCCESS : AMVP_MALLOC_FAIL;
+}
+
+void amvp_perf_free(AMVP_CTX *ctx) {
+    if (ctx->perf) {
+        free(ctx->perf);
+        ctx->perf = NULL;
+    }
+}
@@ -0,0 +1,348 @@
+/** @file */
+/*
+ * Copyright (c) 2021, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libamvp/LICENSE
+ */
+
+/*
+ * Offline benchmark of the KAT handlers, run by "make bench".
+ *
+ * Each handler is run against a vector set fixture in json/bench with a crypto
+ * handler that does nothing, so what is measured is the library's own work:
+ * parsing the vector set, decoding the test cases, building and serializing
+ * the response. Every handler runs in a child process of its own so that the
+ * peak RSS reported is that of the handler alone.
+ *
+ * One JSON object per handler is written to stdout:
+ *   {"handler":"aes","fixture":"aes_cbc.json","iterations":..,"test_cases":..,
+ *    "seconds":..,"tc_per_sec":..,"mb_per_sec":..,"allocs":..,"alloc_bytes":..,
+ *    "peak_rss_kb":..,"result":0}
+ * allocs and alloc_bytes are per iteration, and -1 when allocations cannot be
+ * counted (not glibc).
+ *
+ * With --fixture a single handler is run against the given vector set
+ * instead, for example one made by gen_vectors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "amvp/amvp.h"
+#include "amvp/amvp_lcl.h"
+#include "amvp/parson.h"
+
+#define BENCH_MIN_SECONDS 1.0
+#define BENCH_FIXTURE_DIR "json/bench"
+
+#ifdef __GLIBC__
+/*
+ * Count the allocations of the library by interposing malloc, which the
+ * dynamic linker also resolves to these for libamvp and parson
+ */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static unsigned long long bench_allocs = 0;
+static unsigned long long bench_alloc_bytes = 0;
+#define BENCH_COUNT_ALLOCS 1
+
+void *malloc(size_t size) {
+    bench_allocs++;
+    bench_alloc_bytes += size;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+    bench_allocs++;
+    bench_alloc_bytes += nmemb * size;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    bench_allocs++;
+    bench_alloc_bytes += size;
+    return __libc_realloc(ptr, size);
+}
+#else
+static unsigned long long bench_allocs = 0;
+static unsigned long long bench_alloc_bytes = 0;
+#define BENCH_COUNT_ALLOCS 0
+#endif
+
+static int bench_crypto(AMVP_TEST_CASE *tc) {
+    (void)tc;
+    return 0;
+}
+
+static AMVP_RESULT bench_log(char *msg, AMVP_LOG_LVL level) {
+    (void)level;
+    fprintf(stderr, "[AMVP]: %s\n", msg);
+    return AMVP_SUCCESS;
+}
+
+/*
+ * Register the capability the fixture of each handler needs
+ */
+static AMVP_RESULT bench_setup_aes(AMVP_CTX *ctx) {
+    return amvp_cap_sym_cipher_enable(ctx, AMVP_AES_CBC, bench_crypto);
+}
+
+static AMVP_RESULT bench_setup_aes_gcm(AMVP_CTX *ctx) {
+    return amvp_cap_sym_cipher_enable(ctx, AMVP_AES_GCM, bench_crypto);
+}
+
+static AMVP_RESULT bench_setup_cmac(AMVP_CTX *ctx) {
+    return amvp_cap_cmac_enable(ctx, AMVP_CMAC_AES, bench_crypto);
+}
+
+static AMVP_RESULT bench_setup_hash(AMVP_CTX *ctx) {
+    return amvp_cap_hash_enable(ctx, AMVP_HASH_SHA256, bench_crypto);
+}
+
+static AMVP_RESULT bench_setup_shake(AMVP_CTX *ctx) {
+    AMVP_RESULT rv = amvp_cap_hash_enable(ctx, AMVP_HASH_SHAKE_128, bench_crypto);
+
+    if (rv == AMVP_SUCCESS) {
+        rv = amvp_cap_hash_enable(ctx, AMVP_HASH_SHAKE_256, bench_crypto);
+    }
+    return rv;
+}
+
+static AMVP_RESULT bench_setup_drbg(AMVP_CTX *ctx) {
+    return amvp_cap_drbg_enable(ctx, AMVP_CTRDRBG, bench_crypto);
+}
+
+static AMVP_RESULT bench_setup_rsa_keygen(AMVP_CTX *ctx) {
+    return amvp_cap_rsa_keygen_enable(ctx, AMVP_RSA_KEYGEN, bench_crypto);
+}
+
+static AMVP_RESULT bench_setup_kas_ecc(AMVP_CTX *ctx) {
+    return amvp_cap_kas_ecc_enable(ctx, AMVP_KAS_ECC_CDH, bench_crypto);
+}
+
+static AMVP_RESULT bench_setup_kda_hkdf(AMVP_CTX *ctx) {
+    AMVP_RESULT rv = amvp_cap_kda_enable(ctx, AMVP_KDA_HKDF, bench_crypto);
+
+    if (rv == AMVP_SUCCESS) {
+        rv = amvp_cap_kda_set_parm(ctx, AMVP_KDA_HKDF, AMVP_KDA_L, 512, NULL);
+    }
+    return rv;
+}
+
+typedef struct bench_entry_t {
+    const char *name;
+    const char *fixture;
+    AMVP_RESULT (*setup)(AMVP_CTX *ctx);
+    AMVP_RESULT (*handler)(AMVP_CTX *ctx, JSON_Object *obj);
+} BENCH_ENTRY;
+
+static BENCH_ENTRY bench_tbl[] = {
+    { "aes",        "aes_cbc.json",     bench_setup_aes,        amvp_aes_kat_handler },
+    { "aes_gcm",    "aes_gcm.json",     bench_setup_aes_gcm,    amvp_aes_kat_handler },
+    { "cmac",       "cmac_aes.json",    bench_setup_cmac,       amvp_cmac_kat_handler },
+    { "hash",       "sha2_256.json",    bench_setup_hash,       amvp_hash_kat_handler },
+    { "shake",      "shake_128.json",   bench_setup_shake,      amvp_hash_kat_handler },
+    { "drbg",       "ctr_drbg.json",    bench_setup_drbg,       amvp_drbg_kat_handler },
+    { "rsa_keygen", "rsa_keygen.json",  bench_setup_rsa_keygen, amvp_rsa_keygen_kat_handler },
+    { "kas_ecc",    "kas_ecc_cdh.json", bench_setup_kas_ecc,    amvp_kas_ecc_kat_handler },
+    { "kda_hkdf",   "kda_hkdf.json",    bench_setup_kda_hkdf,   amvp_kda_hkdf_kat_handler },
+};
+#define BENCH_TBL_LEN (sizeof(bench_tbl) / sizeof(BENCH_ENTRY))
+
+static double bench_now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char *bench_read_file(const char *path, long *len) {
+    FILE *fp = NULL;
+    char *buf = NULL;
+
+    fp = fopen(path, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    *len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    buf = calloc(*len + 1, 1);
+    if (buf && fread(buf, 1, *len, fp) != (size_t)*len) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(fp);
+    return buf;
+}
+
+/*
+ * The vector set is the fixture itself or, as in files saved with
+ * --vector_req, the last element of the array
+ */
+static JSON_Object *bench_get_vs(JSON_Value *val) {
+    JSON_Array *arr = json_value_get_array(val);
+
+    if (arr) {
+        return json_array_get_object(arr, json_array_get_count(arr) - 1);
+    }
+    return json_value_get_object(val);
+}
+
+static int bench_count_tcs(JSON_Object *vs) {
+    JSON_Array *groups = json_object_get_array(vs, "testGroups");
+    int i, cnt = 0;
+
+    for (i = 0; i < (int)json_array_get_count(groups); i++) {
+        cnt += json_array_get_count(json_object_get_array(json_array_get_object(groups, i), "tests"));
+    }
+    return cnt;
+}
+
+static AMVP_RESULT bench_run(BENCH_ENTRY *entry, const char *dir, const char *file, double min_seconds) {
+    AMVP_CTX *ctx = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    JSON_Value *val = NULL;
+    struct rusage usage;
+    char path[512];
+    char *buf = NULL, *rsp = NULL;
+    long len = 0;
+    int tcs = 0;
+    unsigned long long iterations = 0, allocs = 0, alloc_bytes = 0;
+    double start = 0, elapsed = 0;
+
+    if (file) {
+        snprintf(path, sizeof(path), "%s", file);
+    } else {
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->fixture);
+    }
+    buf = bench_read_file(path, &len);
+    if (!buf) {
+        printf("{\"handler\":\"%s\",\"fixture\":\"%s\",\"error\":\"missing fixture\"}\n",
+               entry->name, path);
+        return AMVP_MISSING_ARG;
+    }
+    rv = amvp_create_test_session(&ctx, bench_log, AMVP_LOG_LVL_ERR);
+    if (rv == AMVP_SUCCESS) {
+        rv = entry->setup(ctx);
+    }
+
+    start = bench_now();
+    while (rv == AMVP_SUCCESS && (elapsed < min_seconds || !iterations)) {
+        unsigned long long a = bench_allocs, b = bench_alloc_bytes;
+
+        val = json_parse_string(buf);
+        if (!val) {
+            rv = AMVP_JSON_ERR;
+            break;
+        }
+        if (!tcs) {
+            tcs = bench_count_tcs(bench_get_vs(val));
+        }
+        rv = entry->handler(ctx, bench_get_vs(val));
+        if (rv == AMVP_SUCCESS) {
+            rsp = json_serialize_to_string(ctx->work.kat_resp, NULL);
+            json_free_serialized_string(rsp);
+        }
+        json_value_free(val);
+        if (ctx->work.kat_resp) {
+            json_value_free(ctx->work.kat_resp);
+            ctx->work.kat_resp = NULL;
+        }
+        allocs += bench_allocs - a;
+        alloc_bytes += bench_alloc_bytes - b;
+        iterations++;
+        elapsed = bench_now() - start;
+    }
+    getrusage(RUSAGE_SELF, &usage);
+
+    if (!iterations) {
+        iterations = 1;
+    }
+    printf("{\"handler\":\"%s\",\"fixture\":\"%s\",\"iterations\":%llu,\"test_cases\":%llu,"
+           "\"seconds\":%.6f,\"tc_per_sec\":%.1f,\"mb_per_sec\":%.3f,\"allocs\":%lld,"
+           "\"alloc_bytes\":%lld,\"peak_rss_kb\":%ld,\"result\":%d}\n",
+           entry->name, file ? file : entry->fixture, iterations, iterations * tcs, elapsed,
+           elapsed > 0 ? iterations * tcs / elapsed : 0,
+           elapsed > 0 ? iterations * len / elapsed / (1024 * 1024) : 0,
+           BENCH_COUNT_ALLOCS ? (long long)(allocs / iterations) : -1,
+           BENCH_COUNT_ALLOCS ? (long long)(alloc_bytes / iterations) : -1,
+           usage.ru_maxrss, rv);
+    if (ctx) amvp_free_test_session(ctx);
+    free(buf);
+    return rv;
+}
+
+static void bench_usage(const char *prog) {
+    printf("usage: %s [--fixtures <dir>] [--min_time <seconds>] [handler ...]\n", prog);
+    printf("       %s --fixture <file> [--min_time <seconds>] <handler>\n", prog);
+    printf("handlers:");
+    for (size_t i = 0; i < BENCH_TBL_LEN; i++) {
+        printf(" %s", bench_tbl[i].name);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    const char *dir = BENCH_FIXTURE_DIR, *file = NULL;
+    double min_seconds = BENCH_MIN_SECONDS;
+    int first = 1, i = 0, failed = 0;
+    size_t j = 0;
+    pid_t pid;
+    int status = 0;
+
+    for (first = 1; first < argc && !strncmp(argv[first], "--", 2); first++) {
+        if (!strcmp(argv[first], "--fixtures") && first + 1 < argc) {
+            dir = argv[++first];
+        } else if (!strcmp(argv[first], "--fixture") && first + 1 < argc) {
+            file = argv[++first];
+        } else if (!strcmp(argv[first], "--min_time") && first + 1 < argc) {
+            min_seconds = atof(argv[++first]);
+        } else {
+            bench_usage(argv[0]);
+            return 1;
+        }
+    }
+    /* A vector set of its own, e.g. from gen_vectors, is for one handler */
+    if (file && argc - first != 1) {
+        bench_usage(argv[0]);
+        return 1;
+    }
+
+    for (j = 0; j < BENCH_TBL_LEN; j++) {
+        if (first < argc) {
+            for (i = first; i < argc && strcmp(argv[i], bench_tbl[j].name); i++);
+            if (i == argc) {
+                continue;
+            }
+        }
+        fflush(stdout);
+        pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return 1;
+        }
+        if (!pid) {
+            status = bench_run(&bench_tbl[j], dir, file, min_seconds);
+            fflush(stdout);
+            _exit(status == AMVP_SUCCESS ? 0 : 1);
+        }
+        if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status)) {
+            printf("{\"handler\":\"%s\",\"fixture\":\"%s\",\"error\":\"crashed\"}\n",
+                   bench_tbl[j].name, bench_tbl[j].fixture);
+            failed = 1;
+        } else if (WEXITSTATUS(status)) {
+            failed = 1;
+        }
+    }
+    return failed;
+}
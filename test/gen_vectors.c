@@ -0,0 +1,831 @@
+/** @file */
+/*
+ * Copyright (c) 2021, Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://github.com/cisco/libamvp/LICENSE
+ */
+
+/*
+ * Synthetic vector set generator, for scale and stress testing of the KAT
+ * handlers (see bench_amvp.c) with vector sets far larger than the fixtures.
+ *
+ * The field lengths of the generated test groups come from a registration:
+ * either one given with --registration, as printed by --get_registration, or
+ * by default the largest one the capability API accepts for the algorithm,
+ * built by amvp_build_register.c. Every length in a list (keyLen, tagLen,
+ * ...) gets a test group of its own; lengths given as a domain use the max
+ * of the domain, or a random value of it with --random_lengths. --max_len
+ * lowers the max of every domain, to scale vector sets down.
+ *
+ * The vector set is written in the format saved with --vector_req, behind
+ * identifiers of a made up test session, so it can be run with --request
+ * and --response (amvp_run_vectors_from_file()) but not uploaded. Test
+ * case data is random from a seeded PRNG so the same options always give the
+ * same file. With --expected the matching expected results are written too,
+ * in the format of --get_expected_results, for use with --verify_expected.
+ * Computing them needs OpenSSL and is not available for ctrDRBG.
+ *
+ * Both files are streamed as they are generated, so the size of a vector set
+ * is only limited by the disk.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "amvp/amvp.h"
+#include "amvp/amvp_lcl.h"
+#include "amvp/parson.h"
+#ifdef GEN_VECTORS_EXPECTED
+#include <openssl/evp.h>
+#endif
+
+#define GEN_DEFAULT_TESTS 100
+#define GEN_DEFAULT_SEED 1
+#define GEN_MAX_LIST 16
+#define GEN_SESSION_URL "/amvp/v1/testSessions/0"
+#define GEN_JWT "gen_vectors"
+
+/*
+ * Largest payload and AAD lengths the capability API accepts for AES-GCM
+ */
+#define GEN_GCM_PAYLOAD_BIT_MAX 65536
+#define GEN_GCM_AAD_BIT_MAX AMVP_SYM_AAD_BIT_MAX
+
+/*
+ * A length descriptor of the registration: a list of values or a domain
+ */
+typedef struct gen_len_t {
+    int vals[GEN_MAX_LIST];
+    int cnt;
+    int is_domain;
+    int min;
+    int max;
+    int increment;
+} GEN_LEN;
+
+typedef struct gen_t {
+    FILE *vs;
+    FILE *exp;
+    unsigned long long prng;
+    int random_lengths;
+    int max_len;
+    long tests;
+    long tc_id;
+    int tg_id;
+    int group_cnt;
+    int groups_left;
+} GEN;
+
+static int gen_crypto(AMVP_TEST_CASE *tc) {
+    (void)tc;
+    return 0;
+}
+
+static AMVP_RESULT gen_log(char *msg, AMVP_LOG_LVL level) {
+    (void)level;
+    fprintf(stderr, "[AMVP]: %s\n", msg);
+    return AMVP_SUCCESS;
+}
+
+/*
+ * xorshift64*, enough for test data and reproducible across platforms
+ */
+static unsigned long long gen_rand(GEN *gen) {
+    gen->prng ^= gen->prng >> 12;
+    gen->prng ^= gen->prng << 25;
+    gen->prng ^= gen->prng >> 27;
+    return gen->prng * 2685821657736338717ULL;
+}
+
+static void gen_rand_bytes(GEN *gen, unsigned char *buf, int len) {
+    int i;
+
+    for (i = 0; i < len; i++) {
+        buf[i] = (unsigned char)(gen_rand(gen) >> 56);
+    }
+}
+
+static int gen_bytes(int bits) {
+    return (bits + 7) / 8;
+}
+
+static void gen_put_hex(FILE *fp, const unsigned char *buf, int len) {
+    static const char hex[] = "0123456789ABCDEF";
+    int i;
+
+    for (i = 0; i < len; i++) {
+        fputc(hex[buf[i] >> 4], fp);
+        fputc(hex[buf[i] & 0xf], fp);
+    }
+}
+
+static void gen_put_field(FILE *fp, const char *name, const unsigned char *buf, int len) {
+    fprintf(fp, ",\"%s\":\"", name);
+    gen_put_hex(fp, buf, len);
+    fputc('"', fp);
+}
+
+/*
+ * Read a length descriptor: a number, an array of numbers or an array of
+ * {"min","max","increment"} domains, of which only the first is used. The
+ * max of a domain is lowered to --max_len when given.
+ */
+static int gen_read_len(GEN *gen, JSON_Object *obj, const char *name, GEN_LEN *len) {
+    JSON_Value *val = json_object_get_value(obj, name);
+    JSON_Array *arr = NULL;
+    JSON_Object *domain = NULL;
+    int i;
+
+    memset(len, 0, sizeof(GEN_LEN));
+    if (json_value_get_type(val) == JSONNumber) {
+        len->vals[len->cnt++] = (int)json_value_get_number(val);
+        return 1;
+    }
+    arr = json_value_get_array(val);
+    if (!arr || !json_array_get_count(arr)) {
+        return 0;
+    }
+    domain = json_array_get_object(arr, 0);
+    if (domain) {
+        len->is_domain = 1;
+        len->min = (int)json_object_get_number(domain, "min");
+        len->max = (int)json_object_get_number(domain, "max");
+        len->increment = (int)json_object_get_number(domain, "increment");
+        if (len->increment <= 0) {
+            len->increment = 1;
+        }
+        if (gen->max_len && len->max > gen->max_len) {
+            len->max = gen->max_len < len->min ? len->min :
+                       len->min + (gen->max_len - len->min) / len->increment * len->increment;
+        }
+        return 1;
+    }
+    for (i = 0; i < (int)json_array_get_count(arr) && len->cnt < GEN_MAX_LIST; i++) {
+        len->vals[len->cnt++] = (int)json_array_get_number(arr, i);
+    }
+    return 1;
+}
+
+/*
+ * Number of test groups a descriptor spans: one per listed value, one for a domain
+ */
+static int gen_len_groups(GEN_LEN *len) {
+    return len->is_domain ? 1 : len->cnt;
+}
+
+/*
+ * The value of a descriptor for group index idx
+ */
+static int gen_len_pick(GEN *gen, GEN_LEN *len, int idx) {
+    int steps = 0;
+
+    if (!len->is_domain) {
+        return len->vals[idx % len->cnt];
+    }
+    if (!gen->random_lengths) {
+        return len->max;
+    }
+    steps = (len->max - len->min) / len->increment;
+    return len->min + (int)(gen_rand(gen) % (unsigned long long)(steps + 1)) * len->increment;
+}
+
+static int gen_len_max(GEN_LEN *len) {
+    int i, max = len->max;
+
+    for (i = 0; i < len->cnt; i++) {
+        if (len->vals[i] > max) {
+            max = len->vals[i];
+        }
+    }
+    return max;
+}
+
+/*
+ * Spread the test cases evenly over the test groups
+ */
+static long gen_group_tests(GEN *gen) {
+    long tests = gen->tests / gen->group_cnt;
+
+    if (gen->groups_left <= gen->tests % gen->group_cnt) {
+        tests++;
+    }
+    gen->groups_left--;
+    return tests;
+}
+
+/*
+ * The identifiers of the vector set file are those saved with --vector_req,
+ * for a test session that doesn't exist on any server
+ */
+static void gen_vs_begin(GEN *gen, int vs_id, const char *alg, const char *revision) {
+    fprintf(gen->vs, "[{\"jwt\":\"%s\",\"url\":\"%s\",\"vectorSetUrls\":[\"%s/vectorSets/%d\"],"
+            "\"isSample\":false},\n", GEN_JWT, GEN_SESSION_URL, GEN_SESSION_URL, vs_id);
+    fprintf(gen->vs, "{\"vsId\":%d,\"algorithm\":\"%s\",\"revision\":\"%s\","
+            "\"isSample\":false,\"testGroups\":[", vs_id, alg, revision);
+    if (gen->exp) {
+        fprintf(gen->exp, "[{\"amvVersion\":\"1.0\"},\n{\"vsId\":%d,\"algorithm\":\"%s\",\"revision\":\"%s\","
+                "\"testGroups\":[", vs_id, alg, revision);
+    }
+}
+
+static void gen_vs_end(GEN *gen) {
+    fprintf(gen->vs, "\n]}]\n");
+    if (gen->exp) {
+        fprintf(gen->exp, "\n]}]\n");
+    }
+}
+
+/*
+ * Open a test group, the group fields follow in the vector set
+ */
+static void gen_group_begin(GEN *gen) {
+    gen->tg_id++;
+    fprintf(gen->vs, "%s\n{\"tgId\":%d", gen->tg_id > 1 ? "," : "", gen->tg_id);
+    if (gen->exp) {
+        fprintf(gen->exp, "%s\n{\"tgId\":%d,\"tests\":[", gen->tg_id > 1 ? "," : "", gen->tg_id);
+    }
+}
+
+static void gen_group_end(GEN *gen) {
+    fprintf(gen->vs, "]}");
+    if (gen->exp) {
+        fprintf(gen->exp, "]}");
+    }
+}
+
+/*
+ * Open a test case in both files, the fields follow
+ */
+static void gen_tc_begin(GEN *gen, long idx) {
+    gen->tc_id++;
+    fprintf(gen->vs, "%s\n{\"tcId\":%ld", idx ? "," : "", gen->tc_id);
+    if (gen->exp) {
+        fprintf(gen->exp, "%s\n{\"tcId\":%ld", idx ? "," : "", gen->tc_id);
+    }
+}
+
+static void gen_tc_end(GEN *gen) {
+    fputc('}', gen->vs);
+    if (gen->exp) {
+        fputc('}', gen->exp);
+    }
+}
+
+#ifdef GEN_VECTORS_EXPECTED
+static int gen_gcm_encrypt(const unsigned char *key, int key_len, const unsigned char *iv, int iv_len,
+                           const unsigned char *aad, int aad_len, const unsigned char *pt, int pt_len,
+                           unsigned char *ct, unsigned char *tag, int tag_len) {
+    EVP_CIPHER_CTX *cctx = EVP_CIPHER_CTX_new();
+    const EVP_CIPHER *cipher = NULL;
+    int len = 0, ok = 0;
+
+    switch (key_len) {
+    case 16:
+        cipher = EVP_aes_128_gcm();
+        break;
+    case 24:
+        cipher = EVP_aes_192_gcm();
+        break;
+    default:
+        cipher = EVP_aes_256_gcm();
+        break;
+    }
+    ok = cctx && EVP_EncryptInit_ex(cctx, cipher, NULL, NULL, NULL) &&
+         EVP_CIPHER_CTX_ctrl(cctx, EVP_CTRL_GCM_SET_IVLEN, iv_len, NULL) &&
+         EVP_EncryptInit_ex(cctx, NULL, NULL, key, iv) &&
+         (!aad_len || EVP_EncryptUpdate(cctx, NULL, &len, aad, aad_len)) &&
+         (!pt_len || EVP_EncryptUpdate(cctx, ct, &len, pt, pt_len)) &&
+         EVP_EncryptFinal_ex(cctx, ct + len, &len) &&
+         EVP_CIPHER_CTX_ctrl(cctx, EVP_CTRL_GCM_GET_TAG, tag_len, tag);
+    EVP_CIPHER_CTX_free(cctx);
+    return ok;
+}
+
+/*
+ * Digest msg, or for SHAKE produce md_bits of output. Returns the length of md
+ * in bytes, 0 on error.
+ */
+static int gen_digest(const char *alg, const unsigned char *msg, int msg_len,
+                      unsigned char *md, int md_bits) {
+    EVP_MD_CTX *mctx = EVP_MD_CTX_new();
+    const EVP_MD *type = NULL;
+    char name[32];
+    unsigned int len = 0;
+    int ok = 0;
+
+    /* SHA2-512/224 is SHA512-224 and SHAKE-128 is SHAKE128 to OpenSSL */
+    if (!strcmp(alg, "SHA-1")) {
+        snprintf(name, sizeof(name), "SHA1");
+    } else if (!strncmp(alg, "SHA2-", 5)) {
+        snprintf(name, sizeof(name), "SHA%s", alg + 5);
+    } else if (!strncmp(alg, "SHAKE-", 6)) {
+        snprintf(name, sizeof(name), "SHAKE%s", alg + 6);
+    } else {
+        snprintf(name, sizeof(name), "%s", alg);
+    }
+    if (strchr(name, '/')) {
+        *strchr(name, '/') = '-';
+    }
+    type = EVP_get_digestbyname(name);
+    ok = mctx && type && EVP_DigestInit_ex(mctx, type, NULL) &&
+         EVP_DigestUpdate(mctx, msg, msg_len);
+    if (ok && md_bits) {
+        len = gen_bytes(md_bits);
+        ok = EVP_DigestFinalXOF(mctx, md, len);
+        /* Clear the bits past outLen in the last byte */
+        if (md_bits % 8) {
+            md[md_bits / 8] &= 0xff << (8 - md_bits % 8);
+        }
+    } else if (ok) {
+        ok = EVP_DigestFinal_ex(mctx, md, &len);
+    }
+    EVP_MD_CTX_free(mctx);
+    return ok ? (int)len : 0;
+}
+#endif
+
+/*
+ * AES-GCM AFT groups, one per direction, keyLen, tagLen and ivLen
+ */
+static int gen_aes_gcm(GEN *gen, JSON_Object *cap) {
+    JSON_Array *dirs = json_object_get_array(cap, "direction");
+    const char *iv_gen = json_object_get_string(cap, "ivGen");
+    const char *iv_gen_mode = json_object_get_string(cap, "ivGenMode");
+    GEN_LEN key_len, tag_len, iv_len, pt_len, aad_len;
+    unsigned char *key = NULL, *iv = NULL, *aad = NULL, *pt = NULL, *ct = NULL, *tag = NULL;
+    int g, idx, encrypt, klen, tlen, ivlen, plen, alen, rv = 1;
+    long i, tests;
+
+    if (!dirs || !gen_read_len(gen, cap, "keyLen", &key_len) || !gen_read_len(gen, cap, "tagLen", &tag_len) ||
+            !gen_read_len(gen, cap, "ivLen", &iv_len) || !gen_read_len(gen, cap, "payloadLen", &pt_len) ||
+            !gen_read_len(gen, cap, "aadLen", &aad_len) || !iv_gen) {
+        fprintf(stderr, "Registration is missing direction, keyLen, tagLen, ivLen, payloadLen, aadLen or ivGen\n");
+        return 1;
+    }
+    if (gen->exp && strcmp(iv_gen, "external")) {
+        fprintf(stderr, "Expected results need an external ivGen\n");
+        return 1;
+    }
+
+    key = calloc(gen_bytes(gen_len_max(&key_len)) + 1, 1);
+    iv = calloc(gen_bytes(gen_len_max(&iv_len)) + 1, 1);
+    aad = calloc(gen_bytes(gen_len_max(&aad_len)) + 1, 1);
+    pt = calloc(gen_bytes(gen_len_max(&pt_len)) + 1, 1);
+    ct = calloc(gen_bytes(gen_len_max(&pt_len)) + 1, 1);
+    tag = calloc(gen_bytes(gen_len_max(&tag_len)) + 1, 1);
+    if (!key || !iv || !aad || !pt || !ct || !tag) {
+        goto end;
+    }
+
+    gen->group_cnt = json_array_get_count(dirs) * gen_len_groups(&key_len) *
+                     gen_len_groups(&tag_len) * gen_len_groups(&iv_len);
+    gen->groups_left = gen->group_cnt;
+    for (g = 0; g < gen->group_cnt; g++) {
+        /* g counts through ivLen, then tagLen, then keyLen, then direction */
+        idx = g;
+        ivlen = gen_len_pick(gen, &iv_len, idx % gen_len_groups(&iv_len));
+        idx /= gen_len_groups(&iv_len);
+        tlen = gen_len_pick(gen, &tag_len, idx % gen_len_groups(&tag_len));
+        idx /= gen_len_groups(&tag_len);
+        klen = gen_len_pick(gen, &key_len, idx % gen_len_groups(&key_len));
+        idx /= gen_len_groups(&key_len);
+        encrypt = !strcmp(json_array_get_string(dirs, idx), "encrypt");
+        plen = gen_len_pick(gen, &pt_len, 0);
+        alen = gen_len_pick(gen, &aad_len, 0);
+        tests = gen_group_tests(gen);
+
+        gen_group_begin(gen);
+        fprintf(gen->vs, ",\"testType\":\"AFT\",\"direction\":\"%s\",\"keyLen\":%d,\"ivLen\":%d,"
+                "\"ivGen\":\"%s\",", encrypt ? "encrypt" : "decrypt", klen, ivlen, iv_gen);
+        if (iv_gen_mode) {
+            fprintf(gen->vs, "\"ivGenMode\":\"%s\",", iv_gen_mode);
+        }
+        fprintf(gen->vs, "\"payloadLen\":%d,\"aadLen\":%d,\"tagLen\":%d,\"tests\":[",
+                plen, alen, tlen);
+
+        for (i = 0; i < tests; i++) {
+            gen_rand_bytes(gen, key, gen_bytes(klen));
+            gen_rand_bytes(gen, iv, gen_bytes(ivlen));
+            gen_rand_bytes(gen, aad, gen_bytes(alen));
+            gen_rand_bytes(gen, pt, gen_bytes(plen));
+            gen_rand_bytes(gen, ct, gen_bytes(plen));
+            gen_rand_bytes(gen, tag, gen_bytes(tlen));
+#ifdef GEN_VECTORS_EXPECTED
+            if (gen->exp && !gen_gcm_encrypt(key, gen_bytes(klen), iv, gen_bytes(ivlen), aad, gen_bytes(alen),
+                                             pt, gen_bytes(plen), ct, tag, gen_bytes(tlen))) {
+                fprintf(stderr, "AES-GCM encrypt failed\n");
+                goto end;
+            }
+#endif
+            gen_tc_begin(gen, i);
+            gen_put_field(gen->vs, "key", key, gen_bytes(klen));
+            gen_put_field(gen->vs, "iv", iv, gen_bytes(ivlen));
+            gen_put_field(gen->vs, "aad", aad, gen_bytes(alen));
+            if (encrypt) {
+                gen_put_field(gen->vs, "pt", pt, gen_bytes(plen));
+                if (gen->exp) {
+                    gen_put_field(gen->exp, "ct", ct, gen_bytes(plen));
+                    gen_put_field(gen->exp, "tag", tag, gen_bytes(tlen));
+                }
+            } else {
+                gen_put_field(gen->vs, "ct", ct, gen_bytes(plen));
+                gen_put_field(gen->vs, "tag", tag, gen_bytes(tlen));
+                if (gen->exp) {
+                    gen_put_field(gen->exp, "pt", pt, gen_bytes(plen));
+                }
+            }
+            gen_tc_end(gen);
+        }
+        gen_group_end(gen);
+    }
+    rv = 0;
+
+end:
+    free(key);
+    free(iv);
+    free(aad);
+    free(pt);
+    free(ct);
+    free(tag);
+    return rv;
+}
+
+/*
+ * SHA-1, SHA2 and SHA3 AFT groups with messageLength, or a SHAKE VOT group
+ * with outputLen
+ */
+static int gen_hash(GEN *gen, JSON_Object *cap, const char *alg) {
+    GEN_LEN len;
+    unsigned char *msg = NULL, *md = NULL;
+    int xof = !strncmp(alg, "SHAKE-", 6);
+    int msg_bits = 0, out_bits = 0, rv = 1;
+    long i;
+
+    if (!gen_read_len(gen, cap, xof ? "outputLen" : "messageLength", &len)) {
+        fprintf(stderr, "Registration is missing %s\n", xof ? "outputLen" : "messageLength");
+        return 1;
+    }
+    /* VOT messages are one security strength long */
+    msg = calloc(xof ? 32 : gen_bytes(gen_len_max(&len)) + 1, 1);
+    md = calloc(xof ? gen_bytes(gen_len_max(&len)) : AMVP_HASH_MD_BYTE_MAX, 1);
+    if (!msg || !md) {
+        goto end;
+    }
+
+    gen->group_cnt = 1;
+    gen->groups_left = 1;
+    gen_group_begin(gen);
+    fprintf(gen->vs, ",\"testType\":\"%s\",\"tests\":[", xof ? "VOT" : "AFT");
+    for (i = 0; i < gen->tests; i++) {
+        if (xof) {
+            msg_bits = !strcmp(alg, "SHAKE-128") ? 128 : 256;
+            out_bits = gen_len_pick(gen, &len, 0);
+        } else {
+            msg_bits = gen_len_pick(gen, &len, 0);
+        }
+        gen_rand_bytes(gen, msg, gen_bytes(msg_bits));
+        gen_tc_begin(gen, i);
+        gen_put_field(gen->vs, "msg", msg, gen_bytes(msg_bits));
+        fprintf(gen->vs, ",\"len\":%d", msg_bits);
+        if (xof) {
+            fprintf(gen->vs, ",\"outLen\":%d", out_bits);
+        }
+#ifdef GEN_VECTORS_EXPECTED
+        if (gen->exp) {
+            int md_len = gen_digest(alg, msg, gen_bytes(msg_bits), md, out_bits);
+            if (!md_len) {
+                fprintf(stderr, "%s digest failed\n", alg);
+                goto end;
+            }
+            gen_put_field(gen->exp, "md", md, md_len);
+        }
+#endif
+        gen_tc_end(gen);
+    }
+    gen_group_end(gen);
+    rv = 0;
+
+end:
+    free(msg);
+    free(md);
+    return rv;
+}
+
+/*
+ * ctrDRBG AFT groups, one per mode and predResistance setting
+ */
+static int gen_ctr_drbg(GEN *gen, JSON_Object *cap) {
+    JSON_Array *modes = json_object_get_array(cap, "capabilities");
+    JSON_Array *pred = json_object_get_array(cap, "predResistanceEnabled");
+    int reseed = json_object_get_boolean(cap, "reseedImplemented") == 1;
+    GEN_LEN ent_len, nonce_len, perso_len, add_len, ret_len;
+    JSON_Object *mode = NULL;
+    unsigned char *buf = NULL;
+    int m, p, o, pr, ent, nonce, perso, add, ret, other, rv = 1;
+    size_t buf_len = 0;
+    long i, tests;
+
+    if (gen->exp) {
+        fprintf(stderr, "Expected results are not available for ctrDRBG\n");
+        return 1;
+    }
+    if (!modes || !pred) {
+        fprintf(stderr, "Registration is missing capabilities or predResistanceEnabled\n");
+        return 1;
+    }
+
+    gen->group_cnt = json_array_get_count(modes) * json_array_get_count(pred);
+    gen->groups_left = gen->group_cnt;
+    for (m = 0; m < (int)json_array_get_count(modes); m++) {
+        mode = json_array_get_object(modes, m);
+        if (!gen_read_len(gen, mode, "entropyInputLen", &ent_len) || !gen_read_len(gen, mode, "nonceLen", &nonce_len) ||
+                !gen_read_len(gen, mode, "persoStringLen", &perso_len) ||
+                !gen_read_len(gen, mode, "additionalInputLen", &add_len) ||
+                !gen_read_len(gen, mode, "returnedBitsLen", &ret_len)) {
+            fprintf(stderr, "Registration is missing a length of mode %s\n", json_object_get_string(mode, "mode"));
+            goto end;
+        }
+        /* One buffer large enough for any of the inputs */
+        buf_len = gen_bytes(gen_len_max(&ent_len));
+        if ((size_t)gen_bytes(gen_len_max(&perso_len)) > buf_len) buf_len = gen_bytes(gen_len_max(&perso_len));
+        if ((size_t)gen_bytes(gen_len_max(&add_len)) > buf_len) buf_len = gen_bytes(gen_len_max(&add_len));
+        if ((size_t)gen_bytes(gen_len_max(&nonce_len)) > buf_len) buf_len = gen_bytes(gen_len_max(&nonce_len));
+        free(buf);
+        buf = calloc(buf_len + 1, 1);
+        if (!buf) {
+            goto end;
+        }
+
+        for (p = 0; p < (int)json_array_get_count(pred); p++) {
+            pr = json_array_get_boolean(pred, p) == 1;
+            ent = gen_len_pick(gen, &ent_len, 0);
+            nonce = gen_len_pick(gen, &nonce_len, 0);
+            perso = gen_len_pick(gen, &perso_len, 0);
+            add = gen_len_pick(gen, &add_len, 0);
+            ret = gen_len_pick(gen, &ret_len, 0);
+            /* Without prediction resistance a reseed comes before the two generate calls */
+            other = !pr && reseed ? 3 : 2;
+
+            gen_group_begin(gen);
+            fprintf(gen->vs, ",\"testType\":\"AFT\",\"mode\":\"%s\",\"derFunc\":%s,\"predResistance\":%s,"
+                    "\"reSeed\":%s,\"entropyInputLen\":%d,\"nonceLen\":%d,\"persoStringLen\":%d,"
+                    "\"additionalInputLen\":%d,\"returnedBitsLen\":%d,\"tests\":[",
+                    json_object_get_string(mode, "mode"),
+                    json_object_get_boolean(mode, "derFuncEnabled") == 1 ? "true" : "false",
+                    pr ? "true" : "false", reseed ? "true" : "false", ent, nonce, perso, add, ret);
+
+            tests = gen_group_tests(gen);
+            for (i = 0; i < tests; i++) {
+                gen_tc_begin(gen, i);
+                gen_rand_bytes(gen, buf, gen_bytes(ent));
+                gen_put_field(gen->vs, "entropyInput", buf, gen_bytes(ent));
+                gen_rand_bytes(gen, buf, gen_bytes(nonce));
+                gen_put_field(gen->vs, "nonce", buf, gen_bytes(nonce));
+                gen_rand_bytes(gen, buf, gen_bytes(perso));
+                gen_put_field(gen->vs, "persoString", buf, gen_bytes(perso));
+                fprintf(gen->vs, ",\"otherInput\":[");
+                for (o = 0; o < other; o++) {
+                    fprintf(gen->vs, "%s{\"intendedUse\":\"%s\"", o ? "," : "",
+                            other == 3 && !o ? "reSeed" : "generate");
+                    gen_rand_bytes(gen, buf, gen_bytes(add));
+                    gen_put_field(gen->vs, "additionalInput", buf, gen_bytes(add));
+                    /* Entropy is only given on reseed and with prediction resistance */
+                    gen_rand_bytes(gen, buf, gen_bytes(ent));
+                    gen_put_field(gen->vs, "entropyInput", buf, pr || (other == 3 && !o) ? gen_bytes(ent) : 0);
+                    fputc('}', gen->vs);
+                }
+                fputc(']', gen->vs);
+                gen_tc_end(gen);
+            }
+            gen_group_end(gen);
+        }
+    }
+    rv = 0;
+
+end:
+    free(buf);
+    return rv;
+}
+
+/*
+ * Register the largest capability the API accepts for cipher
+ */
+static AMVP_RESULT gen_register_max(AMVP_CTX *ctx, AMVP_CIPHER cipher) {
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    switch (cipher) {
+    case AMVP_AES_GCM:
+        rv = amvp_cap_sym_cipher_enable(ctx, cipher, gen_crypto);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_sym_cipher_set_parm(ctx, cipher, AMVP_SYM_CIPH_PARM_DIR, AMVP_SYM_CIPH_DIR_BOTH);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_sym_cipher_set_parm(ctx, cipher, AMVP_SYM_CIPH_PARM_KO, AMVP_SYM_CIPH_KO_NA);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_sym_cipher_set_parm(ctx, cipher, AMVP_SYM_CIPH_PARM_IVGEN_SRC, AMVP_SYM_CIPH_IVGEN_SRC_EXT);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_sym_cipher_set_parm(ctx, cipher, AMVP_SYM_CIPH_KEYLEN, 128);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_sym_cipher_set_parm(ctx, cipher, AMVP_SYM_CIPH_KEYLEN, 192);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_sym_cipher_set_parm(ctx, cipher, AMVP_SYM_CIPH_KEYLEN, 256);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_sym_cipher_set_parm(ctx, cipher, AMVP_SYM_CIPH_TAGLEN, AMVP_SYM_TAG_BIT_MAX);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_sym_cipher_set_domain(ctx, cipher, AMVP_SYM_CIPH_DOMAIN_IVLEN,
+                                                                    AMVP_AES_GCM_IV_BIT_MIN, AMVP_AES_GCM_IV_BIT_MAX, 8);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_sym_cipher_set_domain(ctx, cipher, AMVP_SYM_CIPH_DOMAIN_PTLEN,
+                                                                    0, GEN_GCM_PAYLOAD_BIT_MAX, 8);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_sym_cipher_set_domain(ctx, cipher, AMVP_SYM_CIPH_DOMAIN_AADLEN,
+                                                                    0, GEN_GCM_AAD_BIT_MAX, 8);
+        break;
+    case AMVP_HASH_SHAKE_128:
+    case AMVP_HASH_SHAKE_256:
+        rv = amvp_cap_hash_enable(ctx, cipher, gen_crypto);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_hash_set_domain(ctx, cipher, AMVP_HASH_OUT_LENGTH,
+                                                              AMVP_HASH_XOF_MD_BIT_MIN, AMVP_HASH_XOF_MD_BIT_MAX, 8);
+        break;
+    case AMVP_HASH_SHA1:
+    case AMVP_HASH_SHA224:
+    case AMVP_HASH_SHA256:
+    case AMVP_HASH_SHA384:
+    case AMVP_HASH_SHA512:
+    case AMVP_HASH_SHA3_224:
+    case AMVP_HASH_SHA3_256:
+    case AMVP_HASH_SHA3_384:
+    case AMVP_HASH_SHA3_512:
+        rv = amvp_cap_hash_enable(ctx, cipher, gen_crypto);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_hash_set_domain(ctx, cipher, AMVP_HASH_MESSAGE_LEN,
+                                                              AMVP_HASH_MSG_BIT_MIN, AMVP_HASH_MSG_BIT_MAX, 8);
+        break;
+    case AMVP_CTRDRBG:
+        rv = amvp_cap_drbg_enable(ctx, cipher, gen_crypto);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_drbg_set_parm(ctx, cipher, AMVP_DRBG_AES_256, 0, AMVP_DRBG_DER_FUNC_ENABLED, 1);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_drbg_set_parm(ctx, cipher, AMVP_DRBG_AES_256, 0, AMVP_DRBG_PRED_RESIST_ENABLED, 0);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_drbg_set_parm(ctx, cipher, AMVP_DRBG_AES_256, 0, AMVP_DRBG_RESEED_ENABLED, 1);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_drbg_set_length(ctx, cipher, AMVP_DRBG_AES_256, 0, AMVP_DRBG_ENTROPY_LEN,
+                                                              256, 8, AMVP_DRBG_ENTPY_IN_BIT_MAX);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_drbg_set_length(ctx, cipher, AMVP_DRBG_AES_256, 0, AMVP_DRBG_NONCE_LEN,
+                                                              128, 8, AMVP_DRBG_NONCE_BIT_MAX);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_drbg_set_length(ctx, cipher, AMVP_DRBG_AES_256, 0, AMVP_DRBG_PERSO_LEN,
+                                                              0, 8, AMVP_DRBG_PER_SO_BIT_MAX);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_drbg_set_length(ctx, cipher, AMVP_DRBG_AES_256, 0, AMVP_DRBG_ADD_IN_LEN,
+                                                              0, 8, AMVP_DRBG_ADDI_IN_BIT_MAX);
+        if (rv == AMVP_SUCCESS) rv = amvp_cap_drbg_set_parm(ctx, cipher, AMVP_DRBG_AES_256, 0, AMVP_DRBG_RET_BITS_LEN,
+                                                            AMVP_DRB_BIT_MAX);
+        break;
+    default:
+        rv = AMVP_UNSUPPORTED_OP;
+        break;
+    }
+    return rv;
+}
+
+/*
+ * Load the registration from file, or build the largest one for alg
+ */
+static JSON_Value *gen_load_registration(const char *reg_file, const char *alg) {
+    AMVP_CTX *ctx = NULL;
+    JSON_Value *reg = NULL;
+    char *str = NULL;
+
+    if (reg_file) {
+        reg = json_parse_file(reg_file);
+        if (!reg) {
+            fprintf(stderr, "Unable to parse registration %s\n", reg_file);
+        }
+        return reg;
+    }
+    if (amvp_create_test_session(&ctx, gen_log, AMVP_LOG_LVL_ERR) != AMVP_SUCCESS) {
+        return NULL;
+    }
+    if (gen_register_max(ctx, amvp_lookup_cipher_index(alg)) != AMVP_SUCCESS) {
+        fprintf(stderr, "Unable to register %s\n", alg);
+        goto end;
+    }
+    str = amvp_get_current_registration(ctx, NULL);
+    if (str) {
+        reg = json_parse_string(str);
+        json_free_serialized_string(str);
+    }
+
+end:
+    amvp_free_test_session(ctx);
+    return reg;
+}
+
+/*
+ * Find the capability of alg: the registration is an array of capabilities,
+ * or an object holding them in "algorithms"
+ */
+static JSON_Object *gen_find_cap(JSON_Value *reg, const char *alg) {
+    JSON_Array *caps = json_value_get_array(reg);
+    JSON_Object *cap = NULL;
+    const char *name = NULL;
+    int i;
+
+    if (!caps) {
+        caps = json_object_get_array(json_value_get_object(reg), "algorithms");
+    }
+    for (i = 0; i < (int)json_array_get_count(caps); i++) {
+        cap = json_array_get_object(caps, i);
+        name = json_object_get_string(cap, "algorithm");
+        if (name && !strcmp(name, alg)) {
+            return cap;
+        }
+    }
+    return NULL;
+}
+
+static void gen_usage(const char *prog) {
+    printf("usage: %s --alg <algorithm> [--tests <n>] [--out <file>] [--expected <file>]\n"
+           "       [--registration <file>] [--random_lengths] [--max_len <bits>] [--seed <n>]\n"
+           "       [--vs_id <n>]\n", prog);
+    printf("algorithms: AMVP-AES-GCM, SHAKE-128, SHAKE-256, SHA-1, SHA2-224, SHA2-256, SHA2-384,\n"
+           "            SHA2-512, SHA3-224, SHA3-256, SHA3-384, SHA3-512, ctrDRBG\n");
+}
+
+int main(int argc, char **argv) {
+    GEN gen;
+    JSON_Value *reg = NULL;
+    JSON_Object *cap = NULL;
+    const char *alg = NULL, *reg_file = NULL, *out_file = NULL, *exp_file = NULL;
+    const char *revision = NULL;
+    int i, vs_id = 1, rv = 1;
+
+    memset(&gen, 0, sizeof(GEN));
+    gen.tests = GEN_DEFAULT_TESTS;
+    gen.prng = GEN_DEFAULT_SEED;
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--alg") && i + 1 < argc) {
+            alg = argv[++i];
+        } else if (!strcmp(argv[i], "--tests") && i + 1 < argc) {
+            gen.tests = atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+            out_file = argv[++i];
+        } else if (!strcmp(argv[i], "--expected") && i + 1 < argc) {
+            exp_file = argv[++i];
+        } else if (!strcmp(argv[i], "--registration") && i + 1 < argc) {
+            reg_file = argv[++i];
+        } else if (!strcmp(argv[i], "--random_lengths")) {
+            gen.random_lengths = 1;
+        } else if (!strcmp(argv[i], "--max_len") && i + 1 < argc) {
+            gen.max_len = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            gen.prng = strtoull(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "--vs_id") && i + 1 < argc) {
+            vs_id = atoi(argv[++i]);
+        } else {
+            gen_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!alg || gen.tests < 1) {
+        gen_usage(argv[0]);
+        return 1;
+    }
+    if (!gen.prng) {
+        gen.prng = GEN_DEFAULT_SEED;
+    }
+#ifndef GEN_VECTORS_EXPECTED
+    if (exp_file) {
+        fprintf(stderr, "Expected results need gen_vectors to be built with OpenSSL\n");
+        return 1;
+    }
+#endif
+
+    reg = gen_load_registration(reg_file, alg);
+    cap = gen_find_cap(reg, alg);
+    if (!cap) {
+        fprintf(stderr, "No %s capability in the registration\n", alg);
+        goto end;
+    }
+    revision = json_object_get_string(cap, "revision");
+
+    gen.vs = out_file ? fopen(out_file, "w") : stdout;
+    if (!gen.vs) {
+        fprintf(stderr, "Unable to open %s\n", out_file);
+        goto end;
+    }
+    if (exp_file) {
+        gen.exp = fopen(exp_file, "w");
+        if (!gen.exp) {
+            fprintf(stderr, "Unable to open %s\n", exp_file);
+            goto end;
+        }
+    }
+
+    gen_vs_begin(&gen, vs_id, alg, revision ? revision : "1.0");
+    if (!strcmp(alg, "AMVP-AES-GCM")) {
+        rv = gen_aes_gcm(&gen, cap);
+    } else if (!strncmp(alg, "SHA", 3)) {
+        rv = gen_hash(&gen, cap, alg);
+    } else if (!strcmp(alg, "ctrDRBG")) {
+        rv = gen_ctr_drbg(&gen, cap);
+    } else {
+        fprintf(stderr, "%s is not supported by the generator\n", alg);
+    }
+    if (!rv) {
+        gen_vs_end(&gen);
+    }
+
+end:
+    if (gen.vs && gen.vs != stdout) fclose(gen.vs);
+    if (gen.exp) fclose(gen.exp);
+    if (reg) json_value_free(reg);
+    return rv;
+}
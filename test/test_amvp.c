@@ -11,6 +11,10 @@
 
 #include "ut_common.h"
 #include "amvp/amvp_lcl.h"
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
 
 AMVP_CTX *ctx;
 static char filename[] = "filename";
@@ -250,6 +254,99 @@ Test(SET_SESSION_PARAMS, null_params_2fa, .init = setup, .fini = teardown) {
     cr_assert(rv == AMVP_NO_CTX);
 }
 
+/*
+ * This test enables background key pre-generation
+ */
+Test(SET_SESSION_PARAMS, key_pregen_good, .init = setup, .fini = teardown) {
+    rv = amvp_set_key_pregen(ctx, 2, 1);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    rv = amvp_set_key_pregen(ctx, 0, AMVP_KEY_PREGEN_DEPTH_MAX);
+    cr_assert(rv == AMVP_SUCCESS);
+}
+
+/*
+ * This test sets key pre-generation with invalid params
+ */
+Test(SET_SESSION_PARAMS, key_pregen_invalid_params, .init = setup, .fini = teardown) {
+    rv = amvp_set_key_pregen(NULL, 2, 1);
+    cr_assert(rv == AMVP_NO_CTX);
+
+    rv = amvp_set_key_pregen(ctx, -1, 1);
+    cr_assert(rv == AMVP_INVALID_ARG);
+
+    rv = amvp_set_key_pregen(ctx, AMVP_KEY_PREGEN_THREADS_MAX + 1, 1);
+    cr_assert(rv == AMVP_INVALID_ARG);
+
+    rv = amvp_set_key_pregen(ctx, 2, 0);
+    cr_assert(rv == AMVP_INVALID_ARG);
+}
+
+/*
+ * This test sets the number of concurrent vector set workers
+ */
+Test(SET_SESSION_PARAMS, vs_workers, .init = setup, .fini = teardown) {
+    rv = amvp_set_vs_workers(ctx, 4);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    rv = amvp_set_vs_workers(NULL, 4);
+    cr_assert(rv == AMVP_NO_CTX);
+
+    rv = amvp_set_vs_workers(ctx, 0);
+    cr_assert(rv == AMVP_INVALID_ARG);
+
+    rv = amvp_set_vs_workers(ctx, AMVP_VS_WORKERS_MAX + 1);
+    cr_assert(rv == AMVP_INVALID_ARG);
+}
+
+static int async_log_count = 0;
+
+static AMVP_RESULT counting_progress(char *msg, AMVP_LOG_LVL level) {
+    if (strstr(msg, "Invalid number of slow test cases")) {
+        async_log_count++;
+    }
+    return AMVP_SUCCESS;
+}
+
+/*
+ * This test starts and stops the asynchronous log sink, and checks that the
+ * queued messages reach the log callback by the time the session is freed
+ */
+Test(SET_SESSION_PARAMS, log_async, .fini = teardown) {
+    int i;
+
+    rv = amvp_create_test_session(&ctx, &counting_progress, AMVP_LOG_LVL_STATUS);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    rv = amvp_set_log_async(NULL, 16);
+    cr_assert(rv == AMVP_NO_CTX);
+
+    rv = amvp_set_log_async(ctx, -1);
+    cr_assert(rv == AMVP_INVALID_ARG);
+
+    rv = amvp_set_log_async(ctx, AMVP_LOG_ASYNC_SLOTS_MAX + 1);
+    cr_assert(rv == AMVP_INVALID_ARG);
+
+    rv = amvp_set_log_async(ctx, 16);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_set_log_async(ctx, 0);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    /* More messages than the ring has slots, each one logged as an error */
+    rv = amvp_set_log_async(ctx, 16);
+    cr_assert(rv == AMVP_SUCCESS);
+    async_log_count = 0;
+    for (i = 0; i < 100; i++) {
+        rv = amvp_set_slow_tc_capture(ctx, AMVP_SLOW_TC_MAX + 1);
+        cr_assert(rv == AMVP_INVALID_ARG);
+    }
+
+    rv = amvp_free_test_session(ctx);
+    cr_assert(rv == AMVP_SUCCESS);
+    ctx = NULL;
+    cr_assert(async_log_count == 100);
+}
+
 /*
  * This test sets json filename
  */
@@ -666,6 +763,7 @@ Test(FREE_CTX, good, .init = setup_full_ctx) {
  * Test amvp_run_vectors_from_file logic
  */
 Test(PROCESS_TESTS, run_vectors_from_file, .init = setup_full_ctx, .fini = teardown) {
+    FILE *fp = NULL;
 
     rv = amvp_run_vectors_from_file(NULL, "test", "test");
     cr_assert(rv == AMVP_NO_CTX);
@@ -679,6 +777,339 @@ Test(PROCESS_TESTS, run_vectors_from_file, .init = setup_full_ctx, .fini = teard
     rv = amvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp1.json");
     cr_assert(rv == AMVP_SUCCESS);
 
+    /* A completed run leaves nothing behind to resume from */
+    fp = fopen("json/rsp1.json.journal", "r");
+    cr_assert_null(fp);
+    fp = fopen("json/rsp1.json.tmp", "r");
+    cr_assert_null(fp);
+}
+
+/*
+ * Test amvp_run_vectors_from_file with a vector set written by gen_vectors,
+ * see test/README.md
+ */
+Test(PROCESS_TESTS, run_generated_vectors, .init = setup_full_ctx, .fini = teardown) {
+    AMVP_PERF_STATS *stats = NULL;
+
+    stats = calloc(1, sizeof(AMVP_PERF_STATS));
+    cr_assert_not_null(stats);
+
+    rv = amvp_run_vectors_from_file(ctx, "json/gen_sha1.json", "json/rsp_gen.json");
+    cr_assert(rv == AMVP_SUCCESS);
+    remove("json/rsp_gen.json");
+
+    rv = amvp_get_perf_stats(ctx, stats);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(stats->alg[AMVP_HASH_SHA1].vs_count == 1);
+    cr_assert(stats->alg[AMVP_HASH_SHA1].tc_count == 8);
+    free(stats);
+}
+
+/*
+ * Whether the two files have the same contents
+ */
+static int same_file(const char *a, const char *b) {
+    FILE *fa = fopen(a, "rb");
+    FILE *fb = fopen(b, "rb");
+    int ca = 0, cb = 0;
+
+    if (fa && fb) {
+        do {
+            ca = fgetc(fa);
+            cb = fgetc(fb);
+        } while (ca == cb && ca != EOF);
+    }
+    if (fa) fclose(fa);
+    if (fb) fclose(fb);
+    return fa && fb && ca == cb;
+}
+
+/*
+ * Test that the vector set workers of amvp_run_vectors_from_file write the
+ * same response file as a serial run
+ */
+Test(PROCESS_TESTS, run_vectors_concurrent, .init = setup_full_ctx, .fini = teardown) {
+    rv = amvp_set_vs_workers(ctx, 1);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_run_vectors_from_file(ctx, "json/gen_sha1_multi.json", "json/rsp_serial.json");
+    cr_assert(rv == AMVP_SUCCESS);
+
+    teardown_ctx(&ctx);
+    ctx = NULL;
+    setup_full_ctx();
+    rv = amvp_set_vs_workers(ctx, 4);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_run_vectors_from_file(ctx, "json/gen_sha1_multi.json", "json/rsp_concurrent.json");
+    cr_assert(rv == AMVP_SUCCESS);
+
+    cr_assert(same_file("json/rsp_serial.json", "json/rsp_concurrent.json"));
+    remove("json/rsp_serial.json");
+    remove("json/rsp_concurrent.json");
+}
+
+/*
+ * Test that a request file with more vector sets than vectorSetUrls fails
+ * the same way with and without vector set workers
+ */
+Test(PROCESS_TESTS, run_vectors_extra_vs, .init = setup_full_ctx, .fini = teardown) {
+    FILE *fp = NULL;
+
+    rv = amvp_run_vectors_from_file(ctx, "json/gen_sha1_extra.json", "json/rsp_extra.json");
+    cr_assert(rv == AMVP_JSON_ERR);
+
+    teardown_ctx(&ctx);
+    ctx = NULL;
+    setup_full_ctx();
+    rv = amvp_set_vs_workers(ctx, 4);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_run_vectors_from_file(ctx, "json/gen_sha1_extra.json", "json/rsp_extra.json");
+    cr_assert(rv == AMVP_JSON_ERR);
+
+    /* A failed run is not resumed, nothing is left behind */
+    fp = fopen("json/rsp_extra.json", "r");
+    cr_assert_null(fp);
+    fp = fopen("json/rsp_extra.json.tmp", "r");
+    cr_assert_null(fp);
+    fp = fopen("json/rsp_extra.json.journal", "r");
+    cr_assert_null(fp);
+}
+
+#ifndef _WIN32
+static int resume_calls = 0;
+static int resume_exit_at = 0;
+
+static int resume_handler(AMVP_TEST_CASE *test_case) {
+    if (resume_exit_at && resume_calls == resume_exit_at) {
+        _exit(0);
+    }
+    resume_calls++;
+    return 0;
+}
+
+static void resume_run(const char *rsp_filename, int exit_at) {
+    resume_calls = 0;
+    resume_exit_at = exit_at;
+    setup_empty_ctx(&ctx);
+    rv = amvp_cap_hash_enable(ctx, AMVP_HASH_SHA1, &resume_handler);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_run_vectors_from_file(ctx, "json/gen_sha1_multi.json", rsp_filename);
+}
+
+/*
+ * Test that a run of amvp_run_vectors_from_file that was killed part way
+ * resumes after the vector sets it completed, and ends with the same response
+ * file as a run that was not interrupted
+ */
+Test(PROCESS_TESTS, run_vectors_resume, .fini = teardown) {
+    FILE *fp = NULL;
+    pid_t pid = 0;
+    int status = 0;
+
+    resume_run("json/rsp_whole.json", 0);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(resume_calls == 24);
+    teardown_ctx(&ctx);
+    ctx = NULL;
+
+    /* Die on the first test case of the fourth vector set */
+    pid = fork();
+    cr_assert(pid >= 0);
+    if (!pid) {
+        resume_run("json/rsp_resume.json", 12);
+        _exit(1);
+    }
+    cr_assert(waitpid(pid, &status, 0) == pid);
+    cr_assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    fp = fopen("json/rsp_resume.json.journal", "r");
+    cr_assert_not_null(fp);
+    if (fp) fclose(fp);
+    fp = fopen("json/rsp_resume.json", "r");
+    cr_assert_null(fp);
+
+    /* Only the last three vector sets are processed again */
+    resume_run("json/rsp_resume.json", 0);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(resume_calls == 12);
+    cr_assert(same_file("json/rsp_whole.json", "json/rsp_resume.json"));
+
+    fp = fopen("json/rsp_resume.json.journal", "r");
+    cr_assert_null(fp);
+    fp = fopen("json/rsp_resume.json.tmp", "r");
+    cr_assert_null(fp);
+    remove("json/rsp_whole.json");
+    remove("json/rsp_resume.json");
+}
+#endif
+
+/*
+ * Test amvp_get_perf_stats after an offline run
+ */
+Test(PROCESS_TESTS, get_perf_stats, .init = setup_full_ctx, .fini = teardown) {
+    AMVP_PERF_STATS *stats = NULL;
+
+    stats = calloc(1, sizeof(AMVP_PERF_STATS));
+    cr_assert_not_null(stats);
+
+    rv = amvp_get_perf_stats(NULL, stats);
+    cr_assert(rv == AMVP_NO_CTX);
+    rv = amvp_get_perf_stats(ctx, NULL);
+    cr_assert(rv == AMVP_MISSING_ARG);
+
+    rv = amvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_perf.json");
+    cr_assert(rv == AMVP_SUCCESS);
+    remove("json/rsp_perf.json");
+
+    rv = amvp_get_perf_stats(ctx, stats);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(stats->alg[AMVP_CMAC_AES].vs_count == 1);
+    cr_assert(stats->alg[AMVP_CMAC_AES].tc_count > 0);
+    cr_assert(stats->alg[AMVP_CMAC_AES].tc_count == stats->total.tc_count);
+    cr_assert(!strcmp(stats->alg[AMVP_CMAC_AES].name, "CMAC-AES"));
+    free(stats);
+}
+
+/*
+ * Test amvp_get_mem_stats after an offline run
+ */
+Test(PROCESS_TESTS, get_mem_stats, .init = setup_full_ctx, .fini = teardown) {
+    AMVP_MEM_STATS stats;
+
+    rv = amvp_get_mem_stats(NULL, &stats);
+    cr_assert(rv == AMVP_NO_CTX);
+    rv = amvp_get_mem_stats(ctx, NULL);
+    cr_assert(rv == AMVP_MISSING_ARG);
+
+    rv = amvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_mem.json");
+    cr_assert(rv == AMVP_SUCCESS);
+    remove("json/rsp_mem.json");
+
+    rv = amvp_get_mem_stats(ctx, &stats);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(stats.vs_count == 1);
+    cr_assert(stats.tag[AMVP_MEM_TC].allocs > 0);
+    cr_assert(stats.peak_vs[AMVP_MEM_JSON] > 0);
+}
+
+/*
+ * Test amvp_get_latency_stats and amvp_set_slow_tc_capture after an offline run
+ */
+Test(PROCESS_TESTS, get_latency_stats, .init = setup_full_ctx, .fini = teardown) {
+    AMVP_LATENCY_STATS stats;
+
+    rv = amvp_set_slow_tc_capture(NULL, 2);
+    cr_assert(rv == AMVP_NO_CTX);
+    rv = amvp_set_slow_tc_capture(ctx, AMVP_SLOW_TC_MAX + 1);
+    cr_assert(rv == AMVP_INVALID_ARG);
+    rv = amvp_set_slow_tc_capture(ctx, 2);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_get_latency_stats(ctx, AMVP_CMAC_AES, NULL);
+    cr_assert(rv == AMVP_MISSING_ARG);
+    rv = amvp_get_latency_stats(ctx, AMVP_CIPHER_END, &stats);
+    cr_assert(rv == AMVP_INVALID_ARG);
+
+    rv = amvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_latency.json");
+    cr_assert(rv == AMVP_SUCCESS);
+    remove("json/rsp_latency.json");
+
+    rv = amvp_get_latency_stats(ctx, AMVP_CMAC_AES, &stats);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(stats.count > 0);
+    cr_assert(stats.min_ns <= stats.p50_ns);
+    cr_assert(stats.p50_ns <= stats.p99_ns);
+    cr_assert(stats.p99_ns <= stats.max_ns);
+    cr_assert(stats.slow_count == 2);
+    cr_assert(stats.slow[0].ns >= stats.slow[1].ns);
+    cr_assert(stats.slow[0].ns == stats.max_ns);
+    cr_assert(stats.slow[0].tc_id > 0);
+
+    rv = amvp_get_latency_stats(ctx, AMVP_HASH_SHA256, &stats);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(stats.count == 0);
+}
+
+/*
+ * Test amvp_estimate_session with and without a calibration run
+ */
+Test(PROCESS_TESTS, estimate_session, .init = setup_full_ctx, .fini = teardown) {
+    AMVP_SESSION_ESTIMATE *est = NULL;
+    AMVP_PERF_STATS *perf = NULL;
+
+    est = calloc(1, sizeof(AMVP_SESSION_ESTIMATE));
+    perf = calloc(1, sizeof(AMVP_PERF_STATS));
+    cr_assert_not_null(est);
+    cr_assert_not_null(perf);
+
+    rv = amvp_estimate_session(NULL, NULL, est);
+    cr_assert(rv == AMVP_NO_CTX);
+    rv = amvp_estimate_session(ctx, NULL, NULL);
+    cr_assert(rv == AMVP_MISSING_ARG);
+
+    rv = amvp_estimate_session(ctx, NULL, est);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(est->total.vs_count == amvp_get_vector_set_count(ctx));
+    cr_assert(est->total.tc_count > 0);
+    cr_assert(est->total.crypto_calls >= est->total.tc_count);
+    cr_assert(est->total.cpu_ns >= est->total.crypto_ns);
+    cr_assert(est->total.vs_max_ns <= est->total.cpu_ns);
+    cr_assert(est->total.mem_peak > 0);
+    cr_assert(est->alg[AMVP_CMAC_AES].vs_count == 1);
+    cr_assert(!est->alg[AMVP_CMAC_AES].calibrated);
+
+    rv = amvp_estimate_session(ctx, "json/req.json", est);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(est->alg[AMVP_CMAC_AES].calibrated);
+    cr_assert(est->alg[AMVP_CMAC_AES].bytes_in > 0);
+    cr_assert(est->alg[AMVP_HASH_SHA1].vs_count == 1);
+    cr_assert(!est->alg[AMVP_HASH_SHA1].calibrated);
+
+    /* The calibration run is not counted in the session */
+    rv = amvp_get_perf_stats(ctx, perf);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(perf->total.tc_count == 0);
+
+    free(perf);
+    free(est);
+}
+
+/*
+ * Test amvp_set_trace_file with an offline run
+ */
+Test(PROCESS_TESTS, set_trace_file, .init = setup_full_ctx, .fini = teardown) {
+    JSON_Value *val = NULL;
+    JSON_Array *events = NULL;
+    JSON_Object *event = NULL;
+    const char *name = NULL;
+    int i = 0, alg_spans = 0, group_spans = 0;
+
+    rv = amvp_set_trace_file(NULL, "json/trace.json");
+    cr_assert(rv == AMVP_NO_CTX);
+
+    rv = amvp_set_trace_file(ctx, "json/trace.json");
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_run_vectors_from_file(ctx, "json/req.json", "json/rsp_trace.json");
+    cr_assert(rv == AMVP_SUCCESS);
+    remove("json/rsp_trace.json");
+    rv = amvp_set_trace_file(ctx, NULL);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    val = json_parse_file("json/trace.json");
+    cr_assert_not_null(val);
+    events = json_value_get_array(val);
+    cr_assert_not_null(events);
+    for (i = 0; i < (int)json_array_get_count(events); i++) {
+        event = json_array_get_object(events, i);
+        name = json_object_get_string(event, "name");
+        if (!strcmp(name, "CMAC-AES")) {
+            alg_spans++;
+        } else if (!strcmp(name, "test group")) {
+            group_spans++;
+            cr_assert(json_object_dotget_number(event, "args.tgId") > 0);
+        }
+    }
+    cr_assert(alg_spans == 1);
+    cr_assert(group_spans > 0);
+    json_value_free(val);
+    remove("json/trace.json");
 }
 
 /*
@@ -959,3 +1390,46 @@ Test(PROCESS_TESTS, amvp_get_expected_results, .init = setup_full_ctx, .fini = t
     rv = amvp_get_expected_results(ctx, "", NULL);
     cr_assert(rv == AMVP_MALFORMED_JSON);
 }
+
+/*
+ * Test amvp_verify_expected_results
+ */
+Test(PROCESS_TESTS, amvp_verify_expected_results, .init = setup_full_ctx, .fini = teardown) {
+    JSON_Value *val = NULL;
+    JSON_Object *group = NULL;
+    JSON_Array *tests = NULL;
+    int mismatches = -1;
+
+    rv = amvp_verify_expected_results(NULL, "json/rsp.json", "json/rsp.json", &mismatches);
+    cr_assert(rv == AMVP_NO_CTX);
+    rv = amvp_verify_expected_results(ctx, NULL, "json/rsp.json", &mismatches);
+    cr_assert(rv == AMVP_MISSING_ARG);
+    rv = amvp_verify_expected_results(ctx, "json/rsp.json", NULL, &mismatches);
+    cr_assert(rv == AMVP_MISSING_ARG);
+    rv = amvp_verify_expected_results(ctx, "json/rsp.json", "json/rsp.json", NULL);
+    cr_assert(rv == AMVP_MISSING_ARG);
+
+    rv = amvp_verify_expected_results(ctx, "json/rsp.json", "json/rsp.json", &mismatches);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(mismatches == 0);
+
+    /*
+     * Change one answer and renumber another test case in the expected
+     * results, which leaves one response without an expected result and one
+     * expected result without a response
+     */
+    val = json_parse_file("json/rsp.json");
+    cr_assert_not_null(val);
+    group = json_array_get_object(json_object_get_array(
+            json_array_get_object(json_value_get_array(val), 1), "testGroups"), 0);
+    tests = json_object_get_array(group, "tests");
+    json_object_set_string(json_array_get_object(tests, 0), "mac", "00");
+    json_object_set_number(json_array_get_object(tests, 1), "tcId", 999999);
+    cr_assert(json_serialize_to_file_pretty(val, "json/expected.json") == JSONSuccess);
+    json_value_free(val);
+
+    rv = amvp_verify_expected_results(ctx, "json/rsp.json", "json/expected.json", &mismatches);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(mismatches == 3);
+    remove("json/expected.json");
+}
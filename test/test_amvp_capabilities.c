@@ -10,6 +10,10 @@
 
 
 #include "ut_common.h"
+#include "amvp/amvp_lcl.h"
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 
 AMVP_CTX *ctx;
 char cvalue[] = "same";
@@ -1838,3 +1842,401 @@ Test(EnableCapKDFTLS13, invalid_params, .fini = teardown) {
     rv = amvp_cap_kdf_tls13_set_parm(ctx, 0, AMVP_SHA256);
     cr_assert(rv == AMVP_INVALID_ARG);
 }
+
+static int dummy_batch_handler(AMVP_TEST_CASE *test_cases, int *results, int count) {
+    if (!test_cases || !results || count <= 0) return 1;
+    return 0;
+}
+
+/*
+ * register a batch handler for an enabled hash capability
+ */
+Test(CapBatchHandler, properly, .fini = teardown) {
+    setup_empty_ctx(&ctx);
+
+    rv = amvp_cap_hash_enable(ctx, AMVP_HASH_SHA256, &dummy_handler_success);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_batch_handler(ctx, AMVP_HASH_SHA256, &dummy_batch_handler);
+    cr_assert(rv == AMVP_SUCCESS);
+}
+
+/*
+ * batch handlers with invalid args, capabilities that were not
+ * enabled, or capabilities that do not support batching
+ */
+Test(CapBatchHandler, invalid_args, .fini = teardown) {
+    setup_empty_ctx(&ctx);
+
+    rv = amvp_cap_set_batch_handler(NULL, AMVP_HASH_SHA256, &dummy_batch_handler);
+    cr_assert(rv == AMVP_NO_CTX);
+    rv = amvp_cap_set_batch_handler(ctx, AMVP_HASH_SHA256, &dummy_batch_handler);
+    cr_assert(rv == AMVP_NO_CAP);
+    rv = amvp_cap_hash_enable(ctx, AMVP_HASH_SHA256, &dummy_handler_success);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_batch_handler(ctx, AMVP_HASH_SHA256, NULL);
+    cr_assert(rv == AMVP_INVALID_ARG);
+    rv = amvp_cap_kdf135_snmp_enable(ctx, &dummy_handler_success);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_batch_handler(ctx, AMVP_KDF135_SNMP, &dummy_batch_handler);
+    cr_assert(rv == AMVP_UNSUPPORTED_OP);
+}
+
+/*
+ * SHA2-256 vector set with an AFT group of 40 test cases, an MCT group and an
+ * AFT group of 3 test cases, tcIds 1 to 44 in order
+ */
+#define HANDLERS_VS "json/hash/sha2_256_handlers.json"
+#define HANDLERS_RSP "json/hash/rsp_handlers.json"
+
+static int last_tc_id = 0;
+static int handler_calls = 0;
+static int batch_sizes[8];
+static int batch_calls = 0;
+
+static int counting_hash_handler(AMVP_TEST_CASE *test_case) {
+    AMVP_HASH_TC *tc = test_case->tc.hash;
+
+    /* The inner MCT iterations all see the same test case */
+    if (tc->tc_id != (unsigned int)last_tc_id) {
+        cr_assert(tc->tc_id == (unsigned int)last_tc_id + 1);
+        last_tc_id = tc->tc_id;
+    }
+    handler_calls++;
+    return 0;
+}
+
+static int counting_batch_handler(AMVP_TEST_CASE *test_cases, int *results, int count) {
+    int i;
+
+    cr_assert(count > 0 && count <= AMVP_BATCH_TC_MAX);
+    cr_assert(batch_calls < 8);
+    for (i = 0; i < count; i++) {
+        cr_assert(test_cases[i].tc.hash->test_type != AMVP_HASH_TEST_TYPE_MCT);
+        cr_assert(test_cases[i].tc.hash->tc_id == (unsigned int)last_tc_id + 1);
+        last_tc_id++;
+        results[i] = 0;
+    }
+    batch_sizes[batch_calls++] = count;
+    return 0;
+}
+
+/*
+ * run a vector set through a batch handler: full batches are handed over as
+ * they fill up, the rest when the group ends, and the MCT group goes through
+ * the crypto_handler in between
+ */
+Test(CapBatchHandler, offline_run, .fini = teardown) {
+    setup_empty_ctx(&ctx);
+    last_tc_id = 0;
+    handler_calls = 0;
+    batch_calls = 0;
+
+    rv = amvp_cap_hash_enable(ctx, AMVP_HASH_SHA256, &counting_hash_handler);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_batch_handler(ctx, AMVP_HASH_SHA256, &counting_batch_handler);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    rv = amvp_run_vectors_from_file(ctx, HANDLERS_VS, HANDLERS_RSP);
+    cr_assert(rv == AMVP_SUCCESS);
+    remove(HANDLERS_RSP);
+
+    cr_assert(batch_calls == 4);
+    cr_assert(batch_sizes[0] == 16);
+    cr_assert(batch_sizes[1] == 16);
+    cr_assert(batch_sizes[2] == 8);
+    cr_assert(batch_sizes[3] == 3);
+    cr_assert(handler_calls == AMVP_HASH_MCT_OUTER * AMVP_HASH_MCT_INNER);
+    cr_assert(last_tc_id == 44);
+}
+
+/*
+ * native MCT handlers are only accepted for hash, AES and TDES
+ * modes that have a Monte Carlo test
+ */
+Test(CapMctHandler, properly, .fini = teardown) {
+    setup_empty_ctx(&ctx);
+
+    rv = amvp_cap_set_mct_handler(NULL, AMVP_HASH_SHA256, &dummy_handler_success);
+    cr_assert(rv == AMVP_NO_CTX);
+    rv = amvp_cap_set_mct_handler(ctx, AMVP_HASH_SHA256, &dummy_handler_success);
+    cr_assert(rv == AMVP_NO_CAP);
+    rv = amvp_cap_hash_enable(ctx, AMVP_HASH_SHA256, &dummy_handler_success);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_mct_handler(ctx, AMVP_HASH_SHA256, NULL);
+    cr_assert(rv == AMVP_INVALID_ARG);
+    rv = amvp_cap_set_mct_handler(ctx, AMVP_HASH_SHA256, &dummy_handler_success);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_sym_cipher_enable(ctx, AMVP_AES_GCM, &dummy_handler_success);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_mct_handler(ctx, AMVP_AES_GCM, &dummy_handler_success);
+    cr_assert(rv == AMVP_UNSUPPORTED_OP);
+}
+
+static int mct_calls = 0;
+static unsigned char mct_md[32];
+
+static int native_mct_handler(AMVP_TEST_CASE *test_case) {
+    AMVP_HASH_TC *tc = test_case->tc.hash;
+
+    cr_assert(tc->test_type == AMVP_HASH_TEST_TYPE_MCT);
+    cr_assert(tc->tc_id == 41);
+    cr_assert(last_tc_id == 40 || last_tc_id == 41);
+    last_tc_id = tc->tc_id;
+    /* Every outer iteration is seeded with the digest of the one before */
+    if (mct_calls) {
+        cr_assert(tc->msg_len == sizeof(mct_md));
+        cr_assert(!memcmp(tc->msg, mct_md, sizeof(mct_md)));
+    }
+    mct_calls++;
+    memset(mct_md, mct_calls, sizeof(mct_md));
+    memcpy(tc->md, mct_md, sizeof(mct_md));
+    tc->md_len = sizeof(mct_md);
+    return 0;
+}
+
+/*
+ * run a vector set with a native MCT handler: it is called once per outer
+ * iteration, and the crypto_handler only sees the AFT test cases
+ */
+Test(CapMctHandler, offline_run, .fini = teardown) {
+    AMVP_PERF_STATS *stats = NULL;
+    AMVP_LATENCY_STATS latency;
+
+    stats = calloc(1, sizeof(AMVP_PERF_STATS));
+    cr_assert_not_null(stats);
+    setup_empty_ctx(&ctx);
+    last_tc_id = 0;
+    handler_calls = 0;
+    mct_calls = 0;
+
+    rv = amvp_cap_hash_enable(ctx, AMVP_HASH_SHA256, &counting_hash_handler);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_mct_handler(ctx, AMVP_HASH_SHA256, &native_mct_handler);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    rv = amvp_run_vectors_from_file(ctx, HANDLERS_VS, HANDLERS_RSP);
+    cr_assert(rv == AMVP_SUCCESS);
+    remove(HANDLERS_RSP);
+
+    cr_assert(mct_calls == AMVP_HASH_MCT_OUTER);
+    cr_assert(handler_calls == 43);
+    cr_assert(last_tc_id == 44);
+
+    /* Native MCT calls are counted like any other call into the module */
+    rv = amvp_get_perf_stats(ctx, stats);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(stats->alg[AMVP_HASH_SHA256].tc_count == 43 + AMVP_HASH_MCT_OUTER);
+    free(stats);
+
+    rv = amvp_get_latency_stats(ctx, AMVP_HASH_SHA256, &latency);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(latency.count == 43 + AMVP_HASH_MCT_OUTER);
+}
+
+static int dummy_group_handler(AMVP_TEST_GROUP *group) {
+    if (!group) return 1;
+    return 0;
+}
+
+/*
+ * register group begin/end callbacks, including for unsupported caps
+ */
+Test(CapGroupHandlers, properly, .fini = teardown) {
+    setup_empty_ctx(&ctx);
+
+    rv = amvp_cap_set_group_handlers(NULL, AMVP_HASH_SHA256, &dummy_group_handler, NULL);
+    cr_assert(rv == AMVP_NO_CTX);
+    rv = amvp_cap_set_group_handlers(ctx, AMVP_HASH_SHA256, &dummy_group_handler, NULL);
+    cr_assert(rv == AMVP_NO_CAP);
+    rv = amvp_cap_hash_enable(ctx, AMVP_HASH_SHA256, &dummy_handler_success);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_group_handlers(ctx, AMVP_HASH_SHA256, NULL, NULL);
+    cr_assert(rv == AMVP_INVALID_ARG);
+    rv = amvp_cap_set_group_handlers(ctx, AMVP_HASH_SHA256, &dummy_group_handler, &dummy_group_handler);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_group_handlers(ctx, AMVP_HASH_SHA256, NULL, &dummy_group_handler);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_kdf135_snmp_enable(ctx, &dummy_handler_success);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_group_handlers(ctx, AMVP_KDF135_SNMP, &dummy_group_handler, NULL);
+    cr_assert(rv == AMVP_UNSUPPORTED_OP);
+}
+
+static unsigned int open_tg_id = 0;
+static int group_begins = 0;
+static int group_ends = 0;
+static int group_tcs = 0;
+
+static int ordered_group_begin(AMVP_TEST_GROUP *group) {
+    cr_assert(open_tg_id == 0);
+    cr_assert(group->tg_id == (unsigned int)group_begins + 1);
+    open_tg_id = group->tg_id;
+    group->user_data = &open_tg_id;
+    group_begins++;
+    return 0;
+}
+
+static int ordered_group_end(AMVP_TEST_GROUP *group) {
+    cr_assert(group->tg_id == open_tg_id);
+    cr_assert(group->user_data == &open_tg_id);
+    open_tg_id = 0;
+    group_ends++;
+    return 0;
+}
+
+static int group_hash_handler(AMVP_TEST_CASE *test_case) {
+    cr_assert_not_null(test_case->group);
+    cr_assert(test_case->group->tg_id == open_tg_id);
+    cr_assert(test_case->group->user_data == &open_tg_id);
+    group_tcs++;
+    return 0;
+}
+
+/*
+ * run a vector set with group callbacks: every test case is processed
+ * between the begin and end of its own group
+ */
+Test(CapGroupHandlers, offline_run, .fini = teardown) {
+    setup_empty_ctx(&ctx);
+    open_tg_id = 0;
+    group_begins = 0;
+    group_ends = 0;
+    group_tcs = 0;
+
+    rv = amvp_cap_hash_enable(ctx, AMVP_HASH_SHA256, &group_hash_handler);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_group_handlers(ctx, AMVP_HASH_SHA256, &ordered_group_begin, &ordered_group_end);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    rv = amvp_run_vectors_from_file(ctx, HANDLERS_VS, HANDLERS_RSP);
+    cr_assert(rv == AMVP_SUCCESS);
+    remove(HANDLERS_RSP);
+
+    cr_assert(group_begins == 3);
+    cr_assert(group_ends == 3);
+    cr_assert(open_tg_id == 0);
+    cr_assert(group_tcs == 43 + AMVP_HASH_MCT_OUTER * AMVP_HASH_MCT_INNER);
+}
+
+static int dummy_key_gen(AMVP_TEST_GROUP *group) {
+    if (!group) return 1;
+    return 0;
+}
+
+static void dummy_key_free(void *key) {
+    return;
+}
+
+/*
+ * register a key pre-generation handler for siggen capabilities
+ */
+Test(CapKeyPregenHandler, properly, .fini = teardown) {
+    setup_empty_ctx(&ctx);
+
+    rv = amvp_cap_set_key_pregen_handler(NULL, AMVP_ECDSA_SIGGEN, &dummy_key_gen, &dummy_key_free);
+    cr_assert(rv == AMVP_NO_CTX);
+    rv = amvp_cap_set_key_pregen_handler(ctx, AMVP_ECDSA_SIGGEN, &dummy_key_gen, &dummy_key_free);
+    cr_assert(rv == AMVP_NO_CAP);
+    rv = amvp_cap_ecdsa_enable(ctx, AMVP_ECDSA_SIGGEN, &dummy_handler_success);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_key_pregen_handler(ctx, AMVP_ECDSA_SIGGEN, &dummy_key_gen, NULL);
+    cr_assert(rv == AMVP_INVALID_ARG);
+    rv = amvp_cap_set_key_pregen_handler(ctx, AMVP_ECDSA_SIGGEN, &dummy_key_gen, &dummy_key_free);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_ecdsa_enable(ctx, AMVP_ECDSA_KEYGEN, &dummy_handler_success);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_key_pregen_handler(ctx, AMVP_ECDSA_KEYGEN, &dummy_key_gen, &dummy_key_free);
+    cr_assert(rv == AMVP_UNSUPPORTED_OP);
+}
+
+#ifndef _WIN32
+/*
+ * Key pairs handed out by pool_key_gen, which notes the thread it ran on
+ */
+typedef struct pool_key_t {
+    pthread_t thread;
+} POOL_KEY;
+
+static pthread_mutex_t pool_key_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_key_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t pool_test_thread;
+static int pool_keys_made = 0;
+static int pool_keys_freed = 0;
+static int pool_keys_used = 0;
+
+static int pool_key_gen(AMVP_TEST_GROUP *group) {
+    POOL_KEY *key = calloc(1, sizeof(POOL_KEY));
+
+    if (!key || group->curve != AMVP_EC_CURVE_P256) {
+        free(key);
+        return 1;
+    }
+    key->thread = pthread_self();
+    group->key = key;
+    pthread_mutex_lock(&pool_key_lock);
+    pool_keys_made++;
+    pthread_cond_broadcast(&pool_key_cond);
+    pthread_mutex_unlock(&pool_key_lock);
+    return 0;
+}
+
+static void pool_key_free(void *key) {
+    pthread_mutex_lock(&pool_key_lock);
+    pool_keys_freed++;
+    pthread_mutex_unlock(&pool_key_lock);
+    free(key);
+}
+
+static int pool_siggen_handler(AMVP_TEST_CASE *test_case) {
+    POOL_KEY *key = NULL;
+
+    cr_assert_not_null(test_case->group);
+    key = test_case->group->key;
+    cr_assert_not_null(key);
+    /* Generated ahead of time by a pool worker, not on demand */
+    cr_assert(!pthread_equal(key->thread, pool_test_thread));
+    pool_keys_used++;
+    return 0;
+}
+
+/*
+ * run a SigGen vector set with key pre-generation: both test groups take
+ * their key from the pool, and every key is released by the end
+ */
+Test(CapKeyPregenHandler, offline_run, .fini = teardown) {
+    setup_empty_ctx(&ctx);
+    pool_test_thread = pthread_self();
+    pool_keys_made = 0;
+    pool_keys_freed = 0;
+    pool_keys_used = 0;
+
+    rv = amvp_cap_ecdsa_enable(ctx, AMVP_ECDSA_SIGGEN, &pool_siggen_handler);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_ecdsa_set_parm(ctx, AMVP_ECDSA_SIGGEN, AMVP_ECDSA_CURVE, AMVP_EC_CURVE_P256);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_cap_set_key_pregen_handler(ctx, AMVP_ECDSA_SIGGEN, &pool_key_gen, &pool_key_free);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_set_key_pregen(ctx, 1, 2);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    /* Let the pool fill up before the run so no group has to wait or generate */
+    rv = amvp_key_pool_start(ctx);
+    cr_assert(rv == AMVP_SUCCESS);
+    pthread_mutex_lock(&pool_key_lock);
+    while (pool_keys_made < 2) {
+        pthread_cond_wait(&pool_key_cond, &pool_key_lock);
+    }
+    pthread_mutex_unlock(&pool_key_lock);
+
+    rv = amvp_run_vectors_from_file(ctx, "json/ecdsa/ecdsa_siggen_pregen.json", "json/ecdsa/rsp_pregen.json");
+    cr_assert(rv == AMVP_SUCCESS);
+    remove("json/ecdsa/rsp_pregen.json");
+    cr_assert(pool_keys_used == 4);
+
+    rv = amvp_free_test_session(ctx);
+    cr_assert(rv == AMVP_SUCCESS);
+    ctx = NULL;
+    cr_assert(pool_keys_made >= 2);
+    cr_assert(pool_keys_freed == pool_keys_made);
+}
+#endif
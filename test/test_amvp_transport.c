@@ -9,6 +9,7 @@
  */
 
 #ifndef AMVP_OFFLINE
+#include <time.h>
 #include "ut_common.h"
 #include "amvp/amvp_lcl.h"
 
@@ -521,6 +522,140 @@ Test(TRANSPORT_DELETE, good, .init = test_setup_session_parameters, .fini = tear
 
 }
 
+/*
+ * Exercise amvp_set_transport_replay and amvp_set_transport_record
+ * with a recording, so no server is needed
+ */
+Test(TRANSPORT_REPLAY, good, .init = test_setup_session_parameters, .fini = teardown) {
+    JSON_Value *val = NULL;
+    FILE *fp = NULL;
+    char line[1024];
+    int lines = 0;
+
+    rv = amvp_set_transport_replay(NULL, "json/transport_replay.jsonl", 0);
+    cr_assert(rv == AMVP_NO_CTX);
+    rv = amvp_set_transport_record(NULL, "json/transport_record.jsonl");
+    cr_assert(rv == AMVP_NO_CTX);
+    rv = amvp_set_transport_replay(ctx, "json/no_such_recording.jsonl", 0);
+    cr_assert(rv == AMVP_INVALID_ARG);
+
+    rv = amvp_set_transport_replay(ctx, "json/transport_replay.jsonl", 0);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_set_transport_record(ctx, "json/transport_record.jsonl");
+    cr_assert(rv == AMVP_SUCCESS);
+
+    rv = amvp_send_login(ctx, login_reg, strlen(login_reg));
+    cr_assert(rv == AMVP_SUCCESS);
+
+    /* The polls are answered in the recorded order, then the last repeats */
+    rv = amvp_retrieve_vector_set(ctx, vsid_url);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert_not_null(strstr(ctx->work.curl_buf, "\"retry\""));
+    rv = amvp_retrieve_vector_set(ctx, vsid_url);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert_not_null(strstr(ctx->work.curl_buf, "SHA-1"));
+    rv = amvp_retrieve_vector_set(ctx, vsid_url);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert_not_null(strstr(ctx->work.curl_buf, "SHA-1"));
+
+    /* Nothing was recorded for this one */
+    rv = amvp_retrieve_vector_set_result(ctx, vsid_url);
+    cr_assert(rv != AMVP_SUCCESS);
+
+    rv = amvp_set_transport_record(ctx, NULL);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_set_transport_replay(ctx, NULL, 0);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    /* One exchange per line, without the password that was sent */
+    fp = fopen("json/transport_record.jsonl", "r");
+    cr_assert_not_null(fp);
+    while (fgets(line, sizeof(line), fp)) {
+        val = json_parse_string(line);
+        cr_assert_not_null(val);
+        cr_assert_not_null(json_object_get_string(json_value_get_object(val), "method"));
+        json_value_free(val);
+        cr_assert_null(strstr(line, "31135756"));
+        lines++;
+    }
+    fclose(fp);
+    cr_assert(lines == 5);
+    remove("json/transport_record.jsonl");
+}
+
+/*
+ * A vector set response the server refuses with a 4xx is not sent again,
+ * only a 5xx or no answer at all is retried
+ */
+Test(TRANSPORT_REPLAY, upload_no_retry, .init = test_setup_session_parameters, .fini = teardown) {
+    FILE *fp = NULL;
+    char line[1024];
+    int posts = 0;
+
+    rv = amvp_set_transport_replay(ctx, "json/transport_upload_403.jsonl", 0);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_set_transport_record(ctx, "json/transport_record_upload.jsonl");
+    cr_assert(rv == AMVP_SUCCESS);
+
+    rv = amvp_upload_vectors_from_file(ctx, "json/rsp_upload.json", 0);
+    cr_assert(rv != AMVP_SUCCESS);
+
+    rv = amvp_set_transport_record(ctx, NULL);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_set_transport_replay(ctx, NULL, 0);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    /* One POST for each of the two vector sets */
+    fp = fopen("json/transport_record_upload.jsonl", "r");
+    cr_assert_not_null(fp);
+    while (fgets(line, sizeof(line), fp)) {
+        if (strstr(line, "\"method\":\"POST\"")) {
+            posts++;
+        }
+    }
+    fclose(fp);
+    cr_assert(posts == 2);
+    remove("json/transport_record_upload.jsonl");
+}
+
+/*
+ * A vector set response the server answers with a 5xx is sent again, and a
+ * replay as fast as possible does not wait before doing so
+ */
+Test(TRANSPORT_REPLAY, upload_retry_fast, .init = test_setup_session_parameters, .fini = teardown) {
+    FILE *fp = NULL;
+    char line[1024];
+    time_t start = 0;
+    int posts = 0;
+
+    rv = amvp_set_transport_replay(ctx, "json/transport_upload_503.jsonl", 0);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_set_transport_record(ctx, "json/transport_record_retry.jsonl");
+    cr_assert(rv == AMVP_SUCCESS);
+
+    start = time(NULL);
+    rv = amvp_upload_vectors_from_file(ctx, "json/rsp_upload.json", 0);
+    cr_assert(rv != AMVP_SUCCESS);
+    cr_assert(time(NULL) - start < AMVP_UPLOAD_RETRY_TIME);
+
+    rv = amvp_set_transport_record(ctx, NULL);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_set_transport_replay(ctx, NULL, 0);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    /* Every attempt for each of the two vector sets */
+    fp = fopen("json/transport_record_retry.jsonl", "r");
+    cr_assert_not_null(fp);
+    while (fgets(line, sizeof(line), fp)) {
+        if (strstr(line, "\"method\":\"POST\"")) {
+            posts++;
+        }
+    }
+    fclose(fp);
+    cr_assert(posts == 2 * (AMVP_UPLOAD_RETRY_MAX + 1));
+    remove("json/transport_record_retry.jsonl");
+}
+
 #if 0 // TODO NIST does not have these enabled via API, we don't have Cisco server yet
 /*
  * missing vector set id url
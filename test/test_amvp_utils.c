@@ -95,14 +95,14 @@ Test(JsonSerializeToFilePrettyW, null_param) {
     AMVP_RESULT rv = AMVP_SUCCESS;
     JSON_Value *value;
 
-    rv = amvp_json_serialize_to_file_pretty_w(NULL, "test");
+    rv = amvp_json_serialize_to_file_pretty_w(ctx, NULL, "test");
     cr_assert(rv == AMVP_JSON_ERR);
 
     value = json_value_init_object();
-    rv = amvp_json_serialize_to_file_pretty_w(value, NULL);
+    rv = amvp_json_serialize_to_file_pretty_w(ctx, value, NULL);
     cr_assert(rv == AMVP_INVALID_ARG);
 
-    rv = amvp_json_serialize_to_file_pretty_w(value, "no_file");
+    rv = amvp_json_serialize_to_file_pretty_w(ctx, value, "no_file");
     cr_assert(rv == AMVP_SUCCESS);
     
     json_value_free(value);
@@ -112,19 +112,86 @@ Test(JsonSerializeToFilePrettyA, null_param) {
     AMVP_RESULT rv = AMVP_SUCCESS;
     JSON_Value *value;
 
-    rv = amvp_json_serialize_to_file_pretty_a(NULL, "test");
+    rv = amvp_json_serialize_to_file_pretty_a(ctx, NULL, "test");
     cr_assert(rv == AMVP_SUCCESS);
 
     value = json_value_init_object();
-    rv = amvp_json_serialize_to_file_pretty_a(value, NULL);
+    rv = amvp_json_serialize_to_file_pretty_a(ctx, value, NULL);
     cr_assert(rv == AMVP_INVALID_ARG);
 
-    rv = amvp_json_serialize_to_file_pretty_a(value, "no_file");
+    rv = amvp_json_serialize_to_file_pretty_a(ctx, value, "no_file");
     cr_assert(rv == AMVP_SUCCESS);
     
     json_value_free(value);
 }
 
+/*
+ * Write a response array with the _w/_a helpers and read it back
+ */
+static void json_file_round_trip(const char *filename) {
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    JSON_Value *value, *parsed;
+    JSON_Array *arr;
+
+    value = json_value_init_object();
+    json_object_set_string(json_value_get_object(value), "name", "value");
+
+    rv = amvp_json_serialize_to_file_pretty_w(ctx, value, filename);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_json_serialize_to_file_pretty_a(ctx, value, filename);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_json_serialize_to_file_pretty_a(ctx, NULL, filename);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    parsed = amvp_json_parse_file(filename);
+    cr_assert_not_null(parsed);
+    arr = json_value_get_array(parsed);
+    cr_assert_not_null(arr);
+    cr_assert(json_array_get_count(arr) == 2);
+    cr_assert(!strcmp(json_object_get_string(json_array_get_object(arr, 1), "name"), "value"));
+
+    json_value_free(parsed);
+    json_value_free(value);
+    remove(filename);
+}
+
+Test(JsonParseFile, plain) {
+    json_file_round_trip("round_trip.json");
+    cr_assert_null(amvp_json_parse_file("no_such_file.json"));
+}
+
+/*
+ * A file of more than one read buffer, so the buffer has to grow
+ */
+Test(JsonParseFile, several_reads) {
+    JSON_Value *parsed, *expected;
+    char *a, *b;
+
+    parsed = amvp_json_parse_file("json/bench/sha2_256.json");
+    expected = json_parse_file("json/bench/sha2_256.json");
+    cr_assert_not_null(parsed);
+    cr_assert_not_null(expected);
+    a = json_serialize_to_string(parsed, NULL);
+    b = json_serialize_to_string(expected, NULL);
+    cr_assert(a && b && !strcmp(a, b));
+    json_free_serialized_string(a);
+    json_free_serialized_string(b);
+    json_value_free(parsed);
+    json_value_free(expected);
+}
+
+#ifdef AMVP_USE_ZLIB
+Test(JsonParseFile, gzip) {
+    json_file_round_trip("round_trip.json.gz");
+}
+#endif
+
+#ifdef AMVP_USE_ZSTD
+Test(JsonParseFile, zstd) {
+    json_file_round_trip("round_trip.json.zst");
+}
+#endif
+
 /*
  * Exercise string_fits logic
  */
@@ -225,3 +292,230 @@ Test(GetObjFromRsp, null_ctx) {
     amvp_free_test_session(ctx);
 }
 
+
+/*
+ * Exercise the vector set metadata kept for failure reporting
+ */
+Test(VsMeta, record_and_lookup) {
+    const AMVP_VS_META *meta = NULL;
+    JSON_Value *val = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    rv = amvp_vs_meta_add(NULL, 1, "ACVP-AES-GCM", NULL);
+    cr_assert(rv == AMVP_NO_CTX);
+
+    setup_empty_ctx(&ctx);
+    rv = amvp_vs_meta_add(ctx, 0, "ACVP-AES-GCM", NULL);
+    cr_assert(rv == AMVP_MISSING_ARG);
+    rv = amvp_vs_meta_add(ctx, 1, "this algorithm name is far too long", NULL);
+    cr_assert(rv == AMVP_INVALID_ARG);
+
+    rv = amvp_vs_meta_add(ctx, 12, "ACVP-AES-GCM", NULL);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_vs_meta_add(ctx, 34, "RSA", "sigGen");
+    cr_assert(rv == AMVP_SUCCESS);
+
+    meta = amvp_vs_meta_lookup(ctx, "/amvp/v1/testSessions/1/vectorSets/34");
+    cr_assert_not_null(meta);
+    cr_assert(!strcmp(meta->alg, "RSA"));
+    cr_assert(!strcmp(meta->mode, "sigGen"));
+    cr_assert_null(amvp_vs_meta_lookup(ctx, "/amvp/v1/testSessions/1/vectorSets/56"));
+
+    /* Round trip through the session info file representation */
+    val = amvp_vs_meta_to_json(ctx);
+    cr_assert_not_null(val);
+    amvp_vs_meta_free(&ctx->vs_meta);
+    cr_assert_null(amvp_vs_meta_lookup(ctx, "/amvp/v1/testSessions/1/vectorSets/12"));
+    rv = amvp_vs_meta_from_json(ctx, json_value_get_array(val));
+    cr_assert(rv == AMVP_SUCCESS);
+    meta = amvp_vs_meta_lookup(ctx, "/amvp/v1/testSessions/1/vectorSets/12");
+    cr_assert_not_null(meta);
+    cr_assert(!strcmp(meta->alg, "ACVP-AES-GCM"));
+    cr_assert(meta->mode[0] == '\0');
+
+    json_value_free(val);
+    amvp_free_test_session(ctx);
+}
+
+/*
+ * Exercise the final statuses recorded by the results monitor
+ */
+Test(VsGraded, record_and_lookup) {
+    const AMVP_VS_GRADED *graded = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    rv = amvp_vs_graded_add(NULL, 1, 0);
+    cr_assert(rv == AMVP_NO_CTX);
+
+    setup_empty_ctx(&ctx);
+    rv = amvp_vs_graded_add(ctx, 0, 0);
+    cr_assert(rv == AMVP_MISSING_ARG);
+
+    rv = amvp_vs_graded_add(ctx, 12, 0);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_vs_graded_add(ctx, 34, 1);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    /* A vector set is graded once, the first status is kept */
+    rv = amvp_vs_graded_add(ctx, 34, 0);
+    cr_assert(rv == AMVP_SUCCESS);
+
+    graded = amvp_vs_graded_lookup(ctx, 34);
+    cr_assert_not_null(graded);
+    cr_assert(graded->failed == 1);
+    graded = amvp_vs_graded_lookup(ctx, 12);
+    cr_assert_not_null(graded);
+    cr_assert(graded->failed == 0);
+    cr_assert_null(amvp_vs_graded_lookup(ctx, 56));
+    cr_assert_null(amvp_vs_graded_lookup(ctx, 0));
+
+    amvp_free_test_session(ctx);
+}
+
+/*
+ * Write text to a file and open it with the streaming reader
+ */
+static AMVP_JSON_STREAM *json_stream_of(const char *text) {
+    AMVP_JSON_STREAM *stream = NULL;
+    FILE *fp = NULL;
+
+    fp = fopen("stream.json", "w");
+    cr_assert_not_null(fp);
+    fputs(text, fp);
+    fclose(fp);
+    cr_assert(amvp_json_stream_open(&stream, "stream.json") == AMVP_SUCCESS);
+    return stream;
+}
+
+/*
+ * Brackets, braces and commas inside strings do not end an element
+ */
+Test(JsonStream, brackets_in_strings) {
+    AMVP_JSON_STREAM *stream = NULL;
+    JSON_Value *val = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    rv = amvp_json_stream_open(NULL, "stream.json");
+    cr_assert(rv == AMVP_MISSING_ARG);
+    rv = amvp_json_stream_next(NULL, &val);
+    cr_assert(rv == AMVP_MISSING_ARG);
+
+    stream = json_stream_of("[ {\"a\":\"]}[{,\"}, \"],\", [\"{\", 2] ]");
+    rv = amvp_json_stream_next(stream, &val);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(!strcmp(json_object_get_string(json_value_get_object(val), "a"), "]}[{,"));
+    json_value_free(val);
+    rv = amvp_json_stream_next(stream, &val);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(!strcmp(json_value_get_string(val), "],"));
+    json_value_free(val);
+    rv = amvp_json_stream_next(stream, &val);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(json_array_get_count(json_value_get_array(val)) == 2);
+    json_value_free(val);
+
+    /* The end of the array, and it stays there */
+    rv = amvp_json_stream_next(stream, &val);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert_null(val);
+    rv = amvp_json_stream_next(stream, &val);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert_null(val);
+    amvp_json_stream_close(stream);
+    remove("stream.json");
+}
+
+/*
+ * Escaped quotes and backslashes inside strings
+ */
+Test(JsonStream, escapes) {
+    AMVP_JSON_STREAM *stream = NULL;
+    JSON_Value *val = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    stream = json_stream_of("[{\"a\":\"q\\\"]}\"},{\"b\":\"\\\\\"},\"\\\\\\\"],\"]");
+    rv = amvp_json_stream_next(stream, &val);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(!strcmp(json_object_get_string(json_value_get_object(val), "a"), "q\"]}"));
+    json_value_free(val);
+    rv = amvp_json_stream_next(stream, &val);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(!strcmp(json_object_get_string(json_value_get_object(val), "b"), "\\"));
+    json_value_free(val);
+    rv = amvp_json_stream_next(stream, &val);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(!strcmp(json_value_get_string(val), "\\\"],"));
+    json_value_free(val);
+    rv = amvp_json_stream_next(stream, &val);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert_null(val);
+    amvp_json_stream_close(stream);
+    remove("stream.json");
+}
+
+/*
+ * Skip steps over whole elements, and not past the end of the array
+ */
+Test(JsonStream, skip) {
+    AMVP_JSON_STREAM *stream = NULL;
+    JSON_Value *val = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+
+    rv = amvp_json_stream_skip(NULL, 1);
+    cr_assert(rv == AMVP_MISSING_ARG);
+
+    stream = json_stream_of("[{\"a\":\"}\"},[{}],{\"c\":3}]");
+    rv = amvp_json_stream_skip(stream, 2);
+    cr_assert(rv == AMVP_SUCCESS);
+    rv = amvp_json_stream_next(stream, &val);
+    cr_assert(rv == AMVP_SUCCESS);
+    cr_assert(json_object_get_number(json_value_get_object(val), "c") == 3);
+    json_value_free(val);
+    rv = amvp_json_stream_skip(stream, 1);
+    cr_assert(rv == AMVP_MALFORMED_JSON);
+    amvp_json_stream_close(stream);
+    remove("stream.json");
+}
+
+/*
+ * Truncated and malformed arrays are errors, not over-reads
+ */
+Test(JsonStream, malformed) {
+    const char *truncated[] = {
+        "",
+        "{\"a\":1}",
+        "[",
+        "[{\"a\":1},",
+        "[{\"a\":[1,2",
+        "[{\"a\":\"abc",
+        "[{\"a\":\"abc\\",
+    };
+    AMVP_JSON_STREAM *stream = NULL;
+    JSON_Value *val = NULL;
+    AMVP_RESULT rv = AMVP_SUCCESS;
+    size_t i;
+
+    for (i = 0; i < sizeof(truncated) / sizeof(truncated[0]); i++) {
+        stream = json_stream_of(truncated[i]);
+        do {
+            rv = amvp_json_stream_next(stream, &val);
+            json_value_free(val);
+        } while (rv == AMVP_SUCCESS && val);
+        cr_assert(rv == AMVP_MALFORMED_JSON);
+        amvp_json_stream_close(stream);
+    }
+
+    /* A complete element that is not valid JSON */
+    stream = json_stream_of("[{\"a\":}, {\"b\":1}]");
+    rv = amvp_json_stream_next(stream, &val);
+    cr_assert(rv == AMVP_JSON_ERR);
+    cr_assert_null(val);
+    amvp_json_stream_close(stream);
+
+    /* Skipping into a truncated element */
+    stream = json_stream_of("[{\"a\":1},{\"b\":[");
+    rv = amvp_json_stream_skip(stream, 2);
+    cr_assert(rv == AMVP_MALFORMED_JSON);
+    amvp_json_stream_close(stream);
+    remove("stream.json");
+}